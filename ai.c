@@ -0,0 +1,278 @@
+/*
+ * ai.c
+ *
+ * Author: Adnaan Buksh
+ */
+
+#include "ai.h"
+#include "input.h"
+#include "timer0.h"
+#include "rules.h"
+
+// How long the computer waits before moving, and the shortest time it
+// lets the dice roll (ms)
+#define AI_THINK_MS 500
+#define AI_ROLL_MS 600
+
+// Positions searched between looks at the time
+#define AI_CHECK_NODES 16
+
+// Options for a move. Joystick moves are AI_JOYSTICK plus a direction.
+#define AI_STEP_1	0
+#define AI_STEP_2	1
+#define AI_ROLL		2
+#define AI_JOYSTICK	3
+#define AI_NUM_OPTIONS (AI_JOYSTICK + 8 * AI_JOYSTICK_MOVES)
+
+// The outcomes of a roll: the total, the number of dice on 6, and how
+// many of the equally likely throws of the dice give it
+typedef struct {
+	uint8_t total;
+	uint8_t sixes;
+	uint8_t throws;
+} Outcome;
+
+static const Outcome one_die[] PROGMEM = {
+	{1, 0, 1}, {2, 0, 1}, {3, 0, 1}, {4, 0, 1}, {5, 0, 1}, {6, 1, 1}
+};
+
+// Totals that can come with or without a 6 are split, for the extra turn
+static const Outcome two_dice[] PROGMEM = {
+	{2, 0, 1}, {3, 0, 2}, {4, 0, 3}, {5, 0, 4}, {6, 0, 5}, {7, 0, 4},
+	{7, 1, 2}, {8, 0, 3}, {8, 1, 2}, {9, 0, 2}, {9, 1, 2}, {10, 0, 1},
+	{10, 1, 2}, {11, 1, 2}, {12, 2, 1}
+};
+
+static const int8_t joystick_moves[8][2] PROGMEM = {
+	{0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}
+};
+
+// How far through its turn the computer is
+#define TURN_WAITING	0	// not the computer's turn
+#define TURN_THINKING	1	// waiting before moving
+#define TURN_ROLLING	2	// dice rolling
+#define TURN_MOVED		3	// waiting for the move to finish
+
+static uint8_t enabled;
+static uint8_t turn_state;
+static uint32_t turn_time;		// when the current part of the turn started
+static uint16_t roll_length;
+
+// The search, with the tables for the board being played (copied out of
+// program memory)
+static AiBoard values;
+static const uint16_t* turns_table;	// for the number of dice rolled
+static const Outcome* outcomes;
+static uint8_t num_outcomes;
+static uint8_t num_throws;			// 6 or 36
+static uint32_t search_start;
+static uint16_t nodes;
+static uint8_t out_of_time;
+
+static uint8_t last_depth;
+static uint16_t last_nodes;
+static uint8_t last_ms;
+
+void ai_set_enabled(uint8_t on) {
+	enabled = on;
+	turn_state = TURN_WAITING;
+}
+
+uint8_t ai_enabled(void) {
+	return enabled;
+}
+
+uint8_t ai_playing(void) {
+	return enabled && get_cur_player() == 1;
+}
+
+void ai_get_stats(uint8_t* depth, uint16_t* searched, uint8_t* ms) {
+	*depth = last_depth;
+	*searched = last_nodes;
+	*ms = last_ms;
+}
+
+static uint16_t best_turns(uint16_t square, uint8_t depth);
+
+// Where a joystick move ends. Moves wrap around the edges of the board.
+static uint16_t joystick_move(uint16_t square, uint8_t direction) {
+	uint8_t width = get_board_width();
+	uint8_t height = get_board_height();
+	uint8_t x, y;
+	get_path_square(square, &x, &y);
+	x = (x + width + (int8_t)pgm_read_byte(&joystick_moves[direction][0])) %
+			width;
+	y = (y + height + (int8_t)pgm_read_byte(&joystick_moves[direction][1])) %
+			height;
+	return pgm_read_word(&values.landing[get_path_position_near(x, y,
+			square)]);
+}
+
+static uint16_t option_turns(uint16_t square, uint8_t option, uint8_t depth);
+
+// Expected turns (times AI_TURN) to the finish moving n squares along the
+// path under the house rules, after any snake or ladder. sixes is the
+// number of dice on 6 for a roll. This turn is counted unless the move
+// earns another.
+static uint16_t move_turns(uint16_t square, uint8_t n, uint8_t sixes,
+		uint8_t depth) {
+	RuleMove move;
+	rules_plan_move(square, n, sixes, &move);
+	square = pgm_read_word(&values.landing[square + move.forward -
+			move.back]);
+	uint16_t turns = best_turns(square, depth - 1);
+	return move.extra_turn ? turns : AI_TURN + turns;
+}
+
+// Fewest expected turns (times AI_TURN) to the finish from square, looking
+// depth turns ahead. Sets out_of_time (and the result is meaningless) if
+// the search has gone over its time.
+static uint16_t best_turns(uint16_t square, uint8_t depth) {
+	if (square == values.squares - 1) {
+		return 0;
+	}
+	if (depth == 0) {
+		return pgm_read_word(&turns_table[square]);
+	}
+	if (++nodes % AI_CHECK_NODES == 0 &&
+			get_current_time() - search_start > AI_BUDGET_MS) {
+		out_of_time = 1;
+	}
+	if (out_of_time) {
+		return 0;
+	}
+	uint16_t best = UINT16_MAX;
+	for (uint8_t option = 0; option < AI_NUM_OPTIONS; option++) {
+		uint16_t turns = option_turns(square, option, depth);
+		if (turns < best) {
+			best = turns;
+		}
+	}
+	return best;
+}
+
+// Expected turns (times AI_TURN) to the finish taking option from square.
+// A roll is the average over the outcomes of the dice.
+static uint16_t option_turns(uint16_t square, uint8_t option, uint8_t depth) {
+	if (option == AI_ROLL) {
+		uint32_t total = 0;
+		for (uint8_t i = 0; i < num_outcomes; i++) {
+			Outcome outcome;
+			memcpy_P(&outcome, &outcomes[i], sizeof(Outcome));
+			total += (uint32_t)outcome.throws * move_turns(square,
+					outcome.total, outcome.sixes, depth);
+		}
+		return (total + num_throws / 2) / num_throws;
+	}
+	if (option == AI_STEP_1 || option == AI_STEP_2) {
+		return move_turns(square, option - AI_STEP_1 + 1, 0, depth);
+	}
+	return AI_TURN + best_turns(joystick_move(square, option - AI_JOYSTICK),
+			depth - 1);
+}
+
+// Choose a move from square, searching one turn deeper each time round
+// while there's time
+static uint8_t choose_move(uint16_t square) {
+	search_start = get_current_time();
+	nodes = 0;
+	out_of_time = 0;
+	uint8_t choice = AI_ROLL;
+	last_depth = 0;
+	for (uint8_t depth = 1; depth <= AI_MAX_DEPTH; depth++) {
+		uint8_t best_option = AI_ROLL;
+		uint16_t best = UINT16_MAX;
+		for (uint8_t option = 0; option < AI_NUM_OPTIONS; option++) {
+			uint16_t turns = option_turns(square, option, depth);
+			if (turns < best) {
+				best = turns;
+				best_option = option;
+			}
+		}
+		if (out_of_time) {
+			break;
+		}
+		choice = best_option;
+		last_depth = depth;
+		// Don't start a search that won't finish in time (the clock only
+		// counts whole milliseconds, so allow for one more)
+		uint32_t elapsed = get_current_time() - search_start;
+		// Each turn searched multiplies the positions by about the number
+		// of options and dice outcomes
+		if ((elapsed + 1) * (AI_NUM_OPTIONS - 1 + num_outcomes) >
+				AI_BUDGET_MS) {
+			break;
+		}
+	}
+	last_nodes = nodes;
+	last_ms = get_current_time() - search_start;
+	return choice;
+}
+
+static uint8_t push(uint8_t type, int8_t arg1, int8_t arg2, uint32_t time) {
+	return input_push_event(type, INPUT_SOURCE_CPU, arg1, arg2, time);
+}
+
+static void take_turn(uint32_t time) {
+	memcpy_P(&values, &ai_boards[get_board_num()], sizeof(AiBoard));
+	turns_table = values.turns[rules_num_dice() - 1];
+	if (rules_num_dice() == 2) {
+		outcomes = two_dice;
+		num_outcomes = sizeof(two_dice) / sizeof(Outcome);
+		num_throws = 36;
+	} else {
+		outcomes = one_die;
+		num_outcomes = sizeof(one_die) / sizeof(Outcome);
+		num_throws = 6;
+	}
+	uint8_t option = choose_move(get_player_path_position(1));
+	if (option == AI_ROLL) {
+		if (push(INPUT_ROLL, 0, 0, time)) {
+			// How long the dice rolls for (and so what it stops on) depends
+			// on when the other player finished their turn
+			roll_length = AI_ROLL_MS + (turn_time & 0xFF);
+			turn_time = time;
+			turn_state = TURN_ROLLING;
+		}
+	} else if (option == AI_STEP_1 || option == AI_STEP_2) {
+		if (push(INPUT_STEP, option - AI_STEP_1 + 1, 0, time)) {
+			turn_state = TURN_MOVED;
+		}
+	} else {
+		option -= AI_JOYSTICK;
+		if (push(INPUT_MOVE, pgm_read_byte(&joystick_moves[option][0]),
+				pgm_read_byte(&joystick_moves[option][1]), time)) {
+			turn_state = TURN_MOVED;
+		}
+	}
+}
+
+void ai_poll(uint32_t time) {
+	if (!ai_playing()) {
+		turn_state = TURN_WAITING;
+		return;
+	}
+	switch (turn_state) {
+		case TURN_WAITING:
+			turn_time = time;
+			turn_state = TURN_THINKING;
+			break;
+		case TURN_THINKING:
+			if (time - turn_time >= AI_THINK_MS) {
+				take_turn(time);
+			}
+			break;
+		case TURN_ROLLING:
+			if (time - turn_time >= roll_length &&
+					push(INPUT_ROLL, 0, 0, time)) {
+				turn_state = TURN_MOVED;
+			}
+			break;
+		case TURN_MOVED:
+			// The move has been made by now, and it's still the computer's
+			// turn - the house rules gave it another one
+			turn_time = time;
+			turn_state = TURN_THINKING;
+			break;
+	}
+}
@@ -0,0 +1,86 @@
+/*
+ * ai.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * A computer opponent that plays as player 2. On its turn it chooses
+ * between a button step of 1 or 2, a dice roll and (if AI_JOYSTICK_MOVES
+ * is set) a joystick move to any of the eight neighbouring squares, then
+ * makes the move by queuing the same input events the buttons would.
+ *
+ * Moves are chosen by expectimax search: the computer picks the option
+ * with the fewest expected turns to the finish, averaging over the dice
+ * outcomes for a roll. Moves are planned with the house rules being played
+ * (rules.h) - one die or the total of two, the finish rule, and a roll with
+ * a 6 costing no turn when it earns another. The search looks ahead over
+ * the computer's own next turns (the players can't affect each other, so
+ * the other player's turns don't matter) and scores the squares it reaches
+ * with a table of expected turns to finish for each square. There's a
+ * table for each number of dice. The tables, in ai_values.c, come from a
+ * Markov chain analysis of each board (rolling every turn, stopping on the
+ * finish, with no extra turns) and are generated by running
+ * "make -C host ai-values".
+ *
+ * The search deepens one turn at a time while the next depth is expected
+ * to finish within AI_BUDGET_MS, and a search that runs over is abandoned
+ * in favour of the last complete one.
+ */
+
+
+#ifndef AI_H_
+#define AI_H_
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#include "game.h"
+#include "rules.h"
+
+// The values in the tables are expected turns to finish times this
+#define AI_TURN 16
+
+// Longest a move may take to choose (ms), and the deepest search
+#define AI_BUDGET_MS 40
+#define AI_MAX_DEPTH 6
+
+// Set to 1 for the house rule that allows a joystick move (to any
+// neighbouring square, wrapping at the edges) instead of a roll or step
+#define AI_JOYSTICK_MOVES 0
+
+typedef struct {
+	// Squares along the path from the start (0) to the finish
+	uint16_t squares;
+	// Expected turns (times AI_TURN) to finish from each square on the
+	// path when rolling every turn with 1 to RULES_MAX_DICE dice, in
+	// program memory
+	const uint16_t* turns[RULES_MAX_DICE];
+	// The square a player landing on each square ends up on - the end of
+	// a snake or ladder, or the square itself - in program memory
+	const uint16_t* landing;
+} AiBoard;
+
+// In ai_values.c
+extern const AiBoard ai_boards[NUM_BOARDS] PROGMEM;
+
+/* Turn the computer opponent on or off. It takes player 2's turns in a
+ * two player game while it's on.
+ */
+void ai_set_enabled(uint8_t enabled);
+uint8_t ai_enabled(void);
+
+/* Return 1 if it's the computer's turn, so input for player 2 from
+ * anywhere else should be ignored.
+ */
+uint8_t ai_playing(void);
+
+/* Take the computer's turn if it's due. Call this every pass of the game
+ * loop. The computer waits a moment before moving so the move can be
+ * followed, and holds a roll for a while so the dice can be seen rolling.
+ */
+void ai_poll(uint32_t time);
+
+/* Search depth, positions searched and time taken (ms) for the last move
+ * chosen.
+ */
+void ai_get_stats(uint8_t* depth, uint16_t* nodes, uint8_t* ms);
+
+#endif /* AI_H_ */
@@ -0,0 +1,282 @@
+/*
+ * ai_values.c
+ *
+ * Generated by host/ai/ai_values - do not edit.
+ */
+
+#include "ai.h"
+
+static const uint16_t board1_turns1[128] PROGMEM = {
+	616, 611, 606, 602, 597, 593, 589, 585, 577, 573, 570, 567,
+	565, 563, 567, 549, 551, 552, 552, 551, 550, 565, 560, 557,
+	553, 548, 542, 536, 529, 539, 528, 517, 507, 498, 489, 462,
+	457, 452, 448, 443, 439, 434, 430, 425, 420, 416, 411, 407,
+	402, 398, 393, 388, 384, 379, 375, 371, 365, 360, 356, 352,
+	349, 346, 331, 331, 331, 330, 328, 327, 338, 333, 328, 322,
+	317, 321, 312, 303, 295, 290, 283, 264, 258, 252, 245, 257,
+	245, 234, 222, 213, 204, 175, 172, 169, 153, 154, 154, 153,
+	152, 151, 164, 159, 154, 150, 146, 141, 136, 130, 124, 129,
+	120, 112, 104, 97, 90, 72, 67, 63, 58, 53, 49, 44,
+	40, 35, 30, 25, 22, 19, 16, 0
+};
+
+static const uint16_t board1_turns2[128] PROGMEM = {
+	305, 303, 300, 297, 295, 292, 290, 287, 287, 285, 283, 282,
+	280, 277, 274, 274, 273, 273, 272, 271, 270, 267, 264, 263,
+	261, 259, 257, 256, 255, 250, 245, 241, 236, 232, 228, 226,
+	223, 221, 219, 216, 214, 212, 210, 207, 205, 203, 200, 198,
+	196, 194, 191, 189, 186, 184, 182, 181, 178, 175, 173, 170,
+	167, 165, 164, 163, 162, 161, 159, 158, 156, 154, 152, 151,
+	149, 145, 142, 138, 134, 131, 128, 126, 124, 122, 121, 117,
+	113, 109, 105, 101, 97, 94, 91, 88, 87, 87, 86, 85,
+	84, 83, 81, 78, 75, 73, 71, 69, 68, 66, 64, 60,
+	57, 53, 49, 46, 42, 40, 38, 36, 33, 31, 28, 26,
+	23, 21, 19, 17, 16, 16, 16, 0
+};
+
+static const uint16_t board1_landing[128] PROGMEM = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+	12, 13, 30, 15, 16, 17, 18, 19, 20, 39, 22, 23,
+	24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 3,
+	36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47,
+	48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59,
+	60, 61, 62, 63, 64, 65, 66, 67, 84, 69, 70, 71,
+	72, 73, 74, 75, 76, 77, 78, 61, 80, 81, 82, 83,
+	84, 85, 86, 87, 88, 70, 90, 91, 92, 93, 94, 95,
+	96, 97, 116, 99, 100, 101, 102, 103, 104, 105, 106, 107,
+	108, 109, 110, 111, 112, 94, 114, 115, 116, 117, 118, 119,
+	120, 121, 122, 123, 124, 125, 126, 127
+};
+
+static const uint16_t board2_turns1[128] PROGMEM = {
+	592, 588, 585, 574, 571, 569, 568, 566, 564, 571, 557, 556,
+	558, 555, 552, 548, 556, 550, 541, 536, 532, 527, 522, 518,
+	513, 509, 504, 500, 495, 491, 486, 481, 477, 473, 468, 462,
+	457, 451, 457, 447, 438, 430, 422, 414, 392, 388, 384, 378,
+	373, 369, 366, 363, 360, 341, 344, 345, 346, 346, 345, 364,
+	359, 355, 350, 346, 341, 337, 332, 327, 323, 319, 314, 309,
+	303, 297, 302, 293, 284, 276, 269, 262, 242, 238, 233, 229,
+	224, 220, 215, 210, 206, 201, 197, 192, 188, 183, 178, 173,
+	169, 165, 161, 158, 146, 145, 143, 141, 139, 136, 142, 138,
+	133, 129, 124, 119, 116, 111, 106, 101, 94, 88, 98, 86,
+	76, 65, 56, 48, 22, 19, 16, 0
+};
+
+static const uint16_t board2_turns2[128] PROGMEM = {
+	297, 294, 292, 291, 289, 287, 286, 285, 283, 280, 280, 279,
+	277, 275, 273, 271, 268, 265, 262, 260, 258, 256, 253, 251,
+	249, 246, 244, 242, 240, 237, 235, 232, 230, 228, 226, 224,
+	222, 221, 217, 213, 210, 206, 202, 199, 197, 195, 193, 191,
+	188, 185, 182, 179, 176, 176, 176, 175, 175, 174, 174, 171,
+	169, 167, 165, 163, 160, 158, 155, 153, 151, 149, 147, 145,
+	143, 141, 137, 134, 130, 127, 124, 120, 118, 116, 114, 111,
+	109, 107, 105, 102, 100, 97, 95, 93, 91, 89, 86, 84,
+	81, 79, 76, 73, 72, 71, 70, 69, 67, 66, 64, 62,
+	60, 57, 54, 51, 50, 48, 46, 44, 43, 41, 37, 32,
+	28, 24, 20, 17, 16, 16, 16, 0
+};
+
+static const uint16_t board2_landing[128] PROGMEM = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 25, 10, 11,
+	12, 13, 14, 15, 32, 17, 4, 19, 20, 21, 22, 23,
+	24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35,
+	36, 37, 38, 39, 40, 41, 42, 43, 28, 45, 46, 47,
+	48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 84,
+	60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71,
+	72, 73, 74, 75, 76, 77, 78, 79, 66, 81, 82, 83,
+	84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95,
+	96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 120, 107,
+	108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119,
+	120, 121, 122, 123, 99, 125, 126, 127
+};
+
+static const uint16_t board3_turns1[512] PROGMEM = {
+	2265, 2260, 2256, 2251, 2247, 2242, 2237, 2232, 2228, 2224, 2220, 2216,
+	2206, 2204, 2202, 2199, 2197, 2194, 2198, 2193, 2189, 2184, 2180, 2175,
+	2171, 2166, 2161, 2157, 2152, 2148, 2143, 2138, 2133, 2129, 2126, 2123,
+	2113, 2107, 2105, 2104, 2106, 2108, 2053, 2073, 2089, 2102, 2113, 2122,
+	2196, 2191, 2186, 2182, 2178, 2173, 2168, 2163, 2159, 2154, 2154, 2145,
+	2138, 2134, 2131, 2129, 2124, 2087, 2098, 2107, 2114, 2120, 2124, 2170,
+	2165, 2160, 2156, 2152, 2148, 2144, 2134, 2132, 2129, 2128, 2125, 2122,
+	2125, 2119, 2112, 2120, 2110, 2100, 2091, 2083, 2075, 2051, 2047, 2042,
+	2038, 2033, 2028, 2024, 2019, 2015, 2010, 2006, 2001, 1996, 1992, 1987,
+	1983, 1978, 1974, 1969, 1964, 1960, 1955, 1951, 1946, 1941, 1937, 1934,
+	1927, 1922, 1918, 1915, 1913, 1912, 1885, 1891, 1896, 1899, 1901, 1903,
+	1934, 1929, 1924, 1920, 1915, 1911, 1906, 1902, 1897, 1892, 1888, 1883,
+	1879, 1874, 1870, 1865, 1860, 1856, 1851, 1847, 1842, 1838, 1833, 1828,
+	1824, 1820, 1815, 1810, 1805, 1800, 1795, 1795, 1788, 1782, 1776, 1770,
+	1765, 1753, 1748, 1744, 1740, 1736, 1732, 1724, 1719, 1717, 1717, 1711,
+	1710, 1671, 1689, 1706, 1722, 1674, 1705, 1780, 1795, 1807, 1817, 1897,
+	1893, 1888, 1883, 1879, 1874, 1870, 1865, 1861, 1856, 1851, 1847, 1842,
+	1838, 1833, 1829, 1824, 1819, 1815, 1810, 1806, 1801, 1797, 1792, 1787,
+	1783, 1778, 1774, 1769, 1765, 1760, 1755, 1751, 1746, 1742, 1737, 1733,
+	1728, 1723, 1719, 1714, 1710, 1706, 1701, 1696, 1690, 1684, 1688, 1679,
+	1671, 1664, 1657, 1650, 1633, 1628, 1623, 1619, 1614, 1610, 1605, 1601,
+	1596, 1592, 1587, 1582, 1577, 1573, 1569, 1564, 1560, 1554, 1549, 1547,
+	1543, 1537, 1530, 1523, 1515, 1538, 1519, 1503, 1489, 1477, 1467, 1412,
+	1407, 1404, 1403, 1404, 1406, 1354, 1372, 1387, 1399, 1409, 1417, 1486,
+	1481, 1477, 1472, 1467, 1463, 1458, 1454, 1449, 1445, 1440, 1435, 1431,
+	1426, 1422, 1417, 1413, 1408, 1403, 1399, 1394, 1390, 1385, 1381, 1376,
+	1371, 1367, 1362, 1358, 1353, 1349, 1344, 1339, 1335, 1330, 1326, 1321,
+	1317, 1312, 1307, 1303, 1298, 1294, 1289, 1285, 1280, 1275, 1271, 1266,
+	1262, 1257, 1253, 1248, 1243, 1239, 1234, 1230, 1225, 1221, 1216, 1211,
+	1207, 1202, 1198, 1193, 1189, 1184, 1179, 1175, 1170, 1166, 1161, 1157,
+	1152, 1147, 1143, 1138, 1134, 1129, 1125, 1120, 1115, 1111, 1106, 1102,
+	1097, 1092, 1088, 1084, 1080, 1075, 1069, 1062, 1063, 1060, 1053, 1045,
+	1033, 1020, 1071, 1040, 1015, 993, 963, 943, 855, 857, 860, 863,
+	786, 821, 847, 866, 878, 884, 978, 1032, 1005, 978, 951, 916,
+	888, 783, 845, 817, 793, 706, 720, 725, 643, 649, 650, 855,
+	803, 758, 719, 685, 655, 498, 493, 489, 484, 479, 475, 470,
+	466, 461, 457, 452, 447, 443, 438, 434, 429, 425, 420, 415,
+	411, 406, 402, 397, 393, 388, 383, 379, 374, 370, 365, 361,
+	356, 351, 347, 342, 338, 333, 329, 324, 319, 315, 310, 306,
+	301, 297, 292, 287, 283, 279, 274, 268, 262, 262, 258, 252,
+	244, 236, 226, 258, 236, 216, 199, 183, 169, 108, 104, 99,
+	94, 90, 85, 81, 76, 72, 67, 63, 58, 53, 49, 44,
+	40, 35, 30, 25, 22, 19, 16, 0
+};
+
+static const uint16_t board3_turns2[512] PROGMEM = {
+	1150, 1148, 1146, 1144, 1142, 1141, 1138, 1135, 1132, 1129, 1126, 1123,
+	1123, 1123, 1123, 1123, 1123, 1123, 1120, 1118, 1116, 1113, 1111, 1109,
+	1106, 1104, 1102, 1100, 1098, 1095, 1092, 1089, 1087, 1085, 1085, 1086,
+	1081, 1077, 1073, 1069, 1064, 1057, 1064, 1071, 1077, 1083, 1088, 1094,
+	1092, 1089, 1087, 1084, 1082, 1079, 1077, 1075, 1074, 1074, 1072, 1066,
+	1061, 1055, 1050, 1044, 1039, 1043, 1047, 1050, 1053, 1056, 1058, 1055,
+	1053, 1051, 1050, 1048, 1047, 1045, 1041, 1036, 1031, 1028, 1025, 1022,
+	1021, 1020, 1020, 1013, 1007, 1001, 995, 989, 984, 981, 979, 977,
+	975, 972, 970, 968, 965, 963, 961, 959, 956, 954, 952, 949,
+	947, 945, 943, 940, 938, 936, 933, 931, 928, 926, 925, 924,
+	921, 918, 915, 911, 908, 904, 906, 907, 907, 908, 909, 909,
+	907, 905, 902, 900, 898, 895, 893, 891, 889, 886, 884, 882,
+	879, 877, 875, 873, 870, 868, 866, 863, 861, 859, 856, 854,
+	853, 850, 847, 845, 842, 840, 837, 836, 835, 834, 833, 832,
+	830, 827, 825, 822, 820, 819, 819, 815, 811, 809, 808, 801,
+	794, 798, 802, 804, 805, 817, 828, 833, 837, 841, 845, 842,
+	840, 838, 836, 833, 831, 829, 826, 824, 822, 820, 817, 815,
+	813, 810, 808, 806, 804, 801, 799, 797, 794, 792, 790, 788,
+	785, 783, 781, 778, 776, 774, 771, 769, 767, 765, 763, 761,
+	758, 756, 753, 749, 748, 746, 745, 743, 742, 741, 735, 730,
+	725, 721, 716, 711, 709, 707, 705, 702, 700, 698, 696, 693,
+	691, 688, 686, 684, 682, 680, 678, 675, 673, 670, 666, 665,
+	663, 662, 661, 660, 658, 652, 646, 640, 635, 632, 630, 625,
+	621, 618, 614, 609, 603, 609, 614, 618, 622, 625, 629, 627,
+	625, 622, 620, 618, 615, 613, 611, 609, 606, 604, 602, 599,
+	597, 595, 593, 590, 588, 586, 583, 581, 579, 577, 574, 572,
+	570, 567, 565, 563, 561, 558, 556, 554, 551, 549, 547, 545,
+	542, 540, 538, 535, 533, 531, 529, 526, 524, 522, 519, 517,
+	515, 513, 510, 508, 506, 503, 501, 499, 497, 494, 492, 490,
+	487, 485, 483, 481, 478, 476, 474, 471, 469, 467, 465, 462,
+	460, 458, 455, 453, 451, 449, 446, 444, 442, 439, 437, 434,
+	432, 430, 429, 427, 424, 422, 418, 413, 413, 412, 411, 410,
+	410, 410, 400, 391, 384, 379, 369, 360, 356, 352, 346, 338,
+	340, 349, 357, 364, 370, 376, 377, 361, 351, 343, 338, 328,
+	319, 319, 306, 293, 276, 279, 281, 283, 289, 297, 307, 292,
+	278, 264, 252, 239, 227, 225, 222, 220, 218, 215, 213, 211,
+	209, 206, 204, 202, 199, 197, 195, 193, 190, 188, 186, 183,
+	181, 179, 177, 174, 172, 170, 167, 165, 163, 161, 158, 156,
+	154, 151, 149, 147, 145, 142, 140, 138, 136, 133, 131, 128,
+	126, 124, 122, 120, 118, 116, 113, 110, 105, 104, 103, 102,
+	101, 100, 100, 93, 86, 79, 73, 67, 60, 58, 56, 54,
+	51, 49, 47, 44, 42, 40, 38, 36, 33, 31, 28, 26,
+	23, 21, 19, 17, 16, 16, 16, 0
+};
+
+static const uint16_t board3_landing[512] PROGMEM = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+	12, 13, 14, 15, 16, 17, 77, 19, 20, 21, 22, 23,
+	24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35,
+	36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47,
+	175, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59,
+	60, 61, 62, 63, 28, 65, 66, 67, 68, 69, 70, 147,
+	72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83,
+	43, 85, 86, 87, 88, 89, 90, 91, 92, 25, 94, 95,
+	96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107,
+	108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119,
+	120, 121, 122, 123, 124, 125, 126, 127, 128, 129, 130, 131,
+	184, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142, 143,
+	144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155,
+	156, 157, 158, 159, 160, 161, 162, 163, 164, 165, 166, 167,
+	168, 214, 170, 171, 172, 173, 174, 175, 176, 177, 178, 179,
+	180, 181, 182, 183, 184, 185, 186, 298, 188, 189, 190, 283,
+	192, 193, 194, 195, 196, 197, 198, 199, 200, 201, 202, 203,
+	204, 205, 206, 207, 208, 209, 210, 211, 212, 213, 214, 215,
+	216, 217, 218, 219, 220, 221, 222, 223, 224, 225, 226, 227,
+	228, 229, 230, 231, 232, 233, 234, 235, 236, 237, 238, 239,
+	240, 241, 242, 243, 180, 245, 246, 247, 248, 249, 250, 251,
+	252, 253, 254, 255, 256, 257, 258, 259, 260, 261, 262, 263,
+	264, 265, 266, 267, 268, 269, 270, 271, 272, 273, 274, 239,
+	276, 277, 278, 279, 280, 281, 282, 283, 284, 285, 286, 383,
+	288, 289, 290, 291, 292, 293, 294, 295, 296, 297, 298, 299,
+	300, 301, 302, 303, 304, 305, 306, 307, 308, 309, 310, 311,
+	312, 313, 314, 315, 316, 317, 318, 319, 320, 321, 322, 323,
+	324, 325, 326, 327, 328, 329, 330, 331, 332, 333, 334, 335,
+	336, 337, 338, 339, 340, 341, 342, 343, 344, 345, 346, 347,
+	348, 349, 350, 351, 352, 353, 354, 355, 356, 357, 358, 359,
+	360, 361, 362, 363, 364, 365, 366, 367, 368, 369, 370, 371,
+	372, 373, 374, 375, 376, 377, 378, 379, 380, 381, 382, 383,
+	384, 385, 386, 387, 388, 389, 390, 391, 311, 393, 394, 395,
+	396, 397, 398, 399, 400, 401, 463, 403, 404, 405, 406, 407,
+	408, 281, 410, 411, 412, 413, 414, 415, 347, 417, 418, 487,
+	420, 421, 422, 423, 424, 303, 426, 427, 428, 429, 430, 431,
+	432, 433, 434, 435, 436, 437, 438, 439, 440, 441, 442, 443,
+	444, 445, 446, 447, 448, 449, 450, 451, 452, 453, 454, 455,
+	456, 457, 458, 459, 460, 461, 462, 463, 464, 465, 466, 467,
+	468, 469, 470, 471, 472, 473, 474, 475, 476, 477, 478, 479,
+	480, 481, 482, 483, 484, 485, 486, 487, 488, 436, 490, 491,
+	492, 493, 494, 495, 496, 497, 498, 499, 500, 501, 502, 503,
+	504, 505, 506, 507, 508, 509, 510, 511
+};
+
+static const uint16_t board4_turns1[128] PROGMEM = {
+	588, 587, 586, 600, 595, 591, 586, 582, 577, 572, 568, 563,
+	559, 554, 549, 545, 541, 536, 532, 525, 520, 517, 516, 511,
+	509, 479, 491, 501, 511, 478, 498, 550, 558, 565, 569, 621,
+	617, 612, 607, 603, 598, 594, 589, 585, 580, 575, 571, 566,
+	562, 557, 553, 548, 543, 539, 534, 530, 525, 520, 516, 511,
+	508, 505, 496, 491, 487, 486, 485, 486, 445, 458, 467, 477,
+	483, 489, 540, 533, 524, 533, 520, 527, 507, 489, 471, 462,
+	443, 402, 389, 378, 368, 329, 324, 320, 315, 310, 306, 301,
+	297, 292, 288, 283, 278, 274, 269, 265, 260, 255, 250, 246,
+	242, 238, 233, 227, 220, 222, 218, 212, 202, 191, 179, 230,
+	200, 171, 147, 126, 108, 19, 16, 0
+};
+
+static const uint16_t board4_turns2[128] PROGMEM = {
+	314, 315, 316, 314, 312, 309, 307, 305, 302, 300, 298, 296,
+	293, 291, 288, 286, 284, 282, 282, 278, 275, 273, 272, 266,
+	259, 262, 264, 265, 264, 273, 282, 285, 288, 291, 294, 292,
+	289, 287, 285, 283, 280, 278, 276, 274, 271, 269, 267, 264,
+	262, 260, 257, 255, 253, 251, 249, 246, 243, 241, 238, 237,
+	235, 235, 231, 228, 225, 221, 218, 213, 217, 218, 219, 222,
+	223, 228, 227, 226, 225, 221, 217, 207, 197, 188, 180, 168,
+	157, 150, 143, 137, 130, 128, 126, 123, 121, 119, 116, 114,
+	112, 110, 107, 105, 103, 101, 98, 96, 93, 91, 89, 87,
+	86, 83, 81, 76, 71, 71, 71, 70, 69, 70, 71, 60,
+	49, 40, 32, 24, 16, 16, 16, 0
+};
+
+static const uint16_t board4_landing[128] PROGMEM = {
+	0, 1, 2, 81, 4, 5, 6, 7, 8, 9, 10, 11,
+	12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23,
+	24, 25, 26, 27, 28, 29, 30, 95, 32, 33, 34, 99,
+	36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47,
+	48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59,
+	60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71,
+	72, 73, 116, 75, 76, 77, 78, 79, 80, 81, 82, 5,
+	84, 11, 86, 87, 88, 17, 90, 91, 92, 93, 94, 95,
+	96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107,
+	108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119,
+	120, 121, 122, 123, 124, 54, 126, 127
+};
+
+const AiBoard ai_boards[NUM_BOARDS] PROGMEM = {
+	// Board 1: turns from the start 38.47 with 1 die, 19.04 with 2 dice
+	{128, {board1_turns1, board1_turns2}, board1_landing},
+	// Board 2: turns from the start 36.99 with 1 die, 18.54 with 2 dice
+	{128, {board2_turns1, board2_turns2}, board2_landing},
+	// Board 3: turns from the start 141.56 with 1 die, 71.90 with 2 dice
+	{512, {board3_turns1, board3_turns2}, board3_landing},
+	// Board 4: turns from the start 36.77 with 1 die, 19.61 with 2 dice
+	{128, {board4_turns1, board4_turns2}, board4_landing}
+};
@@ -1,95 +1,154 @@
-/*
- * buttons.c
- *
- * Author: Peter Sutton
- */ 
-
-#include "buttons.h"
-#include <avr/io.h>
-#include <avr/interrupt.h>
-
-// Global variable to keep track of the last button state so that we 
-// can detect changes when an interrupt fires. The lower 4 bits (0 to 3)
-// will correspond to the last state of port B pins 0 to 3.
-static volatile uint8_t last_button_state;
-
-// Our button queue. button_queue[0] is always the head of the queue. If we
-// take something off the queue we just move everything else along. We don't
-// use a circular buffer since it is usually expected that the queue is very
-// short. In most uses it will never have more than 1 element at a time.
-// This button queue can be changed by the interrupt handler below so we should
-// turn off interrupts if we're changing the queue outside the handler.
-#define BUTTON_QUEUE_SIZE 4
-static volatile uint8_t button_queue[BUTTON_QUEUE_SIZE];
-static volatile int8_t queue_length;
-
-// Setup interrupt if any of pins B0 to B3 change. We do this
-// using a pin change interrupt. These pins correspond to pin
-// change interrupts PCINT8 to PCINT11 which are covered by
-// Pin change interrupt 1.
-void init_button_interrupts(void) {
-	// Enable the interrupt (see datasheet page 77)
-	PCICR |= (1<<PCIE1);
-	
-	// Make sure the interrupt flag is cleared (by writing a 
-	// 1 to it) (see datasheet page 78)
-	PCIFR |= (1<<PCIF1);
-	
-	// Choose which pins we're interested in by setting
-	// the relevant bits in the mask register (see datasheet page 78)
-	PCMSK1 |= (1<<PCINT8)|(1<<PCINT9)|(1<<PCINT10)|(1<<PCINT11);	
-	
-	// Empty the button push queue
-	queue_length = 0;
-}
-
-int8_t button_pushed(void) {
-	int8_t return_value = NO_BUTTON_PUSHED;	// Assume no button pushed
-	if(queue_length > 0) {
-		// Remove the first element off the queue and move all the other
-		// entries closer to the front of the queue. We turn off interrupts (if on)
-		// before we make any changes to the queue. If interrupts were on
-		// we turn them back on when done.
-		return_value = button_queue[0];
-		
-		// Save whether interrupts were enabled and turn them off
-		int8_t interrupts_were_enabled = bit_is_set(SREG, SREG_I);
-		cli();
-		
-		for(uint8_t i = 1; i < queue_length; i++) {
-			button_queue[i-1] = button_queue[i];
-		}
-		queue_length--;
-		
-		if(interrupts_were_enabled) {
-			// Turn them back on again
-			sei();
-		}
-	}
-	return return_value;
-}
-
-// Interrupt handler for a change on buttons
-ISR(PCINT1_vect) {
-	// Get the current state of the buttons. We'll compare this with
-	// the last state to see what has changed.
-	uint8_t button_state = PINB & 0x0F;
-	
-	// Iterate over all the buttons and see which ones have changed.
-	// Any button pushes are added to the queue of button pushes (if
-	// there is space). We ignore button releases so we're just looking
-	// for a transition from 0 in the last_button_state bit to a 1 in the 
-	// button_state.
-	for(uint8_t pin = 0; pin < NUM_BUTTONS; pin++) {
-		if(queue_length < BUTTON_QUEUE_SIZE && 
-				(button_state & (1 << pin)) && 
-				!(last_button_state & (1 << pin))) {
-			// Add the button push to the queue (and update the
-			// length of the queue
-			button_queue[queue_length++] = pin;
-		}
-	}
-	
-	// Remember this button state
-	last_button_state = button_state;
-}
\ No newline at end of file
+/*
+ * buttons.c
+ *
+ * Author: Peter Sutton
+ */ 
+
+#include "buttons.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "timer0.h"
+
+// Debounced state of the buttons. The lower 4 bits (0 to 3) correspond to
+// port B pins 0 to 3. A change on a pin is accepted immediately (so a push
+// is reported without delay) and then further changes on that pin are
+// ignored for BUTTON_DEBOUNCE_MS. button_tick() picks up the final state of
+// the pin once that time has passed, in case the last edge was ignored.
+static volatile uint8_t debounced_state;
+static volatile uint8_t debounce_mask;
+static volatile uint32_t last_change_time[NUM_BUTTONS];
+static volatile uint8_t long_press_sent;
+
+// Our button event queue. This is a ring buffer with a single producer
+// (the pin change and timer interrupt handlers, which can't interrupt each
+// other) and a single consumer (button_get_event()). The producer only
+// writes queue_head and the consumer only writes queue_tail, so neither
+// side needs to turn interrupts off. The size must be a power of two so
+// the indices can be wrapped with a mask. One slot is always left empty to
+// distinguish a full queue from an empty one.
+#define BUTTON_QUEUE_SIZE 8
+#define BUTTON_QUEUE_MASK (BUTTON_QUEUE_SIZE - 1)
+static ButtonEvent button_queue[BUTTON_QUEUE_SIZE];
+static volatile uint8_t queue_head;
+static volatile uint8_t queue_tail;
+
+// Setup interrupt if any of pins B0 to B3 change. We do this
+// using a pin change interrupt. These pins correspond to pin
+// change interrupts PCINT8 to PCINT11 which are covered by
+// Pin change interrupt 1.
+void init_button_interrupts(void) {
+	// Enable the interrupt (see datasheet page 77)
+	PCICR |= (1<<PCIE1);
+	
+	// Make sure the interrupt flag is cleared (by writing a 
+	// 1 to it) (see datasheet page 78)
+	PCIFR |= (1<<PCIF1);
+	
+	// Choose which pins we're interested in by setting
+	// the relevant bits in the mask register (see datasheet page 78)
+	PCMSK1 |= (1<<PCINT8)|(1<<PCINT9)|(1<<PCINT10)|(1<<PCINT11);	
+	
+	// Start from the current state of the buttons so a button held
+	// down at reset isn't reported as a push
+	debounced_state = PINB & 0x0F;
+	debounce_mask = 0;
+	long_press_sent = 0;
+	
+	// Empty the button event queue
+	queue_head = 0;
+	queue_tail = 0;
+}
+
+uint8_t button_get_event(ButtonEvent* event) {
+	uint8_t tail = queue_tail;
+	if (tail == queue_head) {
+		return 0;
+	}
+	*event = button_queue[tail];
+	queue_tail = (tail + 1) & BUTTON_QUEUE_MASK;
+	return 1;
+}
+
+int8_t button_pushed(void) {
+	ButtonEvent event;
+	while (button_get_event(&event)) {
+		if (event.type == BUTTON_EVENT_PRESS) {
+			return event.button;
+		}
+	}
+	return NO_BUTTON_PUSHED;
+}
+
+void clear_button_events(void) {
+	queue_tail = queue_head;
+}
+
+// Add an event to the queue (if there is space). Only called from the
+// interrupt handlers below.
+static void queue_event(uint8_t type, uint8_t button, uint32_t time) {
+	uint8_t head = queue_head;
+	uint8_t next = (head + 1) & BUTTON_QUEUE_MASK;
+	if (next == queue_tail) {
+		// Queue is full - discard the event
+		return;
+	}
+	button_queue[head].type = type;
+	button_queue[head].button = button;
+	button_queue[head].time = time;
+	queue_head = next;
+}
+
+// Accept any changes in button_state on pins that aren't being debounced.
+// Only called from the interrupt handlers below.
+static void accept_changes(uint8_t button_state, uint32_t now) {
+	uint8_t changed = (button_state ^ debounced_state) & ~debounce_mask;
+	
+	for(uint8_t pin = 0; pin < NUM_BUTTONS; pin++) {
+		uint8_t bit = 1 << pin;
+		if (!(changed & bit)) {
+			continue;
+		}
+		debounced_state ^= bit;
+		debounce_mask |= bit;
+		last_change_time[pin] = now;
+		if (button_state & bit) {
+			long_press_sent &= ~bit;
+			queue_event(BUTTON_EVENT_PRESS, pin, now);
+		} else {
+			queue_event(BUTTON_EVENT_RELEASE, pin, now);
+		}
+	}
+}
+
+void button_tick(void) {
+	// Nothing to do unless a pin is being debounced or held down
+	if (debounce_mask == 0 && debounced_state == 0) {
+		return;
+	}
+	uint32_t now = get_current_time();
+	
+	for(uint8_t pin = 0; pin < NUM_BUTTONS; pin++) {
+		uint8_t bit = 1 << pin;
+		uint32_t held_for = now - last_change_time[pin];
+		if ((debounce_mask & bit) && held_for >= BUTTON_DEBOUNCE_MS) {
+			debounce_mask &= ~bit;
+		}
+		if ((debounced_state & bit) && !(long_press_sent & bit) &&
+				held_for >= BUTTON_LONG_PRESS_MS) {
+			long_press_sent |= bit;
+			queue_event(BUTTON_EVENT_LONG_PRESS, pin, now);
+		}
+	}
+	
+	// Pick up any change that was ignored while debouncing
+	accept_changes(PINB & 0x0F, now);
+}
+
+// Interrupt handler for a change on buttons
+ISR(PCINT1_vect) {
+	// Get the current state of the buttons and compare it with the
+	// debounced state to see what has changed. Changes on pins still
+	// inside their debounce interval are ignored here and picked up by
+	// button_tick() if they are still present once it expires.
+	accept_changes(PINB & 0x0F, get_current_time());
+}
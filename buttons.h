@@ -1,39 +1,78 @@
-/*
- * buttons.h
- *
- * Author: Peter Sutton
- *
- * We assume four push buttons (B0 to B3) are connected to pins B0 to B3. We configure
- * pin change interrupts on these pins.
- */ 
-
-
-#ifndef BUTTONS_H_
-#define BUTTONS_H_
-
-#include <stdint.h>
-
-#define NO_BUTTON_PUSHED (-1)
-#define BUTTON0_PUSHED 0
-#define BUTTON1_PUSHED 1
-#define BUTTON2_PUSHED 2
-#define BUTTON3_PUSHED 3
-
-#define NUM_BUTTONS 4
-
-/* Set up pin change interrupts on pins B0 to B3.
- * It is assumed that global interrupts are off when this function is called
- * and are enabled sometime after this function is called.
- */
-void init_button_interrupts(void);
-
-/* Return the last button pushed (0 to 3) or -1 (NO_BUTTON_PUSHED) if 
- * there are no button pushes to return. (A small queue of button pushes
- * is kept. This function should be called frequently enough to
- * ensure the queue does not overflow. Excess button pushes are
- * discarded.)
- */
-int8_t button_pushed(void);
-
-
-#endif /* BUTTONS_H_ */
\ No newline at end of file
+/*
+ * buttons.h
+ *
+ * Author: Peter Sutton
+ *
+ * We assume four push buttons (B0 to B3) are connected to pins B0 to B3. We configure
+ * pin change interrupts on these pins.
+ *
+ * Changes are debounced in software and turned into timestamped events
+ * (press, release and long press) which are queued until they are read.
+ * button_tick() must be called every millisecond (see timer0.c) to finish
+ * debouncing and to detect long presses.
+ */ 
+
+
+#ifndef BUTTONS_H_
+#define BUTTONS_H_
+
+#include <stdint.h>
+
+#define NO_BUTTON_PUSHED (-1)
+#define BUTTON0_PUSHED 0
+#define BUTTON1_PUSHED 1
+#define BUTTON2_PUSHED 2
+#define BUTTON3_PUSHED 3
+
+#define NUM_BUTTONS 4
+
+// Changes on a pin within this many milliseconds of the last accepted
+// change on that pin are treated as contact bounce.
+#define BUTTON_DEBOUNCE_MS 20
+
+// A button held down for this many milliseconds generates a long press
+// event (in addition to the press event generated when it went down).
+#define BUTTON_LONG_PRESS_MS 800
+
+// Button event types
+#define BUTTON_EVENT_PRESS		0
+#define BUTTON_EVENT_RELEASE	1
+#define BUTTON_EVENT_LONG_PRESS	2
+
+typedef struct {
+	uint8_t type;	// One of the BUTTON_EVENT_ values above
+	uint8_t button;	// 0 to 3
+	uint32_t time;	// get_current_time() when the event happened
+} ButtonEvent;
+
+/* Set up pin change interrupts on pins B0 to B3.
+ * It is assumed that global interrupts are off when this function is called
+ * and are enabled sometime after this function is called.
+ */
+void init_button_interrupts(void);
+
+/* Remove the oldest button event from the queue and copy it into event.
+ * Returns 1 if there was an event, 0 if the queue was empty. (This function
+ * should be called frequently enough to ensure the queue does not overflow.
+ * Excess events are discarded.)
+ */
+uint8_t button_get_event(ButtonEvent* event);
+
+/* Return the last button pushed (0 to 3) or -1 (NO_BUTTON_PUSHED) if 
+ * there are no button pushes to return. Release and long press events
+ * ahead of the next push are discarded.
+ */
+int8_t button_pushed(void);
+
+/* Discard all queued button events.
+ */
+void clear_button_events(void);
+
+/* Called from the timer 0 interrupt handler every millisecond. Accepts
+ * changes that were held off by the debounce interval and generates long
+ * press events.
+ */
+void button_tick(void);
+
+
+#endif /* BUTTONS_H_ */
@@ -0,0 +1,626 @@
+/*
+ * command.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * Characters are collected into a line buffer until the end of the line.
+ * The command name is then looked up in a dispatch table in program memory
+ * which gives the handler, the number of arguments it takes and the input
+ * contexts it can be used in. Many commands can arrive between two passes
+ * of the game loop; each one is handled as soon as its line is complete.
+ */
+
+#include "command.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <avr/pgmspace.h>
+#include "input.h"
+#include "serialio.h"
+#include "terminalio.h"
+#include "screen.h"
+#include "telemetry.h"
+#include "timer0.h"
+#include "fmt.h"
+#include "pcm.h"
+#include "memory.h"
+#include "ai.h"
+#include "rules.h"
+#include "link.h"
+#include "joystick.h"
+
+#define COMMAND_MAX_ARGS 2
+
+// Handler result for a command answered somewhere else
+#define NO_REPLY 0xFF
+
+// Terminal row used for replies
+#define REPLY_ROW 24
+
+typedef struct {
+	char name[13];
+	uint8_t contexts;
+	uint8_t min_args;
+	uint8_t max_args;
+	// Returns 0 on success, one of the COMMAND_ERROR_ codes, or
+	// NO_REPLY if the reply will be sent later
+	uint8_t (*handler)(int32_t* args, uint8_t num_args);
+} Command;
+
+static char line[COMMAND_MAX_LENGTH + 1];
+static uint8_t line_length;
+static uint8_t in_command;
+static uint8_t too_long;
+static uint32_t line_time;
+
+// How long the host has to send something at a new baud rate before the
+// old rate is put back
+#define BAUD_CONFIRM_MS 2000
+static long previous_baud;
+static uint32_t baud_deadline;
+static uint8_t baud_unconfirmed;
+
+// A receive benchmark ends after this long without a character
+#define BENCH_IDLE_MS 1000
+
+// CPU cycles per millisecond with the 8MHz clock
+#define CYCLES_PER_MS 8000UL
+
+// Queue an event for the game, or fail if the queue is full
+static uint8_t push(uint8_t type, int8_t arg1, int8_t arg2) {
+	if (!input_push_event(type, INPUT_SOURCE_COMMAND, arg1, arg2, line_time)) {
+		return COMMAND_ERROR_BUSY;
+	}
+	return 0;
+}
+
+// Report the result of a benchmark - the rate is in bytes per second
+static void bench_result(const char* name, uint16_t expected, uint16_t count,
+		uint32_t time) {
+	char text[TELEMETRY_MAX_PAYLOAD + 1];
+	uint32_t rate = time ? (uint32_t)count * 1000 / time : 0;
+	char* p = fmt_str_P(text, PSTR("OK "));
+	p = fmt_str_P(p, name);
+	p = fmt_char(p, ' ');
+	p = fmt_uint(p, count, 0);
+	p = fmt_str_P(p, PSTR(" in "));
+	p = fmt_ulong(p, time, 0);
+	p = fmt_str_P(p, PSTR(" ms "));
+	p = fmt_ulong(p, rate, 0);
+	p = fmt_str_P(p, PSTR(" B/s lost "));
+	fmt_uint(p, expected - count, 0);
+	command_reply(text);
+}
+
+static uint8_t in_range(int32_t value, int32_t min, int32_t max) {
+	return value >= min && value <= max;
+}
+
+static uint8_t do_roll(int32_t* args, uint8_t num_args) {
+	if (num_args == 0) {
+		return push(INPUT_ROLL, 0, 0);
+	}
+	if (!in_range(args[0], 1, 6)) {
+		return COMMAND_ERROR_ARGUMENTS;
+	}
+	return push(INPUT_ROLL, args[0], 0);
+}
+
+static uint8_t do_move(int32_t* args, uint8_t num_args) {
+	if (!in_range(args[0], -1, 1) || !in_range(args[1], -1, 1)) {
+		return COMMAND_ERROR_ARGUMENTS;
+	}
+	return push(INPUT_MOVE, args[0], args[1]);
+}
+
+static uint8_t do_step(int32_t* args, uint8_t num_args) {
+	if (!in_range(args[0], 1, 6)) {
+		return COMMAND_ERROR_ARGUMENTS;
+	}
+	return push(INPUT_STEP, args[0], 0);
+}
+
+static uint8_t do_board(int32_t* args, uint8_t num_args) {
+	if (!in_range(args[0], 1, NUM_BOARDS)) {
+		return COMMAND_ERROR_ARGUMENTS;
+	}
+	return push(INPUT_BOARD, args[0], 0);
+}
+
+static uint8_t do_players(int32_t* args, uint8_t num_args) {
+	if (!in_range(args[0], 1, 2)) {
+		return COMMAND_ERROR_ARGUMENTS;
+	}
+	return push(INPUT_PLAYERS, args[0], 0);
+}
+
+static uint8_t do_rules(int32_t* args, uint8_t num_args) {
+	if (!in_range(args[0], 1, NUM_RULE_SETS)) {
+		return COMMAND_ERROR_ARGUMENTS;
+	}
+	return push(INPUT_RULES, args[0], 0);
+}
+
+static uint8_t do_limit(int32_t* args, uint8_t num_args) {
+	// 0 turns the time limit off
+	if (args[0] != 0 && !in_range(args[0], 10, 127)) {
+		return COMMAND_ERROR_ARGUMENTS;
+	}
+	return push(INPUT_TIME_LIMIT, args[0], 0);
+}
+
+static uint8_t do_start(int32_t* args, uint8_t num_args) {
+	return push(INPUT_START, 0, 0);
+}
+
+static uint8_t do_pause(int32_t* args, uint8_t num_args) {
+	return push(INPUT_PAUSE, 0, 0);
+}
+
+static uint8_t do_sound(int32_t* args, uint8_t num_args) {
+	return push(INPUT_SOUND, 0, 0);
+}
+
+static uint8_t do_telemetry(int32_t* args, uint8_t num_args) {
+	return push(INPUT_TELEMETRY, 0, 0);
+}
+
+static uint8_t do_state(int32_t* args, uint8_t num_args) {
+	// Answered by the game once everything before it has been handled
+	uint8_t error = push(INPUT_QUERY, 0, 0);
+	return error ? error : NO_REPLY;
+}
+
+// Change the baud rate. The reply is sent at the old rate and then the
+// rate is changed. If nothing is received at the new rate within
+// BAUD_CONFIRM_MS the old rate is put back, so a host that didn't follow
+// can't lose contact with the game.
+static uint8_t do_baud(int32_t* args, uint8_t num_args) {
+	if (num_args == 0) {
+		command_report_baud();
+		return NO_REPLY;
+	}
+	if (!in_range(args[0], 1, SERIAL_MAX_BAUD) ||
+			abs(serial_check_baud(args[0])) > SERIAL_MAX_BAUD_ERROR) {
+		return COMMAND_ERROR_ARGUMENTS;
+	}
+	command_reply_P(PSTR("OK"));
+	previous_baud = serial_baud_rate();
+	serial_set_baud(args[0]);
+	baud_deadline = get_current_time() + BAUD_CONFIRM_MS;
+	baud_unconfirmed = 1;
+	return NO_REPLY;
+}
+
+// Send a number of bytes as fast as possible and report the rate they
+// went out at. The bytes are written over the terminal, so it is redrawn
+// afterwards. Lost counts the bytes that couldn't be queued; only the
+// host can tell if any were lost on the line.
+static uint8_t do_bench_tx(int32_t* args, uint8_t num_args) {
+	if (!in_range(args[0], 1, 60000)) {
+		return COMMAND_ERROR_ARGUMENTS;
+	}
+	if (!serial_text_output()) {
+		// Would corrupt the telemetry stream
+		return COMMAND_ERROR_STATE;
+	}
+	uint8_t chunk[16];
+	uint16_t remaining = args[0];
+	uint16_t queued = 0;
+	uint8_t pattern = 0;
+	move_terminal_cursor(1, REPLY_ROW);
+	serial_wait_for_output();
+	uint32_t start = get_current_time();
+	while (remaining) {
+		uint8_t length = remaining < sizeof(chunk) ? remaining : sizeof(chunk);
+		for (uint8_t i = 0; i < length; i++) {
+			chunk[i] = 'A' + pattern;
+			pattern = pattern == 25 ? 0 : pattern + 1;
+		}
+		uint8_t sent = serial_write_raw(chunk, length);
+		if (!sent) {
+			// Wait for space. Waiting for the buffer to empty doesn't
+			// slow the benchmark - the line is only idle between the last
+			// byte going and the next chunk being queued.
+			serial_wait_for_output();
+			sent = serial_write_raw(chunk, length);
+		}
+		if (sent) {
+			queued += length;
+		}
+		remaining -= length;
+	}
+	serial_wait_for_output();
+	uint32_t time = get_current_time() - start;
+	
+	screen_redraw();
+	bench_result(PSTR("TX"), args[0], queued, time);
+	return NO_REPLY;
+}
+
+// Count the bytes the host sends after the OK reply. The benchmark ends
+// when they've all arrived or nothing has been received for
+// BENCH_IDLE_MS. Anything not received was dropped.
+static uint8_t do_bench_rx(int32_t* args, uint8_t num_args) {
+	if (!in_range(args[0], 1, 60000)) {
+		return COMMAND_ERROR_ARGUMENTS;
+	}
+	command_reply_P(PSTR("OK"));
+	uint16_t expected = args[0];
+	uint16_t received = 0;
+	uint32_t start = 0;
+	uint32_t last = get_current_time();
+	while (received < expected && get_current_time() - last < BENCH_IDLE_MS) {
+		if (serial_input_available()) {
+			fgetc(stdin);
+			last = get_current_time();
+			if (received == 0) {
+				start = last;
+			}
+			received++;
+		}
+	}
+	bench_result(PSTR("RX"), expected, received, last - start);
+	return NO_REPLY;
+}
+
+// Time how long it takes to format a status update (the cursor movement
+// and a timer line) and report it in CPU cycles. Built with BENCH_PRINTF
+// defined it also times the same thing with sprintf_P() for comparison -
+// that pulls vfprintf back in, so it is left out normally.
+static uint8_t do_bench_fmt(int32_t* args, uint8_t num_args) {
+	if (!in_range(args[0], 1, 60000)) {
+		return COMMAND_ERROR_ARGUMENTS;
+	}
+	uint16_t count = args[0];
+	char text[SCREEN_MAX_WIDTH + 1];
+	uint32_t start = get_current_time();
+	for (uint16_t i = 0; i < count; i++) {
+		char* p = fmt_cursor(text, 10, 17);
+		p = fmt_str_P(p, PSTR("Player 1: "));
+		p = fmt_int(p, i & 7, 0);
+		p = fmt_char(p, '.');
+		p = fmt_int(p, i & 15, 0);
+		fmt_str_P(p, PSTR(" Seconds left"));
+	}
+	uint32_t time = get_current_time() - start;
+	
+#ifdef BENCH_PRINTF
+	start = get_current_time();
+	for (uint16_t i = 0; i < count; i++) {
+		sprintf_P(text, PSTR("\x1b[%d;%dHPlayer 1: %d.%d Seconds left"),
+				17, 10, i & 7, i & 15);
+	}
+	uint32_t printf_time = get_current_time() - start;
+#endif
+	
+	char* p = fmt_str_P(text, PSTR("OK FMT "));
+	p = fmt_ulong(p, time * CYCLES_PER_MS / count, 0);
+	p = fmt_str_P(p, PSTR(" cycles"));
+#ifdef BENCH_PRINTF
+	p = fmt_str_P(p, PSTR(" printf "));
+	p = fmt_ulong(p, printf_time * CYCLES_PER_MS / count, 0);
+#endif
+	command_reply(text);
+	return NO_REPLY;
+}
+
+static uint8_t do_stats(int32_t* args, uint8_t num_args) {
+	SerialStats stats;
+	serial_get_stats(&stats);
+	char text[TELEMETRY_MAX_PAYLOAD + 1];
+	char* p = fmt_str_P(text, PSTR("OK ovr="));
+	p = fmt_uint(p, stats.overruns, 0);
+	p = fmt_str_P(p, PSTR(" fe="));
+	p = fmt_uint(p, stats.framing_errors, 0);
+	p = fmt_str_P(p, PSTR(" drop="));
+	p = fmt_uint(p, stats.dropped, 0);
+	p = fmt_str_P(p, PSTR(" xoff="));
+	p = fmt_uint(p, stats.xoffs_sent, 0);
+	p = fmt_str_P(p, PSTR(" max="));
+	p = fmt_uint(p, stats.max_used, 0);
+	p = fmt_char(p, '/');
+	fmt_uint(p, stats.size, 0);
+	command_reply(text);
+	return NO_REPLY;
+}
+
+static uint8_t do_stats_clear(int32_t* args, uint8_t num_args) {
+	serial_clear_stats();
+	return 0;
+}
+
+// Report how long the sampled sound interrupt takes
+static uint8_t do_pcm_stats(int32_t* args, uint8_t num_args) {
+	PcmStats stats;
+	pcm_get_stats(&stats);
+	char text[TELEMETRY_MAX_PAYLOAD + 1];
+	char* p = fmt_str_P(text, PSTR("OK pcm max="));
+	p = fmt_uint(p, stats.max_cycles, 0);
+	p = fmt_str_P(p, PSTR(" avg="));
+	p = fmt_uint(p, stats.average_cycles, 0);
+	p = fmt_char(p, '/');
+	p = fmt_uint(p, PCM_CYCLE_BUDGET, 0);
+	p = fmt_str_P(p, PSTR(" over="));
+	p = fmt_uint(p, stats.over_budget, 0);
+	p = fmt_str_P(p, PSTR(" late="));
+	fmt_uint(p, stats.late, 0);
+	command_reply(text);
+	return NO_REPLY;
+}
+
+// Static variables (.data + .bss), bytes on the stack now and at most,
+// and bytes the stack has never reached
+static uint8_t do_mem(int32_t* args, uint8_t num_args) {
+	MemoryStats stats;
+	memory_get_stats(&stats);
+	char text[TELEMETRY_MAX_PAYLOAD + 1];
+	char* p = fmt_str_P(text, PSTR("OK static="));
+	p = fmt_uint(p, stats.data_size, 0);
+	p = fmt_char(p, '+');
+	p = fmt_uint(p, stats.bss_size, 0);
+	p = fmt_str_P(p, PSTR(" stack="));
+	p = fmt_uint(p, stats.stack_used, 0);
+	p = fmt_char(p, '/');
+	p = fmt_uint(p, stats.stack_peak, 0);
+	p = fmt_str_P(p, PSTR(" free="));
+	fmt_uint(p, stats.headroom, 0);
+	command_reply(text);
+	return NO_REPLY;
+}
+
+static uint8_t do_cpu(int32_t* args, uint8_t num_args) {
+	return push(INPUT_PLAYERS, PLAYERS_CPU, 0);
+}
+
+static uint8_t do_cpu_stats(int32_t* args, uint8_t num_args) {
+	uint8_t depth, ms;
+	uint16_t nodes;
+	ai_get_stats(&depth, &nodes, &ms);
+	char text[TELEMETRY_MAX_PAYLOAD + 1];
+	char* p = fmt_str_P(text, PSTR("OK cpu depth="));
+	p = fmt_uint(p, depth, 0);
+	p = fmt_str_P(p, PSTR(" nodes="));
+	p = fmt_uint(p, nodes, 0);
+	p = fmt_str_P(p, PSTR(" ms="));
+	fmt_uint(p, ms, 0);
+	command_reply(text);
+	return NO_REPLY;
+}
+
+static uint8_t do_link(int32_t* args, uint8_t num_args) {
+	if (!in_range(args[0], 0, 2)) {
+		return COMMAND_ERROR_ARGUMENTS;
+	}
+	return push(INPUT_LINK, args[0], 0);
+}
+
+// Round trips (ms) for the last turn sent over the link, the average and
+// the longest, then the events sent again and the bad frames received
+static uint8_t do_link_stats(int32_t* args, uint8_t num_args) {
+	LinkStats stats;
+	link_get_stats(&stats);
+	char text[TELEMETRY_MAX_PAYLOAD + 1];
+	char* p = fmt_str_P(text, PSTR("OK rtt="));
+	p = fmt_uint(p, stats.last_rtt, 0);
+	p = fmt_char(p, '/');
+	p = fmt_uint(p, stats.turns ? stats.total_rtt / stats.turns : 0, 0);
+	p = fmt_char(p, '/');
+	p = fmt_uint(p, stats.max_rtt, 0);
+	p = fmt_str_P(p, PSTR(" re="));
+	p = fmt_uint(p, stats.resent, 0);
+	p = fmt_str_P(p, PSTR(" bad="));
+	fmt_uint(p, stats.bad_frames, 0);
+	command_reply(text);
+	return NO_REPLY;
+}
+
+// Largest joystick deadzone (ADC counts from the centre) and repeat
+// timing (ms) that can be set
+#define JOY_MAX_DEADZONE 511
+#define JOY_MAX_REPEAT_MS 10000
+
+static uint8_t do_joy_deadzone(int32_t* args, uint8_t num_args) {
+	if (!in_range(args[0], 1, JOY_MAX_DEADZONE) ||
+			!in_range(args[1], 0, args[0] - 1)) {
+		return COMMAND_ERROR_ARGUMENTS;
+	}
+	joystick_set_deadzone(args[0], args[1]);
+	return 0;
+}
+
+// A delay of 0 turns auto-repeat off. The interval can't be 0, which would
+// repeat the move on every pass of the game loop.
+static uint8_t do_joy_repeat(int32_t* args, uint8_t num_args) {
+	if (!in_range(args[0], 0, JOY_MAX_REPEAT_MS) ||
+			!in_range(args[1], 1, JOY_MAX_REPEAT_MS)) {
+		return COMMAND_ERROR_ARGUMENTS;
+	}
+	joystick_set_repeat(args[0], args[1]);
+	return 0;
+}
+
+#define GAME INPUT_CONTEXT_GAME
+#define MENU INPUT_CONTEXT_MENU
+#define ALL INPUT_CONTEXT_ALL
+
+static const Command commands[] PROGMEM = {
+	{"ROLL", GAME, 0, 1, do_roll},
+	{"MOVE", GAME, 2, 2, do_move},
+	{"STEP", GAME, 1, 1, do_step},
+	{"PAUSE", GAME, 0, 0, do_pause},
+	{"BOARD", MENU, 1, 1, do_board},
+	{"PLAYERS", MENU, 1, 1, do_players},
+	{"RULES", MENU, 1, 1, do_rules},
+	{"START", MENU, 0, 0, do_start},
+	{"LIMIT", MENU | GAME, 1, 1, do_limit},
+	{"SOUND", ALL, 0, 0, do_sound},
+	{"TELEMETRY", ALL, 0, 0, do_telemetry},
+	{"STATE?", ALL, 0, 0, do_state},
+	{"BAUD", ALL, 0, 1, do_baud},
+	{"BENCH TX", ALL, 1, 1, do_bench_tx},
+	{"BENCH RX", ALL, 1, 1, do_bench_rx},
+	{"BENCH FMT", ALL, 1, 1, do_bench_fmt},
+	{"STATS?", ALL, 0, 0, do_stats},
+	{"STATS CLEAR", ALL, 0, 0, do_stats_clear},
+	{"PCM?", ALL, 0, 0, do_pcm_stats},
+	{"MEM?", ALL, 0, 0, do_mem},
+	{"CPU", MENU, 0, 0, do_cpu},
+	{"CPU?", ALL, 0, 0, do_cpu_stats},
+	{"LINK", MENU, 1, 1, do_link},
+	{"LINK?", ALL, 0, 0, do_link_stats},
+	{"JOY DEADZONE", ALL, 2, 2, do_joy_deadzone},
+	{"JOY REPEAT", ALL, 2, 2, do_joy_repeat}
+};
+#define NUM_COMMANDS (sizeof(commands) / sizeof(commands[0]))
+
+void command_reply(const char* text) {
+	if (telemetry_enabled()) {
+		telemetry_send_reply(text);
+		return;
+	}
+	move_terminal_cursor(1, REPLY_ROW);
+	serial_write(text, strlen(text));
+	clear_to_end_of_line();
+	screen_invalidate_cursor();
+}
+
+void command_report_baud(void) {
+	char text[TELEMETRY_MAX_PAYLOAD + 1];
+	int16_t error = serial_baud_error();
+	char* p = fmt_str_P(text, PSTR("OK "));
+	p = fmt_ulong(p, serial_baud_rate(), 0);
+	p = fmt_str_P(p, PSTR(" baud"));
+	if (serial_double_speed()) {
+		p = fmt_str_P(p, PSTR(" (U2X)"));
+	}
+	p = fmt_str_P(p, PSTR(" error "));
+	if (error >= 0) {
+		p = fmt_char(p, '+');
+	}
+	p = fmt_fixed(p, error, 1);
+	fmt_char(p, '%');
+	command_reply(text);
+}
+
+void command_reply_P(const char* text) {
+	char buffer[COMMAND_MAX_LENGTH + 16];
+	strncpy_P(buffer, text, sizeof(buffer) - 1);
+	buffer[sizeof(buffer) - 1] = 0;
+	command_reply(buffer);
+}
+
+static void reply_error(uint8_t code) {
+	static const char messages[][14] PROGMEM = {
+		"",
+		"unknown",
+		"arguments",
+		"state",
+		"too long",
+		"busy",
+		"baud timeout"
+	};
+	char buffer[24];
+	char* p = fmt_str_P(buffer, PSTR("ERR "));
+	p = fmt_uint(p, code, 0);
+	p = fmt_char(p, ' ');
+	fmt_str_P(p, messages[code]);
+	command_reply(buffer);
+}
+
+// Find the command the line starts with. Names can be more than one word
+// (e.g. "BENCH TX") so they're matched against the start of the line
+// rather than the first word. Returns the index of the command or -1.
+static int8_t find_command(Command* command, char** rest) {
+	for (uint8_t i = 0; i < NUM_COMMANDS; i++) {
+		memcpy_P(command, &commands[i], sizeof(*command));
+		uint8_t length = strlen(command->name);
+		if (strncmp(line, command->name, length) == 0 &&
+				(line[length] == ' ' || line[length] == 0)) {
+			*rest = line + length;
+			return i;
+		}
+	}
+	return -1;
+}
+
+// Split the line into the command name and its arguments and run it
+static void execute(void) {
+	if (line[0] == 0) {
+		return;
+	}
+	Command command;
+	char* rest;
+	if (find_command(&command, &rest) < 0) {
+		reply_error(COMMAND_ERROR_UNKNOWN);
+		return;
+	}
+	
+	int32_t args[COMMAND_MAX_ARGS];
+	uint8_t num_args = 0;
+	char* token = strtok(rest, " ");
+	for (; token != NULL; token = strtok(NULL, " ")) {
+		if (num_args == COMMAND_MAX_ARGS) {
+			reply_error(COMMAND_ERROR_ARGUMENTS);
+			return;
+		}
+		char* end;
+		args[num_args++] = strtol(token, &end, 10);
+		if (*end) {
+			reply_error(COMMAND_ERROR_ARGUMENTS);
+			return;
+		}
+	}
+	
+	if (!(command.contexts & input_get_context())) {
+		reply_error(COMMAND_ERROR_STATE);
+	} else if (num_args < command.min_args || num_args > command.max_args) {
+		reply_error(COMMAND_ERROR_ARGUMENTS);
+	} else {
+		uint8_t error = command.handler(args, num_args);
+		if (error == 0) {
+			command_reply_P(PSTR("OK"));
+		} else if (error != NO_REPLY) {
+			reply_error(error);
+		}
+	}
+}
+
+void command_poll(uint32_t time) {
+	if (baud_unconfirmed && (int32_t)(time - baud_deadline) >= 0) {
+		baud_unconfirmed = 0;
+		serial_set_baud(previous_baud);
+		reply_error(COMMAND_ERROR_BAUD);
+	}
+}
+
+uint8_t command_feed(char c, uint32_t time) {
+	// Anything received means the host is at the same baud rate
+	baud_unconfirmed = 0;
+	if (!in_command) {
+		if (c != COMMAND_PREFIX) {
+			return 0;
+		}
+		in_command = 1;
+		line_length = 0;
+		too_long = 0;
+		line_time = time;
+		return 1;
+	}
+	
+	if (c == '\n' || c == '\r') {
+		in_command = 0;
+		line[line_length] = 0;
+		if (too_long) {
+			reply_error(COMMAND_ERROR_TOO_LONG);
+		} else {
+			execute();
+		}
+	} else if (line_length < COMMAND_MAX_LENGTH) {
+		line[line_length++] = toupper(c);
+	} else {
+		too_long = 1;
+	}
+	return 1;
+}
@@ -0,0 +1,73 @@
+/*
+ * command.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * Line-oriented remote commands for scripted control over the serial port.
+ * A command is a line starting with ':' and ending with a newline, e.g.
+ *   :ROLL 4
+ *   :MOVE 1 0
+ *   :STATE?
+ *   :BAUD 250000
+ *   :BENCH TX 2000
+ *   :MEM?
+ *   :CPU?
+ *   :LINK 1
+ *   :LINK?
+ *   :JOY DEADZONE 320 100
+ *   :JOY REPEAT 400 200
+ * The line may also end with a carriage return. Command names are not case
+ * sensitive and arguments are decimal integers
+ * separated by spaces. Each command is answered with a reply line:
+ *   OK [details]
+ *   ERR <code> <message>
+ * Replies are written to the bottom line of the terminal (or sent as a
+ * TELEMETRY_REPLY frame while telemetry is on).
+ *
+ * Commands that act on the game are turned into input events so they go
+ * through exactly the same path as the buttons and keys.
+ */
+
+
+#ifndef COMMAND_H_
+#define COMMAND_H_
+
+#include <stdint.h>
+
+// Start of a command line
+#define COMMAND_PREFIX ':'
+
+// Longest command line (not counting the prefix)
+#define COMMAND_MAX_LENGTH 24
+
+// Error codes
+#define COMMAND_ERROR_UNKNOWN		1	// no such command
+#define COMMAND_ERROR_ARGUMENTS		2	// wrong number or range of arguments
+#define COMMAND_ERROR_STATE			3	// not available in this state
+#define COMMAND_ERROR_TOO_LONG		4	// line longer than COMMAND_MAX_LENGTH
+#define COMMAND_ERROR_BUSY			5	// input queue full
+#define COMMAND_ERROR_BAUD			6	// new baud rate not confirmed in time
+
+/* Pass a character received on the serial port to the command
+ * interpreter. Returns 1 if the character was part of a command line (and
+ * so should not be treated as a key press), 0 otherwise.
+ */
+uint8_t command_feed(char c, uint32_t time);
+
+/* Called regularly (every input_poll()) to handle timeouts.
+ */
+void command_poll(uint32_t time);
+
+/* Write a reply line. The text is in RAM for command_reply() and in
+ * program memory for command_reply_P().
+ */
+void command_reply(const char* text);
+void command_reply_P(const char* text);
+
+/* Reply with the current baud rate and its error, e.g.
+ * "OK 19200 baud error +0.2%".
+ */
+void command_report_baud(void);
+
+
+#endif /* COMMAND_H_ */
@@ -1,130 +1,228 @@
-/*
- * display.c
- *
- * Authors: Luke Kamols, Jarrod Bennett
- */ 
-
-#include "display.h"
-#include <stdio.h>
-#include <avr/pgmspace.h>
-#include "pixel_colour.h"
-#include "ledmatrix.h"
-#include "game.h"
-
-// constant value used to display 'SNKLD' on launch
-static const uint8_t snkld_display[MATRIX_NUM_COLUMNS] = 
-		{117, 85, 93, 124, 64, 124, 125, 17, 109, 0, 124, 4, 4, 125, 69, 57};
-
-void initialise_display(void) {
-	// start by clearing the LED matrix
-	ledmatrix_clear();
-
-	// create an array with the background colour at every position
-	PixelColour col_colours[MATRIX_NUM_ROWS];
-	for (int row = 0; row < MATRIX_NUM_ROWS; row++) {
-		col_colours[row] = MATRIX_COLOUR_EMPTY;
-	}
-
-	// then add the bounds on the left
-	for (int x = 0; x < MATRIX_X_OFFSET; x++) {
-		ledmatrix_update_column(x, col_colours);
-	}
-
-	// and add the bounds on the right
-	for (int x = MATRIX_X_OFFSET + WIDTH; x < MATRIX_NUM_COLUMNS; x++) {
-		ledmatrix_update_column(x, col_colours);
-	}
-	
-	// create an array with the background colour at every position
-	PixelColour row_colours[MATRIX_NUM_COLUMNS];
-	for (int col = 0; col < MATRIX_NUM_COLUMNS; col++) {
-		row_colours[col] = MATRIX_COLOUR_EMPTY;
-	}
-
-	// then add the bounds on the bottom
-	for (int y = 0; y < MATRIX_Y_OFFSET; y++) {
-		ledmatrix_update_row(y, row_colours);
-	}
-
-	// and add the bounds on the right
-	for (int y = MATRIX_Y_OFFSET + HEIGHT; y < MATRIX_NUM_ROWS; y++) {
-		ledmatrix_update_row(y, row_colours);
-	}
-}
-
-void start_display(void) {
-	PixelColour colour;
-	MatrixColumn column_colour_data;
-	uint8_t col_data;
-		
-	ledmatrix_clear(); // start by clearing the LED matrix
-	for (uint8_t col = 0; col < MATRIX_NUM_COLUMNS; col++) {
-		col_data = snkld_display[col];
-		// using the LSB as the colour determining bit, 1 is red, 0 is green
-		if (col_data & 0x01) {
-			colour = COLOUR_RED;
-		} else {
-			colour = COLOUR_GREEN;
-		}
-		// go through the top 7 bits (not the bottom one as that was our colour bit)
-		// and set any to be the correct colour
-		for(uint8_t i=7; i>=1; i--) {
-			// If the relevant font bit is set, we make this a coloured pixel, else blank
-			if(col_data & 0x80) {
-				column_colour_data[i] = colour;
-			} else {
-				column_colour_data[i] = 0;
-			}
-			col_data <<= 1;
-		}
-		column_colour_data[0] = 0;
-		ledmatrix_update_column(col, column_colour_data);
-	}
-}
-
-// Update the square colour to the display. The object passed can be the object
-// type or an object instance (which additionally has an ID number if 
-// applicable -see get_object_type in game.c/h)
-void update_square_colour(uint8_t x, uint8_t y, uint8_t object) {
-	// determine which colour corresponds to this object
-	PixelColour colour;
-	object = get_object_type(object);
-	
-	switch (object) {
-		case EMPTY_SQUARE:
-			colour = MATRIX_COLOUR_EMPTY;
-			break;
-		case START_POINT:	/* FALLTHROUGH */
-		case FINISH_LINE:
-			colour = MATRIX_COLOUR_START_END;
-			break;
-		case PLAYER_1:
-			colour = MATRIX_COLOUR_P1;
-			break;
-		case PLAYER_2:
-		colour = MATRIX_COLOUR_P2;
-		break;
-			
-		// All snakes should be the same colour
-		case SNAKE_START:	/* FALLTHROUGH */
-		case SNAKE_END:		/* FALLTHROUGH */
-		case SNAKE_MIDDLE:
-			colour = MATRIX_COLOUR_SNAKE;
-			break;
-			
-		// All ladders should be the same colour
-		case LADDER_START:	/* FALLTHROUGH */
-		case LADDER_END:	/* FALLTHROUGH */
-		case LADDER_MIDDLE:
-			colour = MATRIX_COLOUR_LADDER;
-			break;
-		
-		// An invalid object
-		default:
-			colour = MATRIX_COLOUR_EMPTY;
-			break;
-	}
-
-	// Update the pixel at the given location with this colour
-	ledmatrix_update_pixel(y, WIDTH - 1 - x, colour);
-}
\ No newline at end of file
+/*
+ * display.c
+ *
+ * Authors: Luke Kamols, Jarrod Bennett
+ */ 
+
+#include "display.h"
+#include <stdio.h>
+#include <avr/pgmspace.h>
+#include "pixel_colour.h"
+#include "ledmatrix.h"
+#include "game.h"
+
+// How near the edge of the view the current player can get before it
+// scrolls, and the furthest the view scrolls rather than being redrawn
+#define VIEW_MARGIN 2
+#define VIEW_MAX_SCROLL 4
+
+// Board square shown at the bottom left of the LED matrix
+static uint8_t view_x;
+static uint8_t view_y;
+
+// constant value used to display 'SNKLD' on launch
+static const uint8_t snkld_display[MATRIX_NUM_COLUMNS] = 
+		{117, 85, 93, 124, 64, 124, 125, 17, 109, 0, 124, 4, 4, 125, 69, 57};
+
+void initialise_display(void) {
+	// start by clearing the LED matrix
+	ledmatrix_clear();
+	view_x = 0;
+	view_y = 0;
+
+	// create an array with the background colour at every position
+	PixelColour col_colours[MATRIX_NUM_ROWS];
+	for (int row = 0; row < MATRIX_NUM_ROWS; row++) {
+		col_colours[row] = MATRIX_COLOUR_EMPTY;
+	}
+
+	// then add the bounds on the left
+	for (int x = 0; x < MATRIX_X_OFFSET; x++) {
+		ledmatrix_update_column(x, col_colours);
+	}
+
+	// and add the bounds on the right
+	for (int x = MATRIX_X_OFFSET + WIDTH; x < MATRIX_NUM_COLUMNS; x++) {
+		ledmatrix_update_column(x, col_colours);
+	}
+	
+	// create an array with the background colour at every position
+	PixelColour row_colours[MATRIX_NUM_COLUMNS];
+	for (int col = 0; col < MATRIX_NUM_COLUMNS; col++) {
+		row_colours[col] = MATRIX_COLOUR_EMPTY;
+	}
+
+	// then add the bounds on the bottom
+	for (int y = 0; y < MATRIX_Y_OFFSET; y++) {
+		ledmatrix_update_row(y, row_colours);
+	}
+
+	// and add the bounds on the right
+	for (int y = MATRIX_Y_OFFSET + HEIGHT; y < MATRIX_NUM_ROWS; y++) {
+		ledmatrix_update_row(y, row_colours);
+	}
+}
+
+void start_display(void) {
+	PixelColour colour;
+	MatrixColumn column_colour_data;
+	uint8_t col_data;
+		
+	ledmatrix_clear(); // start by clearing the LED matrix
+	for (uint8_t col = 0; col < MATRIX_NUM_COLUMNS; col++) {
+		col_data = snkld_display[col];
+		// using the LSB as the colour determining bit, 1 is red, 0 is green
+		if (col_data & 0x01) {
+			colour = COLOUR_RED;
+		} else {
+			colour = COLOUR_GREEN;
+		}
+		// go through the top 7 bits (not the bottom one as that was our colour bit)
+		// and set any to be the correct colour
+		for(uint8_t i=7; i>=1; i--) {
+			// If the relevant font bit is set, we make this a coloured pixel, else blank
+			if(col_data & 0x80) {
+				column_colour_data[i] = colour;
+			} else {
+				column_colour_data[i] = 0;
+			}
+			col_data <<= 1;
+		}
+		column_colour_data[0] = 0;
+		ledmatrix_update_column(col, column_colour_data);
+	}
+}
+
+// The colour an object is shown in. The object can be the object type or an
+// object instance (which additionally has an ID number if applicable - see
+// get_object_type in game.c/h)
+static PixelColour object_colour(uint8_t object) {
+	// determine which colour corresponds to this object
+	PixelColour colour;
+	object = get_object_type(object);
+	
+	switch (object) {
+		case EMPTY_SQUARE:
+			colour = MATRIX_COLOUR_EMPTY;
+			break;
+		case START_POINT:	/* FALLTHROUGH */
+		case FINISH_LINE:
+			colour = MATRIX_COLOUR_START_END;
+			break;
+		case PLAYER_1:
+			colour = MATRIX_COLOUR_P1;
+			break;
+		case PLAYER_2:
+		colour = MATRIX_COLOUR_P2;
+		break;
+			
+		// All snakes should be the same colour
+		case SNAKE_START:	/* FALLTHROUGH */
+		case SNAKE_END:		/* FALLTHROUGH */
+		case SNAKE_MIDDLE:
+			colour = MATRIX_COLOUR_SNAKE;
+			break;
+			
+		// All ladders should be the same colour
+		case LADDER_START:	/* FALLTHROUGH */
+		case LADDER_END:	/* FALLTHROUGH */
+		case LADDER_MIDDLE:
+			colour = MATRIX_COLOUR_LADDER;
+			break;
+		
+		// An invalid object
+		default:
+			colour = MATRIX_COLOUR_EMPTY;
+			break;
+	}
+	return colour;
+}
+
+// Update the square colour to the display. The object passed can be the object
+// type or an object instance (which additionally has an ID number if 
+// applicable -see get_object_type in game.c/h). Squares outside the view
+// aren't shown.
+void update_square_colour(uint8_t x, uint8_t y, uint8_t object) {
+	if (x < view_x || x >= view_x + WIDTH ||
+			y < view_y || y >= view_y + HEIGHT) {
+		return;
+	}
+	// Update the pixel at the given location with this colour
+	ledmatrix_update_pixel(y - view_y, WIDTH - 1 - (x - view_x),
+			object_colour(object));
+}
+
+// Draw board row y, which is a column of the LED matrix
+static void draw_view_column(uint8_t y) {
+	MatrixColumn column;
+	for (uint8_t row = 0; row < MATRIX_NUM_ROWS; row++) {
+		column[row] = object_colour(get_shown_object(view_x + WIDTH - 1 - row,
+				y));
+	}
+	ledmatrix_update_column(y - view_y, column);
+}
+
+// Draw board column x, which is a row of the LED matrix
+static void draw_view_row(uint8_t x) {
+	MatrixRow row;
+	for (uint8_t col = 0; col < MATRIX_NUM_COLUMNS; col++) {
+		row[col] = object_colour(get_shown_object(x, view_y + col));
+	}
+	ledmatrix_update_row(WIDTH - 1 - (x - view_x), row);
+}
+
+// Where a view of size squares, starting at start, should start along a
+// board of board_size squares to keep position away from its edges
+static uint8_t view_start(uint8_t position, uint8_t start, uint8_t size,
+		uint8_t board_size) {
+	if (board_size <= size) {
+		return 0;
+	}
+	if (position < start + VIEW_MARGIN) {
+		start = position < VIEW_MARGIN ? 0 : position - VIEW_MARGIN;
+	} else if (position + VIEW_MARGIN >= start + size) {
+		start = position + VIEW_MARGIN + 1 - size;
+	}
+	if (start > board_size - size) {
+		start = board_size - size;
+	}
+	return start;
+}
+
+void display_follow(uint8_t x, uint8_t y) {
+	uint8_t new_x = view_start(x, view_x, WIDTH, get_board_width());
+	uint8_t new_y = view_start(y, view_y, HEIGHT, get_board_height());
+	uint8_t distance = (new_x > view_x ? new_x - view_x : view_x - new_x) +
+			(new_y > view_y ? new_y - view_y : view_y - new_y);
+	if (distance > VIEW_MAX_SCROLL) {
+		// Too far to scroll, so draw the whole view again
+		view_x = new_x;
+		view_y = new_y;
+		for (uint8_t col = 0; col < HEIGHT; col++) {
+			draw_view_column(view_y + col);
+		}
+		return;
+	}
+	// Shift what's shown over and draw the row or column that's come into
+	// view, one square at a time
+	while (view_y < new_y) {
+		ledmatrix_shift_display_left();
+		view_y++;
+		draw_view_column(view_y + HEIGHT - 1);
+	}
+	while (view_y > new_y) {
+		ledmatrix_shift_display_right();
+		view_y--;
+		draw_view_column(view_y);
+	}
+	while (view_x < new_x) {
+		ledmatrix_shift_display_down();
+		view_x++;
+		draw_view_row(view_x + WIDTH - 1);
+	}
+	while (view_x > new_x) {
+		ledmatrix_shift_display_up();
+		view_x--;
+		draw_view_row(view_x);
+	}
+}
@@ -0,0 +1,157 @@
+/*
+ * fmt.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * The AVR has no divide instruction, so numbers are converted by
+ * subtracting powers of ten rather than by dividing by ten for every
+ * digit. A digit takes at most nine subtractions, which is much quicker
+ * than a call to the library's 16 or 32 bit division.
+ */
+
+#include "fmt.h"
+#include <string.h>
+#include <avr/pgmspace.h>
+
+static const uint16_t powers_of_ten[] PROGMEM = {10000, 1000, 100, 10};
+
+static const uint32_t long_powers_of_ten[] PROGMEM = {
+	1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10
+};
+
+// Write the digits of value (no leading zeros) and return how many there
+// were. digits must have room for 5 characters.
+static uint8_t uint_digits(char* digits, uint16_t value) {
+	uint8_t length = 0;
+	for (uint8_t i = 0; i < sizeof(powers_of_ten) / sizeof(powers_of_ten[0]); i++) {
+		uint16_t power = pgm_read_word(&powers_of_ten[i]);
+		char digit = '0';
+		while (value >= power) {
+			value -= power;
+			digit++;
+		}
+		if (digit != '0' || length) {
+			digits[length++] = digit;
+		}
+	}
+	digits[length++] = '0' + value;
+	return length;
+}
+
+// As above for 32 bit values - digits must have room for 10 characters
+static uint8_t ulong_digits(char* digits, uint32_t value) {
+	uint8_t length = 0;
+	for (uint8_t i = 0; i < sizeof(long_powers_of_ten) / sizeof(long_powers_of_ten[0]); i++) {
+		uint32_t power = pgm_read_dword(&long_powers_of_ten[i]);
+		char digit = '0';
+		while (value >= power) {
+			value -= power;
+			digit++;
+		}
+		if (digit != '0' || length) {
+			digits[length++] = digit;
+		}
+	}
+	digits[length++] = '0' + value;
+	return length;
+}
+
+// Output a sign (if negative) and digits, padded on the left to width
+static char* put_number(char* p, uint8_t negative, const char* digits,
+		uint8_t length, uint8_t width) {
+	uint8_t total = length + negative;
+	while (width > total) {
+		*p++ = ' ';
+		width--;
+	}
+	if (negative) {
+		*p++ = '-';
+	}
+	memcpy(p, digits, length);
+	p += length;
+	*p = 0;
+	return p;
+}
+
+char* fmt_str(char* p, const char* s) {
+	while ((*p = *s++) != 0) {
+		p++;
+	}
+	return p;
+}
+
+char* fmt_str_P(char* p, const char* s) {
+	while ((*p = pgm_read_byte(s++)) != 0) {
+		p++;
+	}
+	return p;
+}
+
+char* fmt_char(char* p, char c) {
+	*p++ = c;
+	*p = 0;
+	return p;
+}
+
+char* fmt_uint(char* p, uint16_t value, uint8_t width) {
+	char digits[5];
+	uint8_t length = uint_digits(digits, value);
+	return put_number(p, 0, digits, length, width);
+}
+
+char* fmt_int(char* p, int16_t value, uint8_t width) {
+	char digits[5];
+	uint8_t negative = value < 0;
+	// The cast makes -32768 come out right
+	uint8_t length = uint_digits(digits,
+			negative ? -(uint16_t)value : (uint16_t)value);
+	return put_number(p, negative, digits, length, width);
+}
+
+char* fmt_ulong(char* p, uint32_t value, uint8_t width) {
+	char digits[10];
+	uint8_t length = ulong_digits(digits, value);
+	return put_number(p, 0, digits, length, width);
+}
+
+char* fmt_fixed(char* p, int16_t value, uint8_t decimals) {
+	char digits[5];
+	if (value < 0) {
+		*p++ = '-';
+	}
+	uint8_t length = uint_digits(digits,
+			value < 0 ? -(uint16_t)value : (uint16_t)value);
+	// Pad with leading zeros so there's a digit before the point
+	uint8_t total = length > decimals ? length : decimals + 1;
+	for (uint8_t i = 0; i < total; i++) {
+		if (total - i == decimals) {
+			*p++ = '.';
+		}
+		*p++ = i < total - length ? '0' : digits[i - (total - length)];
+	}
+	*p = 0;
+	return p;
+}
+
+char* fmt_cursor(char* p, uint8_t x, uint8_t y) {
+	*p++ = '\x1b';
+	*p++ = '[';
+	p = fmt_uint(p, y, 0);
+	*p++ = ';';
+	p = fmt_uint(p, x, 0);
+	return fmt_char(p, 'H');
+}
+
+char* fmt_cursor_right(char* p, uint8_t n) {
+	*p++ = '\x1b';
+	*p++ = '[';
+	p = fmt_uint(p, n, 0);
+	return fmt_char(p, 'C');
+}
+
+char* fmt_attribute(char* p, uint8_t parameter) {
+	*p++ = '\x1b';
+	*p++ = '[';
+	p = fmt_uint(p, parameter, 0);
+	return fmt_char(p, 'm');
+}
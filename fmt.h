@@ -0,0 +1,58 @@
+/*
+ * fmt.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * Small formatting functions used instead of printf_P() and sprintf_P().
+ * Pulling in vfprintf costs a lot of flash and every call has to parse its
+ * format string, even for something as simple as "Last Roll: %d". These
+ * just do the one thing asked of them.
+ *
+ * Each function writes its output at p, null terminates it and returns a
+ * pointer to the terminating null so that calls can be chained, e.g.
+ *   char text[16];
+ *   char* p = fmt_str_P(text, PSTR("Last Roll: "));
+ *   p = fmt_uint(p, roll, 0);
+ *   serial_write(text, p - text);
+ * The caller makes sure the buffer is big enough.
+ */
+
+
+#ifndef FMT_H_
+#define FMT_H_
+
+#include <stdint.h>
+
+// Longest output of fmt_cursor(), not counting the null
+#define FMT_CURSOR_LENGTH 8
+
+/* Copy a string (from program memory for fmt_str_P()).
+ */
+char* fmt_str(char* p, const char* s);
+char* fmt_str_P(char* p, const char* s);
+
+/* Output one character.
+ */
+char* fmt_char(char* p, char c);
+
+/* Output an integer in decimal, right aligned with spaces in a field of
+ * width characters (0 for no padding).
+ */
+char* fmt_uint(char* p, uint16_t value, uint8_t width);
+char* fmt_int(char* p, int16_t value, uint8_t width);
+char* fmt_ulong(char* p, uint32_t value, uint8_t width);
+
+/* Output a fixed point number. value is in units of 10^-decimals, so
+ * fmt_fixed(p, -35, 1) gives "-3.5" and fmt_fixed(p, 5, 2) gives "0.05".
+ */
+char* fmt_fixed(char* p, int16_t value, uint8_t decimals);
+
+/* Output the escape sequences to move the cursor to (x, y), to move it
+ * right n columns and to set a display attribute.
+ */
+char* fmt_cursor(char* p, uint8_t x, uint8_t y);
+char* fmt_cursor_right(char* p, uint8_t n);
+char* fmt_attribute(char* p, uint8_t parameter);
+
+
+#endif /* FMT_H_ */
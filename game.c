@@ -1,647 +1,895 @@
-/*
- * game.c
- *
- * Functionality related to the game state and features.
- *
- * Author: Jarrod Bennett
- */ 
-
-
-#include "game.h"
-#include <stdlib.h>
-#include <stdio.h>
-#include <stdint.h>
-#include "display.h"
-#include "terminalio.h"
-#include "timer0.h"
-#include "project.h"
-
-
-#include <avr/io.h>
-#include <avr/interrupt.h>
-#include <avr/pgmspace.h>
-
-#define F_CPU 8000000UL
-#include <util/delay.h>
-
-int on_off_sound;
-int stick;
-
-uint8_t board[WIDTH][HEIGHT];
-
-// The initial game layout. Note that this is laid out in such a way that
-// starting_layout[x][y] does not correspond to an (x,y) coordinate but is a
-// better visual representation (but still somewhat messy).
-// In our reference system, (0,0) is the bottom left, but (0,0) in this array
-// is the top left.
-static const uint8_t starting_layout[HEIGHT][WIDTH] =
-{
-	{FINISH_LINE, 0, 0, 0, 0, 0, 0, 0},
-	{0, SNAKE_START | 4, 0, 0, LADDER_END | 4, 0, 0, 0},
-	{0, SNAKE_MIDDLE | 4, 0, LADDER_MIDDLE | 4, 0, 0, 0, 0},
-	{0, SNAKE_MIDDLE | 4, LADDER_START | 4, 0, 0, 0, 0, 0},
-	{0, SNAKE_END | 4, 0, 0, 0, 0, SNAKE_START | 3, 0},
-	{0, 0, 0, 0, LADDER_END | 3, 0, SNAKE_MIDDLE | 3, 0},
-	{SNAKE_START | 2, 0, 0, 0, LADDER_MIDDLE | 3, 0, SNAKE_MIDDLE | 3, 0},
-	{0, SNAKE_MIDDLE | 2, 0, 0, LADDER_START | 3, 0, SNAKE_END | 3, 0},
-	{0, 0, SNAKE_END | 2, 0, 0, 0, 0, 0},
-	{0, 0, 0, 0, 0, 0, 0, 0},
-	{0, 0, 0, 0, 0, 0, 0, 0},
-	{0, 0, 0, SNAKE_START | 1, 0, 0, 0, LADDER_END | 1},
-	{0, LADDER_END | 2, 0, SNAKE_MIDDLE | 1, 0, 0, LADDER_MIDDLE| 1, 0},
-	{0, LADDER_MIDDLE | 2, 0, SNAKE_MIDDLE | 1, 0, LADDER_START | 1, 0, 0},
-	{0, LADDER_START | 2, 0, SNAKE_MIDDLE | 1, 0, 0, 0, 0},
-	{START_POINT, 0, 0, SNAKE_END | 1, 0, 0, 0, 0}
-};
-
-static const uint8_t starting_layout2[HEIGHT][WIDTH] =
-{
-	{FINISH_LINE, 0, 0, SNAKE_START | 4, 0, 0, 0, LADDER_END | 4},
-		      {0, 0, 0, SNAKE_MIDDLE| 4, 0, 0, LADDER_MIDDLE| 4, 0},
-			  {0, 0, 0, SNAKE_MIDDLE| 4, 0, LADDER_START | 4, 0, 0},
-			  {0, 0, 0, SNAKE_END | 4, 0, 0, 0, 0},
-			  {0, 0, 0, 0, 0, 0, 0, 0},
-	   		  {SNAKE_START | 3, 0, 0, 0, LADDER_END | 3, 0, 0, 0},
-			  {0, SNAKE_MIDDLE| 3, 0, 0, LADDER_MIDDLE| 3, 0, 0, 0},
-			  {0, 0, SNAKE_END | 3, 0, LADDER_MIDDLE| 3, 0, 0, 0},
-			  {0, 0, 0, 0, LADDER_START | 3, 0, 0, 0},
-			  {0, 0, 0, 0, 0, 0, 0, 0},
-			  {0, 0, 0, SNAKE_START | 2, 0, 0, 0, 0},
-			  {LADDER_END | 2, 0, 0, SNAKE_MIDDLE| 2, 0, 0, 0, 0},
-			  {LADDER_MIDDLE| 2, 0, 0, SNAKE_END | 2, 0,0, LADDER_END | 1, 0},
-			  {LADDER_START | 2, 0, SNAKE_START | 1,0,0,0, LADDER_MIDDLE| 1, 0},
-			  {0, 0, 0, SNAKE_MIDDLE| 1, 0, 0, LADDER_START | 1,0},
-	{START_POINT, 0, 0,0, SNAKE_END | 1, 0, 0, 0}
-};
-static const uint8_t p1_winner[HEIGHT][WIDTH] =
-{
-	{0, 0, 0, 0, 0, 0, 0, 0},
-	{0, 0, 0, 0, 0, 0, 0, 0},
-	{0, 0, 0, 0, 0, 0, 0, 0},
-	{0, 0, 0, 0, 0, 0, 0, 0},
-	{0, 0, PLAYER_1, PLAYER_1, PLAYER_1, 0, 0, 0},
-	{0, PLAYER_1, PLAYER_1, PLAYER_1, PLAYER_1, 0, 0, 0},
-	{0, PLAYER_1, PLAYER_1, PLAYER_1, PLAYER_1, 0, 0, 0},
-	{0, 0, 0, PLAYER_1, PLAYER_1, 0, 0, 0},
-	{0, 0, 0, PLAYER_1, PLAYER_1, 0, 0, 0},
-	{0, 0, 0, PLAYER_1, PLAYER_1, 0, 0, 0},
-	{0, PLAYER_1, PLAYER_1, PLAYER_1, PLAYER_1, PLAYER_1, PLAYER_1, 0},
-	{0, PLAYER_1, PLAYER_1, PLAYER_1, PLAYER_1, PLAYER_1, PLAYER_1, 0},
-	{0, 0, 0, 0, 0, 0, 0, 0},
-	{0, 0, 0, 0, 0, 0, 0, 0},
-	{0, 0, 0, 0, 0, 0, 0, 0},
-	{0, 0, 0, 0, 0, 0, 0, 0}
-};
-
-static const uint8_t p2_winner[HEIGHT][WIDTH] =
-{
-	{0, 0, 0, 0, 0, 0, 0, 0},
-	{0, 0, 0, 0, 0, 0, 0, 0},
-	{0, 0, 0, 0, 0, 0, 0, 0},
-	{0, 0, 0, 0, 0, 0, 0, 0},
-	{0, 0, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, 0},
-	{0, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, 0},
-	{0, PLAYER_2, PLAYER_2, 0, 0, PLAYER_2, PLAYER_2, 0},
-	{0, 0, 0, 0, 0, PLAYER_2, PLAYER_2, 0},
-	{0, 0, 0, 0, PLAYER_2, PLAYER_2, 0, 0},
-	{0, 0, 0, PLAYER_2, PLAYER_2, 0, 0, 0},
-	{0, 0, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, 0},
-	{0, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, 0},
-	{0, 0, 0, 0, 0, 0, 0, 0},
-	{0, 0, 0, 0, 0, 0, 0, 0},
-	{0, 0, 0, 0, 0, 0, 0, 0},
-	{0, 0, 0, 0, 0, 0, 0, 0}
-};
-
-// The player is not stored in the board itself to avoid overwriting game
-// elements when the player is moved.
-int8_t player_1_x;
-int8_t player_1_y;
-int8_t player_2_x;
-int8_t player_2_y;
-int multiplayer;
-int player_x;
-int player_y;
-int player[2] = {PLAYER_1,PLAYER_2};
-int winner;
-int board_num; 
-int direction;
-int a;
-int b;
-uint8_t current_player = 0;
-// For flashing the player icon
-uint8_t player_visible;
-
-void activate_multiplayer(void){
-	multiplayer = 1; 
-}
-void deactivate_multiplayer(void){
-	multiplayer = 0;
-}
-
-void choose_board(uint8_t board_type){
-	board_num = board_type;
-	initialise_display();
-	for (int x = 0; x < WIDTH; x++) {
-		for (int y = 0; y < HEIGHT; y++) {
-			if (board_num==0){
-				board[x][y] = starting_layout[HEIGHT - 1 - y][x];
-			}
-			if (board_num==1){
-				board[x][y] = starting_layout2[HEIGHT - 1 - y][x];
-			}	
-			update_square_colour(x, y, get_object_type(board[x][y]));
-			
-		}
-	}
-}
-
-void initialise_game(void) {
-		
-	OCR1B = 0xFF;
-	TCCR1A = (1 << WGM10) | (1 << WGM11) | (1 << CS10) | (1 << COM1A1)| (1 << COM1B1);
-	TCCR1B = (1 << WGM12) | (1 << WGM13) | (1 << CS11) ;
-	OCR1A = 0;
-	
-	// initialise the display we are using.
-	initialise_display();
-		
-	// start the player icon at the bottom left of the display
-	// NOTE: (for INternal students) the LED matrix uses a different coordinate
-	// system
-	player_1_x = 0;
-	player_1_y = 0;
-	player_2_x = 0;
-	player_2_y = 0;
-	stick = 0;
-	
-	direction = 1;
-	player_visible = 0;
-
-	// go through and initialise the state of the playing_field
-	for (int x = 0; x < WIDTH; x++) {
-		for (int y = 0; y < HEIGHT; y++) {
-			// initialise this square based on the starting layout
-			// the indices here are to ensure the starting layout
-			// could be easily visualised when declared
-			if (board_num==0){
-				board[x][y] = starting_layout[HEIGHT - 1 - y][x];
-			}
-			if (board_num==1){
-				board[x][y] = starting_layout2[HEIGHT - 1 - y][x];
-			}
-			
-			update_square_colour(x, y, get_object_type(board[x][y]));
-			
-		}
-	}
-	
-	update_square_colour(player_1_x, player_1_y, PLAYER_1);
-	
-}
-
-// Return the game object at the specified position (x, y). This function does
-// not consider the position of the player token since it is not stored on the
-// game board.
-uint8_t get_object_at(uint8_t x, uint8_t y) {
-	// check the bounds, anything outside the bounds
-	// will be considered empty
-	if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) {
-		return EMPTY_SQUARE;
-	} else {
-		//if in the bounds, just index into the array
-		return board[x][y];
-	}
-}
-
-// Extract the object type of a game element (the upper 4 bits).
-uint8_t get_object_type(uint8_t object) {
-	return object & 0xF0;
-}
-
-// Get the identifier of a game object (the lower 4 bits). Not all objects
-// have an identifier, in which case 0 will be returned.
-uint8_t get_object_identifier(uint8_t object) {
-	return object & 0x0F;
-}
-
-// Move the player by the given number of spaces forward.
-void move_player_n(uint8_t num_spaces) {
-	/* suggestions for implementation:
-	 * 1: remove the display of the player at the current location
-	 *		(and replace it with whatever object is at that location).
-	 * 2: update the positional knowledge of the player, this will include
-	 *		variables player_1_x and player_1_y since you will need to consider
-	 *		what should happen if the player reaches the end of the current
-	 *		row. You will need to consider which direction the player should
-	 *		move based on the current row. A loop can be useful to move the
-	 *		player one space at a time but is not essential.
-	 * 3: display the player at the new location
-	 *
-	 * FOR "Flashing Player Icon"
-	 * 4: reset the player cursor flashing cycle. See project.c for how the
-	 *		cursor is flashed.
-	 */
-	// YOUR CODE HERE
-	int i;
-	if (current_player ==0){
-		player_x = player_1_x;
-		player_y = player_1_y;
-	}
-	if (current_player ==1){
-		player_x = player_2_x;
-		player_y = player_2_y;
-	}
-	for(i=0;i<num_spaces;i++){
-		uint8_t object_at_cursor = get_object_at(player_x, player_y);
-		update_square_colour(player_x, player_y, object_at_cursor);
-		
-		if (player_y % 2 == 0){
-			direction = 1;
-		}
-		if (player_y % 2 != 0){
-			direction = -1;
-		}
-		
-		player_x += direction;
-		
-		if (player_x >7){
-			player_y += 1;
-			player_x += -1;
-		}
-		if (player_x <0){
-			
-			player_y += 1;
-			if (player_y > 15){
-				player_x = 0;
-				player_y = 15;
-				
-			}
-			else{player_x += 1;}
-		}
-		if (on_off_sound == 0){OCR1A = ((1000000UL / 25)-1);}
-			
-		b = get_current_time();
-		a = get_current_time();
-		
-		while (b <= a+40)
-		{b = get_current_time();
-			switch_ssd();	
-		}
-		update_square_colour(player_x,player_y,player[current_player]);		
-		
-		b = get_current_time();
-		a = get_current_time();
-
-		while (b <= a+30)
-		{b = get_current_time();
-			switch_ssd();
-		}
-		OCR1A = 0;
-		if (current_player ==0){
-			player_1_x = player_x;
-			player_1_y = player_y;
-		}
-		if (current_player ==1){
-			player_2_x = player_x;
-			player_2_y = player_y;
-		}
-	}
-	check_snake_ladder();
-	is_game_over();
-	if (multiplayer == 1){current_player = current_player^1;}
-	
-	
-	// MY CODE ABOVE
-
-}
-
-// Move the player one space in the direction (dx, dy). The player should wrap
-// around the display if moved 'off' the display.
-void move_player(int8_t dx, int8_t dy) {
-	/* suggestions for implementation:
-	 * 1: remove the display of the player at the current location
-	 *		(and replace it with whatever object is at that location).
-	 * 2: update the positional knowledge of the player, this will include
-	 *		variables player_1_x and player_1_y and cursor_visible. Make sure
-	 *		you consider what should happen if the player moves off the board.
-	 *		(The player should wrap around to the current row/column.)
-	 * 3: display the player at the new location
-	 *
-	 * FOR "Flashing Player Icon"
-	 * 4: reset the player cursor flashing cycle. See project.c for how the
-	 *		cursor is flashed.
-	 */	
-	// YOUR CODE HERE
-	if (current_player ==0){
-		player_x = player_1_x;
-		player_y = player_1_y;
-	}
-	if (current_player ==1){
-		player_x = player_2_x;
-		player_y = player_2_y;
-	}
-	uint8_t object_at_cursor = get_object_at(player_x, player_y);
-	update_square_colour(player_x, player_y, object_at_cursor);
-	player_x += dx;
-	player_y += dy;
-	if (player_y % 2 == 0){
-		direction = 1;
-	}
-	if (player_y % 2 != 0){
-		direction = -1;
-	}
-	if (player_y == -1){
-		player_y = 15;
-	}
-	if (player_y == 16){
-		player_y = 0;
-	}
-	if (player_x == -1){
-		player_x = 7;
-	}
-	if (player_x == 8){
-		player_x = 0;
-	}
-	update_square_colour(player_x,player_y,player[current_player]);
-	if (current_player ==0){
-		player_1_x = player_x;
-		player_1_y = player_y;
-	}
-	if (current_player ==1){
-		player_2_x = player_x;
-		player_2_y = player_y;
-	}
-	if (on_off_sound == 0){	OCR1A = ((1000000UL / 25)-1);}
-	b = get_current_time();
-	a = get_current_time();
-	
-	while (b <= a+70)
-	{b = get_current_time();
-		switch_ssd();
-	}
-	check_snake_ladder();
-	OCR1A = 0;
-	is_game_over();
-	
-	if (multiplayer == 1 && stick == 0){current_player = 1^current_player;}
-	//MY CODE ABOVE
-
-}
-
-// Flash the player icon on and off. This should be called at a regular
-// interval (see where this is called in project.c) to create a consistent
-// 500 ms flash.
-void flash_player_cursor(void) {
-	if (current_player == 0){
-		if(multiplayer ==1){update_square_colour(player_2_x, player_2_y, PLAYER_2);}
-		player_x = player_1_x;
-		player_y = player_1_y;
-	}
-	if (current_player == 1){
-		update_square_colour(player_1_x, player_1_y, PLAYER_1);
-		player_x = player_2_x;
-		player_y = player_2_y;
-	}
-	if (player_visible) {
-		// we need to flash the player off, it should be replaced by
-		// the colour of the object which is at that location
-		uint8_t object_at_cursor = get_object_at(player_x, player_y);
-		update_square_colour(player_x, player_y, object_at_cursor);
-		
-	} else {
-		// we need to flash the player on
-		update_square_colour(player_x, player_y, player[current_player]);
-	}
-	player_visible = 1 - player_visible; //alternate between 0 and 1
-}
-
-// Returns 1 if the game is over, 0 otherwise.
-uint8_t is_game_over(void) {
-	// YOUR CODE HERE
-	if (current_player == 0){
-		player_x = player_1_x;
-		player_y = player_1_y;
-	}
-	else if (current_player == 1){
-		player_x = player_2_x;
-		player_y = player_2_y;
-	}
-	// Detect if the game is over i.e. if a player has won.
-	if (get_object_type(get_object_at(player_x,player_y))==FINISH_LINE){
-		winner = current_player + 1;
-		current_player = 0;
-		player_x = 0;
-		player_y = 0;
-		handle_game_over();
-		return 1;
-		}
-	return 0;
-}
-
-void sound(){
-	if (on_off_sound == 0){
-	OCR1A = (30*(1000000UL / 5000)-1);
-	_delay_ms(100);
-	OCR1A = (10*(1000000UL / 2500)-1);
-	_delay_ms(200);
-	OCR1A = ((1000000UL / 200)-1);}
-}
-
-void sound_off(){
-	on_off_sound = 1;
-	OCR1A = 0;
-}
-void sound_on(){
-	on_off_sound = 0;
-}
-
-void change_joystick(){
-	stick = stick ^ 1;
-}
-
-void show_winner(){
-	if (winner == 1){
-		sound();
-		initialise_display();
-		for (int x = 0; x < WIDTH; x++) {
-			_delay_ms(5);
-			for (int y = 0; y < HEIGHT; y++) {
-				// initialise this square based on the starting layout
-				// the indices here are to ensure the starting layout
-				// could be easily visualised when declared
-				if (board_num==0){
-					board[x][y] = p1_winner[HEIGHT - 1 - y][x];
-				}
-				if (board_num==1){
-					board[x][y] = p1_winner[HEIGHT - 1 - y][x];
-				}
-				
-				update_square_colour(x, y, get_object_type(board[x][y]));
-				_delay_ms(5);
-				
-			}
-		}
-	}
-	
-	if (winner == 2){
-		sound();
-		initialise_display();
-		for (int x = 0; x < WIDTH; x++) {
-			_delay_ms(5);
-			for (int y = 0; y < HEIGHT; y++) {
-				// initialise this square based on the starting layout
-				// the indices here are to ensure the starting layout
-				// could be easily visualised when declared
-				if (board_num==0){
-					board[x][y] = p2_winner[HEIGHT - 1 - y][x];
-				}
-				if (board_num==1){
-					board[x][y] = p2_winner[HEIGHT - 1 - y][x];
-				}
-				
-				update_square_colour(x, y, get_object_type(board[x][y]));
-				_delay_ms(5);
-				
-			}
-		}
-	}
-}
-
-uint8_t get_winner(){
-	if (winner == 0){
-		return ((current_player ^ 1) +1);
-		  
-	}
-	else{return winner;}
-}
-
-uint8_t get_cur_player(){
-	return current_player;
-}
-	
-void check_snake_ladder(void){ 
-	if (current_player == 0){
-		player_x = player_1_x;
-		player_y = player_1_y;
-	}
-	if (current_player == 1){
-		player_x = player_2_x;
-		player_y = player_2_y;
-	}
-	
-	uint8_t object_at_cursor = get_object_at(player_x, player_y);
-	
-		
-	if (get_object_type(object_at_cursor) == LADDER_START){
-		uint8_t end_point = (get_object_type(LADDER_END) | get_object_identifier(object_at_cursor));
-		uint8_t mid_point = (get_object_type(LADDER_MIDDLE) | get_object_identifier(object_at_cursor));
-		for (int x = 0; x < WIDTH; x++) {
-			for (int y = 0; y <HEIGHT ; y++) {
-				if (board[x][y] == mid_point)	{
-					b = get_current_time();
-					a = get_current_time();
-					
-					while (b <= a+50)
-					{b = get_current_time();
-						switch_ssd();
-					}
-					update_square_colour(player_x, player_y, object_at_cursor);
-					player_x = x;
-					player_y = y;
-					update_square_colour(player_x, player_y, player[current_player]);
-					b = get_current_time();
-					a = get_current_time();
-					
-					while (b <= a+120)
-					{b = get_current_time();
-						switch_ssd();
-					}
-				}
-				if (board[x][y] == end_point)	{
-					b = get_current_time();
-					a = get_current_time();
-					
-					while (b <= a+50)
-					{b = get_current_time();
-						switch_ssd();
-					}
-					update_square_colour(player_x, player_y, object_at_cursor);
-					player_x = x;
-					player_y = y;
-					update_square_colour(player_x, player_y, player[current_player]);
-					if (current_player ==0){
-						player_1_x = player_x;
-						player_1_y = player_y;
-					}
-					if (current_player ==1){
-						player_2_x = player_x;
-						player_2_y = player_y;
-					}
-					
-					break; 
-						}
-					}
-				}
-				if (multiplayer == 1 && stick == 1){current_player = current_player^1;}
-	}
-	if (get_object_type(object_at_cursor) == SNAKE_START){
-		uint8_t end_point = (get_object_type(SNAKE_END) | get_object_identifier(object_at_cursor));
-		uint8_t mid_point = (get_object_type(SNAKE_MIDDLE) | get_object_identifier(object_at_cursor));
-		for (int x = 0; x < WIDTH; x++) {
-			for (int y = HEIGHT; y >-1 ; y--) {
-				if (board[x][y] == mid_point)	{
-					if (on_off_sound == 0){OCR1A = (10*(1000000UL / 4000)-1);}
-					b = get_current_time();
-					a = get_current_time();
-					
-					while (b <= a+50)
-					{b = get_current_time();
-						switch_ssd();
-					}
-					if (on_off_sound == 0){OCR1A = (45*(1000000UL / 5000)-1);}
-					update_square_colour(player_x, player_y, object_at_cursor);
-					player_x = x;
-					player_y = y;
-					update_square_colour(player_x, player_y, player[current_player]);
-					b = get_current_time();
-					a = get_current_time();
-					
-					while (b <= a+120)
-					{b = get_current_time();
-						switch_ssd();
-					}
-				}
-				if (board[x][y] == end_point)	{
-					if (on_off_sound == 0){OCR1A = (40*(1000000UL / 4500)-1);}
-					b = get_current_time();
-					a = get_current_time();
-					
-					while (b <= a+50)
-					{b = get_current_time();
-						switch_ssd();
-					}
-					update_square_colour(player_x, player_y, object_at_cursor);
-					player_x = x;
-					player_y = y;
-					update_square_colour(player_x, player_y, player[current_player]);
-					if (current_player ==0){
-						player_1_x = player_x;
-						player_1_y = player_y;
-					}
-					if (current_player ==1){
-						player_2_x = player_x;
-						player_2_y = player_y;
-					}
-					OCR1A =0;
-					
-					break;
-					
-				}
-			}
-		}
-		if (multiplayer == 1 && stick == 1){current_player = current_player^1;}		
-	}
-	
-}
-
+/*
+ * game.c
+ *
+ * Functionality related to the game state and features.
+ *
+ * Author: Jarrod Bennett
+ */ 
+
+
+#include "game.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include "display.h"
+#include "terminalio.h"
+#include "timer0.h"
+#include "project.h"
+#include "sound.h"
+#include "rules.h"
+
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+#define F_CPU 8000000UL
+#include <util/delay.h>
+
+int stick;
+
+// The game layouts, kept in program memory. Note that these are laid out in
+// such a way that starting_layout[x][y] does not correspond to an (x,y)
+// coordinate but is a better visual representation (but still somewhat
+// messy).
+// In our reference system, (0,0) is the bottom left, but (0,0) in this array
+// is the top left.
+static const uint8_t starting_layout[HEIGHT][WIDTH] PROGMEM =
+{
+	{FINISH_LINE, 0, 0, 0, 0, 0, 0, 0},
+	{0, SNAKE_START | 4, 0, 0, LADDER_END | 4, 0, 0, 0},
+	{0, SNAKE_MIDDLE | 4, 0, LADDER_MIDDLE | 4, 0, 0, 0, 0},
+	{0, SNAKE_MIDDLE | 4, LADDER_START | 4, 0, 0, 0, 0, 0},
+	{0, SNAKE_END | 4, 0, 0, 0, 0, SNAKE_START | 3, 0},
+	{0, 0, 0, 0, LADDER_END | 3, 0, SNAKE_MIDDLE | 3, 0},
+	{SNAKE_START | 2, 0, 0, 0, LADDER_MIDDLE | 3, 0, SNAKE_MIDDLE | 3, 0},
+	{0, SNAKE_MIDDLE | 2, 0, 0, LADDER_START | 3, 0, SNAKE_END | 3, 0},
+	{0, 0, SNAKE_END | 2, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, SNAKE_START | 1, 0, 0, 0, LADDER_END | 1},
+	{0, LADDER_END | 2, 0, SNAKE_MIDDLE | 1, 0, 0, LADDER_MIDDLE| 1, 0},
+	{0, LADDER_MIDDLE | 2, 0, SNAKE_MIDDLE | 1, 0, LADDER_START | 1, 0, 0},
+	{0, LADDER_START | 2, 0, SNAKE_MIDDLE | 1, 0, 0, 0, 0},
+	{START_POINT, 0, 0, SNAKE_END | 1, 0, 0, 0, 0}
+};
+
+static const uint8_t starting_layout2[HEIGHT][WIDTH] PROGMEM =
+{
+	{FINISH_LINE, 0, 0, SNAKE_START | 4, 0, 0, 0, LADDER_END | 4},
+		      {0, 0, 0, SNAKE_MIDDLE| 4, 0, 0, LADDER_MIDDLE| 4, 0},
+			  {0, 0, 0, SNAKE_MIDDLE| 4, 0, LADDER_START | 4, 0, 0},
+			  {0, 0, 0, SNAKE_END | 4, 0, 0, 0, 0},
+			  {0, 0, 0, 0, 0, 0, 0, 0},
+	   		  {SNAKE_START | 3, 0, 0, 0, LADDER_END | 3, 0, 0, 0},
+			  {0, SNAKE_MIDDLE| 3, 0, 0, LADDER_MIDDLE| 3, 0, 0, 0},
+			  {0, 0, SNAKE_END | 3, 0, LADDER_MIDDLE| 3, 0, 0, 0},
+			  {0, 0, 0, 0, LADDER_START | 3, 0, 0, 0},
+			  {0, 0, 0, 0, 0, 0, 0, 0},
+			  {0, 0, 0, SNAKE_START | 2, 0, 0, 0, 0},
+			  {LADDER_END | 2, 0, 0, SNAKE_MIDDLE| 2, 0, 0, 0, 0},
+			  {LADDER_MIDDLE| 2, 0, 0, SNAKE_END | 2, 0,0, LADDER_END | 1, 0},
+			  {LADDER_START | 2, 0, SNAKE_START | 1,0,0,0, LADDER_MIDDLE| 1, 0},
+			  {0, 0, 0, SNAKE_MIDDLE| 1, 0, 0, LADDER_START | 1,0},
+	{START_POINT, 0, 0,0, SNAKE_END | 1, 0, 0, 0}
+};
+// The third board is bigger than the LED matrix, and the view scrolls
+// around it. Like the others, its snakes and ladders lean right (or go
+// straight up), the order check_snake_ladder() finds their squares in.
+#define SS(n) (SNAKE_START | (n))
+#define SM(n) (SNAKE_MIDDLE | (n))
+#define SE(n) (SNAKE_END | (n))
+#define LS(n) (LADDER_START | (n))
+#define LM(n) (LADDER_MIDDLE | (n))
+#define LE(n) (LADDER_END | (n))
+static const uint8_t starting_layout3[32][16] PROGMEM =
+{
+	{FINISH_LINE, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 0, LE(2), 0, SS(10), 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, LM(2), 0, 0, 0, SM(10), 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, LM(2), 0, 0, 0, 0, SM(10), 0, 0, 0, 0, LE(6)},
+	{0, 0, 0, 0, LM(2), 0, 0, 0, 0, 0, 0, SE(10), 0, 0, LM(6), 0},
+	{SS(3), 0, 0, LS(2), 0, 0, 0, 0, 0, SS(1), 0, 0, 0, 0, LM(6), 0},
+	{0, SM(3), 0, 0, 0, 0, SS(5), 0, 0, 0, SM(1), 0, 0, LS(6), 0, 0},
+	{0, 0, SM(3), 0, 0, 0, SM(5), 0, SS(7), 0, SM(1), 0, 0, 0, 0, 0},
+	{LE(9), 0, SM(3), 0, 0, 0, SM(5), 0, SM(7), 0, 0, SM(1), 0, 0, 0, 0},
+	{LM(9), 0, 0, SM(3), 0, 0, SM(5), 0, SM(7), 0, 0, 0, SM(1), 0, 0, 0},
+	{LM(9), 0, 0, 0, SE(3), 0, SM(5), 0, SM(7), 0, 0, 0, 0, SM(1), 0, 0},
+	{LM(9), 0, 0, 0, 0, 0, SM(5), 0, SM(7), 0, 0, 0, 0, 0, SM(1), 0},
+	{LM(9), 0, 0, 0, 0, 0, SM(5), 0, SE(7), 0, 0, 0, 0, 0, SM(1), 0},
+	{LM(9), 0, 0, 0, 0, 0, SM(5), 0, 0, 0, LE(1), 0, 0, 0, 0, SE(1)},
+	{LS(9), 0, 0, 0, LE(4), 0, SE(5), 0, 0, LM(1), 0, 0, SS(8), 0, 0, 0},
+	{0, 0, 0, LM(4), 0, 0, 0, 0, LM(1), 0, 0, 0, 0, SM(8), 0, 0},
+	{0, 0, 0, LM(4), 0, 0, 0, LM(1), 0, 0, 0, SS(6), 0, 0, SM(8), 0},
+	{0, 0, LM(4), 0, 0, 0, 0, LM(1), 0, 0, 0, SM(6), 0, 0, 0, SE(8)},
+	{0, LM(4), 0, 0, 0, 0, LM(1), 0, 0, LE(7), 0, SM(6), 0, 0, 0, 0},
+	{0, LM(4), 0, 0, 0, LM(1), 0, 0, 0, LM(7), 0, SM(6), 0, 0, 0, 0},
+	{LS(4), 0, 0, 0, LS(1), 0, 0, LE(10), 0, LM(7), 0, SE(6), 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, LM(10), 0, 0, LS(7), 0, 0, 0, 0, 0, LE(5)},
+	{0, 0, 0, 0, 0, LM(10), 0, 0, 0, 0, 0, 0, LE(3), 0, 0, LM(5)},
+	{0, 0, 0, 0, LS(10), 0, 0, 0, 0, 0, 0, LM(3), 0, 0, 0, LM(5)},
+	{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, LM(3), 0, 0, 0, 0, LM(5)},
+	{0, 0, 0, 0, 0, 0, 0, 0, 0, LM(3), 0, 0, 0, 0, 0, LM(5)},
+	{0, 0, SS(2), 0, 0, 0, 0, 0, LM(3), 0, 0, SS(9), 0, 0, 0, LM(5)},
+	{SS(4), 0, 0, SM(2), 0, 0, 0, LS(3), 0, 0, 0, SM(9), 0, LE(8), 0, LM(5)},
+	{0, SM(4), 0, 0, SM(2), 0, 0, 0, 0, 0, 0, SM(9), 0, LM(8), 0, LS(5)},
+	{0, 0, SM(4), 0, 0, SM(2), 0, 0, 0, 0, 0, SE(9), 0, LM(8), 0, 0},
+	{0, 0, 0, SE(4), 0, 0, SE(2), 0, 0, 0, 0, 0, 0, LS(8), 0, 0},
+	{START_POINT, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+};
+#undef SS
+#undef SM
+#undef SE
+#undef LS
+#undef LM
+#undef LE
+
+// The fourth board's path spirals in to the finish in the middle
+static const uint8_t starting_layout4[HEIGHT][WIDTH] PROGMEM =
+{
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{LADDER_START | 2, LADDER_MIDDLE | 2, LADDER_MIDDLE | 2, LADDER_MIDDLE | 2, LADDER_END | 2, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, LADDER_END | 3, 0, 0, 0, 0, 0},
+	{0, LADDER_MIDDLE | 3, 0, 0, LADDER_END | 1, 0, 0, SNAKE_END | 3},
+	{LADDER_START | 3, 0, 0, LADDER_MIDDLE | 1, 0, 0, SNAKE_MIDDLE | 3, 0},
+	{0, 0, LADDER_MIDDLE | 1, 0, 0, SNAKE_START | 3, 0, 0},
+	{0, LADDER_START | 1, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, SNAKE_START | 2, SNAKE_MIDDLE | 2, SNAKE_MIDDLE | 2, SNAKE_END | 2, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, FINISH_LINE, 0, SNAKE_START | 4, SNAKE_MIDDLE | 4, SNAKE_END | 4},
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, LADDER_END | 4, 0, SNAKE_START | 1, 0, 0},
+	{0, 0, 0, LADDER_MIDDLE | 4, 0, SNAKE_MIDDLE | 1, 0, 0},
+	{START_POINT, 0, 0, LADDER_START | 4, 0, SNAKE_END | 1, 0, 0}
+};
+
+// The paths players take around the boards, as the (x, y) of each square
+// from the start to the finish. Snakes and ladders only need to start and
+// end on the path; any route through every square will do.
+
+// Along each row and back along the next, up the board
+static const uint8_t path_rows[HEIGHT * WIDTH][2] PROGMEM =
+{
+	{0, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0}, {5, 0}, {6, 0}, {7, 0},
+	{7, 1}, {6, 1}, {5, 1}, {4, 1}, {3, 1}, {2, 1}, {1, 1}, {0, 1},
+	{0, 2}, {1, 2}, {2, 2}, {3, 2}, {4, 2}, {5, 2}, {6, 2}, {7, 2},
+	{7, 3}, {6, 3}, {5, 3}, {4, 3}, {3, 3}, {2, 3}, {1, 3}, {0, 3},
+	{0, 4}, {1, 4}, {2, 4}, {3, 4}, {4, 4}, {5, 4}, {6, 4}, {7, 4},
+	{7, 5}, {6, 5}, {5, 5}, {4, 5}, {3, 5}, {2, 5}, {1, 5}, {0, 5},
+	{0, 6}, {1, 6}, {2, 6}, {3, 6}, {4, 6}, {5, 6}, {6, 6}, {7, 6},
+	{7, 7}, {6, 7}, {5, 7}, {4, 7}, {3, 7}, {2, 7}, {1, 7}, {0, 7},
+	{0, 8}, {1, 8}, {2, 8}, {3, 8}, {4, 8}, {5, 8}, {6, 8}, {7, 8},
+	{7, 9}, {6, 9}, {5, 9}, {4, 9}, {3, 9}, {2, 9}, {1, 9}, {0, 9},
+	{0, 10}, {1, 10}, {2, 10}, {3, 10}, {4, 10}, {5, 10}, {6, 10}, {7, 10},
+	{7, 11}, {6, 11}, {5, 11}, {4, 11}, {3, 11}, {2, 11}, {1, 11}, {0, 11},
+	{0, 12}, {1, 12}, {2, 12}, {3, 12}, {4, 12}, {5, 12}, {6, 12}, {7, 12},
+	{7, 13}, {6, 13}, {5, 13}, {4, 13}, {3, 13}, {2, 13}, {1, 13}, {0, 13},
+	{0, 14}, {1, 14}, {2, 14}, {3, 14}, {4, 14}, {5, 14}, {6, 14}, {7, 14},
+	{7, 15}, {6, 15}, {5, 15}, {4, 15}, {3, 15}, {2, 15}, {1, 15}, {0, 15}
+};
+
+static const uint8_t path_rows_large[32 * 16][2] PROGMEM =
+{
+	{0, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0}, {5, 0}, {6, 0}, {7, 0},
+	{8, 0}, {9, 0}, {10, 0}, {11, 0}, {12, 0}, {13, 0}, {14, 0}, {15, 0},
+	{15, 1}, {14, 1}, {13, 1}, {12, 1}, {11, 1}, {10, 1}, {9, 1}, {8, 1},
+	{7, 1}, {6, 1}, {5, 1}, {4, 1}, {3, 1}, {2, 1}, {1, 1}, {0, 1},
+	{0, 2}, {1, 2}, {2, 2}, {3, 2}, {4, 2}, {5, 2}, {6, 2}, {7, 2},
+	{8, 2}, {9, 2}, {10, 2}, {11, 2}, {12, 2}, {13, 2}, {14, 2}, {15, 2},
+	{15, 3}, {14, 3}, {13, 3}, {12, 3}, {11, 3}, {10, 3}, {9, 3}, {8, 3},
+	{7, 3}, {6, 3}, {5, 3}, {4, 3}, {3, 3}, {2, 3}, {1, 3}, {0, 3},
+	{0, 4}, {1, 4}, {2, 4}, {3, 4}, {4, 4}, {5, 4}, {6, 4}, {7, 4},
+	{8, 4}, {9, 4}, {10, 4}, {11, 4}, {12, 4}, {13, 4}, {14, 4}, {15, 4},
+	{15, 5}, {14, 5}, {13, 5}, {12, 5}, {11, 5}, {10, 5}, {9, 5}, {8, 5},
+	{7, 5}, {6, 5}, {5, 5}, {4, 5}, {3, 5}, {2, 5}, {1, 5}, {0, 5},
+	{0, 6}, {1, 6}, {2, 6}, {3, 6}, {4, 6}, {5, 6}, {6, 6}, {7, 6},
+	{8, 6}, {9, 6}, {10, 6}, {11, 6}, {12, 6}, {13, 6}, {14, 6}, {15, 6},
+	{15, 7}, {14, 7}, {13, 7}, {12, 7}, {11, 7}, {10, 7}, {9, 7}, {8, 7},
+	{7, 7}, {6, 7}, {5, 7}, {4, 7}, {3, 7}, {2, 7}, {1, 7}, {0, 7},
+	{0, 8}, {1, 8}, {2, 8}, {3, 8}, {4, 8}, {5, 8}, {6, 8}, {7, 8},
+	{8, 8}, {9, 8}, {10, 8}, {11, 8}, {12, 8}, {13, 8}, {14, 8}, {15, 8},
+	{15, 9}, {14, 9}, {13, 9}, {12, 9}, {11, 9}, {10, 9}, {9, 9}, {8, 9},
+	{7, 9}, {6, 9}, {5, 9}, {4, 9}, {3, 9}, {2, 9}, {1, 9}, {0, 9},
+	{0, 10}, {1, 10}, {2, 10}, {3, 10}, {4, 10}, {5, 10}, {6, 10}, {7, 10},
+	{8, 10}, {9, 10}, {10, 10}, {11, 10}, {12, 10}, {13, 10}, {14, 10}, {15, 10},
+	{15, 11}, {14, 11}, {13, 11}, {12, 11}, {11, 11}, {10, 11}, {9, 11}, {8, 11},
+	{7, 11}, {6, 11}, {5, 11}, {4, 11}, {3, 11}, {2, 11}, {1, 11}, {0, 11},
+	{0, 12}, {1, 12}, {2, 12}, {3, 12}, {4, 12}, {5, 12}, {6, 12}, {7, 12},
+	{8, 12}, {9, 12}, {10, 12}, {11, 12}, {12, 12}, {13, 12}, {14, 12}, {15, 12},
+	{15, 13}, {14, 13}, {13, 13}, {12, 13}, {11, 13}, {10, 13}, {9, 13}, {8, 13},
+	{7, 13}, {6, 13}, {5, 13}, {4, 13}, {3, 13}, {2, 13}, {1, 13}, {0, 13},
+	{0, 14}, {1, 14}, {2, 14}, {3, 14}, {4, 14}, {5, 14}, {6, 14}, {7, 14},
+	{8, 14}, {9, 14}, {10, 14}, {11, 14}, {12, 14}, {13, 14}, {14, 14}, {15, 14},
+	{15, 15}, {14, 15}, {13, 15}, {12, 15}, {11, 15}, {10, 15}, {9, 15}, {8, 15},
+	{7, 15}, {6, 15}, {5, 15}, {4, 15}, {3, 15}, {2, 15}, {1, 15}, {0, 15},
+	{0, 16}, {1, 16}, {2, 16}, {3, 16}, {4, 16}, {5, 16}, {6, 16}, {7, 16},
+	{8, 16}, {9, 16}, {10, 16}, {11, 16}, {12, 16}, {13, 16}, {14, 16}, {15, 16},
+	{15, 17}, {14, 17}, {13, 17}, {12, 17}, {11, 17}, {10, 17}, {9, 17}, {8, 17},
+	{7, 17}, {6, 17}, {5, 17}, {4, 17}, {3, 17}, {2, 17}, {1, 17}, {0, 17},
+	{0, 18}, {1, 18}, {2, 18}, {3, 18}, {4, 18}, {5, 18}, {6, 18}, {7, 18},
+	{8, 18}, {9, 18}, {10, 18}, {11, 18}, {12, 18}, {13, 18}, {14, 18}, {15, 18},
+	{15, 19}, {14, 19}, {13, 19}, {12, 19}, {11, 19}, {10, 19}, {9, 19}, {8, 19},
+	{7, 19}, {6, 19}, {5, 19}, {4, 19}, {3, 19}, {2, 19}, {1, 19}, {0, 19},
+	{0, 20}, {1, 20}, {2, 20}, {3, 20}, {4, 20}, {5, 20}, {6, 20}, {7, 20},
+	{8, 20}, {9, 20}, {10, 20}, {11, 20}, {12, 20}, {13, 20}, {14, 20}, {15, 20},
+	{15, 21}, {14, 21}, {13, 21}, {12, 21}, {11, 21}, {10, 21}, {9, 21}, {8, 21},
+	{7, 21}, {6, 21}, {5, 21}, {4, 21}, {3, 21}, {2, 21}, {1, 21}, {0, 21},
+	{0, 22}, {1, 22}, {2, 22}, {3, 22}, {4, 22}, {5, 22}, {6, 22}, {7, 22},
+	{8, 22}, {9, 22}, {10, 22}, {11, 22}, {12, 22}, {13, 22}, {14, 22}, {15, 22},
+	{15, 23}, {14, 23}, {13, 23}, {12, 23}, {11, 23}, {10, 23}, {9, 23}, {8, 23},
+	{7, 23}, {6, 23}, {5, 23}, {4, 23}, {3, 23}, {2, 23}, {1, 23}, {0, 23},
+	{0, 24}, {1, 24}, {2, 24}, {3, 24}, {4, 24}, {5, 24}, {6, 24}, {7, 24},
+	{8, 24}, {9, 24}, {10, 24}, {11, 24}, {12, 24}, {13, 24}, {14, 24}, {15, 24},
+	{15, 25}, {14, 25}, {13, 25}, {12, 25}, {11, 25}, {10, 25}, {9, 25}, {8, 25},
+	{7, 25}, {6, 25}, {5, 25}, {4, 25}, {3, 25}, {2, 25}, {1, 25}, {0, 25},
+	{0, 26}, {1, 26}, {2, 26}, {3, 26}, {4, 26}, {5, 26}, {6, 26}, {7, 26},
+	{8, 26}, {9, 26}, {10, 26}, {11, 26}, {12, 26}, {13, 26}, {14, 26}, {15, 26},
+	{15, 27}, {14, 27}, {13, 27}, {12, 27}, {11, 27}, {10, 27}, {9, 27}, {8, 27},
+	{7, 27}, {6, 27}, {5, 27}, {4, 27}, {3, 27}, {2, 27}, {1, 27}, {0, 27},
+	{0, 28}, {1, 28}, {2, 28}, {3, 28}, {4, 28}, {5, 28}, {6, 28}, {7, 28},
+	{8, 28}, {9, 28}, {10, 28}, {11, 28}, {12, 28}, {13, 28}, {14, 28}, {15, 28},
+	{15, 29}, {14, 29}, {13, 29}, {12, 29}, {11, 29}, {10, 29}, {9, 29}, {8, 29},
+	{7, 29}, {6, 29}, {5, 29}, {4, 29}, {3, 29}, {2, 29}, {1, 29}, {0, 29},
+	{0, 30}, {1, 30}, {2, 30}, {3, 30}, {4, 30}, {5, 30}, {6, 30}, {7, 30},
+	{8, 30}, {9, 30}, {10, 30}, {11, 30}, {12, 30}, {13, 30}, {14, 30}, {15, 30},
+	{15, 31}, {14, 31}, {13, 31}, {12, 31}, {11, 31}, {10, 31}, {9, 31}, {8, 31},
+	{7, 31}, {6, 31}, {5, 31}, {4, 31}, {3, 31}, {2, 31}, {1, 31}, {0, 31}
+};
+
+// Round the edge from the bottom left, anticlockwise, and in to the middle
+static const uint8_t path_spiral[HEIGHT * WIDTH][2] PROGMEM =
+{
+	{0, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0}, {5, 0}, {6, 0}, {7, 0},
+	{7, 1}, {7, 2}, {7, 3}, {7, 4}, {7, 5}, {7, 6}, {7, 7}, {7, 8},
+	{7, 9}, {7, 10}, {7, 11}, {7, 12}, {7, 13}, {7, 14}, {7, 15}, {6, 15},
+	{5, 15}, {4, 15}, {3, 15}, {2, 15}, {1, 15}, {0, 15}, {0, 14}, {0, 13},
+	{0, 12}, {0, 11}, {0, 10}, {0, 9}, {0, 8}, {0, 7}, {0, 6}, {0, 5},
+	{0, 4}, {0, 3}, {0, 2}, {0, 1}, {1, 1}, {2, 1}, {3, 1}, {4, 1},
+	{5, 1}, {6, 1}, {6, 2}, {6, 3}, {6, 4}, {6, 5}, {6, 6}, {6, 7},
+	{6, 8}, {6, 9}, {6, 10}, {6, 11}, {6, 12}, {6, 13}, {6, 14}, {5, 14},
+	{4, 14}, {3, 14}, {2, 14}, {1, 14}, {1, 13}, {1, 12}, {1, 11}, {1, 10},
+	{1, 9}, {1, 8}, {1, 7}, {1, 6}, {1, 5}, {1, 4}, {1, 3}, {1, 2},
+	{2, 2}, {3, 2}, {4, 2}, {5, 2}, {5, 3}, {5, 4}, {5, 5}, {5, 6},
+	{5, 7}, {5, 8}, {5, 9}, {5, 10}, {5, 11}, {5, 12}, {5, 13}, {4, 13},
+	{3, 13}, {2, 13}, {2, 12}, {2, 11}, {2, 10}, {2, 9}, {2, 8}, {2, 7},
+	{2, 6}, {2, 5}, {2, 4}, {2, 3}, {3, 3}, {4, 3}, {4, 4}, {4, 5},
+	{4, 6}, {4, 7}, {4, 8}, {4, 9}, {4, 10}, {4, 11}, {4, 12}, {3, 12},
+	{3, 11}, {3, 10}, {3, 9}, {3, 8}, {3, 7}, {3, 6}, {3, 5}, {3, 4}
+};
+
+typedef struct {
+	uint8_t width;
+	uint8_t height;
+	const uint8_t* squares;	// in program memory, top row first
+	const uint8_t (*path)[2];	// in program memory, width * height squares
+} BoardLayout;
+
+static const BoardLayout boards[NUM_BOARDS] PROGMEM = {
+	{WIDTH, HEIGHT, &starting_layout[0][0], path_rows},
+	{WIDTH, HEIGHT, &starting_layout2[0][0], path_rows},
+	{16, 32, &starting_layout3[0][0], path_rows_large},
+	{WIDTH, HEIGHT, &starting_layout4[0][0], path_spiral}
+};
+
+// The chosen board, copied out of program memory
+static BoardLayout layout = {WIDTH, HEIGHT, &starting_layout[0][0], path_rows};
+
+static const uint8_t p1_winner[HEIGHT][WIDTH] PROGMEM =
+{
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, PLAYER_1, PLAYER_1, PLAYER_1, 0, 0, 0},
+	{0, PLAYER_1, PLAYER_1, PLAYER_1, PLAYER_1, 0, 0, 0},
+	{0, PLAYER_1, PLAYER_1, PLAYER_1, PLAYER_1, 0, 0, 0},
+	{0, 0, 0, PLAYER_1, PLAYER_1, 0, 0, 0},
+	{0, 0, 0, PLAYER_1, PLAYER_1, 0, 0, 0},
+	{0, 0, 0, PLAYER_1, PLAYER_1, 0, 0, 0},
+	{0, PLAYER_1, PLAYER_1, PLAYER_1, PLAYER_1, PLAYER_1, PLAYER_1, 0},
+	{0, PLAYER_1, PLAYER_1, PLAYER_1, PLAYER_1, PLAYER_1, PLAYER_1, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0}
+};
+
+static const uint8_t p2_winner[HEIGHT][WIDTH] PROGMEM =
+{
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, 0},
+	{0, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, 0},
+	{0, PLAYER_2, PLAYER_2, 0, 0, PLAYER_2, PLAYER_2, 0},
+	{0, 0, 0, 0, 0, PLAYER_2, PLAYER_2, 0},
+	{0, 0, 0, 0, PLAYER_2, PLAYER_2, 0, 0},
+	{0, 0, 0, PLAYER_2, PLAYER_2, 0, 0, 0},
+	{0, 0, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, 0},
+	{0, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, PLAYER_2, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0}
+};
+
+// The player is not stored in the board itself to avoid overwriting game
+// elements when the player is moved.
+int8_t player_1_x;
+int8_t player_1_y;
+int8_t player_2_x;
+int8_t player_2_y;
+// How far along the path each player is, so moves needn't search for it
+static uint16_t player_1_position;
+static uint16_t player_2_position;
+int multiplayer;
+int player_x;
+int player_y;
+int player[2] = {PLAYER_1,PLAYER_2};
+int winner;
+int board_num; 
+int a;
+int b;
+uint8_t current_player = 0;
+// For flashing the player icon
+uint8_t player_visible;
+
+void activate_multiplayer(void){
+	multiplayer = 1; 
+}
+void deactivate_multiplayer(void){
+	multiplayer = 0;
+}
+
+void choose_board(uint8_t board_type){
+	board_num = board_type;
+	memcpy_P(&layout, &boards[board_num], sizeof(BoardLayout));
+	initialise_display();
+	for (int x = 0; x < WIDTH; x++) {
+		for (int y = 0; y < HEIGHT; y++) {
+			update_square_colour(x, y, get_object_type(get_object_at(x, y)));
+			
+		}
+	}
+}
+
+void initialise_game(void) {
+	
+	// initialise the display we are using.
+	initialise_display();
+		
+	// start the player icon at the bottom left of the display
+	// NOTE: (for INternal students) the LED matrix uses a different coordinate
+	// system
+	player_1_x = 0;
+	player_1_y = 0;
+	player_2_x = 0;
+	player_2_y = 0;
+	player_1_position = 0;
+	player_2_position = 0;
+	stick = 0;
+	
+	player_visible = 0;
+	winner = 0;
+	current_player = 0;
+
+	// go through and show the part of the playing field in view
+	for (int x = 0; x < WIDTH; x++) {
+		for (int y = 0; y < HEIGHT; y++) {
+			update_square_colour(x, y, get_object_type(get_object_at(x, y)));
+			
+		}
+	}
+	
+	update_square_colour(player_1_x, player_1_y, PLAYER_1);
+	
+}
+
+// Return the game object at the specified position (x, y). This function does
+// not consider the position of the player token since it is not stored on the
+// game board.
+uint8_t get_object_at(uint8_t x, uint8_t y) {
+	// check the bounds, anything outside the bounds
+	// will be considered empty
+	if (x < 0 || x >= layout.width || y < 0 || y >= layout.height) {
+		return EMPTY_SQUARE;
+	} else {
+		//if in the bounds, just index into the layout (the indices here
+		// are because it's laid out top row first)
+		return pgm_read_byte(&layout.squares[
+				(uint16_t)(layout.height - 1 - y) * layout.width + x]);
+	}
+}
+
+uint8_t get_shown_object(uint8_t x, uint8_t y) {
+	if (x == player_1_x && y == player_1_y) {
+		return PLAYER_1;
+	}
+	if (multiplayer == 1 && x == player_2_x && y == player_2_y) {
+		return PLAYER_2;
+	}
+	return get_object_type(get_object_at(x, y));
+}
+
+void get_path_square(uint16_t position, uint8_t* x, uint8_t* y) {
+	*x = pgm_read_byte(&layout.path[position][0]);
+	*y = pgm_read_byte(&layout.path[position][1]);
+}
+
+uint16_t get_path_position(uint8_t x, uint8_t y) {
+	for (uint16_t position = 0; position < get_board_squares(); position++) {
+		if (pgm_read_byte(&layout.path[position][0]) == x &&
+				pgm_read_byte(&layout.path[position][1]) == y) {
+			return position;
+		}
+	}
+	return 0;
+}
+
+uint16_t get_path_position_near(uint8_t x, uint8_t y, uint16_t near) {
+	// Out from near in both directions at once, so a square a step or two
+	// away on the board is found after a few reads rather than a whole scan
+	uint16_t squares = get_board_squares();
+	for (uint16_t distance = 0; distance < squares; distance++) {
+		if (near + distance < squares &&
+				pgm_read_byte(&layout.path[near + distance][0]) == x &&
+				pgm_read_byte(&layout.path[near + distance][1]) == y) {
+			return near + distance;
+		}
+		if (distance <= near &&
+				pgm_read_byte(&layout.path[near - distance][0]) == x &&
+				pgm_read_byte(&layout.path[near - distance][1]) == y) {
+			return near - distance;
+		}
+	}
+	return 0;
+}
+
+uint8_t get_board_width(void) {
+	return layout.width;
+}
+
+uint8_t get_board_height(void) {
+	return layout.height;
+}
+
+uint16_t get_board_squares(void) {
+	return (uint16_t)layout.width * layout.height;
+}
+
+// Extract the object type of a game element (the upper 4 bits).
+uint8_t get_object_type(uint8_t object) {
+	return object & 0xF0;
+}
+
+// Get the identifier of a game object (the lower 4 bits). Not all objects
+// have an identifier, in which case 0 will be returned.
+uint8_t get_object_identifier(uint8_t object) {
+	return object & 0x0F;
+}
+
+// Store player_x and player_y, which are position along the path, as the
+// current player's position, scrolling the view to keep them on it
+static void set_player_position(uint16_t position) {
+	if (current_player ==0){
+		player_1_x = player_x;
+		player_1_y = player_y;
+		player_1_position = position;
+	}
+	if (current_player ==1){
+		player_2_x = player_x;
+		player_2_y = player_y;
+		player_2_position = position;
+	}
+	display_follow(player_x, player_y);
+}
+
+// Scroll the view to the current player
+static void follow_current_player(void) {
+	if (current_player == 0){
+		display_follow(player_1_x, player_1_y);
+	} else {
+		display_follow(player_2_x, player_2_y);
+	}
+}
+
+static uint8_t move_along_path(uint8_t num_spaces, uint8_t sixes);
+
+// Move the player by the given number of spaces forward.
+void move_player_n(uint8_t num_spaces) {
+	move_along_path(num_spaces, 0);
+}
+
+uint8_t move_player_roll(uint8_t total, uint8_t sixes) {
+	return move_along_path(total, sixes);
+}
+
+// Move the player num_spaces along the path as the house rules allow.
+// Returns 1 if they get another turn.
+static uint8_t move_along_path(uint8_t num_spaces, uint8_t sixes) {
+	/* suggestions for implementation:
+	 * 1: remove the display of the player at the current location
+	 *		(and replace it with whatever object is at that location).
+	 * 2: update the positional knowledge of the player, this will include
+	 *		variables player_1_x and player_1_y since you will need to consider
+	 *		what should happen if the player reaches the end of the current
+	 *		row. You will need to consider which direction the player should
+	 *		move based on the current row. A loop can be useful to move the
+	 *		player one space at a time but is not essential.
+	 * 3: display the player at the new location
+	 *
+	 * FOR "Flashing Player Icon"
+	 * 4: reset the player cursor flashing cycle. See project.c for how the
+	 *		cursor is flashed.
+	 */
+	// YOUR CODE HERE
+	int i;
+	if (current_player ==0){
+		player_x = player_1_x;
+		player_y = player_1_y;
+	}
+	if (current_player ==1){
+		player_x = player_2_x;
+		player_y = player_2_y;
+	}
+	uint16_t position = get_player_path_position(current_player);
+	RuleMove move;
+	rules_plan_move(position, num_spaces, sixes, &move);
+	if (move.forward + move.back == 0) {
+		// The move isn't allowed, but show the player in case they were
+		// flashed off
+		update_square_colour(player_x, player_y, player[current_player]);
+	}
+	for(i=0;i<move.forward + move.back;i++){
+		uint8_t object_at_cursor = get_object_at(player_x, player_y);
+		update_square_colour(player_x, player_y, object_at_cursor);
+		
+		// On to the next square along the path (or back along it, when
+		// bouncing back from the finish)
+		if (i < move.forward) {
+			position++;
+		} else {
+			position--;
+		}
+		uint8_t x, y;
+		get_path_square(position, &x, &y);
+		player_x = x;
+		player_y = y;
+		set_player_position(position);
+		sound_play(SOUND_EFFECT_STEP);
+			
+		b = get_current_time();
+		a = get_current_time();
+		
+		while (b <= a+40)
+		{b = get_current_time();
+			switch_ssd();	
+		}
+		update_square_colour(player_x,player_y,player[current_player]);		
+		
+		b = get_current_time();
+		a = get_current_time();
+
+		while (b <= a+30)
+		{b = get_current_time();
+			switch_ssd();
+		}
+	}
+	check_snake_ladder();
+	is_game_over();
+	if (multiplayer == 1 && !move.extra_turn){current_player = current_player^1;}
+	follow_current_player();
+	
+	
+	// MY CODE ABOVE
+	return move.extra_turn;
+}
+
+// Move the player one space in the direction (dx, dy). The player should wrap
+// around the display if moved 'off' the display.
+void move_player(int8_t dx, int8_t dy) {
+	/* suggestions for implementation:
+	 * 1: remove the display of the player at the current location
+	 *		(and replace it with whatever object is at that location).
+	 * 2: update the positional knowledge of the player, this will include
+	 *		variables player_1_x and player_1_y and cursor_visible. Make sure
+	 *		you consider what should happen if the player moves off the board.
+	 *		(The player should wrap around to the current row/column.)
+	 * 3: display the player at the new location
+	 *
+	 * FOR "Flashing Player Icon"
+	 * 4: reset the player cursor flashing cycle. See project.c for how the
+	 *		cursor is flashed.
+	 */	
+	// YOUR CODE HERE
+	if (current_player ==0){
+		player_x = player_1_x;
+		player_y = player_1_y;
+	}
+	if (current_player ==1){
+		player_x = player_2_x;
+		player_y = player_2_y;
+	}
+	uint8_t object_at_cursor = get_object_at(player_x, player_y);
+	update_square_colour(player_x, player_y, object_at_cursor);
+	player_x += dx;
+	player_y += dy;
+	if (player_y == -1){
+		player_y = layout.height - 1;
+	}
+	if (player_y == layout.height){
+		player_y = 0;
+	}
+	if (player_x == -1){
+		player_x = layout.width - 1;
+	}
+	if (player_x == layout.width){
+		player_x = 0;
+	}
+	set_player_position(get_path_position_near(player_x, player_y,
+			get_player_path_position(current_player)));
+	update_square_colour(player_x,player_y,player[current_player]);
+	sound_play(SOUND_EFFECT_STEP);
+	b = get_current_time();
+	a = get_current_time();
+	
+	while (b <= a+70)
+	{b = get_current_time();
+		switch_ssd();
+	}
+	check_snake_ladder();
+	is_game_over();
+	
+	if (multiplayer == 1 && stick == 0){current_player = 1^current_player;}
+	follow_current_player();
+	//MY CODE ABOVE
+
+}
+
+// Flash the player icon on and off. This should be called at a regular
+// interval (see where this is called in project.c) to create a consistent
+// 500 ms flash.
+void flash_player_cursor(void) {
+	follow_current_player();
+	if (current_player == 0){
+		if(multiplayer ==1){update_square_colour(player_2_x, player_2_y, PLAYER_2);}
+		player_x = player_1_x;
+		player_y = player_1_y;
+	}
+	if (current_player == 1){
+		update_square_colour(player_1_x, player_1_y, PLAYER_1);
+		player_x = player_2_x;
+		player_y = player_2_y;
+	}
+	if (player_visible) {
+		// we need to flash the player off, it should be replaced by
+		// the colour of the object which is at that location
+		uint8_t object_at_cursor = get_object_at(player_x, player_y);
+		update_square_colour(player_x, player_y, object_at_cursor);
+		
+	} else {
+		// we need to flash the player on
+		update_square_colour(player_x, player_y, player[current_player]);
+	}
+	player_visible = 1 - player_visible; //alternate between 0 and 1
+}
+
+// Returns 1 if the game is over, 0 otherwise.
+uint8_t is_game_over(void) {
+	// YOUR CODE HERE
+	if (current_player == 0){
+		player_x = player_1_x;
+		player_y = player_1_y;
+	}
+	else if (current_player == 1){
+		player_x = player_2_x;
+		player_y = player_2_y;
+	}
+	// Detect if the game is over i.e. if a player has won.
+	if (get_object_type(get_object_at(player_x,player_y))==FINISH_LINE){
+		winner = current_player + 1;
+		current_player = 0;
+		player_x = 0;
+		player_y = 0;
+		return 1;
+		}
+	return 0;
+}
+
+void change_joystick(){
+	stick = stick ^ 1;
+}
+
+void show_winner(){
+	if (winner == 1){
+		// The tune repeats for as long as the winner is shown
+		if (!sound_playing()) {
+			sound_play(SOUND_EFFECT_WIN);
+		}
+		initialise_display();
+		for (int x = 0; x < WIDTH; x++) {
+			_delay_ms(5);
+			for (int y = 0; y < HEIGHT; y++) {
+				// initialise this square based on the starting layout
+				// the indices here are to ensure the starting layout
+				// could be easily visualised when declared
+				update_square_colour(x, y, get_object_type(
+						pgm_read_byte(&p1_winner[HEIGHT - 1 - y][x])));
+				_delay_ms(5);
+				
+			}
+		}
+	}
+	
+	if (winner == 2){
+		// The tune repeats for as long as the winner is shown
+		if (!sound_playing()) {
+			sound_play(SOUND_EFFECT_WIN);
+		}
+		initialise_display();
+		for (int x = 0; x < WIDTH; x++) {
+			_delay_ms(5);
+			for (int y = 0; y < HEIGHT; y++) {
+				// initialise this square based on the starting layout
+				// the indices here are to ensure the starting layout
+				// could be easily visualised when declared
+				update_square_colour(x, y, get_object_type(
+						pgm_read_byte(&p2_winner[HEIGHT - 1 - y][x])));
+				_delay_ms(5);
+				
+			}
+		}
+	}
+}
+
+uint8_t has_winner(void) {
+	return winner != 0;
+}
+
+uint8_t get_winner(){
+	if (winner == 0){
+		return ((current_player ^ 1) +1);
+		  
+	}
+	else{return winner;}
+}
+
+uint8_t get_board_num(void) {
+	return board_num;
+}
+
+uint8_t get_cur_player(){
+	return current_player;
+}
+
+uint16_t get_player_path_position(uint8_t player) {
+	if (player == 0) {
+		return player_1_position;
+	}
+	return player_2_position;
+}
+
+void get_player_position(uint8_t player, int8_t* x, int8_t* y){
+	if (player == 0){
+		*x = player_1_x;
+		*y = player_1_y;
+	}
+	else{
+		*x = player_2_x;
+		*y = player_2_y;
+	}
+}
+	
+void check_snake_ladder(void){ 
+	if (current_player == 0){
+		player_x = player_1_x;
+		player_y = player_1_y;
+	}
+	if (current_player == 1){
+		player_x = player_2_x;
+		player_y = player_2_y;
+	}
+	
+	uint8_t object_at_cursor = get_object_at(player_x, player_y);
+	
+		
+	if (get_object_type(object_at_cursor) == LADDER_START){
+		uint8_t end_point = (get_object_type(LADDER_END) | get_object_identifier(object_at_cursor));
+		uint8_t mid_point = (get_object_type(LADDER_MIDDLE) | get_object_identifier(object_at_cursor));
+		for (int x = 0; x < layout.width; x++) {
+			for (int y = 0; y < layout.height ; y++) {
+				if (get_object_at(x, y) == mid_point)	{
+					b = get_current_time();
+					a = get_current_time();
+					
+					while (b <= a+50)
+					{b = get_current_time();
+						switch_ssd();
+					}
+					update_square_colour(player_x, player_y, object_at_cursor);
+					player_x = x;
+					player_y = y;
+					set_player_position(get_path_position(x, y));
+					update_square_colour(player_x, player_y, player[current_player]);
+					b = get_current_time();
+					a = get_current_time();
+					
+					while (b <= a+120)
+					{b = get_current_time();
+						switch_ssd();
+					}
+				}
+				if (get_object_at(x, y) == end_point)	{
+					b = get_current_time();
+					a = get_current_time();
+					
+					while (b <= a+50)
+					{b = get_current_time();
+						switch_ssd();
+					}
+					update_square_colour(player_x, player_y, object_at_cursor);
+					player_x = x;
+					player_y = y;
+					set_player_position(get_path_position(x, y));
+					update_square_colour(player_x, player_y, player[current_player]);
+					
+					break; 
+						}
+					}
+				}
+				if (multiplayer == 1 && stick == 1){current_player = current_player^1;}
+	}
+	if (get_object_type(object_at_cursor) == SNAKE_START){
+		uint8_t end_point = (get_object_type(SNAKE_END) | get_object_identifier(object_at_cursor));
+		uint8_t mid_point = (get_object_type(SNAKE_MIDDLE) | get_object_identifier(object_at_cursor));
+		for (int x = 0; x < layout.width; x++) {
+			for (int y = layout.height - 1; y >-1 ; y--) {
+				if (get_object_at(x, y) == mid_point)	{
+					sound_play(SOUND_EFFECT_SNAKE_MIDDLE);
+					b = get_current_time();
+					a = get_current_time();
+					
+					while (b <= a+50)
+					{b = get_current_time();
+						switch_ssd();
+					}
+					update_square_colour(player_x, player_y, object_at_cursor);
+					player_x = x;
+					player_y = y;
+					set_player_position(get_path_position(x, y));
+					update_square_colour(player_x, player_y, player[current_player]);
+					b = get_current_time();
+					a = get_current_time();
+					
+					while (b <= a+120)
+					{b = get_current_time();
+						switch_ssd();
+					}
+				}
+				if (get_object_at(x, y) == end_point)	{
+					sound_play(SOUND_EFFECT_SNAKE_END);
+					b = get_current_time();
+					a = get_current_time();
+					
+					while (b <= a+50)
+					{b = get_current_time();
+						switch_ssd();
+					}
+					update_square_colour(player_x, player_y, object_at_cursor);
+					player_x = x;
+					player_y = y;
+					set_player_position(get_path_position(x, y));
+					update_square_colour(player_x, player_y, player[current_player]);
+					break;
+					
+				}
+			}
+		}
+		if (multiplayer == 1 && stick == 1){current_player = current_player^1;}		
+	}
+	
+}
+
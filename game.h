@@ -1,82 +1,121 @@
-/*
- * game.h
- *
- * Author: Jarrod Bennett
- *
- * Function prototypes for game functions available externally. You may wish
- * to add extra function prototypes here to make other functions available to
- * other files.
- */
-
-
-#ifndef GAME_H_
-#define GAME_H_
-
-#include <stdint.h>
-
-// Game board dimensions
-#define WIDTH  8
-#define HEIGHT 16
-
-// Game objects. Note upper 4 bits indicate type, lower 4 bits indicate the
-// identifier number (if applicable)
-#define EMPTY_SQUARE    ((uint8_t) 0x00)
-#define START_POINT		((uint8_t) 0x10)
-#define FINISH_LINE		((uint8_t) 0x20)
-#define PLAYER_1		((uint8_t) 0x40)
-#define PLAYER_2		((uint8_t) 0x50)
-
-// Snakes and ladders are represented by a start and end, which must share a
-// common identifier to generate the link. A third type is used to indicate
-// the 'tunnel' that connects the start and end.
-#define SNAKE_START		((uint8_t) 0x80)
-#define SNAKE_END		((uint8_t) 0x90)
-#define SNAKE_MIDDLE	((uint8_t) 0xA0)
-
-#define LADDER_START	((uint8_t) 0xC0)
-#define LADDER_END		((uint8_t) 0xD0)
-#define LADDER_MIDDLE	((uint8_t) 0xE0)
-
-// Initialise the display of the board. This creates the internal board
-// and also updates the display to show the initialised board.
-void initialise_game(void);
-
-// Return the game object at the specified position (x, y). This function does
-// not consider the position of the player token since it is not stored on the
-// game board.
-uint8_t get_object_at(uint8_t x, uint8_t y);
-
-// Extract the object type of a game element.
-uint8_t get_object_type(uint8_t object);
-
-// Move the player by the given number of spaces forward.
-void move_player_n(uint8_t num_spaces);
-
-void change_joystick();
-void sound_off();
-void sound_on();
-void show_winner();
-uint8_t get_cur_player();
-uint8_t get_winner();
-void choose_board(uint8_t board_type);
-void activate_multiplayer(void);
-void deactivate_multiplayer(void);
-void check_snake_ladder(void);
-void handle_game_over(void);
-
-// Move the player one space in the direction (dx, dy). The player should wrap
-// around the display if moved 'off' the display.
-void move_player(int8_t dx, int8_t dy);
-
-// Flash the player icon on and off. This should be called at a regular
-// interval (see where this is called in project.c) to create a consistent
-// 500 ms flash.
-void flash_player_cursor(void);
-
-// Returns 1 if the game is over, 0 otherwise.
-uint8_t is_game_over(void);
-
-
-
-#endif
-
+/*
+ * game.h
+ *
+ * Author: Jarrod Bennett
+ *
+ * Function prototypes for game functions available externally. You may wish
+ * to add extra function prototypes here to make other functions available to
+ * other files.
+ */
+
+
+#ifndef GAME_H_
+#define GAME_H_
+
+#include <stdint.h>
+
+// The part of the board shown on the LED matrix at once. Boards can be
+// bigger than this, and the view follows the current player around them.
+#define WIDTH  8
+#define HEIGHT 16
+
+// Largest board. Boards are kept in program memory, so a bigger board
+// doesn't take any more RAM.
+#define BOARD_MAX_WIDTH 32
+#define BOARD_MAX_HEIGHT 64
+
+// Number of boards to choose from
+#define NUM_BOARDS 4
+
+// Game objects. Note upper 4 bits indicate type, lower 4 bits indicate the
+// identifier number (if applicable)
+#define EMPTY_SQUARE    ((uint8_t) 0x00)
+#define START_POINT		((uint8_t) 0x10)
+#define FINISH_LINE		((uint8_t) 0x20)
+#define PLAYER_1		((uint8_t) 0x40)
+#define PLAYER_2		((uint8_t) 0x50)
+
+// Snakes and ladders are represented by a start and end, which must share a
+// common identifier to generate the link. A third type is used to indicate
+// the 'tunnel' that connects the start and end.
+#define SNAKE_START		((uint8_t) 0x80)
+#define SNAKE_END		((uint8_t) 0x90)
+#define SNAKE_MIDDLE	((uint8_t) 0xA0)
+
+#define LADDER_START	((uint8_t) 0xC0)
+#define LADDER_END		((uint8_t) 0xD0)
+#define LADDER_MIDDLE	((uint8_t) 0xE0)
+
+// Initialise the display of the board. This creates the internal board
+// and also updates the display to show the initialised board.
+void initialise_game(void);
+
+// Return the game object at the specified position (x, y). This function does
+// not consider the position of the player token since it is not stored on the
+// game board.
+uint8_t get_object_at(uint8_t x, uint8_t y);
+
+// The object to show at (x, y) - a player if one is there, otherwise the
+// game object.
+uint8_t get_shown_object(uint8_t x, uint8_t y);
+
+// The path players take around the chosen board: position is the number of
+// squares along it from the start (0). A square not on the path is at 0.
+void get_path_square(uint16_t position, uint8_t* x, uint8_t* y);
+uint16_t get_path_position(uint8_t x, uint8_t y);
+// As get_path_position(), but looking out from position near first: quick
+// for a square close to it along the path.
+uint16_t get_path_position_near(uint8_t x, uint8_t y, uint16_t near);
+
+// Size of the chosen board, and the number of squares on it
+uint8_t get_board_width(void);
+uint8_t get_board_height(void);
+uint16_t get_board_squares(void);
+
+// Extract the object type of a game element.
+uint8_t get_object_type(uint8_t object);
+
+// Get the identifier of a game object (the lower 4 bits). Not all objects
+// have an identifier, in which case 0 will be returned.
+uint8_t get_object_identifier(uint8_t object);
+
+// Move the player by the given number of spaces forward.
+void move_player_n(uint8_t num_spaces);
+
+// Move the player by a dice roll of total, of which sixes dice came up 6,
+// under the selected house rules (rules.h). Returns 1 if the player gets
+// another turn.
+uint8_t move_player_roll(uint8_t total, uint8_t sixes);
+
+void change_joystick();
+void show_winner();
+uint8_t get_cur_player();
+// Get the position of player 0 (player 1) or 1 (player 2).
+void get_player_position(uint8_t player, int8_t* x, int8_t* y);
+// How far along the path player 0 (player 1) or 1 (player 2) is.
+uint16_t get_player_path_position(uint8_t player);
+uint8_t get_winner();
+uint8_t get_board_num(void);
+// Returns 1 once a player has reached the finish, 0 before then.
+uint8_t has_winner(void);
+void choose_board(uint8_t board_type);
+void activate_multiplayer(void);
+void deactivate_multiplayer(void);
+void check_snake_ladder(void);
+
+// Move the player one space in the direction (dx, dy). The player should wrap
+// around the display if moved 'off' the display.
+void move_player(int8_t dx, int8_t dy);
+
+// Flash the player icon on and off. This should be called at a regular
+// interval (see where this is called in project.c) to create a consistent
+// 500 ms flash.
+void flash_player_cursor(void);
+
+// Returns 1 if the game is over, 0 otherwise.
+uint8_t is_game_over(void);
+
+
+
+#endif
+
@@ -0,0 +1,152 @@
+/*
+ * ai_values.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * Writes the firmware's ai_values.c - the tables the computer opponent
+ * (ai.c) scores positions with. For each board, every square on the path
+ * gets the expected number of turns to reach the finish when rolling every
+ * turn with each number of dice (1 to RULES_MAX_DICE), and the square a
+ * player landing there ends up on.
+ *
+ * The boards come from the firmware's game.c (linked in). The expected
+ * turns solve
+ *   E(finish) = 0
+ *   E(s) = 1 + (sum over the throws t of E(after moving the total of t)) /
+ *          (number of throws, 6 for one die and 36 for two)
+ * by repeating the update until nothing changes - snakes make the chain
+ * loop back on itself, so there's no order to solve it in directly. A move
+ * past the finish stops on it and there are no extra turns - ai.c applies
+ * the other house rules in its search.
+ *
+ * Usage: ai_values > ai_values.c
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "game_host.h"
+#include "ai.h"
+
+static void find_landings(uint16_t* landing) {
+	for (uint16_t s = 0; s < get_board_squares(); s++) {
+		uint8_t x, y;
+		get_path_square(s, &x, &y);
+		uint8_t object = get_object_at(x, y);
+		uint8_t type = get_object_type(object);
+		landing[s] = s;
+		if (type != SNAKE_START && type != LADDER_START) {
+			continue;
+		}
+		uint8_t end = (type == SNAKE_START ? SNAKE_END : LADDER_END) |
+				get_object_identifier(object);
+		for (uint8_t end_x = 0; end_x < get_board_width(); end_x++) {
+			for (uint8_t end_y = 0; end_y < get_board_height(); end_y++) {
+				if (get_object_at(end_x, end_y) == end) {
+					landing[s] = get_path_position(end_x, end_y);
+				}
+			}
+		}
+	}
+}
+
+// Number of throws of the dice giving each total
+static void dice_totals(uint8_t dice, uint16_t* throws) {
+	for (uint8_t total = 0; total <= 6 * RULES_MAX_DICE; total++) {
+		throws[total] = total == 0;
+	}
+	for (uint8_t die = 0; die < dice; die++) {
+		for (int8_t total = 6 * (die + 1); total >= 0; total--) {
+			throws[total] = 0;
+			for (uint8_t face = 1; face <= 6 && face <= total; face++) {
+				throws[total] += throws[total - face];
+			}
+		}
+	}
+}
+
+static void expected_turns(const uint16_t* landing, uint8_t dice,
+		double* turns) {
+	uint16_t finish = get_board_squares() - 1;
+	uint16_t throws[6 * RULES_MAX_DICE + 1];
+	double all_throws = pow(6, dice);
+	dice_totals(dice, throws);
+	for (uint16_t s = 0; s <= finish; s++) {
+		turns[s] = 0;
+	}
+	double change = 1;
+	while (change > 1e-9) {
+		change = 0;
+		for (int16_t s = finish - 1; s >= 0; s--) {
+			double total = 0;
+			for (uint8_t roll = dice; roll <= 6 * dice; roll++) {
+				uint16_t next = s + roll > finish ? finish : s + roll;
+				total += throws[roll] * turns[landing[next]];
+			}
+			double value = 1 + total / all_throws;
+			change = fmax(change, fabs(value - turns[s]));
+			turns[s] = value;
+		}
+	}
+}
+
+// Print a table of the board's values, twelve to a line
+static void print_table(const char* name, uint8_t number,
+		const uint16_t* values) {
+	uint16_t squares = get_board_squares();
+	printf("static const uint16_t board%u_%s[%u] PROGMEM = {", number + 1,
+			name, squares);
+	for (uint16_t s = 0; s < squares; s++) {
+		printf("%s%u%s", s % 12 ? "" : "\n\t", values[s],
+				s < squares - 1 ? (s % 12 == 11 ? "," : ", ") : "");
+	}
+	printf("\n};\n\n");
+}
+
+int main(void) {
+	printf("/*\n"
+			" * ai_values.c\n"
+			" *\n"
+			" * Generated by host/ai/ai_values - do not edit.\n"
+			" */\n"
+			"\n"
+			"#include \"ai.h\"\n"
+			"\n");
+	double start_turns[NUM_BOARDS][RULES_MAX_DICE];
+	for (uint8_t number = 0; number < NUM_BOARDS; number++) {
+		uint16_t landing[BOARD_MAX_WIDTH * BOARD_MAX_HEIGHT];
+		double turns[BOARD_MAX_WIDTH * BOARD_MAX_HEIGHT];
+		uint16_t values[BOARD_MAX_WIDTH * BOARD_MAX_HEIGHT];
+		choose_board(number);
+		find_landings(landing);
+		for (uint8_t dice = 1; dice <= RULES_MAX_DICE; dice++) {
+			char name[16];
+			expected_turns(landing, dice, turns);
+			start_turns[number][dice - 1] = turns[0];
+			for (uint16_t s = 0; s < get_board_squares(); s++) {
+				values[s] = lround(turns[s] * AI_TURN);
+			}
+			snprintf(name, sizeof(name), "turns%u", dice);
+			print_table(name, number, values);
+		}
+		print_table("landing", number, landing);
+	}
+	printf("const AiBoard ai_boards[NUM_BOARDS] PROGMEM = {\n");
+	for (uint8_t number = 0; number < NUM_BOARDS; number++) {
+		choose_board(number);
+		printf("\t// Board %u: turns from the start", number + 1);
+		for (uint8_t dice = 1; dice <= RULES_MAX_DICE; dice++) {
+			printf("%s %.2f with %u %s", dice > 1 ? "," : "",
+					start_turns[number][dice - 1], dice,
+					dice > 1 ? "dice" : "die");
+		}
+		printf("\n\t{%u, {", get_board_squares());
+		for (uint8_t dice = 1; dice <= RULES_MAX_DICE; dice++) {
+			printf("%sboard%u_turns%u", dice > 1 ? ", " : "", number + 1,
+					dice);
+		}
+		printf("}, board%u_landing}%s\n", number + 1,
+				number < NUM_BOARDS - 1 ? "," : "");
+	}
+	printf("};\n");
+	return 0;
+}
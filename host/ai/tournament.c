@@ -0,0 +1,721 @@
+/*
+ * tournament.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * Plays round robin tournaments between computer opponent strategies on
+ * every board, to compare them over many thousands of games. Every pair of
+ * strategies plays the same number of games on each board from each seat
+ * (first or second to move), and the results are turned into Elo ratings
+ * with 95% confidence intervals.
+ *
+ * Games use the same model of the rules as the firmware's computer opponent
+ * (ai.c): a player's square along the path, the landing table from
+ * ai_values.c for the snakes and ladders, and a choice each turn between
+ * stepping 1, stepping 2 and rolling. Games are played under the standard
+ * rules - one die, and going past the finish stops on it.
+ *
+ * Games are numbered, and everything about a game - the strategies, board,
+ * seat and dice - comes from its number and the base seed, so a tournament
+ * gives the same results however many threads play it. The two games of a
+ * pairing that differ only in seat get the same dice, which takes much of
+ * the luck out of the comparison.
+ *
+ * The games are split into chunks, which are dealt out to the threads in
+ * contiguous ranges. A thread plays its own chunks from the back of its
+ * range and, when it runs out, steals half of what's left at the front of
+ * another thread's range. The chunks are in pairing order and the deeper
+ * searches take far longer, so without stealing the threads that were
+ * dealt those pairings would finish long after the rest.
+ *
+ * Usage: tournament [-g games] [-j threads] [-s seed] [-o file] [-b]
+ *        tournament -r file
+ *   -g games    games per pairing, board and seat (default 500)
+ *   -j threads  threads to play on (default: one per core)
+ *   -s seed     base seed (default 1)
+ *   -o file     write every game to file as it's played (format below)
+ *   -r file     report the ratings from a file written with -o
+ *   -b          benchmark: play the tournament on 1, 2, 4... threads up to
+ *               -j and report the games per second and speedup of each
+ *
+ * The output file is little endian. It starts with
+ *   "SLT1", strategies (1 byte), boards (1 byte), games (4 bytes),
+ *   seed (8 bytes), the strategy names (each ending with a 0 byte)
+ * followed by a block for each chunk, in the order they finish:
+ *   first game number (4 bytes), games in the block (2 bytes),
+ *   then the columns, one entry per game:
+ *     first player's strategy (1 byte each)
+ *     second player's strategy (1 byte each)
+ *     board (1 byte each)
+ *     winner: 0 first player, 1 second player, 2 nobody (1 byte each)
+ *     turns taken by both players together (2 bytes each)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "ai.h"
+
+// Games in a chunk - the unit of work and of the output file
+#define CHUNK_GAMES 256
+
+// A game not won after this many turns (both players together) is a draw
+#define MAX_TURNS 2000
+
+#define MAX_THREADS 256
+#define MAX_STRATEGIES 16
+
+#define RESULT_FIRST	0
+#define RESULT_SECOND	1
+#define RESULT_DRAW		2
+
+// Options for a turn, as in ai.c
+#define OPTION_STEP_1	0
+#define OPTION_STEP_2	1
+#define OPTION_ROLL		2
+#define NUM_OPTIONS		3
+
+typedef struct {
+	uint64_t state;
+} Rng;
+
+typedef struct {
+	const char* name;
+	// Search depth for expectimax, 0 for the fixed strategies
+	uint8_t depth;
+	uint8_t (*choose)(const AiBoard* board, uint16_t square, uint8_t depth,
+			Rng* rng);
+} Strategy;
+
+typedef struct {
+	uint8_t first;
+	uint8_t second;
+	uint8_t board;
+	uint8_t result;
+	uint16_t turns;
+} Game;
+
+// Games each strategy won, lost and drew against each other
+typedef struct {
+	double score[MAX_STRATEGIES][MAX_STRATEGIES];	// wins plus half the draws
+	uint32_t played[MAX_STRATEGIES][MAX_STRATEGIES];
+	uint64_t first_wins;
+	uint64_t decided;
+	uint64_t turns;
+	uint64_t games;
+	uint64_t checksum;
+} Tally;
+
+// A thread's remaining chunks, [front, back)
+typedef struct {
+	pthread_mutex_t lock;
+	uint32_t front;
+	uint32_t back;
+} Range;
+
+typedef struct {
+	pthread_t thread;
+	uint32_t number;
+	Tally tally;
+	uint32_t steals;
+} Worker;
+
+static uint8_t choose_roll(const AiBoard* board, uint16_t square,
+		uint8_t depth, Rng* rng);
+static uint8_t choose_random(const AiBoard* board, uint16_t square,
+		uint8_t depth, Rng* rng);
+static uint8_t choose_expectimax(const AiBoard* board, uint16_t square,
+		uint8_t depth, Rng* rng);
+
+static const Strategy strategies[] = {
+	{"random", 0, choose_random},
+	{"roll", 0, choose_roll},
+	{"greedy", 1, choose_expectimax},
+	{"expectimax-2", 2, choose_expectimax},
+	{"expectimax-3", 3, choose_expectimax},
+};
+#define NUM_STRATEGIES (sizeof(strategies) / sizeof(strategies[0]))
+#define NUM_PAIRS (NUM_STRATEGIES * (NUM_STRATEGIES - 1) / 2)
+
+// The tournament being played
+static uint32_t games_per_seat;
+static uint64_t base_seed;
+static uint32_t num_games;
+static uint32_t num_chunks;
+static uint8_t pairs[NUM_PAIRS][2];
+
+static Range ranges[MAX_THREADS];
+static uint32_t num_workers;
+
+static FILE* output;
+static pthread_mutex_t output_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// splitmix64 - small, fast, and any seed is a good one
+static uint64_t next_random(Rng* rng) {
+	uint64_t z = (rng->state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+// A number from 0 to n - 1
+static uint8_t random_below(Rng* rng, uint8_t n) {
+	return ((next_random(rng) >> 32) * n) >> 32;
+}
+
+static uint16_t step(const AiBoard* board, uint16_t square, uint8_t n) {
+	uint16_t finish = board->squares - 1;
+	square = square + n > finish ? finish : square + n;
+	return board->landing[square];
+}
+
+static uint16_t option_turns(const AiBoard* board, uint16_t square,
+		uint8_t option, uint8_t depth);
+
+// Fewest expected turns (times AI_TURN) to the finish from square, looking
+// depth turns ahead - the same search as ai.c without the time limit
+static uint16_t best_turns(const AiBoard* board, uint16_t square,
+		uint8_t depth) {
+	if (square == board->squares - 1) {
+		return 0;
+	}
+	if (depth == 0) {
+		return board->turns[0][square];
+	}
+	uint16_t best = UINT16_MAX;
+	for (uint8_t option = 0; option < NUM_OPTIONS; option++) {
+		uint16_t turns = option_turns(board, square, option, depth);
+		if (turns < best) {
+			best = turns;
+		}
+	}
+	return best;
+}
+
+static uint16_t option_turns(const AiBoard* board, uint16_t square,
+		uint8_t option, uint8_t depth) {
+	if (option == OPTION_ROLL) {
+		uint16_t total = 0;
+		for (uint8_t roll = 1; roll <= 6; roll++) {
+			total += best_turns(board, step(board, square, roll), depth - 1);
+		}
+		return AI_TURN + (total + 3) / 6;
+	}
+	return AI_TURN + best_turns(board, step(board, square, option + 1),
+			depth - 1);
+}
+
+static uint8_t choose_expectimax(const AiBoard* board, uint16_t square,
+		uint8_t depth, Rng* rng) {
+	(void)rng;
+	uint8_t choice = OPTION_ROLL;
+	uint16_t best = UINT16_MAX;
+	for (uint8_t option = 0; option < NUM_OPTIONS; option++) {
+		uint16_t turns = option_turns(board, square, option, depth);
+		if (turns < best) {
+			best = turns;
+			choice = option;
+		}
+	}
+	return choice;
+}
+
+static uint8_t choose_roll(const AiBoard* board, uint16_t square,
+		uint8_t depth, Rng* rng) {
+	(void)board;
+	(void)square;
+	(void)depth;
+	(void)rng;
+	return OPTION_ROLL;
+}
+
+static uint8_t choose_random(const AiBoard* board, uint16_t square,
+		uint8_t depth, Rng* rng) {
+	(void)board;
+	(void)square;
+	(void)depth;
+	return random_below(rng, NUM_OPTIONS);
+}
+
+// Game number n is game n % games_per_seat of its seat, board and pairing
+static void play_game(uint32_t n, Game* game) {
+	uint32_t rest = n / games_per_seat;
+	uint8_t seat = rest % 2;
+	rest /= 2;
+	game->board = rest % NUM_BOARDS;
+	const uint8_t* pair = pairs[rest / NUM_BOARDS];
+	game->first = pair[seat];
+	game->second = pair[1 - seat];
+
+	// Each player's dice (and random choices) come from their own stream,
+	// and swapping seats swaps the streams
+	uint32_t shared = n - seat * games_per_seat;
+	Rng rng[2];
+	Rng seeder = {base_seed ^ ((uint64_t)shared << 20)};
+	rng[seat] = (Rng){next_random(&seeder)};
+	rng[1 - seat] = (Rng){next_random(&seeder)};
+
+	const AiBoard* board = &ai_boards[game->board];
+	uint16_t square[2] = {0, 0};
+	uint8_t players[2] = {game->first, game->second};
+	game->result = RESULT_DRAW;
+	for (game->turns = 0; game->turns < MAX_TURNS; game->turns++) {
+		uint8_t player = game->turns % 2;
+		const Strategy* strategy = &strategies[players[player]];
+		uint8_t option = strategy->choose(board, square[player],
+				strategy->depth, &rng[player]);
+		uint8_t n = option == OPTION_ROLL ?
+				random_below(&rng[player], 6) + 1 : option + 1;
+		square[player] = step(board, square[player], n);
+		if (square[player] == board->squares - 1) {
+			game->result = player;
+			game->turns++;
+			break;
+		}
+	}
+}
+
+static void tally_game(Tally* tally, uint32_t n, const Game* game) {
+	uint8_t a = game->first;
+	uint8_t b = game->second;
+	tally->played[a][b]++;
+	tally->played[b][a]++;
+	if (game->result == RESULT_DRAW) {
+		tally->score[a][b] += 0.5;
+		tally->score[b][a] += 0.5;
+	} else {
+		tally->score[game->result == RESULT_FIRST ? a : b]
+				[game->result == RESULT_FIRST ? b : a] += 1;
+		tally->decided++;
+		tally->first_wins += game->result == RESULT_FIRST;
+	}
+	tally->turns += game->turns;
+	tally->games++;
+	// Added up in any order this comes out the same, so runs on different
+	// numbers of threads can be checked against each other
+	Rng mix = {((uint64_t)n << 32) ^ ((uint64_t)game->result << 16) ^
+			game->turns};
+	tally->checksum += next_random(&mix);
+}
+
+static void merge_tally(Tally* into, const Tally* from) {
+	for (uint8_t a = 0; a < NUM_STRATEGIES; a++) {
+		for (uint8_t b = 0; b < NUM_STRATEGIES; b++) {
+			into->score[a][b] += from->score[a][b];
+			into->played[a][b] += from->played[a][b];
+		}
+	}
+	into->first_wins += from->first_wins;
+	into->decided += from->decided;
+	into->turns += from->turns;
+	into->games += from->games;
+	into->checksum += from->checksum;
+}
+
+static void put_le(uint8_t* p, uint64_t value, uint8_t bytes) {
+	for (uint8_t i = 0; i < bytes; i++) {
+		p[i] = value >> (8 * i);
+	}
+}
+
+static uint64_t get_le(const uint8_t* p, uint8_t bytes) {
+	uint64_t value = 0;
+	for (uint8_t i = 0; i < bytes; i++) {
+		value |= (uint64_t)p[i] << (8 * i);
+	}
+	return value;
+}
+
+static void write_header(void) {
+	uint8_t header[18];
+	memcpy(header, "SLT1", 4);
+	header[4] = NUM_STRATEGIES;
+	header[5] = NUM_BOARDS;
+	put_le(header + 6, games_per_seat, 4);
+	put_le(header + 10, base_seed, 8);
+	fwrite(header, 1, sizeof(header), output);
+	for (uint8_t i = 0; i < NUM_STRATEGIES; i++) {
+		fwrite(strategies[i].name, 1, strlen(strategies[i].name) + 1, output);
+	}
+}
+
+static void write_block(uint32_t first, const Game* games, uint16_t count) {
+	uint8_t block[6 + CHUNK_GAMES * 6];
+	put_le(block, first, 4);
+	put_le(block + 4, count, 2);
+	uint8_t* column = block + 6;
+	for (uint16_t i = 0; i < count; i++) {
+		column[i] = games[i].first;
+		column[count + i] = games[i].second;
+		column[2 * count + i] = games[i].board;
+		column[3 * count + i] = games[i].result;
+		put_le(column + 4 * count + 2 * i, games[i].turns, 2);
+	}
+	pthread_mutex_lock(&output_lock);
+	fwrite(block, 1, 6 + count * 6, output);
+	pthread_mutex_unlock(&output_lock);
+}
+
+static void play_chunk(Worker* worker, uint32_t chunk) {
+	Game games[CHUNK_GAMES];
+	uint32_t first = chunk * CHUNK_GAMES;
+	uint16_t count = num_games - first < CHUNK_GAMES ?
+			num_games - first : CHUNK_GAMES;
+	for (uint16_t i = 0; i < count; i++) {
+		play_game(first + i, &games[i]);
+		tally_game(&worker->tally, first + i, &games[i]);
+	}
+	if (output) {
+		write_block(first, games, count);
+	}
+}
+
+// Take the last chunk of the worker's own range. Returns 0 if it's empty.
+static int take_own(uint32_t number, uint32_t* chunk) {
+	Range* range = &ranges[number];
+	pthread_mutex_lock(&range->lock);
+	int found = range->front < range->back;
+	if (found) {
+		*chunk = --range->back;
+	}
+	pthread_mutex_unlock(&range->lock);
+	return found;
+}
+
+// Move the front half of another worker's chunks into this worker's range.
+// Returns 0 if there was nothing left anywhere.
+static int steal(Worker* worker) {
+	for (uint32_t i = 1; i < num_workers; i++) {
+		Range* victim = &ranges[(worker->number + i) % num_workers];
+		pthread_mutex_lock(&victim->lock);
+		uint32_t left = victim->back - victim->front;
+		if (left == 0) {
+			pthread_mutex_unlock(&victim->lock);
+			continue;
+		}
+		uint32_t front = victim->front;
+		uint32_t taken = (left + 1) / 2;
+		victim->front += taken;
+		pthread_mutex_unlock(&victim->lock);
+
+		Range* own = &ranges[worker->number];
+		pthread_mutex_lock(&own->lock);
+		own->front = front;
+		own->back = front + taken;
+		pthread_mutex_unlock(&own->lock);
+		worker->steals++;
+		return 1;
+	}
+	return 0;
+}
+
+static void* run_worker(void* argument) {
+	Worker* worker = argument;
+	uint32_t chunk;
+	do {
+		while (take_own(worker->number, &chunk)) {
+			play_chunk(worker, chunk);
+		}
+	} while (steal(worker));
+	return NULL;
+}
+
+// Play every game on threads threads and add up the results. Returns the
+// time taken in seconds.
+static double play_tournament(uint32_t threads, Tally* total,
+		uint32_t* steals) {
+	static Worker workers[MAX_THREADS];
+	num_workers = threads;
+	for (uint32_t i = 0; i < threads; i++) {
+		pthread_mutex_init(&ranges[i].lock, NULL);
+		ranges[i].front = (uint64_t)num_chunks * i / threads;
+		ranges[i].back = (uint64_t)num_chunks * (i + 1) / threads;
+		memset(&workers[i], 0, sizeof(Worker));
+		workers[i].number = i;
+	}
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (uint32_t i = 0; i < threads; i++) {
+		pthread_create(&workers[i].thread, NULL, run_worker, &workers[i]);
+	}
+	memset(total, 0, sizeof(Tally));
+	*steals = 0;
+	for (uint32_t i = 0; i < threads; i++) {
+		pthread_join(workers[i].thread, NULL);
+		merge_tally(total, &workers[i].tally);
+		*steals += workers[i].steals;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	// Not until every thread has finished - they can still be looking for
+	// chunks to steal after their own have run out
+	for (uint32_t i = 0; i < threads; i++) {
+		pthread_mutex_destroy(&ranges[i].lock);
+	}
+	return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+// Elo ratings (averaging 1500) from the Bradley-Terry model fitted by
+// minorisation-maximisation, with 95% confidence intervals from the
+// curvature of the likelihood at the fit. Draws count as half a win each.
+static void report(const Tally* tally, const char* const* names,
+		uint8_t count) {
+	double strength[MAX_STRATEGIES];
+	double error[MAX_STRATEGIES];
+	for (uint8_t i = 0; i < count; i++) {
+		strength[i] = 1;
+	}
+	for (uint16_t iteration = 0; iteration < 10000; iteration++) {
+		double change = 0;
+		for (uint8_t i = 0; i < count; i++) {
+			double wins = 0, expected = 0;
+			for (uint8_t j = 0; j < count; j++) {
+				if (j != i && tally->played[i][j]) {
+					wins += tally->score[i][j];
+					expected += tally->played[i][j] / (strength[i] + strength[j]);
+				}
+			}
+			// A strategy that never wins would go to zero - stop it short
+			double updated = expected ? fmax(wins / expected, 1e-9) : 1;
+			change = fmax(change, fabs(log(updated / strength[i])));
+			strength[i] = updated;
+		}
+		double mean = 0;
+		for (uint8_t i = 0; i < count; i++) {
+			mean += log(strength[i]) / count;
+		}
+		for (uint8_t i = 0; i < count; i++) {
+			strength[i] /= exp(mean);
+		}
+		if (change < 1e-10) {
+			break;
+		}
+	}
+	for (uint8_t i = 0; i < count; i++) {
+		double information = 0;
+		for (uint8_t j = 0; j < count; j++) {
+			if (j != i) {
+				double p = strength[i] / (strength[i] + strength[j]);
+				information += tally->played[i][j] * p * (1 - p);
+			}
+		}
+		error[i] = information ? 1.96 / sqrt(information) : INFINITY;
+	}
+
+	double scale = 400 / log(10);
+	printf("%-14s %6s %6s %9s", "strategy", "elo", "95%", "score");
+	for (uint8_t j = 0; j < count; j++) {
+		printf(" %8.8s", names[j]);
+	}
+	putchar('\n');
+	for (uint8_t i = 0; i < count; i++) {
+		double score = 0;
+		uint32_t played = 0;
+		for (uint8_t j = 0; j < count; j++) {
+			score += tally->score[i][j];
+			played += tally->played[i][j];
+		}
+		printf("%-14s %6.0f %6.1f %8.2f%%", names[i],
+				1500 + scale * log(strength[i]), scale * error[i],
+				played ? 100 * score / played : 0);
+		for (uint8_t j = 0; j < count; j++) {
+			if (j == i || !tally->played[i][j]) {
+				printf(" %8s", "-");
+			} else {
+				printf(" %7.2f%%",
+						100 * tally->score[i][j] / tally->played[i][j]);
+			}
+		}
+		putchar('\n');
+	}
+	printf("%llu games, %.1f turns each, first player won %.2f%%\n",
+			(unsigned long long)tally->games,
+			tally->games ? (double)tally->turns / tally->games : 0,
+			tally->decided ? 100.0 * tally->first_wins / tally->decided : 0);
+}
+
+static int read_results(const char* filename) {
+	FILE* file = fopen(filename, "rb");
+	if (!file) {
+		perror(filename);
+		return -1;
+	}
+	uint8_t header[18];
+	if (fread(header, 1, sizeof(header), file) != sizeof(header) ||
+			memcmp(header, "SLT1", 4)) {
+		fprintf(stderr, "tournament: %s isn't a tournament file\n", filename);
+		fclose(file);
+		return -1;
+	}
+	uint8_t count = header[4];
+	if (count > MAX_STRATEGIES) {
+		fprintf(stderr, "tournament: %s has too many strategies\n", filename);
+		fclose(file);
+		return -1;
+	}
+	char names[MAX_STRATEGIES][32];
+	const char* name_list[MAX_STRATEGIES];
+	for (uint16_t i = 0; i < count; i++) {
+		int c;
+		uint8_t length = 0;
+		while ((c = fgetc(file)) > 0) {
+			if (length < sizeof(names[i]) - 1) {
+				names[i][length++] = c;
+			}
+		}
+		names[i][length] = 0;
+		name_list[i] = names[i];
+	}
+	printf("games %u per pairing, board and seat, seed %llu\n",
+			(unsigned)get_le(header + 6, 4),
+			(unsigned long long)get_le(header + 10, 8));
+
+	static Tally tally;
+	static uint8_t block[6 + 65535 * 6];
+	while (fread(block, 1, 6, file) == 6) {
+		uint32_t first = get_le(block, 4);
+		uint16_t games = get_le(block + 4, 2);
+		const uint8_t* column = block + 6;
+		if (fread(block + 6, 1, games * 6, file) != games * 6u) {
+			fprintf(stderr, "tournament: %s is cut short\n", filename);
+			break;
+		}
+		for (uint16_t i = 0; i < games; i++) {
+			Game game = {column[i], column[games + i], column[2 * games + i],
+					column[3 * games + i],
+					get_le(column + 4 * games + 2 * i, 2)};
+			if (game.first < count && game.second < count) {
+				tally_game(&tally, first + i, &game);
+			}
+		}
+	}
+	fclose(file);
+	report(&tally, name_list, count);
+	printf("checksum %016llx\n", (unsigned long long)tally.checksum);
+	return 0;
+}
+
+static void benchmark(uint32_t max_threads) {
+	static Tally tally;
+	uint32_t steals;
+	double base_rate = 0;
+	uint64_t checksum = 0;
+	printf("%7s %10s %12s %8s %10s %7s\n", "threads", "seconds", "games/s",
+			"speedup", "efficiency", "steals");
+	for (uint32_t threads = 1; ; threads *= 2) {
+		if (threads > max_threads) {
+			threads = max_threads;
+		}
+		double seconds = play_tournament(threads, &tally, &steals);
+		double rate = num_games / seconds;
+		if (threads == 1) {
+			base_rate = rate;
+			checksum = tally.checksum;
+		}
+		printf("%7u %10.3f %12.0f %7.2fx %9.1f%% %7u%s\n", threads, seconds,
+				rate, rate / base_rate, 100 * rate / base_rate / threads, steals,
+				tally.checksum == checksum ? "" : "  RESULTS DIFFER");
+		if (threads == max_threads) {
+			break;
+		}
+	}
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	printf("%ld core%s\n", cores, cores == 1 ? "" : "s");
+}
+
+static void usage(void) {
+	fprintf(stderr, "usage: tournament [-g games] [-j threads] [-s seed] "
+			"[-o file] [-b]\n       tournament -r file\n");
+	exit(2);
+}
+
+int main(int argc, char** argv) {
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	uint32_t threads = cores > 0 ? cores : 1;
+	const char* output_file = NULL;
+	const char* results_file = NULL;
+	uint8_t bench = 0;
+	games_per_seat = 500;
+	base_seed = 1;
+	int option;
+	while ((option = getopt(argc, argv, "g:j:s:o:r:b")) != -1) {
+		switch (option) {
+			case 'g':
+				games_per_seat = strtoul(optarg, NULL, 0);
+				break;
+			case 'j':
+				threads = strtoul(optarg, NULL, 0);
+				break;
+			case 's':
+				base_seed = strtoull(optarg, NULL, 0);
+				break;
+			case 'o':
+				output_file = optarg;
+				break;
+			case 'r':
+				results_file = optarg;
+				break;
+			case 'b':
+				bench = 1;
+				break;
+			default:
+				usage();
+		}
+	}
+	if (optind != argc || games_per_seat == 0 || threads == 0) {
+		usage();
+	}
+	if (results_file) {
+		return read_results(results_file) < 0 ? 1 : 0;
+	}
+	if (threads > MAX_THREADS) {
+		threads = MAX_THREADS;
+	}
+
+	uint8_t pair = 0;
+	for (uint8_t a = 0; a < NUM_STRATEGIES; a++) {
+		for (uint8_t b = a + 1; b < NUM_STRATEGIES; b++) {
+			pairs[pair][0] = a;
+			pairs[pair][1] = b;
+			pair++;
+		}
+	}
+	uint64_t total = (uint64_t)NUM_PAIRS * NUM_BOARDS * 2 * games_per_seat;
+	if (total > UINT32_MAX - CHUNK_GAMES) {
+		fprintf(stderr, "tournament: too many games\n");
+		return 2;
+	}
+	num_games = total;
+	num_chunks = (num_games + CHUNK_GAMES - 1) / CHUNK_GAMES;
+
+	if (bench) {
+		benchmark(threads);
+		return 0;
+	}
+	if (output_file) {
+		output = fopen(output_file, "wb");
+		if (!output) {
+			perror(output_file);
+			return 2;
+		}
+		write_header();
+	}
+	static Tally tally;
+	uint32_t steals;
+	double seconds = play_tournament(threads, &tally, &steals);
+	if (output) {
+		fclose(output);
+	}
+	const char* names[NUM_STRATEGIES];
+	for (uint8_t i = 0; i < NUM_STRATEGIES; i++) {
+		names[i] = strategies[i].name;
+	}
+	report(&tally, names, NUM_STRATEGIES);
+	printf("checksum %016llx, %.2fs on %u thread%s (%.0f games/s)\n",
+			(unsigned long long)tally.checksum, seconds, threads,
+			threads == 1 ? "" : "s", num_games / seconds);
+	return 0;
+}
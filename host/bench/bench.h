@@ -0,0 +1,55 @@
+/*
+ * bench.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * Shared by the benchmark firmware (bench_main.c) and the simavr runner
+ * (bench_run.c). The firmware marks where each scenario starts and ends by
+ * writing to GPIOR0, which nothing else uses:
+ *   scenario number    the scenario starts (cycles, SPI and UART bytes
+ *                      are counted from here)
+ *   BENCH_MARK_END     stop counting cycles and SPI bytes
+ *   BENCH_MARK_DRAINED the serial output has all been sent - stop counting
+ *                      UART bytes
+ *   BENCH_MARK_DONE    every scenario has been run
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include "rules.h"
+
+#define BENCH_MOVE_PLAYER_N		1
+#define BENCH_LADDER			2
+#define BENCH_CHOOSE_BOARD		3
+#define BENCH_WINNER			4
+#define BENCH_MAIN_LOOP			5
+// Then one scenario for each rule set in rules.h
+#define BENCH_RULES				6
+#define BENCH_NUM_SCENARIOS		(5 + NUM_RULE_SETS)
+
+#define BENCH_MARK_END			0x80
+#define BENCH_MARK_DRAINED		0x81
+#define BENCH_MARK_DONE			0xFF
+
+// Passes of the run_game() loop in the BENCH_MAIN_LOOP scenario. The
+// firmware is built with BENCH_MAIN_LOOPS set to this.
+#define BENCH_LOOPS 1000
+
+// Moves planned in each rule set's scenario - every square on the board
+// with each of the rolls 1 to 6 in turn. Dividing the cycles by this gives
+// the cost of planning one move under those rules.
+#define BENCH_RULE_MOVES 128
+
+// Scenario names, in number order
+#define BENCH_RULES_NAME(id, name, options, dice) "rules: " name,
+#define BENCH_SCENARIO_NAMES { \
+	"move_player_n(6)", \
+	"ladder climb", \
+	"choose_board", \
+	"winner screen", \
+	"1000 main loops", \
+	RULE_SETS(BENCH_RULES_NAME) \
+}
+
+#endif /* BENCH_H_ */
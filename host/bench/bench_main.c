@@ -0,0 +1,110 @@
+/*
+ * bench_main.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * main() for the benchmark firmware. The rest of the firmware is linked in
+ * unchanged (with project.c's main() renamed) and this runs each scenario
+ * in bench.h once, marking it out for the simulator with GPIOR0.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include "bench.h"
+#include "game.h"
+#include "project.h"
+#include "serialio.h"
+#include "rules.h"
+
+// From project.c
+void initialise_hardware(void);
+void new_game(void);
+
+// From game.c
+extern int8_t player_1_x;
+extern int8_t player_1_y;
+extern int winner;
+
+// Output left over from the last scenario would be counted against this
+// one, so wait for it first
+static void scenario_start(uint8_t scenario) {
+	serial_wait_for_output();
+	GPIOR0 = scenario;
+}
+
+static void scenario_end(void) {
+	GPIOR0 = BENCH_MARK_END;
+	serial_wait_for_output();
+	GPIOR0 = BENCH_MARK_DRAINED;
+}
+
+// Put player 1 on the start of the first ladder on the board
+static void move_to_ladder(void) {
+	for (uint8_t x = 0; x < WIDTH; x++) {
+		for (uint8_t y = 0; y < HEIGHT; y++) {
+			if (get_object_type(get_object_at(x, y)) == LADDER_START) {
+				player_1_x = x;
+				player_1_y = y;
+				return;
+			}
+		}
+	}
+}
+
+// Plan a move from every square under the selected rules. The results go
+// somewhere volatile so none of the work can be left out.
+static void plan_moves(void) {
+	static volatile RuleMove result;
+	RuleMove move;
+	for (uint8_t square = 0; square < BENCH_RULE_MOVES; square++) {
+		rules_plan_move(square, square % 6 + 1, square % 6 == 5, &move);
+		result = move;
+	}
+}
+
+int main(void) {
+	initialise_hardware();
+	new_game();
+
+	scenario_start(BENCH_MOVE_PLAYER_N);
+	move_player_n(6);
+	scenario_end();
+
+	new_game();
+	move_to_ladder();
+	scenario_start(BENCH_LADDER);
+	check_snake_ladder();
+	scenario_end();
+
+	scenario_start(BENCH_CHOOSE_BOARD);
+	choose_board(1);
+	scenario_end();
+	choose_board(0);
+
+	winner = 1;
+	scenario_start(BENCH_WINNER);
+	show_winner();
+	scenario_end();
+	winner = 0;
+
+	new_game();
+	scenario_start(BENCH_MAIN_LOOP);
+	run_game(STATE_PLAYING);
+	scenario_end();
+
+	for (uint8_t rule_set = 0; rule_set < NUM_RULE_SETS; rule_set++) {
+		rules_select(rule_set);
+		scenario_start(BENCH_RULES + rule_set);
+		plan_moves();
+		scenario_end();
+	}
+	rules_select(RULES_STANDARD);
+
+	GPIOR0 = BENCH_MARK_DONE;
+	// Sleeping with interrupts off ends the simulation
+	cli();
+	sleep_mode();
+	for (;;) {
+	}
+}
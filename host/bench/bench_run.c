@@ -0,0 +1,272 @@
+/*
+ * bench_run.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * Runs the benchmark firmware under simavr and reports the cycles, SPI
+ * bytes (LED matrix) and UART bytes (terminal) of each scenario. Cycles
+ * include any interrupts that ran during the scenario, and the time spent
+ * in the firmware's own delays.
+ *
+ * Usage: bench_run [-m mcu] [-b baseline] [-w results] [-t percent] elf
+ *   -m mcu       simavr core to run on (default atmega324p)
+ *   -b baseline  compare with the results in baseline
+ *   -w results   write the results to a file (to use as a baseline)
+ *   -t percent   allowed increase in cycles before it counts as a
+ *                regression (default 1)
+ *
+ * The exit status is 1 if any scenario is slower than the baseline by
+ * more than the allowed amount, sends more bytes, or isn't in the
+ * baseline at all.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+#include <simavr/sim_io.h>
+#include <simavr/avr_uart.h>
+#include <simavr/avr_spi.h>
+#include "bench.h"
+
+// Data space address of GPIOR0 on the ATmega324
+#define GPIOR0_ADDRESS 0x3E
+
+// Give up if the firmware runs for longer than this (a minute at 8MHz)
+#define CYCLE_LIMIT (60ULL * 8000000)
+
+typedef struct {
+	uint64_t cycles;
+	uint32_t spi_bytes;
+	uint32_t uart_bytes;
+	uint8_t ran;
+} Result;
+
+static const char* scenario_names[] = BENCH_SCENARIO_NAMES;
+
+static Result results[BENCH_NUM_SCENARIOS + 1];
+static uint8_t scenario;			// 0 when between scenarios
+static uint8_t counting_spi;
+static uint8_t counting_uart;
+static uint64_t start_cycle;
+static uint8_t done;
+
+static void marker_write(struct avr_t* avr, avr_io_addr_t address,
+		uint8_t value, void* param) {
+	(void)param;
+	avr->data[address] = value;
+	if (value >= 1 && value <= BENCH_NUM_SCENARIOS) {
+		scenario = value;
+		memset(&results[scenario], 0, sizeof(Result));
+		start_cycle = avr->cycle;
+		counting_spi = 1;
+		counting_uart = 1;
+	} else if (value == BENCH_MARK_END && scenario) {
+		results[scenario].cycles = avr->cycle - start_cycle;
+		counting_spi = 0;
+	} else if (value == BENCH_MARK_DRAINED && scenario) {
+		results[scenario].ran = 1;
+		counting_uart = 0;
+		scenario = 0;
+	} else if (value == BENCH_MARK_DONE) {
+		done = 1;
+	}
+}
+
+static void spi_output(struct avr_irq_t* irq, uint32_t value, void* param) {
+	(void)irq;
+	(void)value;
+	(void)param;
+	if (counting_spi) {
+		results[scenario].spi_bytes++;
+	}
+}
+
+static void uart_output(struct avr_irq_t* irq, uint32_t value, void* param) {
+	(void)irq;
+	(void)value;
+	(void)param;
+	if (counting_uart) {
+		results[scenario].uart_bytes++;
+	}
+}
+
+static int run(const char* elf, const char* mcu) {
+	elf_firmware_t firmware;
+	memset(&firmware, 0, sizeof(firmware));
+	if (elf_read_firmware(elf, &firmware)) {
+		fprintf(stderr, "bench_run: can't load %s\n", elf);
+		return -1;
+	}
+	snprintf(firmware.mmcu, sizeof(firmware.mmcu), "%s", mcu);
+	firmware.frequency = 8000000;
+
+	avr_t* avr = avr_make_mcu_by_name(firmware.mmcu);
+	if (!avr) {
+		fprintf(stderr, "bench_run: simavr doesn't know %s\n", mcu);
+		return -1;
+	}
+	avr_init(avr);
+	avr_load_firmware(avr, &firmware);
+
+	// Count the UART's output rather than printing it
+	uint32_t flags = 0;
+	avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+	flags &= ~AVR_UART_FLAG_STDIO;
+	avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+	avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'),
+			UART_IRQ_OUTPUT), uart_output, NULL);
+	avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_SPI_GETIRQ(0),
+			SPI_IRQ_OUTPUT), spi_output, NULL);
+	avr_register_io_write(avr, GPIOR0_ADDRESS, marker_write, NULL);
+
+	while (!done) {
+		int state = avr_run(avr);
+		if (state == cpu_Done || state == cpu_Crashed) {
+			break;
+		}
+		if (avr->cycle > CYCLE_LIMIT) {
+			fprintf(stderr, "bench_run: still running after %llu cycles\n",
+					(unsigned long long)avr->cycle);
+			return -1;
+		}
+	}
+	if (!done) {
+		fprintf(stderr, "bench_run: the firmware stopped early\n");
+		return -1;
+	}
+	return 0;
+}
+
+// Read a baseline written with -w. Returns -1 if it can't be read.
+static int read_results(const char* filename, Result* baseline) {
+	FILE* file = fopen(filename, "r");
+	if (!file) {
+		perror(filename);
+		return -1;
+	}
+	char line[200];
+	while (fgets(line, sizeof(line), file)) {
+		unsigned number;
+		unsigned long long cycles;
+		unsigned spi, uart;
+		if (sscanf(line, "%u %llu %u %u", &number, &cycles, &spi, &uart) == 4
+				&& number >= 1 && number <= BENCH_NUM_SCENARIOS) {
+			baseline[number].cycles = cycles;
+			baseline[number].spi_bytes = spi;
+			baseline[number].uart_bytes = uart;
+			baseline[number].ran = 1;
+		}
+	}
+	fclose(file);
+	return 0;
+}
+
+static int write_results(const char* filename) {
+	FILE* file = fopen(filename, "w");
+	if (!file) {
+		perror(filename);
+		return -1;
+	}
+	fprintf(file, "# scenario cycles spi_bytes uart_bytes\n");
+	for (uint8_t i = 1; i <= BENCH_NUM_SCENARIOS; i++) {
+		fprintf(file, "%u %llu %u %u # %s\n", i,
+				(unsigned long long)results[i].cycles, results[i].spi_bytes,
+				results[i].uart_bytes, scenario_names[i - 1]);
+	}
+	fclose(file);
+	return 0;
+}
+
+// Print the results, compared with the baseline if there is one. Returns
+// the number of regressions.
+static int report(const Result* baseline, double tolerance) {
+	int regressions = 0;
+	printf("%-18s %12s %9s %10s %10s\n", "scenario", "cycles", "ms",
+			"SPI bytes", "UART bytes");
+	for (uint8_t i = 1; i <= BENCH_NUM_SCENARIOS; i++) {
+		const Result* result = &results[i];
+		if (!result->ran) {
+			printf("%-18s did not run\n", scenario_names[i - 1]);
+			regressions++;
+			continue;
+		}
+		printf("%-18s %12llu %9.2f %10u %10u", scenario_names[i - 1],
+				(unsigned long long)result->cycles, result->cycles / 8000.0,
+				result->spi_bytes, result->uart_bytes);
+		if (baseline && !baseline[i].ran) {
+			printf("  NOT IN BASELINE");
+			regressions++;
+		} else if (baseline) {
+			const Result* before = &baseline[i];
+			double change = before->cycles ?
+					100.0 * ((double)result->cycles - before->cycles) /
+					before->cycles : 0;
+			printf("  %+.2f%%", change);
+			if (result->spi_bytes != before->spi_bytes) {
+				printf(" SPI %+d", (int)(result->spi_bytes - before->spi_bytes));
+			}
+			if (result->uart_bytes != before->uart_bytes) {
+				printf(" UART %+d",
+						(int)(result->uart_bytes - before->uart_bytes));
+			}
+			if (change > tolerance || result->spi_bytes > before->spi_bytes ||
+					result->uart_bytes > before->uart_bytes) {
+				printf("  REGRESSION");
+				regressions++;
+			}
+		}
+		putchar('\n');
+	}
+	return regressions;
+}
+
+static void usage(void) {
+	fprintf(stderr, "usage: bench_run [-m mcu] [-b baseline] [-w results] "
+			"[-t percent] elf\n");
+	exit(2);
+}
+
+int main(int argc, char** argv) {
+	const char* mcu = "atmega324p";
+	const char* baseline_file = NULL;
+	const char* results_file = NULL;
+	double tolerance = 1.0;
+	int option;
+	while ((option = getopt(argc, argv, "m:b:w:t:")) != -1) {
+		switch (option) {
+			case 'm':
+				mcu = optarg;
+				break;
+			case 'b':
+				baseline_file = optarg;
+				break;
+			case 'w':
+				results_file = optarg;
+				break;
+			case 't':
+				tolerance = atof(optarg);
+				break;
+			default:
+				usage();
+		}
+	}
+	if (optind != argc - 1) {
+		usage();
+	}
+
+	Result baseline[BENCH_NUM_SCENARIOS + 1];
+	memset(baseline, 0, sizeof(baseline));
+	if (baseline_file && read_results(baseline_file, baseline) < 0) {
+		return 2;
+	}
+	if (run(argv[optind], mcu) < 0) {
+		return 2;
+	}
+	if (results_file && write_results(results_file) < 0) {
+		return 2;
+	}
+	return report(baseline_file ? baseline : NULL, tolerance) ? 1 : 0;
+}
@@ -0,0 +1,643 @@
+/*
+ * fuzz.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * Property testing of the game rules in game.c. Random sequences of inputs
+ * are played through the game.c functions project.c calls for them, and
+ * after every input these must hold:
+ *   - both players are on the board
+ *   - the player who moved is shown on exactly one square, and in a one
+ *     player game that is always player 1
+ *   - a move that lands on the start of a snake or ladder ends on the _END
+ *     square with the same identifier, and any other move stays where it
+ *     landed
+ *   - a roll or step goes as far along the path as the house rules
+ *     (rules.h) allow, and in a two player game it's then the other
+ *     player's turn unless the rules give the player another
+ *   - the game is won exactly once, by the player who reached the finish
+ * Before any of that, every board's path (game.h) must go through each of
+ * its squares once, from the start point to the finish line.
+ *
+ * The inputs (one per line in -r files) are:
+ *   new b p       start a new game on board b (from 0) with p players.
+ *                 Ignored while a game is being played, like START.
+ *   roll n        roll the dice and stop it on n
+ *   step n        button step of n squares (1 or 2)
+ *   move dx dy    move with the keys (w, a, s, d)
+ *   joystick dx dy
+ *   pause n       pause with n flashes of the cursor, then resume
+ *   rules r       choose house rules r (from 0, in the order of RULE_SETS)
+ *                 for the next game. Ignored while a game is being played.
+ *
+ * The fuzzing runs in a child process so that a crash, or a sanitizer
+ * stopping the program, is caught too. A failing sequence is shrunk to
+ * the shortest one that still fails (each attempt run in its own child),
+ * then printed and replayed to show what went wrong.
+ *
+ * Usage: fuzz [-n sequences] [-l length] [-s seed] [-o file] [-r file]
+ *   -n sequences  number of random sequences (default 100000)
+ *   -l length     most inputs in a sequence (default 200)
+ *   -s seed       random seed (default from the time)
+ *   -o file       save a failing sequence to file
+ *   -r file       run the sequence in file instead (and shrink it if it
+ *                 fails)
+ *
+ * The exit status is 1 if a sequence failed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "game_host.h"
+#include "rules.h"
+
+#define MAX_LENGTH 1000
+
+typedef enum {
+	ACTION_NEW, ACTION_ROLL, ACTION_STEP, ACTION_MOVE, ACTION_JOYSTICK,
+	ACTION_PAUSE, ACTION_RULES
+} ActionType;
+
+static const char* action_names[] = {
+	"new", "roll", "step", "move", "joystick", "pause", "rules"
+};
+
+#define RULE_SET_OPTIONS(id, name, options, dice) options,
+static const uint8_t rule_options[] = {RULE_SETS(RULE_SET_OPTIONS)};
+
+typedef struct {
+	uint8_t type;
+	int8_t arg1;
+	int8_t arg2;
+} Action;
+
+// A sequence lives in memory shared with the child processes, so the
+// parent can find out what a child was running when it died
+typedef struct {
+	uint32_t length;
+	Action actions[MAX_LENGTH];
+} Sequence;
+
+//////////////////////////////// Running //////////////////////////////////
+
+static char failure[200];
+
+static void fail(uint32_t step, const Action* action, const char* format,
+		...) {
+	int length = snprintf(failure, sizeof(failure), "input %u (%s %d %d): ",
+			step + 1, action_names[action->type], action->arg1, action->arg2);
+	va_list args;
+	va_start(args, format);
+	vsnprintf(failure + length, sizeof(failure) - length, format, args);
+	va_end(args);
+}
+
+static void get_position(uint8_t player, int8_t* x, int8_t* y) {
+	*x = player ? player_2_x : player_1_x;
+	*y = player ? player_2_y : player_1_y;
+}
+
+// Squares are numbered along the board's path from 0 at the start
+static void path_position(uint16_t square, int8_t* x, int8_t* y) {
+	uint8_t path_x, path_y;
+	get_path_square(square, &path_x, &path_y);
+	*x = path_x;
+	*y = path_y;
+}
+
+// Where moving n squares from square ends under the house rules
+static uint16_t move_along(uint16_t square, uint8_t n, uint8_t rules) {
+	uint16_t finish = get_board_squares() - 1;
+	uint16_t target = square + n;
+	if (target <= finish) {
+		return target;
+	}
+	if (rule_options[rules] & RULE_EXACT_FINISH) {
+		return square;
+	}
+	if (rule_options[rules] & RULE_BOUNCE_BACK) {
+		return 2 * finish - target;
+	}
+	return finish;
+}
+
+// Where the _END of a snake or ladder is. Returns 0 if there isn't exactly
+// one.
+static uint8_t find_end(uint8_t end, int8_t* end_x, int8_t* end_y) {
+	uint8_t found = 0;
+	for (int8_t x = 0; x < get_board_width(); x++) {
+		for (int8_t y = 0; y < get_board_height(); y++) {
+			if (get_object_at(x, y) == end) {
+				*end_x = x;
+				*end_y = y;
+				found++;
+			}
+		}
+	}
+	return found == 1;
+}
+
+// Check every board's path goes through each square once, from the start
+// point to the finish line. Returns 1 if they all do.
+static uint8_t check_paths(void) {
+	for (uint8_t number = 0; number < NUM_BOARDS; number++) {
+		static uint8_t visited[BOARD_MAX_WIDTH][BOARD_MAX_HEIGHT];
+		memset(visited, 0, sizeof(visited));
+		choose_board(number);
+		uint16_t squares = get_board_squares();
+		for (uint16_t position = 0; position < squares; position++) {
+			uint8_t x, y;
+			get_path_square(position, &x, &y);
+			const char* problem = NULL;
+			if (x >= get_board_width() || y >= get_board_height()) {
+				problem = "is off the board";
+			} else if (visited[x][y]++) {
+				problem = "has been visited before";
+			} else if (get_path_position(x, y) != position) {
+				problem = "isn't found at this position";
+			} else if (position == 0 &&
+					get_object_type(get_object_at(x, y)) != START_POINT) {
+				problem = "isn't the start point";
+			} else if (position == squares - 1 &&
+					get_object_type(get_object_at(x, y)) != FINISH_LINE) {
+				problem = "isn't the finish line";
+			}
+			if (problem) {
+				printf("board %u: path square %u (%u,%u) %s\n", number + 1,
+						position, x, y, problem);
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+// Start a game the way project.c does when it leaves the splash screen
+static void new_game(int8_t board_number, int8_t players) {
+	if (players == 2) {
+		activate_multiplayer();
+	} else {
+		deactivate_multiplayer();
+	}
+	choose_board(board_number);
+	initialise_game();
+}
+
+// Play a sequence from power up. Returns the number of the input that
+// broke a rule (from 1), or 0 if they all held.
+static uint32_t run(const Sequence* sequence) {
+	// Power up state
+	current_player = 0;
+	stick = 0;
+	rules_select(RULES_STANDARD);
+	new_game(0, 1);
+	uint8_t playing = 1;
+	uint8_t players = 1;
+	uint8_t rules = RULES_STANDARD;
+
+	for (uint32_t i = 0; i < sequence->length; i++) {
+		const Action* action = &sequence->actions[i];
+		if (action->type == ACTION_NEW) {
+			if (!playing) {
+				new_game(action->arg1, action->arg2);
+				players = action->arg2;
+				playing = 1;
+			}
+			continue;
+		}
+		if (action->type == ACTION_RULES) {
+			if (!playing) {
+				rules = action->arg1;
+				rules_select(rules);
+			}
+			continue;
+		}
+		if (!playing) {
+			// Only START and the menu choices do anything on the game over
+			// screen
+			continue;
+		}
+		if (action->type == ACTION_PAUSE) {
+			for (int8_t flash = 0; flash < action->arg1; flash++) {
+				flash_player_cursor();
+			}
+			continue;
+		}
+
+		// Work out where the move should land
+		uint8_t mover = current_player;
+		int8_t x, y;
+		get_position(mover, &x, &y);
+		uint8_t extra_turn = 0;
+		if (action->type == ACTION_ROLL || action->type == ACTION_STEP) {
+			path_position(move_along(get_path_position(x, y), action->arg1,
+					rules),
+					&x, &y);
+			extra_turn = action->type == ACTION_ROLL && action->arg1 == 6 &&
+					(rule_options[rules] & RULE_EXTRA_TURN);
+		} else {
+			x = (x + action->arg1 + get_board_width()) % get_board_width();
+			y = (y + action->arg2 + get_board_height()) % get_board_height();
+		}
+		uint8_t landed_on = get_object_at(x, y);
+		uint8_t type = get_object_type(landed_on);
+		if (type == SNAKE_START || type == LADDER_START) {
+			uint8_t end = (type == SNAKE_START ? SNAKE_END : LADDER_END) |
+					get_object_identifier(landed_on);
+			if (!find_end(end, &x, &y)) {
+				fail(i, action, "there isn't exactly one end to %02X",
+						landed_on);
+				return i + 1;
+			}
+		}
+
+		switch (action->type) {
+			case ACTION_ROLL:
+				move_player_roll(action->arg1, action->arg1 == 6);
+				break;
+			case ACTION_STEP:
+				move_player_n(action->arg1);
+				break;
+			case ACTION_MOVE:
+				move_player(action->arg1, action->arg2);
+				break;
+			case ACTION_JOYSTICK:
+				change_joystick();
+				move_player(action->arg1, action->arg2);
+				change_joystick();
+				break;
+		}
+
+		if (players == 1 && mover != 0) {
+			fail(i, action, "player %u moved in a one player game", mover + 1);
+			return i + 1;
+		}
+		for (uint8_t player = 0; player < 2; player++) {
+			int8_t player_x, player_y;
+			get_position(player, &player_x, &player_y);
+			if (player_x < 0 || player_x >= get_board_width() ||
+					player_y < 0 || player_y >= get_board_height()) {
+				fail(i, action, "player %u is off the board at (%d,%d)",
+						player + 1, player_x, player_y);
+				return i + 1;
+			}
+			if (get_player_path_position(player) !=
+					get_path_position(player_x, player_y)) {
+				fail(i, action, "player %u is kept at path square %u, not %u",
+						player + 1, get_player_path_position(player),
+						get_path_position(player_x, player_y));
+				return i + 1;
+			}
+		}
+		int8_t final_x, final_y;
+		get_position(mover, &final_x, &final_y);
+		if (final_x != x || final_y != y) {
+			fail(i, action, "player %u ended at (%d,%d) instead of (%d,%d)",
+					mover + 1, final_x, final_y, x, y);
+			return i + 1;
+		}
+		uint8_t squares = 0;
+		for (uint8_t square_x = 0; square_x < get_board_width(); square_x++) {
+			for (uint8_t square_y = 0; square_y < get_board_height();
+					square_y++) {
+				if (game_host_display[square_x][square_y] == (mover ? PLAYER_2 : PLAYER_1)) {
+					squares++;
+				}
+			}
+		}
+		if (squares != 1) {
+			fail(i, action, "player %u is shown on %u squares", mover + 1,
+					squares);
+			return i + 1;
+		}
+
+		uint8_t finished = get_object_type(get_object_at(x, y)) == FINISH_LINE;
+		if (players == 2 && !finished && (action->type == ACTION_ROLL ||
+				action->type == ACTION_STEP)) {
+			uint8_t next = extra_turn ? mover : mover ^ 1;
+			if (current_player != next) {
+				fail(i, action, "player %u to play next instead of player %u",
+						current_player + 1, next + 1);
+				return i + 1;
+			}
+		}
+		if (finished != has_winner()) {
+			fail(i, action, finished ? "reached the finish without winning" :
+					"won without reaching the finish");
+			return i + 1;
+		}
+		if (finished) {
+			if (get_winner() != mover + 1) {
+				fail(i, action, "player %u won but player %u reached the finish",
+						get_winner(), mover + 1);
+				return i + 1;
+			}
+			// On to the game over screen, which draws over the board
+			show_winner();
+			deactivate_multiplayer();
+			playing = 0;
+		}
+	}
+	return 0;
+}
+
+// Run a sequence in a child process. Returns 1 if it failed in any way.
+static uint8_t run_in_child(const Sequence* sequence) {
+	fflush(stdout);
+	pid_t pid = fork();
+	if (pid < 0) {
+		perror("fork");
+		exit(2);
+	}
+	if (pid == 0) {
+		// Only the final run shows what went wrong
+		freopen("/dev/null", "w", stderr);
+		_exit(run(sequence) ? 1 : 0);
+	}
+	int status;
+	waitpid(pid, &status, 0);
+	return !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+}
+
+////////////////////////////// Generating //////////////////////////////////
+
+static void random_action(Action* action) {
+	static const int8_t directions[][2] = {
+		{0, 1}, {-1, 0}, {0, -1}, {1, 0}
+	};
+	int r = rand() % 100;
+	action->arg2 = 0;
+	if (r < 40) {
+		action->type = ACTION_ROLL;
+		action->arg1 = 1 + rand() % 6;
+	} else if (r < 55) {
+		action->type = ACTION_STEP;
+		action->arg1 = 1 + rand() % 2;
+	} else if (r < 70) {
+		action->type = ACTION_MOVE;
+		int d = rand() % 4;
+		action->arg1 = directions[d][0];
+		action->arg2 = directions[d][1];
+	} else if (r < 85) {
+		// Any of the eight directions
+		action->type = ACTION_JOYSTICK;
+		do {
+			action->arg1 = rand() % 3 - 1;
+			action->arg2 = rand() % 3 - 1;
+		} while (!action->arg1 && !action->arg2);
+	} else if (r < 92) {
+		action->type = ACTION_PAUSE;
+		action->arg1 = 1 + rand() % 4;
+	} else if (r < 97) {
+		action->type = ACTION_NEW;
+		action->arg1 = rand() % NUM_BOARDS;
+		action->arg2 = 1 + rand() % 2;
+	} else {
+		action->type = ACTION_RULES;
+		action->arg1 = rand() % NUM_RULE_SETS;
+	}
+}
+
+static void random_sequence(Sequence* sequence, uint32_t max_length) {
+	sequence->length = 1 + rand() % max_length;
+	// Always start with a new game so every board and both modes are
+	// played from the start
+	sequence->actions[0].type = ACTION_NEW;
+	sequence->actions[0].arg1 = rand() % NUM_BOARDS;
+	sequence->actions[0].arg2 = 1 + rand() % 2;
+	for (uint32_t i = 1; i < sequence->length; i++) {
+		random_action(&sequence->actions[i]);
+	}
+}
+
+// Play random sequences until one fails. Returns 1 if one did (it's left
+// in sequence).
+static uint8_t fuzz(Sequence* sequence, uint32_t count, uint32_t max_length,
+		unsigned seed) {
+	srand(seed);
+	for (uint32_t n = 0; n < count; n++) {
+		random_sequence(sequence, max_length);
+		if (run(sequence)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/////////////////////////////// Shrinking //////////////////////////////////
+
+static void remove_actions(Sequence* sequence, uint32_t start,
+		uint32_t count) {
+	memmove(&sequence->actions[start], &sequence->actions[start + count],
+			(sequence->length - start - count) * sizeof(Action));
+	sequence->length -= count;
+}
+
+// Make a failing sequence as short and simple as possible while it still
+// fails - take out runs of inputs, halving the size of the runs each time
+// round, then make the rolls, steps and pauses as small as possible
+static void shrink(Sequence* sequence) {
+	Sequence* attempt = mmap(NULL, sizeof(Sequence), PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	uint8_t changed = 1;
+	while (changed) {
+		changed = 0;
+		for (uint32_t chunk = sequence->length / 2; chunk >= 1; chunk /= 2) {
+			uint32_t start = 0;
+			while (start + chunk <= sequence->length) {
+				*attempt = *sequence;
+				remove_actions(attempt, start, chunk);
+				if (run_in_child(attempt)) {
+					*sequence = *attempt;
+					changed = 1;
+				} else {
+					start += chunk;
+				}
+			}
+		}
+		for (uint32_t i = 0; i < sequence->length; i++) {
+			Action* action = &sequence->actions[i];
+			if (action->type != ACTION_ROLL && action->type != ACTION_STEP &&
+					action->type != ACTION_PAUSE) {
+				continue;
+			}
+			for (int8_t smaller = 1; smaller < action->arg1; smaller++) {
+				*attempt = *sequence;
+				attempt->actions[i].arg1 = smaller;
+				if (run_in_child(attempt)) {
+					*sequence = *attempt;
+					changed = 1;
+					break;
+				}
+			}
+		}
+	}
+	munmap(attempt, sizeof(Sequence));
+}
+
+///////////////////////////////// Files ////////////////////////////////////
+
+static int read_sequence(const char* filename, Sequence* sequence) {
+	FILE* file = fopen(filename, "r");
+	if (!file) {
+		perror(filename);
+		return -1;
+	}
+	char line[100];
+	uint32_t line_number = 0;
+	sequence->length = 0;
+	while (fgets(line, sizeof(line), file)) {
+		line_number++;
+		char name[20];
+		int arg1 = 0, arg2 = 0;
+		if (line[0] == '#' || sscanf(line, "%19s %d %d", name, &arg1,
+				&arg2) < 1) {
+			continue;
+		}
+		uint8_t type = 0;
+		while (type <= ACTION_RULES && strcmp(name, action_names[type])) {
+			type++;
+		}
+		if (type > ACTION_RULES || sequence->length == MAX_LENGTH) {
+			fprintf(stderr, "%s:%u: invalid line\n", filename, line_number);
+			fclose(file);
+			return -1;
+		}
+		Action* action = &sequence->actions[sequence->length++];
+		action->type = type;
+		action->arg1 = arg1;
+		action->arg2 = arg2;
+	}
+	fclose(file);
+	return 0;
+}
+
+static void write_sequence(FILE* file, const Sequence* sequence) {
+	for (uint32_t i = 0; i < sequence->length; i++) {
+		const Action* action = &sequence->actions[i];
+		fprintf(file, "%s %d %d\n", action_names[action->type], action->arg1,
+				action->arg2);
+	}
+}
+
+static void usage(void) {
+	fprintf(stderr, "usage: fuzz [-n sequences] [-l length] [-s seed] "
+			"[-o file] [-r file]\n");
+	exit(2);
+}
+
+int main(int argc, char** argv) {
+	uint32_t count = 100000;
+	uint32_t max_length = 200;
+	unsigned seed = time(NULL);
+	const char* output_file = NULL;
+	const char* replay_file = NULL;
+	int option;
+	while ((option = getopt(argc, argv, "n:l:s:o:r:")) != -1) {
+		switch (option) {
+			case 'n':
+				count = strtoul(optarg, NULL, 10);
+				break;
+			case 'l':
+				max_length = strtoul(optarg, NULL, 10);
+				if (max_length < 1 || max_length > MAX_LENGTH) {
+					usage();
+				}
+				break;
+			case 's':
+				seed = strtoul(optarg, NULL, 10);
+				break;
+			case 'o':
+				output_file = optarg;
+				break;
+			case 'r':
+				replay_file = optarg;
+				break;
+			default:
+				usage();
+		}
+	}
+	if (optind != argc) {
+		usage();
+	}
+
+	if (!check_paths()) {
+		return 1;
+	}
+
+	Sequence* sequence = mmap(NULL, sizeof(Sequence), PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (sequence == MAP_FAILED) {
+		perror("mmap");
+		return 2;
+	}
+
+	if (replay_file) {
+		if (read_sequence(replay_file, sequence) < 0) {
+			return 2;
+		}
+		if (!run_in_child(sequence)) {
+			printf("%s: passed\n", replay_file);
+			return 0;
+		}
+	} else {
+		printf("seed %u\n", seed);
+		struct timespec start, end;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		fflush(stdout);
+		pid_t pid = fork();
+		if (pid < 0) {
+			perror("fork");
+			return 2;
+		}
+		if (pid == 0) {
+			// exit() rather than _exit() so coverage data gets written
+			exit(fuzz(sequence, count, max_length, seed));
+		}
+		int status;
+		waitpid(pid, &status, 0);
+		if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+			clock_gettime(CLOCK_MONOTONIC, &end);
+			double seconds = (end.tv_sec - start.tv_sec) +
+					(end.tv_nsec - start.tv_nsec) / 1e9;
+			printf("%u sequences passed in %.1fs (%.0f a second)\n", count,
+					seconds, count / seconds);
+			return 0;
+		}
+	}
+
+	uint32_t original_length = sequence->length;
+	shrink(sequence);
+	printf("failing sequence (shrunk from %u inputs to %u):\n",
+			original_length, sequence->length);
+	write_sequence(stdout, sequence);
+	if (output_file) {
+		FILE* file = fopen(output_file, "w");
+		if (file) {
+			write_sequence(file, sequence);
+			fclose(file);
+		} else {
+			perror(output_file);
+		}
+	}
+
+	// Run it once more to show what went wrong (or let the sanitizer say)
+	printf("\n");
+	fflush(stdout);
+	if (fork() == 0) {
+		if (run(sequence)) {
+			printf("%s\n", failure);
+		}
+		fflush(stdout);
+		_exit(0);
+	}
+	wait(NULL);
+	return 1;
+}
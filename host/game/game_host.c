@@ -0,0 +1,52 @@
+/*
+ * game_host.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * Stand-ins for the firmware that game.c calls (see game_host.h).
+ */
+
+#include <string.h>
+#include "game_host.h"
+
+uint8_t game_host_display[BOARD_MAX_WIDTH][BOARD_MAX_HEIGHT];
+
+static uint32_t now;
+
+void initialise_display(void) {
+	memset(game_host_display, 0, sizeof(game_host_display));
+}
+
+void update_square_colour(uint8_t x, uint8_t y, uint8_t object) {
+	if (x < BOARD_MAX_WIDTH && y < BOARD_MAX_HEIGHT) {
+		game_host_display[x][y] = object;
+	}
+}
+
+// The whole board is always in view
+void display_follow(uint8_t x, uint8_t y) {
+	(void)x;
+	(void)y;
+}
+
+// The game's delays are loops waiting for the time to pass, so each call
+// moves the time on far enough to end them straight away
+uint32_t get_current_time(void) {
+	now += 1000;
+	return now;
+}
+
+void switch_ssd(void) {
+}
+
+void sound_play(uint8_t effect) {
+	(void)effect;
+}
+
+uint8_t sound_playing(void) {
+	return 1;
+}
+
+void sim_delay_us(double us) {
+	(void)us;
+}
@@ -0,0 +1,31 @@
+/*
+ * game_host.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * For host tools that link the firmware's game.c. game_host.c supplies the
+ * parts of the firmware game.c uses (the display, timer, sound and seven
+ * segment display) with stand-ins that cost nothing, and this gives access
+ * to the game's state.
+ */
+
+#ifndef GAME_HOST_H_
+#define GAME_HOST_H_
+
+#include <stdint.h>
+#include "game.h"
+
+// The object last drawn on each square of the board. The whole board is
+// kept, as if the LED matrix were big enough to show it all.
+extern uint8_t game_host_display[BOARD_MAX_WIDTH][BOARD_MAX_HEIGHT];
+
+// From game.c
+extern int8_t player_1_x;
+extern int8_t player_1_y;
+extern int8_t player_2_x;
+extern int8_t player_2_y;
+extern uint8_t current_player;
+extern int stick;
+extern int multiplayer;
+
+#endif /* GAME_HOST_H_ */
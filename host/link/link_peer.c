@@ -0,0 +1,454 @@
+/*
+ * link_peer.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * Stands in for the other unit of a linked game (see link.h in the
+ * firmware). It speaks the link protocol on a serial port or
+ * pseudo-terminal - sim -L makes one for the simulated unit - and plays
+ * its player through its own copy of the firmware's game.c, rolling the
+ * dice on each of its turns. Every event is printed as it is sent or
+ * received, with the positions after each move, so they can be checked
+ * against the unit's (STATE? on its terminal). At the end of each game it
+ * reports the round trip for every turn it sent: from sending the event
+ * that ended the turn to the unit's acknowledgement.
+ *
+ * Frames are decoded with the telemetry decoder (host/telemetry), since
+ * the link uses the same framing.
+ *
+ * Usage: link_peer [options] device
+ *   -p player   the player to play (1 or 2, default 2)
+ *   -g          start the game from here, rather than waiting for the unit
+ *               to start it
+ *   -b board    board for -g (1 to NUM_BOARDS, default 1)
+ *   -r rules    rule set for -g (1 to NUM_RULE_SETS, default 1)
+ *   -n games    games to play before exiting (default 1)
+ *   -d ms       how long to wait before each roll, and to let the dice
+ *               roll (default 300)
+ *   -c percent  corrupt this percent of the frames sent, to exercise the
+ *               unit's CRC check and resending (default 0)
+ *   -s seed     random seed for the dice (default from the time)
+ *
+ * The exit status is 1 if the unit stopped answering (10 seconds without
+ * an acknowledgement) or sent a move out of turn.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "game_host.h"
+#include "rules.h"
+#include "link.h"
+#include "telemetry_decode.h"
+
+// Kind, sequence number, event and CRC, every byte escaped, and the two
+// SLIP_END delimiters
+#define ENCODED_SIZE ((2 + sizeof(LinkEvent) + 2) * 2 + 2)
+
+#define QUEUE_SIZE 16
+#define MAX_TURNS 1000
+
+// How long the unit may take to acknowledge an event before giving up (ms)
+#define GIVE_UP_MS 10000
+
+typedef struct {
+	LinkEvent event;
+	int ends_turn;
+} Outgoing;
+
+static int fd;
+static TelemetryDecoder decoder;
+
+// Events waiting to be sent, oldest (in flight) first
+static Outgoing send_queue[QUEUE_SIZE];
+static int send_length;
+static uint8_t send_sequence;
+static int sent;
+static long first_sent;
+static long last_sent;
+static long resend_ms;
+
+static int have_received;
+static uint8_t last_received;
+
+// Options
+static uint8_t me = 1;			// the player played here (0 or 1)
+static int delay_ms = 300;
+static int corrupt_percent;
+
+// The game
+static int playing;
+static int rolling;
+static long turn_time;			// when this side's turn (or roll) began
+
+// Statistics for the game
+static long turn_rtt[MAX_TURNS];
+static int turns_measured;
+static int resent;
+static unsigned long bad_frames;
+
+static long now_ms(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000L + now.tv_nsec / 1000000;
+}
+
+static const char* event_name(uint8_t type) {
+	switch (type) {
+		case INPUT_MOVE: return "MOVE";
+		case INPUT_STEP: return "STEP";
+		case INPUT_ROLL: return "ROLL";
+		case INPUT_START: return "START";
+		default: return "?";
+	}
+}
+
+static void print_event(const char* direction, const LinkEvent* event) {
+	printf("%6ld %s %s %d %d%s\n", now_ms() % 1000000, direction,
+			event_name(event->type), event->arg1, event->arg2,
+			event->source == INPUT_SOURCE_JOYSTICK ? " (joystick)" : "");
+}
+
+static void print_positions(void) {
+	int8_t p1_x, p1_y, p2_x, p2_y;
+	get_player_position(0, &p1_x, &p1_y);
+	get_player_position(1, &p2_x, &p2_y);
+	printf("       cur=%u p1=%d,%d p2=%d,%d win=%u\n", current_player + 1,
+			p1_x, p1_y, p2_x, p2_y, has_winner() ? get_winner() : 0);
+}
+
+static void encode_byte(uint8_t* data, size_t* length, uint8_t byte) {
+	if (byte == SLIP_END) {
+		data[(*length)++] = SLIP_ESC;
+		byte = SLIP_ESC_END;
+	} else if (byte == SLIP_ESC) {
+		data[(*length)++] = SLIP_ESC;
+		byte = SLIP_ESC_ESC;
+	} else if (byte == SLIP_XON) {
+		data[(*length)++] = SLIP_ESC;
+		byte = SLIP_ESC_XON;
+	} else if (byte == SLIP_XOFF) {
+		data[(*length)++] = SLIP_ESC;
+		byte = SLIP_ESC_XOFF;
+	}
+	data[(*length)++] = byte;
+}
+
+static void send_frame(uint8_t kind, uint8_t sequence, const LinkEvent* event) {
+	uint8_t raw[2 + sizeof(LinkEvent) + 2];
+	size_t raw_length = 0;
+	raw[raw_length++] = kind;
+	raw[raw_length++] = sequence;
+	if (event) {
+		raw[raw_length++] = event->type;
+		raw[raw_length++] = event->source;
+		raw[raw_length++] = event->arg1;
+		raw[raw_length++] = event->arg2;
+	}
+	uint16_t crc = telemetry_crc16(raw, raw_length);
+	raw[raw_length++] = crc & 0xFF;
+	raw[raw_length++] = crc >> 8;
+	if (rand() % 100 < corrupt_percent) {
+		raw[rand() % raw_length] ^= 1 << (rand() % 8);
+	}
+
+	uint8_t data[ENCODED_SIZE];
+	size_t length = 0;
+	data[length++] = SLIP_END;
+	for (size_t i = 0; i < raw_length; i++) {
+		encode_byte(data, &length, raw[i]);
+	}
+	data[length++] = SLIP_END;
+	if (write(fd, data, length) != (ssize_t)length) {
+		perror("link_peer: write");
+		exit(1);
+	}
+}
+
+// Queue an event to send. The caller sets ends_turn once it has been
+// played here.
+static Outgoing* send_event(uint8_t type, int8_t arg1, int8_t arg2) {
+	if (send_length == QUEUE_SIZE) {
+		fprintf(stderr, "link_peer: send queue full\n");
+		exit(1);
+	}
+	Outgoing* outgoing = &send_queue[send_length++];
+	outgoing->event.type = type;
+	outgoing->event.source = INPUT_SOURCE_BUTTON;
+	outgoing->event.arg1 = arg1;
+	outgoing->event.arg2 = arg2;
+	outgoing->ends_turn = 0;
+	print_event("->", &outgoing->event);
+	return outgoing;
+}
+
+static void new_game(uint8_t board, uint8_t rule_set) {
+	rules_select(rule_set - 1);
+	activate_multiplayer();
+	choose_board(board - 1);
+	initialise_game();
+	playing = 1;
+	rolling = 0;
+	turn_time = now_ms();
+	turns_measured = 0;
+	resent = 0;
+	printf("       new game on board %u, rules %u\n", board, rule_set);
+}
+
+// Play a move, as project.c does for the same event
+static void play(const LinkEvent* event) {
+	switch (event->type) {
+		case INPUT_MOVE:
+			if (event->source == INPUT_SOURCE_JOYSTICK) {
+				change_joystick();
+				move_player(event->arg1, event->arg2);
+				change_joystick();
+			} else {
+				move_player(event->arg1, event->arg2);
+			}
+			break;
+		case INPUT_STEP:
+			move_player_n(event->arg1);
+			break;
+		case INPUT_ROLL:
+			if (event->arg1 == 0) {
+				rolling = 1;
+				return;
+			}
+			rolling = 0;
+			move_player_roll(event->arg1 + event->arg2,
+					(event->arg1 == 6) + (event->arg2 == 6));
+			break;
+	}
+	print_positions();
+}
+
+static int my_turn(void) {
+	return playing && !has_winner() && current_player == me;
+}
+
+static void report_game(void) {
+	printf("       player %u wins\n", get_winner());
+	if (turns_measured == 0) {
+		printf("       no turns measured\n");
+		return;
+	}
+	long total = 0, min = turn_rtt[0], max = turn_rtt[0];
+	printf("       turn round trips (ms):");
+	for (int i = 0; i < turns_measured; i++) {
+		printf(" %ld", turn_rtt[i]);
+		total += turn_rtt[i];
+		if (turn_rtt[i] < min) {
+			min = turn_rtt[i];
+		}
+		if (turn_rtt[i] > max) {
+			max = turn_rtt[i];
+		}
+	}
+	printf("\n       %d turns: min %ld, avg %.1f, max %ld ms; "
+			"%d resent, %lu bad frames received\n", turns_measured, min,
+			(double)total / turns_measured, max, resent, bad_frames);
+}
+
+static void handle_frame(const TelemetryFrame* frame, long now) {
+	if (frame->type == LINK_ACK && frame->length == 0) {
+		if (!sent || frame->sequence != send_sequence) {
+			return;
+		}
+		if (send_queue[0].ends_turn && turns_measured < MAX_TURNS) {
+			turn_rtt[turns_measured++] = now - first_sent;
+		}
+		send_length--;
+		memmove(send_queue, send_queue + 1, send_length * sizeof(Outgoing));
+		send_sequence++;
+		sent = 0;
+		return;
+	}
+	if (frame->type != LINK_EVENT || frame->length != sizeof(LinkEvent)) {
+		bad_frames++;
+		return;
+	}
+	send_frame(LINK_ACK, frame->sequence, NULL);
+	if (have_received && frame->sequence == last_received) {
+		return;
+	}
+	have_received = 1;
+	last_received = frame->sequence;
+	LinkEvent event = {frame->payload[0], frame->payload[1],
+			frame->payload[2], frame->payload[3]};
+	print_event("<-", &event);
+	if (event.type == INPUT_START) {
+		if (!playing) {
+			new_game(event.arg1, event.arg2);
+		}
+		return;
+	}
+	if (!playing || my_turn()) {
+		fprintf(stderr, "link_peer: %s out of turn\n", event_name(event.type));
+		exit(1);
+	}
+	play(&event);
+	turn_time = now;
+}
+
+// Take this side's turn: start the dice rolling, then stop it
+static void take_turn(long now) {
+	if (now - turn_time < delay_ms) {
+		return;
+	}
+	turn_time = now;
+	if (!rolling) {
+		rolling = 1;
+		send_event(INPUT_ROLL, 0, 0);
+		return;
+	}
+	int8_t first = rand() % 6 + 1;
+	int8_t second = rules_num_dice() > 1 ? rand() % 6 + 1 : 0;
+	Outgoing* outgoing = send_event(INPUT_ROLL, first, second);
+	play(&outgoing->event);
+	outgoing->ends_turn = !my_turn();
+}
+
+static void usage(void) {
+	fprintf(stderr, "usage: link_peer [-p player] [-g] [-b board] [-r rules] "
+			"[-n games] [-d ms] [-c percent] [-s seed] device\n");
+	exit(2);
+}
+
+static int open_port(const char* path) {
+	int port = open(path, O_RDWR | O_NOCTTY);
+	if (port < 0) {
+		perror(path);
+		exit(1);
+	}
+	struct termios tio;
+	if (tcgetattr(port, &tio) == 0) {
+		cfmakeraw(&tio);
+		cfsetispeed(&tio, B38400);
+		cfsetospeed(&tio, B38400);
+		tcsetattr(port, TCSANOW, &tio);
+	}
+	return port;
+}
+
+int main(int argc, char** argv) {
+	int start_here = 0;
+	int board = 1;
+	int rule_set = 1;
+	int games = 1;
+	unsigned seed = time(NULL);
+	int option;
+	while ((option = getopt(argc, argv, "p:gb:r:n:d:c:s:")) != -1) {
+		switch (option) {
+			case 'p':
+				me = atoi(optarg) - 1;
+				if (me > 1) {
+					usage();
+				}
+				break;
+			case 'g':
+				start_here = 1;
+				break;
+			case 'b':
+				board = atoi(optarg);
+				if (board < 1 || board > NUM_BOARDS) {
+					usage();
+				}
+				break;
+			case 'r':
+				rule_set = atoi(optarg);
+				if (rule_set < 1 || rule_set > NUM_RULE_SETS) {
+					usage();
+				}
+				break;
+			case 'n':
+				games = atoi(optarg);
+				break;
+			case 'd':
+				delay_ms = atoi(optarg);
+				break;
+			case 'c':
+				corrupt_percent = atoi(optarg);
+				break;
+			case 's':
+				seed = strtoul(optarg, NULL, 10);
+				break;
+			default:
+				usage();
+		}
+	}
+	if (optind != argc - 1) {
+		usage();
+	}
+	srand(seed);
+	fd = open_port(argv[optind]);
+	telemetry_decoder_init(&decoder);
+	printf("       playing player %u, seed %u\n", me + 1, seed);
+
+	send_sequence = rand();
+	if (start_here) {
+		send_event(INPUT_START, board, rule_set);
+		new_game(board, rule_set);
+	}
+	for (;;) {
+		long now = now_ms();
+		if (send_length && (!sent || now - last_sent >= resend_ms)) {
+			if (sent) {
+				resent++;
+				if (resend_ms < LINK_RESEND_MAX_MS) {
+					resend_ms *= 2;
+				}
+			} else {
+				sent = 1;
+				first_sent = now;
+				resend_ms = LINK_RESEND_MS;
+			}
+			last_sent = now;
+			send_frame(LINK_EVENT, send_sequence, &send_queue[0].event);
+		}
+		if (sent && now - first_sent > GIVE_UP_MS) {
+			fprintf(stderr, "link_peer: no acknowledgement\n");
+			return 1;
+		}
+		if (playing && has_winner() && !send_length) {
+			report_game();
+			playing = 0;
+			if (--games == 0) {
+				return 0;
+			}
+			if (start_here) {
+				send_event(INPUT_START, board, rule_set);
+				new_game(board, rule_set);
+			}
+		}
+		if (my_turn() && !send_length) {
+			take_turn(now);
+		}
+		fflush(stdout);
+
+		struct pollfd wait = {fd, POLLIN, 0};
+		if (poll(&wait, 1, 5) < 0 && errno != EINTR) {
+			perror("link_peer: poll");
+			return 1;
+		}
+		if (!(wait.revents & POLLIN)) {
+			continue;
+		}
+		uint8_t data[64];
+		ssize_t length = read(fd, data, sizeof(data));
+		unsigned long errors = decoder.crc_errors + decoder.framing_errors;
+		for (ssize_t i = 0; i < length; i++) {
+			TelemetryFrame frame;
+			if (telemetry_decoder_feed(&decoder, data[i], &frame)) {
+				handle_frame(&frame, now_ms());
+			}
+		}
+		bad_frames += decoder.crc_errors + decoder.framing_errors - errors;
+	}
+}
@@ -0,0 +1,247 @@
+/*
+ * pcm_encode.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * Convert WAV files into samples for pcm.c. Each argument is
+ *   name:format:file.wav
+ * where format is pcm8 or adpcm. The WAV files must be mono PCM, 8 or 16
+ * bit, and are resampled to PCM_SAMPLE_RATE. The C source for all the
+ * samples is written to standard output.
+ *
+ * Usage: pcm_encode click:pcm8:click.wav slide:adpcm:slide.wav > pcm_samples.c
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pcm.h"
+
+static const int adpcm_index_table[8] = {
+	-1, -1, -1, -1, 2, 4, 6, 8
+};
+
+static const int adpcm_step_table[89] = {
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37,
+	41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173,
+	190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+	724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+	2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484,
+	7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818,
+	18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static uint32_t get_le(const uint8_t* p, int bytes) {
+	uint32_t value = 0;
+	for (int i = bytes - 1; i >= 0; i--) {
+		value = (value << 8) | p[i];
+	}
+	return value;
+}
+
+// Read a mono WAV file into 16 bit samples. Returns the number of samples
+// or -1 on error.
+static long read_wav(const char* path, int16_t** samples, long* rate) {
+	FILE* file = fopen(path, "rb");
+	if (!file) {
+		perror(path);
+		return -1;
+	}
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	uint8_t* wav = malloc(size);
+	if (!wav || fread(wav, 1, size, file) != (size_t)size) {
+		fprintf(stderr, "%s: read failed\n", path);
+		fclose(file);
+		return -1;
+	}
+	fclose(file);
+	if (size < 12 || memcmp(wav, "RIFF", 4) || memcmp(wav + 8, "WAVE", 4)) {
+		fprintf(stderr, "%s: not a WAV file\n", path);
+		return -1;
+	}
+
+	int channels = 0, bits = 0;
+	long count = -1;
+	for (long offset = 12; offset + 8 <= size;) {
+		const uint8_t* chunk = wav + offset;
+		long length = get_le(chunk + 4, 4);
+		if (offset + 8 + length > size) {
+			break;
+		}
+		if (!memcmp(chunk, "fmt ", 4) && length >= 16) {
+			if (get_le(chunk + 8, 2) != 1) {
+				fprintf(stderr, "%s: not PCM\n", path);
+				return -1;
+			}
+			channels = get_le(chunk + 10, 2);
+			*rate = get_le(chunk + 12, 4);
+			bits = get_le(chunk + 22, 2);
+		} else if (!memcmp(chunk, "data", 4) && channels) {
+			if (channels != 1 || (bits != 8 && bits != 16)) {
+				fprintf(stderr, "%s: must be mono, 8 or 16 bit\n", path);
+				return -1;
+			}
+			count = length / (bits / 8);
+			*samples = malloc(count * sizeof(int16_t));
+			for (long i = 0; i < count; i++) {
+				if (bits == 8) {
+					(*samples)[i] = (chunk[8 + i] - 128) << 8;
+				} else {
+					(*samples)[i] = (int16_t)get_le(chunk + 8 + i * 2, 2);
+				}
+			}
+		}
+		offset += 8 + length + (length & 1);
+	}
+	free(wav);
+	if (count < 0) {
+		fprintf(stderr, "%s: no sample data\n", path);
+	}
+	return count;
+}
+
+// Linear interpolation to the playback rate
+static long resample(const int16_t* in, long count, long rate, int16_t** out) {
+	long out_count = (long)((double)count * PCM_SAMPLE_RATE / rate);
+	*out = malloc((out_count + 1) * sizeof(int16_t));
+	for (long i = 0; i < out_count; i++) {
+		double position = (double)i * rate / PCM_SAMPLE_RATE;
+		long j = (long)position;
+		double fraction = position - j;
+		int16_t a = in[j];
+		int16_t b = j + 1 < count ? in[j + 1] : in[j];
+		(*out)[i] = (int16_t)(a + (b - a) * fraction);
+	}
+	return out_count;
+}
+
+// Encode one sample, updating the encoder state exactly as the decoder in
+// pcm.c will so the two stay in step
+static int adpcm_encode(int sample, int* predictor, int* index) {
+	int step = adpcm_step_table[*index];
+	int difference = sample - *predictor;
+	int code = 0;
+	if (difference < 0) {
+		code = 8;
+		difference = -difference;
+	}
+	if (difference >= step) {
+		code |= 4;
+		difference -= step;
+	}
+	if (difference >= step >> 1) {
+		code |= 2;
+		difference -= step >> 1;
+	}
+	if (difference >= step >> 2) {
+		code |= 1;
+	}
+
+	int decoded = step >> 3;
+	if (code & 4) {
+		decoded += step;
+	}
+	if (code & 2) {
+		decoded += step >> 1;
+	}
+	if (code & 1) {
+		decoded += step >> 2;
+	}
+	*predictor += (code & 8) ? -decoded : decoded;
+	if (*predictor > 32767) {
+		*predictor = 32767;
+	} else if (*predictor < -32768) {
+		*predictor = -32768;
+	}
+	*index += adpcm_index_table[code & 7];
+	if (*index < 0) {
+		*index = 0;
+	} else if (*index > 88) {
+		*index = 88;
+	}
+	return code;
+}
+
+static void print_bytes(const uint8_t* bytes, long count) {
+	for (long i = 0; i < count; i++) {
+		printf("%s0x%02x,", i % 12 ? " " : "\n\t", bytes[i]);
+	}
+	printf("\n");
+}
+
+static int encode(const char* name, const char* format, const char* path) {
+	int16_t* wav;
+	long rate;
+	long count = read_wav(path, &wav, &rate);
+	if (count < 0) {
+		return 0;
+	}
+	int16_t* samples;
+	count = resample(wav, count, rate, &samples);
+	free(wav);
+
+	uint8_t* bytes = malloc(count + 1);
+	long length;
+	const char* format_name;
+	if (!strcmp(format, "adpcm")) {
+		int predictor = 0, index = 0;
+		memset(bytes, 0, count + 1);
+		for (long i = 0; i < count; i++) {
+			int code = adpcm_encode(samples[i], &predictor, &index);
+			bytes[i / 2] |= (i & 1) ? code << 4 : code;
+		}
+		length = (count + 1) / 2;
+		format_name = "PCM_FORMAT_ADPCM";
+	} else if (!strcmp(format, "pcm8")) {
+		for (long i = 0; i < count; i++) {
+			bytes[i] = (uint8_t)(samples[i] >> 8);
+		}
+		length = count;
+		format_name = "PCM_FORMAT_PCM8";
+	} else {
+		fprintf(stderr, "%s: unknown format %s\n", name, format);
+		return 0;
+	}
+	if (count > 65535) {
+		fprintf(stderr, "%s: too long\n", name);
+		return 0;
+	}
+
+	printf("\n// %s: %ld samples from %s\n", name, count, path);
+	printf("static const uint8_t %s_data[] PROGMEM = {", name);
+	print_bytes(bytes, length);
+	printf("};\n");
+	printf("const PcmSample pcm_%s PROGMEM = {%s_data, %ld, %s};\n", name,
+			name, count, format_name);
+	free(samples);
+	free(bytes);
+	return 1;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		fprintf(stderr, "Usage: %s name:format:file.wav ...\n", argv[0]);
+		return 1;
+	}
+	printf("/*\n * pcm_samples.c\n *\n * Generated by host/pcm/pcm_encode - "
+			"do not edit.\n */\n\n#include \"pcm_samples.h\"\n"
+			"#include <avr/pgmspace.h>\n");
+	for (int i = 1; i < argc; i++) {
+		char* argument = strdup(argv[i]);
+		char* name = strtok(argument, ":");
+		char* format = strtok(NULL, ":");
+		char* path = strtok(NULL, "");
+		if (!name || !format || !path) {
+			fprintf(stderr, "Bad argument %s\n", argv[i]);
+			return 1;
+		}
+		if (!encode(name, format, path)) {
+			return 1;
+		}
+		free(argument);
+	}
+	return 0;
+}
@@ -0,0 +1,21 @@
+/*
+ * interrupt.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * Stand-in for <avr/interrupt.h> in the host simulator. Interrupt
+ * handlers become ordinary functions which the simulator calls when
+ * their interrupt is due and interrupts are enabled.
+ */
+
+#ifndef SIM_AVR_INTERRUPT_H_
+#define SIM_AVR_INTERRUPT_H_
+
+#define ISR(vector) void vector(void)
+
+void sim_cli(void);
+void sim_sei(void);
+#define cli() sim_cli()
+#define sei() sim_sei()
+
+#endif /* SIM_AVR_INTERRUPT_H_ */
@@ -0,0 +1,151 @@
+/*
+ * io.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * Stand-in for <avr/io.h> when the firmware is built for the host
+ * simulator. Most registers are plain variables (defined in sim.c) that
+ * the simulator reads and writes. Registers whose reads do something in
+ * the hardware are accessed through functions instead - in particular
+ * every read of SREG lets the simulator advance time and run any
+ * interrupts that are due, so the firmware's busy-wait loops must read
+ * SREG (or UCSR0A) to make progress.
+ */
+
+#ifndef SIM_AVR_IO_H_
+#define SIM_AVR_IO_H_
+
+#include <stdint.h>
+
+extern volatile uint8_t PINB, PINC, PIND;
+extern volatile uint8_t DDRB, DDRC, DDRD;
+extern volatile uint8_t PORTB, PORTC, PORTD;
+extern volatile uint8_t PCICR, PCIFR, PCMSK1;
+extern volatile uint8_t TCCR0A, TCCR0B, TCNT0, OCR0A, TIMSK0, TIFR0;
+extern volatile uint8_t TCCR1A, TCCR1B;
+extern volatile uint16_t OCR1A, OCR1B;
+extern volatile uint8_t TCCR2A, TCCR2B, OCR2B, TIMSK2, TIFR2;
+extern volatile uint8_t ADMUX, ADCSRA, ADCSRB, DIDR0;
+extern volatile uint16_t ADC;
+extern volatile uint8_t UCSR0B, UCSR0C;
+extern volatile uint16_t UBRR0;
+extern volatile uint8_t UCSR1A, UCSR1B, UCSR1C;
+extern volatile uint16_t UBRR1;
+extern volatile uint8_t SPCR0, SPSR0, SPDR0;
+
+volatile uint8_t* sim_sreg(void);
+volatile uint8_t* sim_ucsr0a(void);
+volatile uint8_t* sim_tcnt2(void);
+#define SREG (*sim_sreg())
+#define UCSR0A (*sim_ucsr0a())
+#define TCNT2 (*sim_tcnt2())
+
+// UDR0 is wider than the real register so that the simulator can tell
+// whether an interrupt handler wrote to it. See sim.c.
+extern volatile uint16_t sim_udr0;
+#define UDR0 sim_udr0
+extern volatile uint16_t sim_udr1;
+#define UDR1 sim_udr1
+
+#define SREG_I 7
+
+#define bit_is_set(sfr, bit) ((sfr) & (1 << (bit)))
+#define bit_is_clear(sfr, bit) (!((sfr) & (1 << (bit))))
+#define _BV(bit) (1 << (bit))
+
+// Port bits
+#define PINC7 7
+#define PIND2 2
+#define DDB4 4
+#define DDB5 5
+#define DDB7 7
+#define DDRD2 2
+#define DDRD4 4
+#define DDRD6 6
+#define PORTB4 4
+
+// Pin change interrupts
+#define PCIE1 1
+#define PCIF1 1
+#define PCINT8 0
+#define PCINT9 1
+#define PCINT10 2
+#define PCINT11 3
+
+// Timer 0
+#define WGM00 0
+#define WGM01 1
+#define CS00 0
+#define CS01 1
+#define CS02 2
+#define OCIE0A 1
+#define OCF0A 1
+
+// Timer 1
+#define WGM10 0
+#define WGM11 1
+#define WGM12 3
+#define WGM13 4
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define COM1A0 6
+#define COM1A1 7
+#define COM1B0 4
+#define COM1B1 5
+
+// Timer 2
+#define WGM20 0
+#define WGM21 1
+#define CS20 0
+#define CS21 1
+#define CS22 2
+#define COM2B0 4
+#define COM2B1 5
+#define TOIE2 0
+#define TOV2 0
+
+// ADC
+#define REFS0 6
+#define MUX0 0
+#define ADEN 7
+#define ADSC 6
+#define ADATE 5
+#define ADIF 4
+#define ADIE 3
+#define ADPS2 2
+#define ADPS1 1
+#define ADPS0 0
+#define ADC0D 0
+#define ADC1D 1
+
+// UART 0
+#define RXC0 7
+#define TXC0 6
+#define UDRE0 5
+#define FE0 4
+#define DOR0 3
+#define U2X0 1
+#define RXCIE0 7
+#define UDRIE0 5
+#define RXEN0 4
+#define TXEN0 3
+
+// UART 1
+#define U2X1 1
+#define RXCIE1 7
+#define UDRIE1 5
+#define RXEN1 4
+#define TXEN1 3
+#define UCSZ11 2
+#define UCSZ10 1
+
+// SPI
+#define SPE0 6
+#define MSTR0 4
+#define SPR10 1
+#define SPR00 0
+#define SPIF0 7
+#define SPI2X0 0
+
+#endif /* SIM_AVR_IO_H_ */
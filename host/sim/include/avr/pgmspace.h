@@ -0,0 +1,34 @@
+/*
+ * pgmspace.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * Stand-in for <avr/pgmspace.h> in the host simulator. There is only one
+ * address space on the host, so program memory is ordinary (read only)
+ * memory and the _P functions are the standard ones.
+ */
+
+#ifndef SIM_AVR_PGMSPACE_H_
+#define SIM_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define pgm_read_word(address) (*(const uint16_t*)(address))
+#define pgm_read_dword(address) (*(const uint32_t*)(address))
+#define pgm_read_ptr(address) (*(void* const*)(address))
+
+#define memcpy_P memcpy
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define sprintf_P sprintf
+
+#endif /* SIM_AVR_PGMSPACE_H_ */
@@ -0,0 +1,28 @@
+/*
+ * crc16.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * Stand-in for <util/crc16.h> in the host simulator. Only the CRC the
+ * firmware uses is provided.
+ */
+
+#ifndef SIM_UTIL_CRC16_H_
+#define SIM_UTIL_CRC16_H_
+
+#include <stdint.h>
+
+// CRC-16 with polynomial 0x1021, most significant bit first
+static inline uint16_t _crc_xmodem_update(uint16_t crc, uint8_t data) {
+	crc ^= (uint16_t)data << 8;
+	for (uint8_t i = 0; i < 8; i++) {
+		if (crc & 0x8000) {
+			crc = (crc << 1) ^ 0x1021;
+		} else {
+			crc <<= 1;
+		}
+	}
+	return crc;
+}
+
+#endif /* SIM_UTIL_CRC16_H_ */
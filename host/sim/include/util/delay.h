@@ -0,0 +1,18 @@
+/*
+ * delay.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * Stand-in for <util/delay.h> in the host simulator. Delays advance the
+ * simulator's clock (running any interrupts that fall due) rather than
+ * spinning.
+ */
+
+#ifndef SIM_UTIL_DELAY_H_
+#define SIM_UTIL_DELAY_H_
+
+void sim_delay_us(double us);
+#define _delay_us(us) sim_delay_us(us)
+#define _delay_ms(ms) sim_delay_us((ms) * 1000.0)
+
+#endif /* SIM_UTIL_DELAY_H_ */
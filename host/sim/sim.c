@@ -0,0 +1,632 @@
+/*
+ * sim.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * Host simulator for the Snakes and Ladders firmware. The firmware (all of
+ * it except spi.c) is compiled for the host against the stand-in AVR
+ * headers in include/, and this file provides the registers, the clock
+ * and the interrupts. The LED matrix is simulated by sim_spi.c, the
+ * terminal by sim_term.c, and input comes from a script (sim_script.c) or,
+ * in real time mode, the keyboard.
+ *
+ * Time is virtual - it is counted in CPU cycles and only moves when the
+ * firmware touches the hardware (see sim.h) - so by default a whole game
+ * runs in a fraction of a second and every run with the same script
+ * produces exactly the same output. Real time mode (-r) holds the virtual
+ * clock back to the wall clock so the game can be played.
+ *
+ * Usage: sim [options]
+ *   -s script  read input from script (see sim_script.c)
+ *   -t ms      stop after ms milliseconds (default 60000, no limit with -r)
+ *   -r         real time, reading keys from the terminal
+ *   -o file    write everything sent on the serial port to file
+ *   -l file    write the event log (see sim_output.c) to file
+ *   -p prefix  write each new LED matrix frame to <prefix><ms>.ppm
+ *   -a         print each new LED matrix frame in ANSI colours
+ *   -q         don't print the terminal and matrix at the end
+ *   -L path    connect USART1 (the link to another unit, see link.h) to a
+ *              new pseudo-terminal, with a symbolic link to it at path,
+ *              and hold the clock back to the wall clock as with -r. The
+ *              other unit can then be played by a host program such as
+ *              link_peer (host/link).
+ */
+
+// For the pseudo-terminal functions
+#define _GNU_SOURCE
+
+#include "sim.h"
+#include <avr/io.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+// The firmware's main() (renamed when it is compiled) and its interrupt
+// handlers
+int firmware_main(void);
+void PCINT1_vect(void);
+void TIMER2_OVF_vect(void);
+void TIMER0_COMPA_vect(void);
+void USART0_RX_vect(void);
+void USART0_UDRE_vect(void);
+void ADC_vect(void);
+void USART1_RX_vect(void);
+void USART1_UDRE_vect(void);
+
+// Cycles charged for each read of SREG or UCSR0A - about one pass of a
+// busy-wait or polling loop
+#define POLL_CYCLES 40
+
+// A conversion takes 13 ADC clocks (the ADC clock is divided by 128)
+#define ADC_CYCLES (13 * 128)
+
+// Value UDR0 is set to before running a UART interrupt handler. If it
+// has changed afterwards, the handler wrote a character to send. A
+// received character is or'ed in - reading UDR0 into a char drops the
+// marker bit.
+#define UDR0_UNWRITTEN 0x8000
+
+#define RX_QUEUE_SIZE 4096
+
+#define XON 0x11
+#define XOFF 0x13
+
+#define DEFAULT_STOP_MS 60000
+
+// The registers
+volatile uint8_t PINB, PINC, PIND;
+volatile uint8_t DDRB, DDRC, DDRD;
+volatile uint8_t PORTB, PORTC, PORTD;
+volatile uint8_t PCICR, PCIFR, PCMSK1;
+volatile uint8_t TCCR0A, TCCR0B, TCNT0, OCR0A, TIMSK0, TIFR0;
+volatile uint8_t TCCR1A, TCCR1B;
+volatile uint16_t OCR1A, OCR1B;
+volatile uint8_t TCCR2A, TCCR2B, OCR2B, TIMSK2, TIFR2;
+volatile uint8_t ADMUX, ADCSRA, ADCSRB, DIDR0;
+volatile uint16_t ADC;
+volatile uint8_t UCSR0B, UCSR0C;
+volatile uint16_t UBRR0;
+volatile uint8_t SPCR0, SPSR0, SPDR0;
+volatile uint16_t sim_udr0;
+volatile uint8_t UCSR1A, UCSR1B, UCSR1C;
+volatile uint16_t UBRR1;
+volatile uint16_t sim_udr1;
+static volatile uint8_t sreg;
+static volatile uint8_t ucsr0a;
+static volatile uint8_t tcnt2;
+
+// The firmware's stdin and stdout (see sim_firmware.h)
+struct sim_stream* sim_stdout;
+struct sim_stream* sim_stdin;
+
+uint64_t sim_cycles;
+
+// Interrupts waiting to be run
+static uint8_t timer0_pending;
+static uint8_t pcint_pending;
+static uint64_t timer2_due;
+static uint64_t adc_due;
+
+static uint16_t joystick[2] = {512, 512};
+
+// The UART transmitter. One character can be waiting in UDR0 while
+// another is being shifted out.
+static uint64_t tx_shift_end;
+static uint8_t tx_register_full;
+
+// Characters waiting to be received, and when the next one arrives. The
+// other end stops sending when it receives XOFF.
+static uint8_t rx_queue[RX_QUEUE_SIZE];
+static uint16_t rx_head;
+static uint16_t rx_tail;
+static uint64_t rx_due;
+static uint8_t rx_stopped;
+
+// USART1 and the pseudo-terminal it is connected to (-1 without -L).
+// Bytes are sent one at a time, each taking a character time.
+static int link_fd = -1;
+static int link_slave_fd = -1;
+static const char* link_path;
+static uint8_t link_rx_queue[RX_QUEUE_SIZE];
+static uint16_t link_rx_head;
+static uint16_t link_rx_tail;
+static uint64_t link_rx_due;
+static uint64_t link_tx_end;
+
+// Options
+static uint32_t stop_ms = DEFAULT_STOP_MS;
+static uint8_t realtime;
+static uint8_t quiet;
+static FILE* uart_capture;
+
+static volatile sig_atomic_t stopping;
+static struct timespec start_time;
+static struct termios saved_termios;
+static uint8_t termios_saved;
+
+uint32_t sim_time_ms(void) {
+	return sim_cycles / SIM_CYCLES_PER_MS;
+}
+
+static uint32_t uart_byte_cycles(void) {
+	uint8_t divisor = (ucsr0a & (1 << U2X0)) ? 8 : 16;
+	// Start bit, 8 data bits and a stop bit
+	return 10UL * divisor * (UBRR0 + 1UL);
+}
+
+static uint32_t link_byte_cycles(void) {
+	uint8_t divisor = (UCSR1A & (1 << U2X1)) ? 8 : 16;
+	return 10UL * divisor * (UBRR1 + 1UL);
+}
+
+static uint32_t timer2_prescale(void) {
+	static const uint16_t prescale[8] = {0, 1, 8, 32, 64, 128, 256, 1024};
+	return prescale[TCCR2B & 0x07];
+}
+
+static uint8_t timer2_running(void) {
+	return (TIMSK2 & (1 << TOIE2)) && timer2_prescale();
+}
+
+static uint8_t adc_running(void) {
+	return (ADCSRA & (1 << ADEN)) && (ADCSRA & (1 << ADIE));
+}
+
+// Move a waiting character into the shift register once the one in
+// front of it has gone
+static void tx_update(void) {
+	if (tx_register_full && sim_cycles >= tx_shift_end) {
+		tx_register_full = 0;
+		tx_shift_end += uart_byte_cycles();
+	}
+}
+
+// A character the firmware has sent. It goes to the capture file and the
+// virtual terminal (and the real one in real time mode).
+static void transmit(uint8_t c) {
+	tx_update();
+	if (sim_cycles >= tx_shift_end) {
+		tx_shift_end = sim_cycles + uart_byte_cycles();
+	} else {
+		tx_register_full = 1;
+	}
+	if (c == XOFF) {
+		rx_stopped = 1;
+	} else if (c == XON) {
+		rx_stopped = 0;
+	}
+	if (uart_capture) {
+		fputc(c, uart_capture);
+	}
+	term_output(c);
+	if (realtime) {
+		putchar(c);
+	}
+}
+
+// A byte the firmware has sent on USART1
+static void link_transmit(uint8_t c) {
+	link_tx_end = sim_cycles + link_byte_cycles();
+	if (link_fd >= 0 && write(link_fd, &c, 1) < 0 && errno != EAGAIN) {
+		perror("sim: link");
+	}
+}
+
+static uint8_t link_rx_ready(void) {
+	return (UCSR1B & (1 << RXCIE1)) && link_rx_head != link_rx_tail;
+}
+
+static uint8_t link_udre_ready(void) {
+	return (UCSR1B & (1 << UDRIE1)) && sim_cycles >= link_tx_end;
+}
+
+static uint8_t udre_ready(void) {
+	tx_update();
+	return (UCSR0B & (1 << UDRIE0)) && !tx_register_full;
+}
+
+static uint8_t rx_ready(void) {
+	return (UCSR0B & (1 << RXCIE0)) && rx_head != rx_tail && !rx_stopped;
+}
+
+static void run_isr(void (*isr)(void)) {
+	// Interrupts are off while a handler runs, as on the AVR
+	sreg &= ~(1 << SREG_I);
+	isr();
+	sreg |= (1 << SREG_I);
+}
+
+// Run the interrupts that are due, highest priority (lowest vector
+// number) first
+static void run_due_interrupts(void) {
+	while (sreg & (1 << SREG_I)) {
+		if (pcint_pending) {
+			pcint_pending = 0;
+			run_isr(PCINT1_vect);
+		} else if (timer2_running() && sim_cycles >= timer2_due) {
+			uint32_t period = 256 * timer2_prescale();
+			// Overflows missed while interrupts were off are lost
+			timer2_due = (sim_cycles / period + 1) * period;
+			run_isr(TIMER2_OVF_vect);
+		} else if (timer0_pending) {
+			timer0_pending = 0;
+			run_isr(TIMER0_COMPA_vect);
+		} else if (rx_ready() && sim_cycles >= rx_due) {
+			uint8_t c = rx_queue[rx_tail];
+			rx_tail = (rx_tail + 1) % RX_QUEUE_SIZE;
+			rx_due = sim_cycles + uart_byte_cycles();
+			sim_udr0 = UDR0_UNWRITTEN | c;
+			run_isr(USART0_RX_vect);
+			if (sim_udr0 != (UDR0_UNWRITTEN | c)) {
+				// Echoed
+				transmit(sim_udr0);
+			}
+		} else if (udre_ready()) {
+			sim_udr0 = UDR0_UNWRITTEN;
+			run_isr(USART0_UDRE_vect);
+			if (sim_udr0 != UDR0_UNWRITTEN) {
+				transmit(sim_udr0);
+			}
+		} else if (adc_running() && sim_cycles >= adc_due) {
+			adc_due = (sim_cycles / ADC_CYCLES + 1) * ADC_CYCLES;
+			ADC = joystick[ADMUX & (1 << MUX0)];
+			run_isr(ADC_vect);
+		} else if (link_rx_ready() && sim_cycles >= link_rx_due) {
+			sim_udr1 = link_rx_queue[link_rx_tail];
+			link_rx_tail = (link_rx_tail + 1) % RX_QUEUE_SIZE;
+			link_rx_due = sim_cycles + link_byte_cycles();
+			run_isr(USART1_RX_vect);
+		} else if (link_udre_ready()) {
+			sim_udr1 = UDR0_UNWRITTEN;
+			run_isr(USART1_UDRE_vect);
+			if (sim_udr1 != UDR0_UNWRITTEN) {
+				link_transmit(sim_udr1);
+			}
+		} else {
+			break;
+		}
+	}
+}
+
+// When the next interrupt will fall due (other than timer 0, which is
+// dealt with at the end of each millisecond)
+static uint64_t next_interrupt_time(void) {
+	uint64_t next = UINT64_MAX;
+	if (timer2_running() && timer2_due < next) {
+		next = timer2_due;
+	}
+	if (adc_running() && adc_due < next) {
+		next = adc_due;
+	}
+	if (rx_ready() && rx_due < next) {
+		next = rx_due;
+	}
+	if ((UCSR0B & (1 << UDRIE0)) && tx_register_full && tx_shift_end < next) {
+		next = tx_shift_end;
+	}
+	if (link_rx_ready() && link_rx_due < next) {
+		next = link_rx_due;
+	}
+	if ((UCSR1B & (1 << UDRIE1)) && link_tx_end < next) {
+		next = link_tx_end;
+	}
+	return next > sim_cycles ? next : sim_cycles + 1;
+}
+
+static void finish(void) {
+	if (uart_capture) {
+		fclose(uart_capture);
+	}
+	if (output_log) {
+		fclose(output_log);
+	}
+	if (link_path) {
+		unlink(link_path);
+	}
+	if (!quiet && !realtime) {
+		term_dump(stdout);
+		putchar('\n');
+		output_matrix_ansi(stdout);
+	}
+	exit(0);
+}
+
+static void restore_terminal(void) {
+	if (termios_saved) {
+		tcsetattr(STDIN_FILENO, TCSANOW, &saved_termios);
+		// Move below the panel
+		printf("\x1b[%u;1H\n", SIM_TERM_ROWS + SIM_MATRIX_ROWS + 2);
+	}
+}
+
+static void handle_signal(int signal) {
+	(void)signal;
+	stopping = 1;
+}
+
+// Pass keys through to the UART
+static void realtime_millisecond(void) {
+	uint8_t keys[64];
+	ssize_t length = read(STDIN_FILENO, keys, sizeof(keys));
+	if (length > 0) {
+		sim_receive(keys, length);
+	}
+	fflush(stdout);
+}
+
+// Queue whatever the other end of the link has sent for USART1 to receive
+static void link_millisecond(void) {
+	uint8_t data[64];
+	ssize_t length = read(link_fd, data, sizeof(data));
+	for (ssize_t i = 0; i < length; i++) {
+		uint16_t next = (link_rx_head + 1) % RX_QUEUE_SIZE;
+		if (next == link_rx_tail) {
+			fprintf(stderr, "sim: link input queue full\n");
+			break;
+		}
+		if (link_rx_head == link_rx_tail) {
+			link_rx_due = sim_cycles + link_byte_cycles();
+		}
+		link_rx_queue[link_rx_head] = data[i];
+		link_rx_head = next;
+	}
+}
+
+// Keep the virtual clock from getting ahead of the real one
+static void hold_to_wall_clock(uint32_t ms) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	int64_t elapsed_us = (now.tv_sec - start_time.tv_sec) * 1000000LL +
+			(now.tv_nsec - start_time.tv_nsec) / 1000;
+	int64_t ahead_us = ms * 1000LL - elapsed_us;
+	if (ahead_us > 0) {
+		struct timespec delay = {ahead_us / 1000000, ahead_us % 1000000 * 1000};
+		nanosleep(&delay, NULL);
+	}
+}
+
+static void millisecond(void) {
+	uint32_t ms = sim_time_ms();
+	if (TIMSK0 & (1 << OCIE0A)) {
+		timer0_pending = 1;
+	}
+	script_run(ms);
+	output_millisecond(ms);
+	if (realtime) {
+		realtime_millisecond();
+	}
+	if (link_fd >= 0) {
+		link_millisecond();
+	}
+	if (realtime || link_fd >= 0) {
+		hold_to_wall_clock(ms);
+	}
+	if (stopping || (stop_ms && ms >= stop_ms)) {
+		finish();
+	}
+}
+
+void sim_advance(uint32_t cycles) {
+	uint64_t target = sim_cycles + cycles;
+	for (;;) {
+		run_due_interrupts();
+		uint64_t next = (sim_time_ms() + 1ULL) * SIM_CYCLES_PER_MS;
+		if (sreg & (1 << SREG_I)) {
+			uint64_t interrupt = next_interrupt_time();
+			if (interrupt < next) {
+				next = interrupt;
+			}
+		}
+		if (next > target) {
+			break;
+		}
+		sim_cycles = next;
+		if (sim_cycles % SIM_CYCLES_PER_MS == 0) {
+			millisecond();
+		}
+	}
+	sim_cycles = target;
+}
+
+volatile uint8_t* sim_sreg(void) {
+	sim_advance(POLL_CYCLES);
+	return &sreg;
+}
+
+volatile uint8_t* sim_ucsr0a(void) {
+	sim_advance(POLL_CYCLES);
+	tx_update();
+	// Only U2X0 is kept from what was written
+	ucsr0a &= (1 << U2X0);
+	if (!tx_register_full) {
+		ucsr0a |= (1 << UDRE0);
+		if (sim_cycles >= tx_shift_end) {
+			ucsr0a |= (1 << TXC0);
+		}
+	}
+	return &ucsr0a;
+}
+
+volatile uint8_t* sim_tcnt2(void) {
+	uint32_t prescale = timer2_prescale();
+	tcnt2 = prescale ? sim_cycles / prescale : 0;
+	return &tcnt2;
+}
+
+void sim_cli(void) {
+	sreg &= ~(1 << SREG_I);
+}
+
+void sim_sei(void) {
+	sreg |= (1 << SREG_I);
+	run_due_interrupts();
+}
+
+void sim_delay_us(double us) {
+	// The seven segment display is multiplexed by holding each digit for
+	// a few milliseconds, so what's on PORTC now is what's being shown
+	output_seven_seg(PORTC);
+	sim_advance(us * (SIM_F_CPU / 1000000));
+}
+
+void sim_set_buttons(uint8_t buttons) {
+	uint8_t changed = (PINB ^ buttons) & 0x0F;
+	PINB = (PINB & 0xF0) | (buttons & 0x0F);
+	if ((changed & PCMSK1) && (PCICR & (1 << PCIE1))) {
+		pcint_pending = 1;
+	}
+}
+
+uint8_t sim_get_buttons(void) {
+	return PINB & 0x0F;
+}
+
+void sim_set_joystick(uint16_t x, uint16_t y) {
+	joystick[0] = x;
+	joystick[1] = y;
+}
+
+void sim_receive(const uint8_t* data, uint16_t length) {
+	if (rx_head == rx_tail && rx_due < sim_cycles + uart_byte_cycles()) {
+		// The first character takes a character time to arrive
+		rx_due = sim_cycles + uart_byte_cycles();
+	}
+	while (length--) {
+		uint16_t next = (rx_head + 1) % RX_QUEUE_SIZE;
+		if (next == rx_tail) {
+			fprintf(stderr, "sim: serial input queue full\n");
+			return;
+		}
+		rx_queue[rx_head] = *data++;
+		rx_head = next;
+	}
+}
+
+void sim_stop(void) {
+	stopping = 1;
+}
+
+static void usage(const char* program) {
+	fprintf(stderr, "usage: %s [-s script] [-t ms] [-r] [-o uart_file] "
+			"[-l log_file] [-p ppm_prefix] [-a] [-q] [-L link_path]\n",
+			program);
+	exit(2);
+}
+
+// Open a pseudo-terminal for USART1, in raw mode so bytes go through
+// untouched, and put a symbolic link to it at path
+static void open_link(const char* path) {
+	link_fd = posix_openpt(O_RDWR | O_NOCTTY);
+	if (link_fd < 0 || grantpt(link_fd) < 0 || unlockpt(link_fd) < 0) {
+		perror("sim: pseudo-terminal");
+		exit(1);
+	}
+	const char* name = ptsname(link_fd);
+	// Holding the other side open keeps the pseudo-terminal usable while
+	// nothing else has it open
+	link_slave_fd = open(name, O_RDWR | O_NOCTTY);
+	struct termios raw;
+	if (link_slave_fd < 0 || tcgetattr(link_slave_fd, &raw) < 0) {
+		perror(name);
+		exit(1);
+	}
+	cfmakeraw(&raw);
+	tcsetattr(link_slave_fd, TCSANOW, &raw);
+	fcntl(link_fd, F_SETFL, fcntl(link_fd, F_GETFL) | O_NONBLOCK);
+	unlink(path);
+	if (symlink(name, path) < 0) {
+		perror(path);
+		exit(1);
+	}
+	link_path = path;
+	fprintf(stderr, "sim: link on %s (%s)\n", path, name);
+}
+
+static FILE* open_output(const char* filename) {
+	FILE* file = fopen(filename, "wb");
+	if (!file) {
+		perror(filename);
+		exit(1);
+	}
+	return file;
+}
+
+int main(int argc, char** argv) {
+	int option;
+	uint8_t stop_given = 0;
+	while ((option = getopt(argc, argv, "s:t:ro:l:p:aqL:")) != -1) {
+		switch (option) {
+			case 's':
+				if (script_load(optarg) < 0) {
+					return 1;
+				}
+				break;
+			case 't':
+				stop_ms = strtoul(optarg, NULL, 10);
+				stop_given = 1;
+				break;
+			case 'r':
+				realtime = 1;
+				break;
+			case 'o':
+				uart_capture = open_output(optarg);
+				break;
+			case 'l':
+				output_log = open_output(optarg);
+				break;
+			case 'p':
+				output_ppm = optarg;
+				break;
+			case 'a':
+				output_ansi = 1;
+				break;
+			case 'q':
+				quiet = 1;
+				break;
+			case 'L':
+				open_link(optarg);
+				break;
+			default:
+				usage(argv[0]);
+		}
+	}
+	if (optind != argc) {
+		usage(argv[0]);
+	}
+
+	if (realtime) {
+		if (!stop_given) {
+			stop_ms = 0;
+		}
+		output_live = 1;
+		output_ansi = 0;
+		if (isatty(STDIN_FILENO)) {
+			// Keys are passed on as they're typed. Ctrl-C still stops.
+			struct termios raw;
+			tcgetattr(STDIN_FILENO, &saved_termios);
+			termios_saved = 1;
+			raw = saved_termios;
+			raw.c_lflag &= ~(ICANON | ECHO);
+			raw.c_cc[VMIN] = 0;
+			raw.c_cc[VTIME] = 0;
+			tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+		} else {
+			fcntl(STDIN_FILENO, F_SETFL,
+					fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+		}
+		atexit(restore_terminal);
+	}
+	if (realtime || link_fd >= 0) {
+		signal(SIGINT, handle_signal);
+		clock_gettime(CLOCK_MONOTONIC, &start_time);
+	}
+
+	firmware_main();
+	finish();
+	return 0;
+}
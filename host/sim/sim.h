@@ -0,0 +1,99 @@
+/*
+ * sim.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * Internal interface between the parts of the host simulator. The
+ * simulator keeps a virtual clock in CPU cycles which only moves forward
+ * when the firmware touches the simulated hardware (reads SREG or UCSR0A,
+ * sends an SPI byte or calls _delay_ms()). Interrupts that have fallen due
+ * are run at those points, in the ATmega324A's vector priority order.
+ */
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define SIM_F_CPU 8000000UL
+#define SIM_CYCLES_PER_MS (SIM_F_CPU / 1000)
+
+// Size of the LED matrix
+#define SIM_MATRIX_COLUMNS 16
+#define SIM_MATRIX_ROWS 8
+
+// Size of the virtual terminal
+#define SIM_TERM_COLUMNS 80
+#define SIM_TERM_ROWS 30
+
+/* sim.c - the clock and the hardware around the CPU */
+
+// Cycles since reset
+extern uint64_t sim_cycles;
+
+// Milliseconds since reset
+uint32_t sim_time_ms(void);
+
+// Move the clock on, running any interrupts that fall due
+void sim_advance(uint32_t cycles);
+
+// Set the buttons (bits 0 to 3, high is pressed) and the joystick ADC
+// readings. These are called by the script.
+void sim_set_buttons(uint8_t buttons);
+uint8_t sim_get_buttons(void);
+void sim_set_joystick(uint16_t x, uint16_t y);
+
+// Queue characters to be received by the UART
+void sim_receive(const uint8_t* data, uint16_t length);
+
+// Stop at the end of the current millisecond
+void sim_stop(void);
+
+/* sim_spi.c - the LED matrix */
+
+// The pixels lit on the LED matrix. Colours are as in pixel_colour.h - red
+// brightness in the low nibble, green in the high nibble.
+extern uint8_t sim_matrix[SIM_MATRIX_ROWS][SIM_MATRIX_COLUMNS];
+
+// Set whenever a command changes the matrix
+extern uint8_t sim_matrix_changed;
+
+/* sim_term.c - the virtual terminal */
+
+// Interpret a character sent by the firmware
+void term_output(uint8_t c);
+
+// Write the text on the screen, without trailing blanks or blank lines
+void term_dump(FILE* file);
+
+/* sim_script.c - scripted input */
+
+// Load a script. Returns 0 on success, -1 (after printing an error) if the
+// script can't be read or is invalid.
+int8_t script_load(const char* filename);
+
+// Carry out the actions due by the given time
+void script_run(uint32_t ms);
+
+// Returns non-zero once every action has been carried out
+uint8_t script_finished(void);
+
+/* sim_output.c - showing the matrix and seven segment display */
+
+// Options set from the command line
+extern FILE* output_log;		// event log, or NULL
+extern const char* output_ppm;	// prefix for PPM frames, or NULL
+extern uint8_t output_ansi;		// show the matrix with ANSI colours
+extern uint8_t output_live;		// keep a panel updated below the terminal
+
+// Record the seven segment display port while the firmware is holding it
+void output_seven_seg(uint8_t port);
+
+// Called at the end of every millisecond to record anything that changed
+void output_millisecond(uint32_t ms);
+
+// Write the matrix as ANSI colour blocks
+void output_matrix_ansi(FILE* file);
+
+#endif /* SIM_H_ */
@@ -0,0 +1,35 @@
+/*
+ * sim_firmware.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * Included ahead of every firmware source file in the simulator build
+ * (with -include). avr-libc's stdio lets a program supply its own put and
+ * get functions for stdin and stdout; glibc's doesn't, so FILE is
+ * replaced with a small structure holding just those two functions.
+ */
+
+#ifndef SIM_FIRMWARE_H_
+#define SIM_FIRMWARE_H_
+
+#include <stdio.h>
+
+typedef struct sim_stream {
+	int (*put)(char, struct sim_stream*);
+	int (*get)(struct sim_stream*);
+} sim_stream;
+
+extern sim_stream* sim_stdout;
+extern sim_stream* sim_stdin;
+
+#define FILE sim_stream
+#undef stdout
+#undef stdin
+#define stdout sim_stdout
+#define stdin sim_stdin
+#define FDEV_SETUP_STREAM(put, get, flags) { put, get }
+#define _FDEV_SETUP_RW 0
+#undef fgetc
+#define fgetc(stream) ((stream)->get(stream))
+
+#endif /* SIM_FIRMWARE_H_ */
@@ -0,0 +1,20 @@
+/*
+ * sim_memory.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * Replaces memory.c in the simulator build. The firmware's variables and
+ * stack are the host's, so there is nothing meaningful to measure and
+ * every figure is reported as 0.
+ */
+
+#include <string.h>
+#include "memory.h"
+
+void memory_get_stats(MemoryStats* stats) {
+	memset(stats, 0, sizeof(MemoryStats));
+}
+
+uint16_t memory_stack_peak(void) {
+	return 0;
+}
@@ -0,0 +1,184 @@
+/*
+ * sim_output.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * Shows what the simulated hardware is doing. At the end of each
+ * millisecond anything that has changed (the LED matrix, the seven
+ * segment display, the note on the piezo buzzer and whether a sample is
+ * playing) is written to the event log, the LED matrix is written as a PPM
+ * frame and/or ANSI colour blocks, and the live panel is redrawn.
+ *
+ * The event log is plain text with one entry per change, so two runs can
+ * be compared with diff:
+ *   <ms> matrix       followed by 8 lines of 16 colours (hex)
+ *   <ms> ssd <xy>     the two digits shown (- for blank, ? if unknown)
+ *   <ms> tone <Hz>    or "tone off"
+ *   <ms> pcm on|off
+ */
+
+#include "sim.h"
+#include <avr/io.h>
+
+// Size in pixels of each LED in PPM frames
+#define PPM_SCALE 16
+
+FILE* output_log;
+const char* output_ppm;
+uint8_t output_ansi;
+uint8_t output_live;
+
+// Segment patterns (a in bit 0 to g in bit 6) and what they show
+static const struct {
+	uint8_t segments;
+	char digit;
+} seven_seg_digits[] = {
+	{63, '0'}, {6, '1'}, {91, '2'}, {79, '3'}, {102, '4'},
+	{109, '5'}, {125, '6'}, {7, '7'}, {127, '8'}, {111, '9'},
+	{0, '-'}, {64, '-'}
+};
+
+// The segments last shown on each digit. The digit select line is PC7 -
+// high for the left digit.
+static uint8_t seven_seg[2];
+static uint8_t last_seven_seg[2] = {0xFF, 0xFF};
+
+static uint16_t last_tone = 0xFFFF;
+static uint8_t last_pcm = 0xFF;
+
+void output_seven_seg(uint8_t port) {
+	if (DDRC) {
+		seven_seg[port >> 7] = port & 0x7F;
+	}
+}
+
+static char seven_seg_char(uint8_t segments) {
+	for (uint8_t i = 0; i < sizeof(seven_seg_digits) /
+			sizeof(seven_seg_digits[0]); i++) {
+		if (seven_seg_digits[i].segments == segments) {
+			return seven_seg_digits[i].digit;
+		}
+	}
+	return '?';
+}
+
+// Colour of an LED as 8 bit red and green levels
+static uint8_t red(uint8_t colour) {
+	return (colour & 0x0F) * 17;
+}
+
+static uint8_t green(uint8_t colour) {
+	return (colour >> 4) * 17;
+}
+
+void output_matrix_ansi(FILE* file) {
+	for (uint8_t y = 0; y < SIM_MATRIX_ROWS; y++) {
+		for (uint8_t x = 0; x < SIM_MATRIX_COLUMNS; x++) {
+			uint8_t colour = sim_matrix[y][x];
+			if (colour) {
+				fprintf(file, "\x1b[48;2;%u;%u;0m  ", red(colour),
+						green(colour));
+			} else {
+				// Unlit LEDs are dark grey so the grid can be seen
+				fprintf(file, "\x1b[48;2;40;40;40m  ");
+			}
+		}
+		fprintf(file, "\x1b[0m\n");
+	}
+}
+
+static void write_ppm(uint32_t ms) {
+	char filename[FILENAME_MAX];
+	snprintf(filename, sizeof(filename), "%s%08u.ppm", output_ppm, ms);
+	FILE* file = fopen(filename, "wb");
+	if (!file) {
+		perror(filename);
+		return;
+	}
+	fprintf(file, "P6\n%u %u\n255\n", SIM_MATRIX_COLUMNS * PPM_SCALE,
+			SIM_MATRIX_ROWS * PPM_SCALE);
+	for (uint16_t row = 0; row < SIM_MATRIX_ROWS * PPM_SCALE; row++) {
+		for (uint16_t column = 0; column < SIM_MATRIX_COLUMNS * PPM_SCALE;
+				column++) {
+			uint8_t colour = sim_matrix[row / PPM_SCALE][column / PPM_SCALE];
+			uint8_t pixel[3] = {red(colour), green(colour), 0};
+			// Leave a black gap between the LEDs
+			if (row % PPM_SCALE == 0 || column % PPM_SCALE == 0) {
+				pixel[0] = pixel[1] = 0;
+			} else if (!colour) {
+				pixel[0] = pixel[1] = pixel[2] = 40;
+			}
+			fwrite(pixel, 1, sizeof(pixel), file);
+		}
+	}
+	fclose(file);
+}
+
+// Draw the matrix and seven segment display below the terminal,
+// leaving the cursor where the firmware put it
+static void draw_live_panel(void) {
+	printf("\x1b" "7\x1b[%u;1H", SIM_TERM_ROWS + 1);
+	output_matrix_ansi(stdout);
+	printf("\n  %c%c\x1b" "8", seven_seg_char(seven_seg[1]),
+			seven_seg_char(seven_seg[0]));
+	fflush(stdout);
+}
+
+void output_millisecond(uint32_t ms) {
+	uint8_t redraw = 0;
+
+	if (sim_matrix_changed) {
+		sim_matrix_changed = 0;
+		redraw = 1;
+		if (output_log) {
+			fprintf(output_log, "%u matrix\n", ms);
+			for (uint8_t y = 0; y < SIM_MATRIX_ROWS; y++) {
+				for (uint8_t x = 0; x < SIM_MATRIX_COLUMNS; x++) {
+					fprintf(output_log, " %02X", sim_matrix[y][x]);
+				}
+				fputc('\n', output_log);
+			}
+		}
+		if (output_ppm) {
+			write_ppm(ms);
+		}
+		if (output_ansi) {
+			printf("%u ms\n", ms);
+			output_matrix_ansi(stdout);
+		}
+	}
+
+	if (seven_seg[0] != last_seven_seg[0] ||
+			seven_seg[1] != last_seven_seg[1]) {
+		last_seven_seg[0] = seven_seg[0];
+		last_seven_seg[1] = seven_seg[1];
+		redraw = 1;
+		if (output_log) {
+			fprintf(output_log, "%u ssd %c%c\n", ms,
+					seven_seg_char(seven_seg[1]), seven_seg_char(seven_seg[0]));
+		}
+	}
+
+	// Timer 1 counts at 1MHz with OCR1A as TOP (see sound.c)
+	uint16_t tone = OCR1A ? 1000000UL / (OCR1A + 1UL) : 0;
+	if (tone != last_tone) {
+		last_tone = tone;
+		if (output_log && tone) {
+			fprintf(output_log, "%u tone %u\n", ms, tone);
+		} else if (output_log) {
+			fprintf(output_log, "%u tone off\n", ms);
+		}
+	}
+
+	uint8_t pcm = (TIMSK2 & (1 << TOIE2)) != 0;
+	if (pcm != last_pcm) {
+		last_pcm = pcm;
+		if (output_log) {
+			fprintf(output_log, "%u pcm %s\n", ms, pcm ? "on" : "off");
+		}
+	}
+
+	if (redraw && output_live) {
+		draw_live_panel();
+	}
+}
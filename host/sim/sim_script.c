@@ -0,0 +1,239 @@
+/*
+ * sim_script.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * Scripted input for the simulator. A script is a text file with one
+ * action per line:
+ *
+ *   time action [arguments]
+ *
+ * time is in milliseconds from reset, or +n for n milliseconds after the
+ * previous line. Blank lines and lines starting with # are ignored. The
+ * actions are:
+ *
+ *   type text      send text to the serial port (C escapes such as \r, \n,
+ *                  \e and \x41 can be used)
+ *   command text   send a remote command - ":" text "\r"
+ *   press n        press button n (0 to 3)
+ *   release n      release button n
+ *   click n        press button n and release it 100ms later
+ *   joystick x y   set the joystick ADC readings (0 to 1023)
+ *   end            stop the simulation
+ */
+
+#include "sim.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_LINE 256
+
+// How long click holds a button down
+#define CLICK_MS 100
+
+typedef enum {
+	ACTION_TYPE, ACTION_PRESS, ACTION_RELEASE, ACTION_JOYSTICK, ACTION_END
+} ActionType;
+
+typedef struct {
+	uint32_t time;
+	ActionType type;
+	uint16_t arg1;
+	uint16_t arg2;
+	uint8_t* text;
+	uint16_t length;
+	uint32_t order;		// line order, to keep the sort stable
+} Action;
+
+static Action* actions;
+static uint32_t num_actions;
+static uint32_t next_action;
+
+static Action* add_action(uint32_t time, ActionType type) {
+	static uint32_t allocated;
+	if (num_actions == allocated) {
+		allocated = allocated ? allocated * 2 : 64;
+		actions = realloc(actions, allocated * sizeof(Action));
+		if (!actions) {
+			perror("script");
+			exit(1);
+		}
+	}
+	Action* action = &actions[num_actions++];
+	memset(action, 0, sizeof(Action));
+	action->time = time;
+	action->type = type;
+	action->order = num_actions;
+	return action;
+}
+
+// Expand C style escapes in place. Returns the length of the result.
+static uint16_t unescape(char* text) {
+	char* from = text;
+	char* to = text;
+	while (*from) {
+		if (*from != '\\' || !from[1]) {
+			*to++ = *from++;
+			continue;
+		}
+		from++;
+		switch (*from) {
+			case 'n': *to++ = '\n'; break;
+			case 'r': *to++ = '\r'; break;
+			case 't': *to++ = '\t'; break;
+			case 'e': *to++ = 0x1B; break;
+			case 's': *to++ = ' '; break;
+			case 'x':
+				*to++ = strtoul(from + 1, &from, 16);
+				continue;
+			default: *to++ = *from; break;
+		}
+		from++;
+	}
+	return to - text;
+}
+
+// Actions must be carried out in time order, but a click's release can
+// end up after later lines
+static int compare_actions(const void* a, const void* b) {
+	const Action* first = a;
+	const Action* second = b;
+	if (first->time != second->time) {
+		return first->time < second->time ? -1 : 1;
+	}
+	// Keep the order of the file for actions at the same time
+	return first->order < second->order ? -1 : 1;
+}
+
+static int8_t parse_line(char* line, uint32_t* time) {
+	char* p = line;
+	uint8_t relative = 0;
+	if (*p == '+') {
+		relative = 1;
+		p++;
+	}
+	if (!isdigit((unsigned char)*p)) {
+		return -1;
+	}
+	uint32_t value = strtoul(p, &p, 10);
+	*time = relative ? *time + value : value;
+
+	while (isspace((unsigned char)*p)) {
+		p++;
+	}
+	char* name = p;
+	while (*p && !isspace((unsigned char)*p)) {
+		p++;
+	}
+	if (*p) {
+		*p++ = 0;
+	}
+	// Only one space separates the action from text so that text can
+	// start with spaces
+	char* rest = p;
+
+	if (!strcmp(name, "type") || !strcmp(name, "command")) {
+		uint8_t is_command = name[0] == 'c';
+		uint16_t length = unescape(rest);
+		Action* action = add_action(*time, ACTION_TYPE);
+		action->text = malloc(length + 2);
+		uint8_t* text = action->text;
+		if (is_command) {
+			*text++ = ':';
+		}
+		memcpy(text, rest, length);
+		text += length;
+		if (is_command) {
+			*text++ = '\r';
+		}
+		action->length = text - action->text;
+	} else if (!strcmp(name, "press") || !strcmp(name, "release") ||
+			!strcmp(name, "click")) {
+		char* end;
+		unsigned long button = strtoul(rest, &end, 10);
+		if (end == rest || button > 3) {
+			return -1;
+		}
+		if (name[0] == 'r') {
+			add_action(*time, ACTION_RELEASE)->arg1 = button;
+		} else {
+			add_action(*time, ACTION_PRESS)->arg1 = button;
+		}
+		if (name[0] == 'c') {
+			add_action(*time + CLICK_MS, ACTION_RELEASE)->arg1 = button;
+		}
+	} else if (!strcmp(name, "joystick")) {
+		char* end;
+		unsigned long x = strtoul(rest, &end, 10);
+		unsigned long y = strtoul(end, &end, 10);
+		if (end == rest || x > 1023 || y > 1023) {
+			return -1;
+		}
+		Action* action = add_action(*time, ACTION_JOYSTICK);
+		action->arg1 = x;
+		action->arg2 = y;
+	} else if (!strcmp(name, "end")) {
+		add_action(*time, ACTION_END);
+	} else {
+		return -1;
+	}
+	return 0;
+}
+
+int8_t script_load(const char* filename) {
+	FILE* file = fopen(filename, "r");
+	if (!file) {
+		perror(filename);
+		return -1;
+	}
+	char line[MAX_LINE];
+	uint32_t line_number = 0;
+	uint32_t time = 0;
+	while (fgets(line, sizeof(line), file)) {
+		line_number++;
+		line[strcspn(line, "\r\n")] = 0;
+		char* p = line;
+		while (isspace((unsigned char)*p)) {
+			p++;
+		}
+		if (!*p || *p == '#') {
+			continue;
+		}
+		if (parse_line(p, &time) < 0) {
+			fprintf(stderr, "%s:%u: invalid line\n", filename, line_number);
+			fclose(file);
+			return -1;
+		}
+	}
+	fclose(file);
+	qsort(actions, num_actions, sizeof(Action), compare_actions);
+	return 0;
+}
+
+void script_run(uint32_t ms) {
+	while (next_action < num_actions && actions[next_action].time <= ms) {
+		Action* action = &actions[next_action++];
+		switch (action->type) {
+			case ACTION_TYPE:
+				sim_receive(action->text, action->length);
+				break;
+			case ACTION_PRESS:
+				sim_set_buttons(sim_get_buttons() | (1 << action->arg1));
+				break;
+			case ACTION_RELEASE:
+				sim_set_buttons(sim_get_buttons() & ~(1 << action->arg1));
+				break;
+			case ACTION_JOYSTICK:
+				sim_set_joystick(action->arg1, action->arg2);
+				break;
+			case ACTION_END:
+				sim_stop();
+				break;
+		}
+	}
+}
+
+uint8_t script_finished(void) {
+	return next_action == num_actions;
+}
@@ -0,0 +1,141 @@
+/*
+ * sim_spi.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * Replaces spi.c in the simulator build. Bytes sent over SPI are decoded
+ * as LED matrix commands (see ledmatrix.c) and applied to sim_matrix.
+ */
+
+#include "sim.h"
+#include <string.h>
+#include "spi.h"
+
+#define CMD_UPDATE_ALL		0x00
+#define CMD_UPDATE_PIXEL	0x01
+#define CMD_UPDATE_ROW		0x02
+#define CMD_UPDATE_COL		0x03
+#define CMD_SHIFT_DISPLAY	0x04
+#define CMD_CLEAR_SCREEN	0x0F
+
+#define NO_COMMAND 0xFF
+
+uint8_t sim_matrix[SIM_MATRIX_ROWS][SIM_MATRIX_COLUMNS];
+uint8_t sim_matrix_changed;
+
+// Cycles to send one byte (8 bits at the SPI clock)
+static uint32_t byte_cycles = 8 * 128;
+
+// The command being received, the bytes that follow it so far and the
+// number still to come
+static uint8_t command = NO_COMMAND;
+static uint8_t data[SIM_MATRIX_ROWS * SIM_MATRIX_COLUMNS];
+static uint8_t received;
+static uint8_t remaining;
+
+void spi_setup_master(uint8_t clockdivider) {
+	// The firmware treats anything it doesn't recognise as 128
+	switch (clockdivider) {
+		case 2: case 4: case 8: case 16: case 32: case 64:
+			byte_cycles = 8 * clockdivider;
+			break;
+		default:
+			byte_cycles = 8 * 128;
+			break;
+	}
+}
+
+static void shift(uint8_t direction) {
+	uint8_t old[SIM_MATRIX_ROWS][SIM_MATRIX_COLUMNS];
+	memcpy(old, sim_matrix, sizeof(old));
+	memset(sim_matrix, 0, sizeof(sim_matrix));
+	int8_t dx = 0, dy = 0;
+	if (direction & 0x01) {
+		dx = 1;
+	} else if (direction & 0x02) {
+		dx = -1;
+	}
+	if (direction & 0x04) {
+		dy = 1;
+	} else if (direction & 0x08) {
+		dy = -1;
+	}
+	for (int8_t y = 0; y < SIM_MATRIX_ROWS; y++) {
+		for (int8_t x = 0; x < SIM_MATRIX_COLUMNS; x++) {
+			int8_t to_x = x + dx;
+			int8_t to_y = y + dy;
+			if (to_x >= 0 && to_x < SIM_MATRIX_COLUMNS &&
+					to_y >= 0 && to_y < SIM_MATRIX_ROWS) {
+				sim_matrix[to_y][to_x] = old[y][x];
+			}
+		}
+	}
+}
+
+// Carry out the command once all its bytes have arrived
+static void apply(void) {
+	switch (command) {
+		case CMD_UPDATE_ALL:
+			memcpy(sim_matrix, data, sizeof(sim_matrix));
+			break;
+		case CMD_UPDATE_PIXEL:
+			sim_matrix[data[0] >> 4 & 0x07][data[0] & 0x0F] = data[1];
+			break;
+		case CMD_UPDATE_ROW:
+			memcpy(sim_matrix[data[0] & 0x07], &data[1], SIM_MATRIX_COLUMNS);
+			break;
+		case CMD_UPDATE_COL:
+			for (uint8_t y = 0; y < SIM_MATRIX_ROWS; y++) {
+				sim_matrix[y][data[0] & 0x0F] = data[1 + y];
+			}
+			break;
+		case CMD_SHIFT_DISPLAY:
+			shift(data[0]);
+			break;
+		case CMD_CLEAR_SCREEN:
+			memset(sim_matrix, 0, sizeof(sim_matrix));
+			break;
+	}
+	sim_matrix_changed = 1;
+	command = NO_COMMAND;
+}
+
+uint8_t spi_send_byte(uint8_t byte) {
+	sim_advance(byte_cycles);
+
+	if (command == NO_COMMAND) {
+		command = byte;
+		received = 0;
+		switch (command) {
+			case CMD_UPDATE_ALL:
+				remaining = SIM_MATRIX_ROWS * SIM_MATRIX_COLUMNS;
+				break;
+			case CMD_UPDATE_PIXEL:
+				remaining = 2;
+				break;
+			case CMD_UPDATE_ROW:
+				remaining = 1 + SIM_MATRIX_COLUMNS;
+				break;
+			case CMD_UPDATE_COL:
+				remaining = 1 + SIM_MATRIX_ROWS;
+				break;
+			case CMD_SHIFT_DISPLAY:
+				remaining = 1;
+				break;
+			case CMD_CLEAR_SCREEN:
+				apply();
+				break;
+			default:
+				// Not a command - ignore it
+				command = NO_COMMAND;
+				break;
+		}
+		return 0;
+	}
+
+	data[received++] = byte;
+	if (--remaining == 0) {
+		apply();
+	}
+	return 0;
+}
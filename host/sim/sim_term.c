@@ -0,0 +1,238 @@
+/*
+ * sim_term.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * A small VT100 style terminal that interprets the serial output. It
+ * understands the escape sequences terminalio.c sends, which is enough to
+ * dump what a real terminal would be showing. Attributes (colours,
+ * reverse video) are ignored.
+ */
+
+#include "sim.h"
+#include <string.h>
+
+#define ESC 0x1B
+
+#define STATE_TEXT 0
+#define STATE_ESCAPE 1
+#define STATE_CSI 2
+
+#define MAX_PARAMETERS 4
+
+static char screen[SIM_TERM_ROWS][SIM_TERM_COLUMNS];
+static uint8_t initialised;
+static uint8_t cursor_x;
+static uint8_t cursor_y;
+static uint8_t scroll_top;
+static uint8_t scroll_bottom = SIM_TERM_ROWS - 1;
+
+static uint8_t state;
+static uint16_t parameters[MAX_PARAMETERS];
+static uint8_t num_parameters;
+static uint8_t private_mode;
+
+static void clear_rows(uint8_t from, uint8_t to) {
+	for (uint8_t y = from; y <= to; y++) {
+		memset(screen[y], ' ', SIM_TERM_COLUMNS);
+	}
+}
+
+// Move the lines in the scrolling region up (lines > 0) or down one
+static void scroll(int8_t lines) {
+	if (lines > 0) {
+		memmove(screen[scroll_top], screen[scroll_top + 1],
+				(scroll_bottom - scroll_top) * SIM_TERM_COLUMNS);
+		clear_rows(scroll_bottom, scroll_bottom);
+	} else {
+		memmove(screen[scroll_top + 1], screen[scroll_top],
+				(scroll_bottom - scroll_top) * SIM_TERM_COLUMNS);
+		clear_rows(scroll_top, scroll_top);
+	}
+}
+
+static void line_feed(void) {
+	if (cursor_y == scroll_bottom) {
+		scroll(1);
+	} else if (cursor_y < SIM_TERM_ROWS - 1) {
+		cursor_y++;
+	}
+}
+
+static void reverse_line_feed(void) {
+	if (cursor_y == scroll_top) {
+		scroll(-1);
+	} else if (cursor_y > 0) {
+		cursor_y--;
+	}
+}
+
+// The nth parameter, or default if it wasn't given (or was 0)
+static uint16_t parameter(uint8_t n, uint16_t default_value) {
+	if (n >= num_parameters || parameters[n] == 0) {
+		return default_value;
+	}
+	return parameters[n];
+}
+
+static uint8_t clamp(int16_t value, uint8_t limit) {
+	if (value < 0) {
+		return 0;
+	}
+	return value >= limit ? limit - 1 : value;
+}
+
+static void control_sequence(uint8_t final) {
+	switch (final) {
+		case 'A':
+			cursor_y = clamp(cursor_y - parameter(0, 1), SIM_TERM_ROWS);
+			break;
+		case 'B':
+			cursor_y = clamp(cursor_y + parameter(0, 1), SIM_TERM_ROWS);
+			break;
+		case 'C':
+			cursor_x = clamp(cursor_x + parameter(0, 1), SIM_TERM_COLUMNS);
+			break;
+		case 'D':
+			cursor_x = clamp(cursor_x - parameter(0, 1), SIM_TERM_COLUMNS);
+			break;
+		case 'H':
+		case 'f':
+			cursor_y = clamp(parameter(0, 1) - 1, SIM_TERM_ROWS);
+			cursor_x = clamp(parameter(1, 1) - 1, SIM_TERM_COLUMNS);
+			break;
+		case 'J':
+			if (num_parameters && parameters[0] == 2) {
+				clear_rows(0, SIM_TERM_ROWS - 1);
+			} else {
+				memset(&screen[cursor_y][cursor_x], ' ',
+						SIM_TERM_COLUMNS - cursor_x);
+				if (cursor_y < SIM_TERM_ROWS - 1) {
+					clear_rows(cursor_y + 1, SIM_TERM_ROWS - 1);
+				}
+			}
+			break;
+		case 'K':
+			memset(&screen[cursor_y][cursor_x], ' ',
+					SIM_TERM_COLUMNS - cursor_x);
+			break;
+		case 'r':
+			scroll_top = clamp(parameter(0, 1) - 1, SIM_TERM_ROWS);
+			scroll_bottom = clamp(parameter(1, SIM_TERM_ROWS) - 1,
+					SIM_TERM_ROWS);
+			if (scroll_bottom <= scroll_top) {
+				scroll_top = 0;
+				scroll_bottom = SIM_TERM_ROWS - 1;
+			}
+			cursor_x = 0;
+			cursor_y = 0;
+			break;
+		default:
+			// Attributes, cursor visibility and anything else that
+			// doesn't change the text
+			break;
+	}
+}
+
+void term_output(uint8_t c) {
+	if (!initialised) {
+		clear_rows(0, SIM_TERM_ROWS - 1);
+		initialised = 1;
+	}
+
+	if (state == STATE_ESCAPE) {
+		state = STATE_TEXT;
+		if (c == '[') {
+			state = STATE_CSI;
+			num_parameters = 0;
+			private_mode = 0;
+			memset(parameters, 0, sizeof(parameters));
+		} else if (c == 'D') {
+			line_feed();
+		} else if (c == 'M') {
+			reverse_line_feed();
+		}
+		return;
+	}
+
+	if (state == STATE_CSI) {
+		if (c >= '0' && c <= '9') {
+			if (num_parameters == 0) {
+				num_parameters = 1;
+			}
+			if (num_parameters <= MAX_PARAMETERS) {
+				uint16_t* value = &parameters[num_parameters - 1];
+				*value = *value * 10 + (c - '0');
+			}
+		} else if (c == ';') {
+			if (num_parameters == 0) {
+				num_parameters = 1;
+			}
+			num_parameters++;
+		} else if (c == '?') {
+			private_mode = 1;
+		} else {
+			if (num_parameters > MAX_PARAMETERS) {
+				num_parameters = MAX_PARAMETERS;
+			}
+			if (!private_mode) {
+				control_sequence(c);
+			}
+			state = STATE_TEXT;
+		}
+		return;
+	}
+
+	switch (c) {
+		case ESC:
+			state = STATE_ESCAPE;
+			break;
+		case '\r':
+			cursor_x = 0;
+			break;
+		case '\n':
+			line_feed();
+			break;
+		case '\b':
+			if (cursor_x > 0) {
+				cursor_x--;
+			}
+			break;
+		default:
+			if (c < ' ' || c > '~') {
+				// Other control characters (including XON and XOFF)
+				// aren't shown
+				break;
+			}
+			screen[cursor_y][cursor_x] = c;
+			if (cursor_x < SIM_TERM_COLUMNS - 1) {
+				cursor_x++;
+			}
+			break;
+	}
+}
+
+void term_dump(FILE* file) {
+	if (!initialised) {
+		return;
+	}
+	// Leave off blank lines at the bottom
+	int8_t last = SIM_TERM_ROWS - 1;
+	while (last >= 0) {
+		uint8_t x = 0;
+		while (x < SIM_TERM_COLUMNS && screen[last][x] == ' ') {
+			x++;
+		}
+		if (x < SIM_TERM_COLUMNS) {
+			break;
+		}
+		last--;
+	}
+	for (int8_t y = 0; y <= last; y++) {
+		uint8_t length = SIM_TERM_COLUMNS;
+		while (length > 0 && screen[y][length - 1] == ' ') {
+			length--;
+		}
+		fprintf(file, "%.*s\n", length, screen[y]);
+	}
+}
@@ -0,0 +1,255 @@
+/*
+ * matrix_view.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * Mirror the game's LED matrix from the TELEMETRY_MATRIX frames in its
+ * telemetry, e.g. on a big screen, and report how much of the serial
+ * line the matrix takes.
+ *
+ * Usage: matrix_view [-q] [device [baud]]
+ * With no device the telemetry is read from standard input (e.g. a capture
+ * of the serial port). The matrix is redrawn in ANSI colours after every
+ * frame. With -q it's only written out once, at the end, in the same
+ * layout as the simulator's event log ("??" for pixels not known).
+ *
+ * Rates are worked out from the game's own clock in the snapshots, so a
+ * capture gives the same figures as the live port. The baud rate (19200
+ * by default) is what the line's capacity is worked out from.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "telemetry_decode.h"
+
+// Bytes sent in each second of the game's clock, and the most in any one
+typedef struct {
+	unsigned long total;
+	unsigned long second;
+	unsigned long peak;
+} ByteCount;
+
+static TelemetryMatrix matrix;
+static ByteCount matrix_bytes;
+static ByteCount all_bytes;
+static unsigned long matrix_frames;
+static unsigned long resyncs;
+static int in_step;
+static int have_time;
+static uint32_t first_time;
+static uint32_t last_time;
+static long baud = 19200;
+static int quiet;
+
+static speed_t baud_constant(long baud) {
+	switch (baud) {
+		case 9600: return B9600;
+		case 19200: return B19200;
+		case 38400: return B38400;
+		case 57600: return B57600;
+		case 115200: return B115200;
+		case 230400: return B230400;
+#ifdef B250000
+		case 250000: return B250000;
+#endif
+#ifdef B500000
+		case 500000: return B500000;
+#endif
+#ifdef B1000000
+		case 1000000: return B1000000;
+#endif
+		default: return 0;
+	}
+}
+
+static int open_port(const char* path, long baud) {
+	int fd = open(path, O_RDONLY | O_NOCTTY);
+	if (fd < 0) {
+		return -1;
+	}
+	struct termios tio;
+	if (tcgetattr(fd, &tio) == 0) {
+		speed_t speed = baud_constant(baud);
+		cfmakeraw(&tio);
+		if (speed) {
+			cfsetispeed(&tio, speed);
+			cfsetospeed(&tio, speed);
+		}
+		tcsetattr(fd, TCSANOW, &tio);
+	}
+	return fd;
+}
+
+static void count_bytes(ByteCount* count, unsigned long bytes) {
+	count->total += bytes;
+	count->second += bytes;
+}
+
+static void end_second(ByteCount* count) {
+	if (count->second > count->peak) {
+		count->peak = count->second;
+	}
+	count->second = 0;
+}
+
+static int count_known(void) {
+	int known = 0;
+	for (int y = 0; y < TELEMETRY_MATRIX_ROWS; y++) {
+		for (int x = 0; x < TELEMETRY_MATRIX_COLUMNS; x++) {
+			known += matrix.known[y][x];
+		}
+	}
+	return known;
+}
+
+// Bytes per second over the whole run
+static double rate(const ByteCount* count) {
+	if (!have_time || last_time == first_time) {
+		return 0;
+	}
+	return count->total * 1000.0 / (last_time - first_time);
+}
+
+static void draw(void) {
+	printf("\x1b[H");
+	for (int y = 0; y < TELEMETRY_MATRIX_ROWS; y++) {
+		for (int x = 0; x < TELEMETRY_MATRIX_COLUMNS; x++) {
+			uint8_t colour = matrix.pixels[y][x];
+			if (!matrix.known[y][x]) {
+				// Not sent since a frame was lost
+				printf("\x1b[48;2;40;40;40m??");
+			} else if (colour) {
+				printf("\x1b[48;2;%u;%u;0m  ", (colour & 0x0F) * 17,
+						(colour >> 4) * 17);
+			} else {
+				printf("\x1b[48;2;40;40;40m  ");
+			}
+		}
+		printf("\x1b[0m\n");
+	}
+	if (in_step) {
+		printf("\nin step\x1b[K\n");
+	} else {
+		printf("\nwaiting for every pixel (%d of %d)\x1b[K\n", count_known(),
+				TELEMETRY_MATRIX_COLUMNS * TELEMETRY_MATRIX_ROWS);
+	}
+	printf("matrix %.0f B/s, all telemetry %.0f B/s, of %ld B/s at %ld "
+			"baud\x1b[K\n", rate(&matrix_bytes), rate(&all_bytes),
+			baud / 10, baud);
+	fflush(stdout);
+}
+
+static void handle_frame(const TelemetryFrame* frame, unsigned long bytes) {
+	TelemetrySnapshot snapshot;
+	count_bytes(&all_bytes, bytes);
+	if (telemetry_decode_snapshot(frame, &snapshot)) {
+		if (!have_time) {
+			have_time = 1;
+			first_time = snapshot.time;
+		} else if (snapshot.time / 1000 != last_time / 1000) {
+			end_second(&matrix_bytes);
+			end_second(&all_bytes);
+		}
+		last_time = snapshot.time;
+		return;
+	}
+	if (!telemetry_matrix_apply(&matrix, frame)) {
+		return;
+	}
+	count_bytes(&matrix_bytes, bytes);
+	matrix_frames++;
+	if (!in_step && telemetry_matrix_complete(&matrix)) {
+		in_step = 1;
+	}
+	if (!quiet) {
+		draw();
+	}
+}
+
+int main(int argc, char** argv) {
+	int option;
+	while ((option = getopt(argc, argv, "q")) != -1) {
+		switch (option) {
+			case 'q':
+				quiet = 1;
+				break;
+			default:
+				fprintf(stderr, "usage: matrix_view [-q] [device [baud]]\n");
+				return 1;
+		}
+	}
+	int fd = STDIN_FILENO;
+	if (optind < argc) {
+		if (optind + 1 < argc) {
+			baud = atol(argv[optind + 1]);
+		}
+		fd = open_port(argv[optind], baud);
+		if (fd < 0) {
+			fprintf(stderr, "%s: %s\n", argv[optind], strerror(errno));
+			return 1;
+		}
+	}
+	if (!quiet) {
+		printf("\x1b[2J");
+	}
+
+	TelemetryDecoder decoder;
+	TelemetryFrame frame;
+	uint8_t buffer[256];
+	ssize_t count;
+	unsigned long frame_bytes = 0;
+	telemetry_decoder_init(&decoder);
+	telemetry_matrix_init(&matrix);
+	while ((count = read(fd, buffer, sizeof(buffer))) > 0) {
+		for (ssize_t i = 0; i < count; i++) {
+			unsigned long errors = decoder.crc_errors +
+					decoder.framing_errors + decoder.lost_frames;
+			int good = telemetry_decoder_feed(&decoder, buffer[i], &frame);
+			frame_bytes++;
+			if (decoder.crc_errors + decoder.framing_errors +
+					decoder.lost_frames != errors) {
+				// It may have been a matrix frame
+				telemetry_matrix_forget(&matrix);
+				if (in_step) {
+					in_step = 0;
+					resyncs++;
+				}
+			}
+			if (good) {
+				// Everything since the last frame, delimiters included
+				handle_frame(&frame, frame_bytes);
+				frame_bytes = 0;
+			}
+		}
+	}
+
+	if (quiet) {
+		printf("matrix\n");
+		for (int y = 0; y < TELEMETRY_MATRIX_ROWS; y++) {
+			for (int x = 0; x < TELEMETRY_MATRIX_COLUMNS; x++) {
+				if (matrix.known[y][x]) {
+					printf(" %02X", matrix.pixels[y][x]);
+				} else {
+					printf(" ??");
+				}
+			}
+			printf("\n");
+		}
+	}
+	end_second(&matrix_bytes);
+	end_second(&all_bytes);
+	fprintf(stderr, "%lu matrix frames, %s, lost step %lu times\n",
+			matrix_frames, in_step ? "in step" : "not in step", resyncs);
+	fprintf(stderr, "matrix: %lu bytes, %.0f B/s, peak %lu B/s\n",
+			matrix_bytes.total, rate(&matrix_bytes), matrix_bytes.peak);
+	fprintf(stderr, "all telemetry: %lu bytes, %.0f B/s, peak %lu B/s\n",
+			all_bytes.total, rate(&all_bytes), all_bytes.peak);
+	fprintf(stderr, "line: %ld B/s at %ld baud, matrix peak %.0f%%\n",
+			baud / 10, baud, matrix_bytes.peak * 1000.0 / baud);
+	return 0;
+}
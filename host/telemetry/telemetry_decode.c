@@ -0,0 +1,263 @@
+/*
+ * telemetry_decode.c
+ *
+ * Author: Adnaan Buksh
+ */
+
+#include "telemetry_decode.h"
+#include <string.h>
+
+// Sizes of the payloads on the wire
+#define SNAPSHOT_LENGTH 19
+#define EVENT_LENGTH 8
+#define COUNTERS_LENGTH 12
+
+uint16_t telemetry_crc16(const uint8_t* data, size_t length) {
+	uint16_t crc = 0xFFFF;
+	for (size_t i = 0; i < length; i++) {
+		crc ^= (uint16_t)data[i] << 8;
+		for (int bit = 0; bit < 8; bit++) {
+			if (crc & 0x8000) {
+				crc = (crc << 1) ^ 0x1021;
+			} else {
+				crc <<= 1;
+			}
+		}
+	}
+	return crc;
+}
+
+void telemetry_decoder_init(TelemetryDecoder* decoder) {
+	memset(decoder, 0, sizeof(*decoder));
+}
+
+// Check and unpack a complete (unescaped) frame
+static int finish_frame(TelemetryDecoder* decoder, TelemetryFrame* frame) {
+	size_t length = decoder->length;
+	const uint8_t* data = decoder->buffer;
+
+	if (length < 4) {
+		decoder->crc_errors++;
+		return 0;
+	}
+	uint16_t crc = data[length - 2] | (data[length - 1] << 8);
+	if (telemetry_crc16(data, length - 2) != crc) {
+		decoder->crc_errors++;
+		return 0;
+	}
+
+	frame->type = data[0];
+	frame->sequence = data[1];
+	frame->length = length - 4;
+	memcpy(frame->payload, data + 2, frame->length);
+
+	if (decoder->have_sequence && frame->sequence != decoder->next_sequence) {
+		decoder->lost_frames += (uint8_t)(frame->sequence - decoder->next_sequence);
+	}
+	decoder->have_sequence = 1;
+	decoder->next_sequence = frame->sequence + 1;
+	decoder->frames++;
+	return 1;
+}
+
+int telemetry_decoder_feed(TelemetryDecoder* decoder, uint8_t byte,
+		TelemetryFrame* frame) {
+	if (byte == SLIP_END) {
+		int result = 0;
+		if (decoder->overflow) {
+			decoder->framing_errors++;
+		} else if (decoder->length > 0) {
+			result = finish_frame(decoder, frame);
+		}
+		decoder->length = 0;
+		decoder->escaped = 0;
+		decoder->overflow = 0;
+		return result;
+	}
+	if (decoder->overflow) {
+		return 0;
+	}
+	if (byte == SLIP_XON || byte == SLIP_XOFF) {
+		// Flow control from the game - never part of a frame
+		return 0;
+	}
+
+	if (decoder->escaped) {
+		decoder->escaped = 0;
+		if (byte == SLIP_ESC_END) {
+			byte = SLIP_END;
+		} else if (byte == SLIP_ESC_ESC) {
+			byte = SLIP_ESC;
+		} else if (byte == SLIP_ESC_XON) {
+			byte = SLIP_XON;
+		} else if (byte == SLIP_ESC_XOFF) {
+			byte = SLIP_XOFF;
+		} else {
+			// Not a valid escape - throw the frame away
+			decoder->overflow = 1;
+			return 0;
+		}
+	} else if (byte == SLIP_ESC) {
+		decoder->escaped = 1;
+		return 0;
+	}
+
+	if (decoder->length == sizeof(decoder->buffer)) {
+		decoder->overflow = 1;
+		return 0;
+	}
+	decoder->buffer[decoder->length++] = byte;
+	return 0;
+}
+
+static uint16_t get_word(const uint8_t* data) {
+	return data[0] | (data[1] << 8);
+}
+
+static uint32_t get_long(const uint8_t* data) {
+	return get_word(data) | ((uint32_t)get_word(data + 2) << 16);
+}
+
+int telemetry_decode_snapshot(const TelemetryFrame* frame,
+		TelemetrySnapshot* snapshot) {
+	const uint8_t* p = frame->payload;
+	if (frame->type != TELEMETRY_SNAPSHOT || frame->length != SNAPSHOT_LENGTH) {
+		return 0;
+	}
+	snapshot->time = get_long(p);
+	snapshot->flags = p[4];
+	snapshot->current_player = p[5];
+	snapshot->p1_x = p[6];
+	snapshot->p1_y = p[7];
+	snapshot->p2_x = p[8];
+	snapshot->p2_y = p[9];
+	snapshot->dice = p[10];
+	snapshot->board = p[11];
+	snapshot->p1_turns = p[12];
+	snapshot->p2_turns = p[13];
+	snapshot->p1_time_left = (int16_t)get_word(p + 14);
+	snapshot->p2_time_left = (int16_t)get_word(p + 16);
+	snapshot->winner = p[18];
+	return 1;
+}
+
+int telemetry_decode_event(const TelemetryFrame* frame, TelemetryEvent* event) {
+	const uint8_t* p = frame->payload;
+	if (frame->type != TELEMETRY_EVENT || frame->length != EVENT_LENGTH) {
+		return 0;
+	}
+	event->time = get_long(p);
+	event->type = p[4];
+	event->source = p[5];
+	event->arg1 = (int8_t)p[6];
+	event->arg2 = (int8_t)p[7];
+	return 1;
+}
+
+int telemetry_decode_counters(const TelemetryFrame* frame,
+		TelemetryCounters* counters) {
+	const uint8_t* p = frame->payload;
+	if (frame->type != TELEMETRY_COUNTERS || frame->length != COUNTERS_LENGTH) {
+		return 0;
+	}
+	counters->frames_sent = get_word(p);
+	counters->frames_dropped = get_word(p + 2);
+	counters->input_latency = get_word(p + 4);
+	counters->loops = get_word(p + 6);
+	counters->period = get_word(p + 8);
+	counters->serial_space = get_word(p + 10);
+	return 1;
+}
+
+int telemetry_decode_reply(const TelemetryFrame* frame, char* text) {
+	if (frame->type != TELEMETRY_REPLY) {
+		return 0;
+	}
+	memcpy(text, frame->payload, frame->length);
+	text[frame->length] = 0;
+	return 1;
+}
+
+void telemetry_matrix_init(TelemetryMatrix* matrix) {
+	memset(matrix, 0, sizeof(*matrix));
+}
+
+void telemetry_matrix_forget(TelemetryMatrix* matrix) {
+	memset(matrix->known, 0, sizeof(matrix->known));
+}
+
+// Move every pixel (and whether it's known) dx columns and dy rows, as
+// the LED matrix's shift command does
+static void matrix_shift(TelemetryMatrix* matrix, int dx, int dy) {
+	TelemetryMatrix old = *matrix;
+	memset(matrix->pixels, 0, sizeof(matrix->pixels));
+	for (int y = 0; y < TELEMETRY_MATRIX_ROWS; y++) {
+		for (int x = 0; x < TELEMETRY_MATRIX_COLUMNS; x++) {
+			int from_x = x - dx;
+			int from_y = y - dy;
+			if (from_x >= 0 && from_x < TELEMETRY_MATRIX_COLUMNS &&
+					from_y >= 0 && from_y < TELEMETRY_MATRIX_ROWS) {
+				matrix->pixels[y][x] = old.pixels[from_y][from_x];
+				matrix->known[y][x] = old.known[from_y][from_x];
+			} else {
+				// Shifted in black, as the firmware expects
+				matrix->known[y][x] = 1;
+			}
+		}
+	}
+}
+
+int telemetry_matrix_apply(TelemetryMatrix* matrix,
+		const TelemetryFrame* frame) {
+	const uint8_t* p = frame->payload;
+	const int pixels = TELEMETRY_MATRIX_COLUMNS * TELEMETRY_MATRIX_ROWS;
+	if (frame->type != TELEMETRY_MATRIX || frame->length < 2) {
+		return 0;
+	}
+
+	// Check the codes before changing anything
+	int index = p[1];
+	size_t i = 2;
+	while (i < frame->length) {
+		index += (p[i] & ~MATRIX_CODE_SKIP) + 1;
+		i += p[i] & MATRIX_CODE_SKIP ? 1 : 2;
+	}
+	if (i > frame->length || index > pixels) {
+		telemetry_matrix_forget(matrix);
+		return 0;
+	}
+
+	// The shift is two signed nibbles
+	int dx = (int8_t)(p[0] << 4) >> 4;
+	int dy = (int8_t)p[0] >> 4;
+	if (dx || dy) {
+		matrix_shift(matrix, dx, dy);
+	}
+	index = p[1];
+	for (i = 2; i < frame->length; i++) {
+		int run = (p[i] & ~MATRIX_CODE_SKIP) + 1;
+		if (p[i] & MATRIX_CODE_SKIP) {
+			index += run;
+			continue;
+		}
+		uint8_t colour = p[++i];
+		for (; run > 0; run--, index++) {
+			int x = index % TELEMETRY_MATRIX_COLUMNS;
+			int y = index / TELEMETRY_MATRIX_COLUMNS;
+			matrix->pixels[y][x] = colour;
+			matrix->known[y][x] = 1;
+		}
+	}
+	return 1;
+}
+
+int telemetry_matrix_complete(const TelemetryMatrix* matrix) {
+	for (int y = 0; y < TELEMETRY_MATRIX_ROWS; y++) {
+		for (int x = 0; x < TELEMETRY_MATRIX_COLUMNS; x++) {
+			if (!matrix->known[y][x]) {
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
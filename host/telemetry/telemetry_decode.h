@@ -0,0 +1,94 @@
+/*
+ * telemetry_decode.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * Host side decoder for the binary telemetry sent by the game (see
+ * telemetry.h in the firmware for the frame format). Bytes read from the
+ * serial port are fed in one at a time and complete, CRC checked frames
+ * come out. Text that arrives outside a frame (e.g. before telemetry was
+ * turned on) fails the CRC check and is counted and thrown away.
+ */
+
+#ifndef TELEMETRY_DECODE_H_
+#define TELEMETRY_DECODE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "telemetry.h"
+
+// Type, sequence number, payload and CRC
+#define TELEMETRY_MAX_FRAME (2 + TELEMETRY_MAX_PAYLOAD + 2)
+
+typedef struct {
+	uint8_t type;
+	uint8_t sequence;
+	uint8_t length;
+	uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+} TelemetryFrame;
+
+typedef struct {
+	uint8_t buffer[TELEMETRY_MAX_FRAME];
+	size_t length;
+	int escaped;
+	int overflow;
+	int have_sequence;
+	uint8_t next_sequence;
+
+	// Statistics
+	unsigned long frames;			// good frames decoded
+	unsigned long crc_errors;		// frames with a bad CRC (or too short)
+	unsigned long framing_errors;	// bad escapes or frames that were too long
+	unsigned long lost_frames;		// gaps in the sequence numbers
+} TelemetryDecoder;
+
+void telemetry_decoder_init(TelemetryDecoder* decoder);
+
+/* Feed one received byte to the decoder. Returns 1 and fills in frame when
+ * the byte completes a good frame, 0 otherwise.
+ */
+int telemetry_decoder_feed(TelemetryDecoder* decoder, uint8_t byte,
+		TelemetryFrame* frame);
+
+/* Unpack the payload of a frame. Each returns 1 on success or 0 if the
+ * frame is of the wrong type or length.
+ */
+int telemetry_decode_snapshot(const TelemetryFrame* frame,
+		TelemetrySnapshot* snapshot);
+int telemetry_decode_event(const TelemetryFrame* frame, TelemetryEvent* event);
+int telemetry_decode_counters(const TelemetryFrame* frame,
+		TelemetryCounters* counters);
+/* text must have room for TELEMETRY_MAX_PAYLOAD + 1 characters
+ */
+int telemetry_decode_reply(const TelemetryFrame* frame, char* text);
+
+// The LED matrix rebuilt from TELEMETRY_MATRIX frames. A pixel is known
+// once it has been sent since the decoder started or a frame was lost -
+// the whole matrix is right when every pixel is known.
+typedef struct {
+	uint8_t pixels[TELEMETRY_MATRIX_ROWS][TELEMETRY_MATRIX_COLUMNS];
+	uint8_t known[TELEMETRY_MATRIX_ROWS][TELEMETRY_MATRIX_COLUMNS];
+} TelemetryMatrix;
+
+void telemetry_matrix_init(TelemetryMatrix* matrix);
+
+/* Forget every pixel, after a frame has been lost. What was shown is kept.
+ */
+void telemetry_matrix_forget(TelemetryMatrix* matrix);
+
+/* Apply a TELEMETRY_MATRIX frame. Returns 1 on success or 0 if the frame
+ * is of the wrong type or its codes run off the end of the matrix (and
+ * then every pixel is forgotten).
+ */
+int telemetry_matrix_apply(TelemetryMatrix* matrix,
+		const TelemetryFrame* frame);
+
+/* Returns 1 if every pixel is known.
+ */
+int telemetry_matrix_complete(const TelemetryMatrix* matrix);
+
+/* CRC-16/CCITT-FALSE as used by the frames
+ */
+uint16_t telemetry_crc16(const uint8_t* data, size_t length);
+
+#endif /* TELEMETRY_DECODE_H_ */
@@ -0,0 +1,127 @@
+/*
+ * telemetry_dump.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * Print the telemetry sent by the game, one message per line.
+ *
+ * Usage: telemetry_dump [device [baud]]
+ * With no device the telemetry is read from standard input (e.g. a capture
+ * of the serial port).
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "telemetry_decode.h"
+
+static speed_t baud_constant(long baud) {
+	switch (baud) {
+		case 9600: return B9600;
+		case 19200: return B19200;
+		case 38400: return B38400;
+		case 57600: return B57600;
+		case 115200: return B115200;
+		case 230400: return B230400;
+#ifdef B250000
+		case 250000: return B250000;
+#endif
+#ifdef B500000
+		case 500000: return B500000;
+#endif
+#ifdef B1000000
+		case 1000000: return B1000000;
+#endif
+		default: return 0;
+	}
+}
+
+static int open_port(const char* path, long baud) {
+	int fd = open(path, O_RDONLY | O_NOCTTY);
+	if (fd < 0) {
+		return -1;
+	}
+	struct termios tio;
+	if (tcgetattr(fd, &tio) == 0) {
+		speed_t speed = baud_constant(baud);
+		cfmakeraw(&tio);
+		if (speed) {
+			cfsetispeed(&tio, speed);
+			cfsetospeed(&tio, speed);
+		}
+		tcsetattr(fd, TCSANOW, &tio);
+	}
+	return fd;
+}
+
+static void print_frame(const TelemetryFrame* frame) {
+	TelemetrySnapshot snapshot;
+	TelemetryEvent event;
+	TelemetryCounters counters;
+	char reply[TELEMETRY_MAX_PAYLOAD + 1];
+
+	if (telemetry_decode_snapshot(frame, &snapshot)) {
+		printf("snapshot seq=%u t=%lu player=%u p1=(%u,%u) p2=(%u,%u) "
+				"dice=%u board=%u turns=%u/%u time=%d/%d flags=0x%02x winner=%u\n",
+				frame->sequence, (unsigned long)snapshot.time,
+				snapshot.current_player + 1, snapshot.p1_x, snapshot.p1_y,
+				snapshot.p2_x, snapshot.p2_y, snapshot.dice, snapshot.board,
+				snapshot.p1_turns, snapshot.p2_turns, snapshot.p1_time_left,
+				snapshot.p2_time_left, snapshot.flags, snapshot.winner);
+	} else if (telemetry_decode_event(frame, &event)) {
+		printf("event seq=%u t=%lu type=%u source=%u args=%d,%d\n",
+				frame->sequence, (unsigned long)event.time, event.type,
+				event.source, event.arg1, event.arg2);
+	} else if (telemetry_decode_counters(frame, &counters)) {
+		printf("counters seq=%u sent=%u dropped=%u latency=%ums "
+				"loops=%u/%ums space=%u\n",
+				frame->sequence, counters.frames_sent, counters.frames_dropped,
+				counters.input_latency, counters.loops, counters.period,
+				counters.serial_space);
+	} else if (frame->type == TELEMETRY_MATRIX && frame->length >= 2) {
+		printf("matrix seq=%u shift=%d,%d start=%u codes=%u\n",
+				frame->sequence, (int8_t)(frame->payload[0] << 4) >> 4,
+				(int8_t)frame->payload[0] >> 4, frame->payload[1],
+				frame->length - 2);
+	} else if (telemetry_decode_reply(frame, reply)) {
+		printf("reply seq=%u %s\n", frame->sequence, reply);
+	} else {
+		printf("unknown seq=%u type=0x%02x length=%u\n", frame->sequence,
+				frame->type, frame->length);
+	}
+	fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+	int fd = STDIN_FILENO;
+	if (argc > 1) {
+		long baud = argc > 2 ? atol(argv[2]) : 19200;
+		fd = open_port(argv[1], baud);
+		if (fd < 0) {
+			fprintf(stderr, "%s: %s\n", argv[1], strerror(errno));
+			return 1;
+		}
+	}
+
+	TelemetryDecoder decoder;
+	TelemetryFrame frame;
+	uint8_t buffer[256];
+	ssize_t count;
+	telemetry_decoder_init(&decoder);
+	while ((count = read(fd, buffer, sizeof(buffer))) > 0) {
+		for (ssize_t i = 0; i < count; i++) {
+			if (telemetry_decoder_feed(&decoder, buffer[i], &frame)) {
+				print_frame(&frame);
+			}
+		}
+	}
+
+	fprintf(stderr, "%lu frames, %lu CRC errors, %lu framing errors, "
+			"%lu lost\n", decoder.frames, decoder.crc_errors,
+			decoder.framing_errors, decoder.lost_frames);
+	return 0;
+}
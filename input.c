@@ -0,0 +1,187 @@
+/*
+ * input.c
+ *
+ * Author: Adnaan Buksh
+ */
+
+#include "input.h"
+#include <stdio.h>
+#include <ctype.h>
+#include "buttons.h"
+#include "serialio.h"
+#include "joystick.h"
+#include "timer0.h"
+#include "telemetry.h"
+#include "command.h"
+
+// Serial key bindings. Keys are matched case insensitively so only the
+// lower case key is listed.
+typedef struct {
+	char key;
+	uint8_t contexts;
+	uint8_t type;
+	int8_t arg1;
+	int8_t arg2;
+} KeyBinding;
+
+static const KeyBinding key_bindings[] = {
+	{'s', INPUT_CONTEXT_MENU, INPUT_START, 0, 0},
+	{'1', INPUT_CONTEXT_MENU, INPUT_PLAYERS, 1, 0},
+	{'2', INPUT_CONTEXT_MENU, INPUT_PLAYERS, 2, 0},
+	{'c', INPUT_CONTEXT_MENU, INPUT_PLAYERS, PLAYERS_CPU, 0},
+	{'b', INPUT_CONTEXT_MENU, INPUT_BOARD, 0, 0},
+	{'v', INPUT_CONTEXT_MENU, INPUT_RULES, 0, 0},
+	{'w', INPUT_CONTEXT_GAME, INPUT_MOVE, 0, 1},
+	{'a', INPUT_CONTEXT_GAME, INPUT_MOVE, -1, 0},
+	{'s', INPUT_CONTEXT_GAME, INPUT_MOVE, 0, -1},
+	{'d', INPUT_CONTEXT_GAME, INPUT_MOVE, 1, 0},
+	{'r', INPUT_CONTEXT_GAME, INPUT_ROLL, 0, 0},
+	{'p', INPUT_CONTEXT_GAME, INPUT_PAUSE, 0, 0},
+	{'e', INPUT_CONTEXT_MENU | INPUT_CONTEXT_GAME, INPUT_DIFFICULTY, DIFFICULTY_EASY, 0},
+	{'m', INPUT_CONTEXT_MENU | INPUT_CONTEXT_GAME, INPUT_DIFFICULTY, DIFFICULTY_MEDIUM, 0},
+	{'h', INPUT_CONTEXT_MENU | INPUT_CONTEXT_GAME, INPUT_DIFFICULTY, DIFFICULTY_HARD, 0},
+	{'q', INPUT_CONTEXT_ALL, INPUT_SOUND, 0, 0},
+	{'t', INPUT_CONTEXT_ALL, INPUT_TELEMETRY, 0, 0}
+};
+#define NUM_KEY_BINDINGS (sizeof(key_bindings) / sizeof(key_bindings[0]))
+
+// Push button bindings
+typedef struct {
+	uint8_t button;
+	uint8_t contexts;
+	uint8_t type;
+	int8_t arg1;
+} ButtonBinding;
+
+static const ButtonBinding button_bindings[] = {
+	{BUTTON0_PUSHED, INPUT_CONTEXT_MENU, INPUT_START, 0},
+	{BUTTON1_PUSHED, INPUT_CONTEXT_MENU, INPUT_START, 0},
+	{BUTTON2_PUSHED, INPUT_CONTEXT_MENU, INPUT_START, 0},
+	{BUTTON3_PUSHED, INPUT_CONTEXT_MENU, INPUT_START, 0},
+	{BUTTON0_PUSHED, INPUT_CONTEXT_GAME, INPUT_STEP, 1},
+	{BUTTON1_PUSHED, INPUT_CONTEXT_GAME, INPUT_STEP, 2},
+	{BUTTON2_PUSHED, INPUT_CONTEXT_GAME, INPUT_ROLL, 0},
+	{BUTTON3_PUSHED, INPUT_CONTEXT_GAME, INPUT_PAUSE, 0}
+};
+#define NUM_BUTTON_BINDINGS (sizeof(button_bindings) / sizeof(button_bindings[0]))
+
+// The event queue. Events are only added and removed from the main loop so
+// this is a plain ring buffer. The size must be a power of two.
+#define INPUT_QUEUE_SIZE 16
+#define INPUT_QUEUE_MASK (INPUT_QUEUE_SIZE - 1)
+static InputEvent input_queue[INPUT_QUEUE_SIZE];
+static uint8_t queue_head;
+static uint8_t queue_tail;
+
+static uint8_t input_context = INPUT_CONTEXT_MENU;
+
+void input_set_context(uint8_t context) {
+	input_context = context;
+}
+
+uint8_t input_get_context(void) {
+	return input_context;
+}
+
+static uint8_t queue_full(void) {
+	return ((queue_head + 1) & INPUT_QUEUE_MASK) == queue_tail;
+}
+
+static uint8_t last_event_is(uint8_t type) {
+	return queue_head != queue_tail &&
+			input_queue[(queue_head - 1) & INPUT_QUEUE_MASK].type == type;
+}
+
+uint8_t input_push_event(uint8_t type, uint8_t source, int8_t arg1, int8_t arg2,
+		uint32_t time) {
+	if (queue_full()) {
+		return 0;
+	}
+	InputEvent* event = &input_queue[queue_head];
+	event->type = type;
+	event->source = source;
+	event->arg1 = arg1;
+	event->arg2 = arg2;
+	event->time = time;
+	queue_head = (queue_head + 1) & INPUT_QUEUE_MASK;
+	return 1;
+}
+
+static void translate_key(char key, uint32_t time) {
+	key = tolower(key);
+	for (uint8_t i = 0; i < NUM_KEY_BINDINGS; i++) {
+		const KeyBinding* binding = &key_bindings[i];
+		if (binding->key == key && (binding->contexts & input_context)) {
+			input_push_event(binding->type, INPUT_SOURCE_SERIAL, binding->arg1,
+					binding->arg2, time);
+			return;
+		}
+	}
+}
+
+static void translate_button(uint8_t button, uint32_t time) {
+	for (uint8_t i = 0; i < NUM_BUTTON_BINDINGS; i++) {
+		const ButtonBinding* binding = &button_bindings[i];
+		if (binding->button == button && (binding->contexts & input_context)) {
+			input_push_event(binding->type, INPUT_SOURCE_BUTTON, binding->arg1, 0,
+					time);
+			return;
+		}
+	}
+}
+
+void input_poll(void) {
+	ButtonEvent button_event;
+	while (!queue_full() && button_get_event(&button_event)) {
+		if (button_event.type == BUTTON_EVENT_PRESS) {
+			translate_button(button_event.button, button_event.time);
+		}
+	}
+	
+	command_poll(get_current_time());
+	
+	// Each character is either part of a remote command line or a key
+	// press. A command line can queue at most one event so there's always
+	// room for it. Keys and commands are translated for the current
+	// context, so stop after anything that starts a game - the rest is
+	// left waiting until the game has started.
+	while (!queue_full() && serial_input_available() &&
+			!last_event_is(INPUT_START)) {
+		char c = fgetc(stdin);
+		uint32_t now = get_current_time();
+		if (!command_feed(c, now)) {
+			translate_key(c, now);
+		}
+	}
+	
+	// The joystick is only used to move during a game
+	JoystickMove move;
+	if (!queue_full() && (input_context & INPUT_CONTEXT_GAME) &&
+			joystick_get_move(&move)) {
+		input_push_event(INPUT_MOVE, INPUT_SOURCE_JOYSTICK, move.dx, move.dy,
+				get_current_time());
+	}
+}
+
+uint8_t input_get_event(InputEvent* event) {
+	if (queue_tail == queue_head) {
+		return 0;
+	}
+	*event = input_queue[queue_tail];
+	queue_tail = (queue_tail + 1) & INPUT_QUEUE_MASK;
+	
+	// Report every event that is handed to the game
+	TelemetryEvent report;
+	report.time = event->time;
+	report.type = event->type;
+	report.source = event->source;
+	report.arg1 = event->arg1;
+	report.arg2 = event->arg2;
+	telemetry_send_event(&report);
+	return 1;
+}
+
+void input_clear(void) {
+	queue_tail = queue_head;
+	clear_button_events();
+}
@@ -0,0 +1,100 @@
+/*
+ * input.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * A single queue of input events. The push buttons, serial terminal and
+ * joystick are polled by input_poll() and their input is translated into
+ * typed events through a binding table. What a key or button means depends
+ * on the current input context (e.g. 's' starts the game from the menu but
+ * moves the player down during a game).
+ */
+
+
+#ifndef INPUT_H_
+#define INPUT_H_
+
+#include <stdint.h>
+
+// Input event types
+#define INPUT_MOVE			1	// move one square: arg1 = dx, arg2 = dy
+#define INPUT_STEP			2	// move forward: arg1 = number of spaces
+#define INPUT_ROLL			3	// start/stop rolling the dice, or roll arg1
+									// (1 to 6) if it isn't 0
+#define INPUT_PAUSE			4	// pause/resume the game
+#define INPUT_START			5	// leave the start or game over screen
+#define INPUT_PLAYERS		6	// arg1 = number of players, or PLAYERS_CPU
+#define INPUT_DIFFICULTY	7	// arg1 = one of the DIFFICULTY_ values below
+#define INPUT_BOARD			8	// switch to the next board, or to board
+									// arg1 (1 to NUM_BOARDS) if it isn't 0
+#define INPUT_SOUND			9	// toggle sound on/off
+#define INPUT_TELEMETRY		10	// toggle binary telemetry on/off
+#define INPUT_TIME_LIMIT	11	// arg1 = time limit in seconds (0 = none)
+#define INPUT_QUERY			12	// reply with the game state
+#define INPUT_RULES			13	// switch to the next house rules, or to
+									// rule set arg1 (1 to NUM_RULE_SETS) if it
+									// isn't 0
+#define INPUT_LINK			14	// play linked to another unit as player
+									// arg1 (1 or 2), or 0 for no link (link.h)
+
+// Argument for INPUT_PLAYERS to play against the computer (ai.h)
+#define PLAYERS_CPU		0
+
+// Arguments for INPUT_DIFFICULTY
+#define DIFFICULTY_EASY		0
+#define DIFFICULTY_MEDIUM	1
+#define DIFFICULTY_HARD		2
+
+// Where an event came from
+#define INPUT_SOURCE_BUTTON		0
+#define INPUT_SOURCE_SERIAL		1
+#define INPUT_SOURCE_JOYSTICK	2
+#define INPUT_SOURCE_COMMAND	3
+#define INPUT_SOURCE_CPU		4	// the computer opponent
+
+// Input contexts. Bindings apply in one or more contexts.
+#define INPUT_CONTEXT_MENU	0x01	// start screen and game over screen
+#define INPUT_CONTEXT_GAME	0x02	// playing or paused
+#define INPUT_CONTEXT_ALL	0xFF
+
+typedef struct {
+	uint8_t type;	// One of the INPUT_ types above
+	uint8_t source;	// One of the INPUT_SOURCE_ values above
+	int8_t arg1;
+	int8_t arg2;
+	uint32_t time;	// get_current_time() when the input happened
+} InputEvent;
+
+/* Set the context used to translate input into events. Events already in
+ * the queue are not affected.
+ */
+void input_set_context(uint8_t context);
+
+/* Return the current input context.
+ */
+uint8_t input_get_context(void);
+
+/* Add an event to the queue. Returns 1 if it was added, 0 if the queue was
+ * full.
+ */
+uint8_t input_push_event(uint8_t type, uint8_t source, int8_t arg1, int8_t arg2,
+		uint32_t time);
+
+/* Move any waiting input from the buttons, serial port and joystick into
+ * the event queue. Input is left with its source if the queue is full, so
+ * nothing is lost as long as this is called regularly.
+ */
+void input_poll(void);
+
+/* Remove the oldest event from the queue and copy it into event. Returns 1
+ * if there was an event, 0 if the queue was empty.
+ */
+uint8_t input_get_event(InputEvent* event);
+
+/* Discard all queued events and any button presses waiting. Serial input
+ * is kept so that scripted input sent ahead isn't lost.
+ */
+void input_clear(void);
+
+
+#endif /* INPUT_H_ */
@@ -0,0 +1,245 @@
+/*
+ * joystick.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * The ADC free-runs at 62.5kHz (8MHz / 128), giving a conversion roughly
+ * every 208us. The conversion complete interrupt accumulates
+ * JOYSTICK_OVERSAMPLE conversions of one axis, runs the average through a
+ * simple IIR low pass filter and then switches to the other axis. Once
+ * both axes have been updated the pair is published to a double buffer, so
+ * the main loop can pick up the latest sample without waiting for the ADC.
+ */
+
+#include "joystick.h"
+#include <stdlib.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "timer0.h"
+
+// Number of conversions averaged into each filtered value (a power of two
+// so the average is a shift).
+#define JOYSTICK_OVERSAMPLE_SHIFT 2
+#define JOYSTICK_OVERSAMPLE (1 << JOYSTICK_OVERSAMPLE_SHIFT)
+
+// Weight given to a new average by the low pass filter. Each new average
+// moves the filtered value 1/(2^JOYSTICK_FILTER_SHIFT) of the way towards it.
+#define JOYSTICK_FILTER_SHIFT 1
+
+// Double buffer of published samples. The ISR always writes the buffer that
+// readers are not using and then flips front_buffer. A new sample is only
+// published every 10 conversions (~2ms) so a reader copying the front buffer
+// can't be overtaken twice.
+static volatile JoystickSample samples[2];
+static volatile uint8_t front_buffer;
+
+// State used only by the ISR
+static uint16_t filtered[2];
+static uint16_t accumulator;
+static uint8_t conversions;
+static uint8_t channel;
+static uint8_t discard_next;
+
+// Calibrated readings further than this from JOYSTICK_CENTRE are rejected
+#define JOYSTICK_CALIBRATION_LIMIT 100
+
+// Axis classes used by the decoder
+#define AXIS_LOW	0
+#define AXIS_CENTRE	1
+#define AXIS_HIGH	2
+
+// Move for each combination of axis classes, indexed by [x class][y class].
+// Pushing the stick along X moves the player up/down the board and pushing
+// it along Y moves the player left/right.
+static const JoystickMove direction_table[3][3] = {
+	{{ 1, -1}, { 0, -1}, {-1, -1}},
+	{{ 1,  0}, { 0,  0}, {-1,  0}},
+	{{ 1,  1}, { 0,  1}, {-1,  1}}
+};
+
+// Decoder states
+#define DECODER_IDLE		0	// stick in the centre
+#define DECODER_SETTLING	1	// stick moved, waiting for it to settle
+#define DECODER_HELD		2	// move emitted, waiting to repeat
+
+static uint16_t centre_x = JOYSTICK_CENTRE;
+static uint16_t centre_y = JOYSTICK_CENTRE;
+static uint16_t deadzone = JOYSTICK_DEFAULT_DEADZONE;
+static uint16_t hysteresis = JOYSTICK_DEFAULT_HYSTERESIS;
+static uint16_t repeat_delay = JOYSTICK_DEFAULT_REPEAT_DELAY;
+static uint16_t repeat_interval = JOYSTICK_DEFAULT_REPEAT_MS;
+
+static uint8_t decoder_state;
+static uint8_t class_x = AXIS_CENTRE;
+static uint8_t class_y = AXIS_CENTRE;
+static JoystickMove held_move;
+static uint32_t next_event_time;
+
+void init_joystick(void) {
+	filtered[0] = JOYSTICK_CENTRE;
+	filtered[1] = JOYSTICK_CENTRE;
+	samples[0].x = samples[0].y = JOYSTICK_CENTRE;
+	samples[1].x = samples[1].y = JOYSTICK_CENTRE;
+	front_buffer = 0;
+	accumulator = 0;
+	conversions = 0;
+	channel = 0;
+	discard_next = 1;
+	
+	// The joystick pins are analog only, so turn off their digital input
+	// buffers to save power and reduce noise
+	DIDR0 |= (1<<ADC0D)|(1<<ADC1D);
+	
+	// AVCC reference, start on channel 0 (X)
+	ADMUX = (1<<REFS0);
+	
+	// Free running mode (ADTS bits all 0)
+	ADCSRB = 0;
+	
+	// Enable the ADC with auto triggering and the conversion complete
+	// interrupt, divide the clock by 128 and start the first conversion.
+	ADCSRA = (1<<ADEN)|(1<<ADSC)|(1<<ADATE)|(1<<ADIE)
+			|(1<<ADPS2)|(1<<ADPS1)|(1<<ADPS0);
+}
+
+void joystick_read(JoystickSample* sample) {
+	uint8_t buffer = front_buffer;
+	sample->x = samples[buffer].x;
+	sample->y = samples[buffer].y;
+}
+
+ISR(ADC_vect) {
+	uint16_t value = ADC;
+	
+	// In free running mode the next conversion has already started by the
+	// time we get here, so a change of channel only applies to the
+	// conversion after it. Throw away the one result that may have been
+	// taken from the previous channel.
+	if (discard_next) {
+		discard_next = 0;
+		return;
+	}
+	
+	accumulator += value;
+	if (++conversions < JOYSTICK_OVERSAMPLE) {
+		return;
+	}
+	value = accumulator >> JOYSTICK_OVERSAMPLE_SHIFT;
+	accumulator = 0;
+	conversions = 0;
+	
+	if (value >= filtered[channel]) {
+		filtered[channel] += (value - filtered[channel]) >> JOYSTICK_FILTER_SHIFT;
+	} else {
+		filtered[channel] -= (filtered[channel] - value) >> JOYSTICK_FILTER_SHIFT;
+	}
+	
+	if (channel == 1) {
+		// Both axes are up to date - publish them into the back buffer
+		uint8_t back_buffer = front_buffer ^ 1;
+		samples[back_buffer].x = filtered[0];
+		samples[back_buffer].y = filtered[1];
+		front_buffer = back_buffer;
+	}
+	
+	channel ^= 1;
+	ADMUX = (ADMUX & ~(1<<MUX0)) | (channel << MUX0);
+	discard_next = 1;
+}
+
+void joystick_calibrate(void) {
+	JoystickSample sample;
+	joystick_read(&sample);
+	if (abs((int16_t)sample.x - JOYSTICK_CENTRE) <= JOYSTICK_CALIBRATION_LIMIT &&
+			abs((int16_t)sample.y - JOYSTICK_CENTRE) <= JOYSTICK_CALIBRATION_LIMIT) {
+		centre_x = sample.x;
+		centre_y = sample.y;
+	}
+	decoder_state = DECODER_IDLE;
+	class_x = AXIS_CENTRE;
+	class_y = AXIS_CENTRE;
+}
+
+void joystick_set_deadzone(uint16_t new_deadzone, uint16_t new_hysteresis) {
+	if (new_hysteresis < new_deadzone) {
+		deadzone = new_deadzone;
+		hysteresis = new_hysteresis;
+	}
+}
+
+void joystick_set_repeat(uint16_t delay_ms, uint16_t interval_ms) {
+	repeat_delay = delay_ms;
+	repeat_interval = interval_ms;
+}
+
+// Classify one axis, given its previous class. The threshold to leave a
+// class is wider than the threshold to enter it, so noise around the
+// boundary can't make the class flicker.
+static uint8_t classify_axis(uint16_t value, uint16_t centre, uint8_t previous) {
+	int16_t deflection = (int16_t)value - (int16_t)centre;
+	int16_t enter = deadzone;
+	int16_t leave = deadzone - hysteresis;
+	
+	if (previous == AXIS_HIGH && deflection > leave) {
+		return AXIS_HIGH;
+	}
+	if (previous == AXIS_LOW && deflection < -leave) {
+		return AXIS_LOW;
+	}
+	if (deflection > enter) {
+		return AXIS_HIGH;
+	}
+	if (deflection < -enter) {
+		return AXIS_LOW;
+	}
+	return AXIS_CENTRE;
+}
+
+uint8_t joystick_get_move(JoystickMove* move) {
+	JoystickSample sample;
+	joystick_read(&sample);
+	uint32_t now = get_current_time();
+	
+	class_x = classify_axis(sample.x, centre_x, class_x);
+	class_y = classify_axis(sample.y, centre_y, class_y);
+	JoystickMove direction = direction_table[class_x][class_y];
+	
+	if (direction.dx == 0 && direction.dy == 0) {
+		decoder_state = DECODER_IDLE;
+		return 0;
+	}
+	
+	// A new direction (from the centre or from another direction) has to
+	// settle before it is reported.
+	if (decoder_state == DECODER_IDLE || direction.dx != held_move.dx ||
+			direction.dy != held_move.dy) {
+		held_move = direction;
+		decoder_state = DECODER_SETTLING;
+		next_event_time = now + JOYSTICK_DEFAULT_SETTLE_MS;
+		return 0;
+	}
+	
+	if (now < next_event_time) {
+		return 0;
+	}
+	
+	if (decoder_state == DECODER_SETTLING) {
+		decoder_state = DECODER_HELD;
+		if (repeat_delay == 0) {
+			// Never repeat - wait for the stick to return to the centre
+			next_event_time = UINT32_MAX;
+		} else {
+			next_event_time = now + repeat_delay;
+		}
+	} else {
+		// Schedule from the previous deadline rather than now so the
+		// repeat rate doesn't depend on how often we're called. If we've
+		// fallen more than a whole interval behind, don't try to catch up.
+		next_event_time += repeat_interval;
+		if (next_event_time <= now) {
+			next_event_time = now + repeat_interval;
+		}
+	}
+	*move = held_move;
+	return 1;
+}
@@ -0,0 +1,92 @@
+/*
+ * joystick.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * The joystick X and Y axes are connected to ADC0 and ADC1 (pins A0 and A1).
+ * The ADC is run in free-running (auto-trigger) mode and the conversion
+ * complete interrupt alternates between the two channels, oversampling and
+ * filtering each axis before publishing the result. Interrupts must be
+ * enabled globally for samples to be taken.
+ *
+ * The samples are decoded into discrete moves by a small state machine.
+ * Each axis is classified as low, centre or high using a calibrated centre,
+ * a deadzone and a hysteresis band, and the pair of classes is looked up in
+ * a direction table. Holding the stick produces a first move once the
+ * direction has settled and then repeats it at a fixed, configurable rate.
+ */
+
+
+#ifndef JOYSTICK_H_
+#define JOYSTICK_H_
+
+#include <stdint.h>
+
+// Centre reading of a 10 bit axis. Filtered values start here so the first
+// samples after initialisation don't register as a move.
+#define JOYSTICK_CENTRE 512
+
+// Default decoder settings. Deflections are measured from the calibrated
+// centre. An axis leaves the centre once it is deflected by more than
+// JOYSTICK_DEFAULT_DEADZONE and returns to it once it is back within
+// JOYSTICK_DEFAULT_DEADZONE - JOYSTICK_DEFAULT_HYSTERESIS.
+#define JOYSTICK_DEFAULT_DEADZONE		320
+#define JOYSTICK_DEFAULT_HYSTERESIS		100
+// A direction must be held this long before the first move is emitted
+// (so a diagonal doesn't first register as the cardinal direction it
+// passes through).
+#define JOYSTICK_DEFAULT_SETTLE_MS		30
+// Holding a direction repeats the move after the delay and then at the
+// given interval.
+#define JOYSTICK_DEFAULT_REPEAT_DELAY	400
+#define JOYSTICK_DEFAULT_REPEAT_MS		200
+
+// A filtered reading of both joystick axes (0 to 1023 each)
+typedef struct {
+	uint16_t x;
+	uint16_t y;
+} JoystickSample;
+
+/* Set up the ADC in free-running mode on the joystick channels and start
+ * converting. It is assumed that global interrupts are off when this
+ * function is called and are enabled sometime after.
+ */
+void init_joystick(void);
+
+/* Copy the most recently published sample of both axes into sample. This
+ * never waits for a conversion.
+ */
+void joystick_read(JoystickSample* sample);
+
+// A discrete move decoded from the joystick. dx and dy are -1, 0 or 1 and
+// follow the board coordinates used by move_player().
+typedef struct {
+	int8_t dx;
+	int8_t dy;
+} JoystickMove;
+
+/* Use the current position of the stick as its centre. The stick should be
+ * at rest when this is called. A reading too far from the nominal centre is
+ * assumed to be a held stick and is ignored. This also resets the decoder
+ * so a held stick must return to the centre before it moves again.
+ */
+void joystick_calibrate(void);
+
+/* Set the deadzone and hysteresis (in ADC counts from the centre). The
+ * hysteresis must be smaller than the deadzone.
+ */
+void joystick_set_deadzone(uint16_t deadzone, uint16_t hysteresis);
+
+/* Set the auto-repeat timing in milliseconds. A delay of 0 turns
+ * auto-repeat off (one move per push of the stick).
+ */
+void joystick_set_repeat(uint16_t delay_ms, uint16_t interval_ms);
+
+/* Run the decoder on the latest sample. Returns 1 and fills in move if a
+ * move is due, 0 otherwise. This never blocks and should be called
+ * regularly from the main loop.
+ */
+uint8_t joystick_get_move(JoystickMove* move);
+
+
+#endif /* JOYSTICK_H_ */
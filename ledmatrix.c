@@ -1,116 +1,217 @@
-/*
- * ledmatrix.c
- *
- * Author: Peter Sutton
- * 
- * See the LED matrix Reference for details of the SPI commands used.
- */ 
-
-#include "ledmatrix.h"
-#include <avr/io.h>
-#include "spi.h"
-
-#define CMD_UPDATE_ALL		0x00
-#define CMD_UPDATE_PIXEL	0x01
-#define CMD_UPDATE_ROW		0x02
-#define CMD_UPDATE_COL		0x03
-#define CMD_SHIFT_DISPLAY	0x04
-#define CMD_CLEAR_SCREEN	0x0F
-
-void ledmatrix_setup(void) {
-	// Setup SPI - we divide the clock by 128.
-	// (This speed guarantees the SPI buffer will never overflow on
-	// the LED matrix.)
-	spi_setup_master(128);
-}
-
-void ledmatrix_update_all(MatrixData data) {
-	(void)spi_send_byte(CMD_UPDATE_ALL);
-	for(uint8_t y=0; y<MATRIX_NUM_ROWS; y++) {
-		for(uint8_t x=0; x<MATRIX_NUM_COLUMNS; x++) {
-			(void)spi_send_byte(data[x][y]);
-		}
-	}
-}
-
-void ledmatrix_update_pixel(uint8_t x, uint8_t y, PixelColour pixel) {
-	if(x >= MATRIX_NUM_COLUMNS || y >= MATRIX_NUM_ROWS) {
-		// Position isn't valid - we ignore the request.
-		return;
-	}
-	(void)spi_send_byte(CMD_UPDATE_PIXEL);
-	(void)spi_send_byte(((y & 0x07) << 4) | (x & 0x0F));
-	(void)spi_send_byte(pixel);
-}
-
-void ledmatrix_update_row(uint8_t y, MatrixRow row) {
-	if(y >= MATRIX_NUM_ROWS) {
-		// y value is too large - we ignore the request
-		return;
-	}
-	(void)spi_send_byte(CMD_UPDATE_ROW);
-	(void)spi_send_byte(y & 0x07);	// row number
-	for(uint8_t x = 0; x<MATRIX_NUM_COLUMNS; x++) {
-		(void)spi_send_byte(row[x]);
-	}
-}
-
-void ledmatrix_update_column(uint8_t x, MatrixColumn col) {
-	if(x >= MATRIX_NUM_COLUMNS) {
-		// x value is too large - we ignore the request
-		return;
-	}
-	(void)spi_send_byte(CMD_UPDATE_COL);
-	(void)spi_send_byte(x & 0x0F); // column number
-	for(uint8_t y = 0; y<MATRIX_NUM_ROWS; y++) {
-		(void)spi_send_byte(col[y]);
-	}
-}
-
-void ledmatrix_shift_display_left(void) {
-	(void)spi_send_byte(CMD_SHIFT_DISPLAY);
-	(void)spi_send_byte(0x02);
-}
-
-void ledmatrix_shift_display_right(void) {
-	(void)spi_send_byte(CMD_SHIFT_DISPLAY);
-	(void)spi_send_byte(0x01);
-}
-
-void ledmatrix_shift_display_up(void) {
-	(void)spi_send_byte(CMD_SHIFT_DISPLAY);
-	(void)spi_send_byte(0x08);
-}
-
-void ledmatrix_shift_display_down(void) {
-	(void)spi_send_byte(CMD_SHIFT_DISPLAY);
-	(void)spi_send_byte(0x04);
-}
-
-void ledmatrix_clear(void) {
-	(void)spi_send_byte(CMD_CLEAR_SCREEN);
-}
-
-void copy_matrix_column(MatrixColumn from, MatrixColumn to) {
-	for(uint8_t row = 0; row <MATRIX_NUM_ROWS; row++) {
-		to[row] = from[row];
-	}
-}
-
-void copy_matrix_row(MatrixRow from, MatrixRow to) {
-	for(uint8_t col = 0; col < MATRIX_NUM_COLUMNS; col++) {
-		to[col] = from[col];
-	}
-}
-
-void set_matrix_column_to_colour(MatrixColumn matrix_column, PixelColour colour) {
-	for(uint8_t row = 0; row < MATRIX_NUM_ROWS; row++) {
-		matrix_column[row] = colour;
-	}
-}
-
-void set_matrix_row_to_colour(MatrixRow matrix_row, PixelColour colour) {
-	for(uint8_t column = 0; column < MATRIX_NUM_COLUMNS; column++) {
-		matrix_row[column] = colour;
-	}
-}
+/*
+ * ledmatrix.c
+ *
+ * Author: Peter Sutton
+ * 
+ * See the LED matrix Reference for details of the SPI commands used.
+ */ 
+
+#include "ledmatrix.h"
+#include <avr/io.h>
+#include "spi.h"
+
+#define CMD_UPDATE_ALL		0x00
+#define CMD_UPDATE_PIXEL	0x01
+#define CMD_UPDATE_ROW		0x02
+#define CMD_UPDATE_COL		0x03
+#define CMD_SHIFT_DISPLAY	0x04
+#define CMD_CLEAR_SCREEN	0x0F
+
+// The shadow frame by row, and the pixels changed since they were last
+// sent - bit x of changed[y] for pixel (x, y)
+static PixelColour shadow[MATRIX_NUM_ROWS][MATRIX_NUM_COLUMNS];
+static uint16_t changed[MATRIX_NUM_ROWS];
+static int8_t shift_x;
+static int8_t shift_y;
+
+static void set_shadow(uint8_t x, uint8_t y, PixelColour pixel) {
+	if(shadow[y][x] != pixel) {
+		shadow[y][x] = pixel;
+		changed[y] |= (uint16_t)1 << x;
+	}
+}
+
+// The display moves dx columns and dy rows (each -1, 0 or 1). The pixels
+// shifted in are blank, and are marked as changed because what was sent
+// for them may have been shifted away.
+static void shift_shadow(int8_t dx, int8_t dy) {
+	if(dy > 0) {
+		for(uint8_t y = MATRIX_NUM_ROWS - 1; y > 0; y--) {
+			copy_matrix_row(shadow[y - 1], shadow[y]);
+			changed[y] = changed[y - 1];
+		}
+		set_matrix_row_to_colour(shadow[0], COLOUR_BLACK);
+		changed[0] = 0xFFFF;
+	} else if(dy < 0) {
+		for(uint8_t y = 0; y < MATRIX_NUM_ROWS - 1; y++) {
+			copy_matrix_row(shadow[y + 1], shadow[y]);
+			changed[y] = changed[y + 1];
+		}
+		set_matrix_row_to_colour(shadow[MATRIX_NUM_ROWS - 1], COLOUR_BLACK);
+		changed[MATRIX_NUM_ROWS - 1] = 0xFFFF;
+	}
+	for(uint8_t y = 0; y < MATRIX_NUM_ROWS; y++) {
+		if(dx > 0) {
+			for(uint8_t x = MATRIX_NUM_COLUMNS - 1; x > 0; x--) {
+				shadow[y][x] = shadow[y][x - 1];
+			}
+			shadow[y][0] = COLOUR_BLACK;
+			changed[y] = (changed[y] << 1) | 0x0001;
+		} else if(dx < 0) {
+			for(uint8_t x = 0; x < MATRIX_NUM_COLUMNS - 1; x++) {
+				shadow[y][x] = shadow[y][x + 1];
+			}
+			shadow[y][MATRIX_NUM_COLUMNS - 1] = COLOUR_BLACK;
+			changed[y] = (changed[y] >> 1) | 0x8000;
+		}
+	}
+	shift_x += dx;
+	shift_y += dy;
+	if(shift_x < -8 || shift_x > 7 || shift_y < -8 || shift_y > 7) {
+		// Too far to send as a shift - with every pixel to be sent again
+		// the shift doesn't matter
+		ledmatrix_mark_all_changed();
+	}
+}
+
+void ledmatrix_setup(void) {
+	// Setup SPI - we divide the clock by 128.
+	// (This speed guarantees the SPI buffer will never overflow on
+	// the LED matrix.)
+	spi_setup_master(128);
+}
+
+void ledmatrix_update_all(MatrixData data) {
+	(void)spi_send_byte(CMD_UPDATE_ALL);
+	for(uint8_t y=0; y<MATRIX_NUM_ROWS; y++) {
+		for(uint8_t x=0; x<MATRIX_NUM_COLUMNS; x++) {
+			(void)spi_send_byte(data[x][y]);
+			set_shadow(x, y, data[x][y]);
+		}
+	}
+}
+
+void ledmatrix_update_pixel(uint8_t x, uint8_t y, PixelColour pixel) {
+	if(x >= MATRIX_NUM_COLUMNS || y >= MATRIX_NUM_ROWS) {
+		// Position isn't valid - we ignore the request.
+		return;
+	}
+	(void)spi_send_byte(CMD_UPDATE_PIXEL);
+	(void)spi_send_byte(((y & 0x07) << 4) | (x & 0x0F));
+	(void)spi_send_byte(pixel);
+	set_shadow(x, y, pixel);
+}
+
+void ledmatrix_update_row(uint8_t y, MatrixRow row) {
+	if(y >= MATRIX_NUM_ROWS) {
+		// y value is too large - we ignore the request
+		return;
+	}
+	(void)spi_send_byte(CMD_UPDATE_ROW);
+	(void)spi_send_byte(y & 0x07);	// row number
+	for(uint8_t x = 0; x<MATRIX_NUM_COLUMNS; x++) {
+		(void)spi_send_byte(row[x]);
+		set_shadow(x, y, row[x]);
+	}
+}
+
+void ledmatrix_update_column(uint8_t x, MatrixColumn col) {
+	if(x >= MATRIX_NUM_COLUMNS) {
+		// x value is too large - we ignore the request
+		return;
+	}
+	(void)spi_send_byte(CMD_UPDATE_COL);
+	(void)spi_send_byte(x & 0x0F); // column number
+	for(uint8_t y = 0; y<MATRIX_NUM_ROWS; y++) {
+		(void)spi_send_byte(col[y]);
+		set_shadow(x, y, col[y]);
+	}
+}
+
+void ledmatrix_shift_display_left(void) {
+	(void)spi_send_byte(CMD_SHIFT_DISPLAY);
+	(void)spi_send_byte(0x02);
+	shift_shadow(-1, 0);
+}
+
+void ledmatrix_shift_display_right(void) {
+	(void)spi_send_byte(CMD_SHIFT_DISPLAY);
+	(void)spi_send_byte(0x01);
+	shift_shadow(1, 0);
+}
+
+void ledmatrix_shift_display_up(void) {
+	(void)spi_send_byte(CMD_SHIFT_DISPLAY);
+	(void)spi_send_byte(0x08);
+	shift_shadow(0, -1);
+}
+
+void ledmatrix_shift_display_down(void) {
+	(void)spi_send_byte(CMD_SHIFT_DISPLAY);
+	(void)spi_send_byte(0x04);
+	shift_shadow(0, 1);
+}
+
+void ledmatrix_clear(void) {
+	(void)spi_send_byte(CMD_CLEAR_SCREEN);
+	for(uint8_t y = 0; y < MATRIX_NUM_ROWS; y++) {
+		for(uint8_t x = 0; x < MATRIX_NUM_COLUMNS; x++) {
+			set_shadow(x, y, COLOUR_BLACK);
+		}
+	}
+}
+
+PixelColour ledmatrix_get_pixel(uint8_t index) {
+	return shadow[index / MATRIX_NUM_COLUMNS][index % MATRIX_NUM_COLUMNS];
+}
+
+uint8_t ledmatrix_pixel_changed(uint8_t index) {
+	return (changed[index / MATRIX_NUM_COLUMNS] >>
+			(index % MATRIX_NUM_COLUMNS)) & 1;
+}
+
+void ledmatrix_get_shift(int8_t* dx, int8_t* dy) {
+	*dx = shift_x;
+	*dy = shift_y;
+}
+
+void ledmatrix_changes_sent(uint8_t start, uint8_t end) {
+	for(uint8_t index = start; index < end; index++) {
+		changed[index / MATRIX_NUM_COLUMNS] &=
+				~((uint16_t)1 << (index % MATRIX_NUM_COLUMNS));
+	}
+	shift_x = 0;
+	shift_y = 0;
+}
+
+void ledmatrix_mark_all_changed(void) {
+	for(uint8_t y = 0; y < MATRIX_NUM_ROWS; y++) {
+		changed[y] = 0xFFFF;
+	}
+	shift_x = 0;
+	shift_y = 0;
+}
+
+void copy_matrix_column(MatrixColumn from, MatrixColumn to) {
+	for(uint8_t row = 0; row <MATRIX_NUM_ROWS; row++) {
+		to[row] = from[row];
+	}
+}
+
+void copy_matrix_row(MatrixRow from, MatrixRow to) {
+	for(uint8_t col = 0; col < MATRIX_NUM_COLUMNS; col++) {
+		to[col] = from[col];
+	}
+}
+
+void set_matrix_column_to_colour(MatrixColumn matrix_column, PixelColour colour) {
+	for(uint8_t row = 0; row < MATRIX_NUM_ROWS; row++) {
+		matrix_column[row] = colour;
+	}
+}
+
+void set_matrix_row_to_colour(MatrixRow matrix_row, PixelColour colour) {
+	for(uint8_t column = 0; column < MATRIX_NUM_COLUMNS; column++) {
+		matrix_row[column] = colour;
+	}
+}
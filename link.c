@@ -0,0 +1,385 @@
+/*
+ * link.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * USART1 is driven by interrupts through two small rings, like the
+ * serial port in serialio.c. Frames are only built and taken apart in
+ * link_poll(), from the main loop, so the interrupt handlers just move
+ * bytes.
+ */
+
+#include "link.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/crc16.h>
+#include "telemetry.h"
+#include "timer0.h"
+#include "game.h"
+
+#define SYSCLK 8000000L
+
+// Double speed mode: 38400 baud is 0.2% fast
+#define LINK_UBRR ((SYSCLK / 8 + LINK_BAUD / 2) / LINK_BAUD - 1)
+
+// Kind, sequence number, event and CRC
+#define FRAME_SIZE (2 + sizeof(LinkEvent) + 2)
+
+// The most a frame can take once SLIP encoded - every byte escaped, and
+// the two SLIP_END delimiters
+#define ENCODED_SIZE (FRAME_SIZE * 2 + 2)
+
+// Rings between the main loop and the interrupt handlers. The sizes must
+// be powers of two no larger than 256.
+#define RX_SIZE 64
+#define RX_MASK (RX_SIZE - 1)
+#define TX_SIZE 32
+#define TX_MASK (TX_SIZE - 1)
+static volatile uint8_t rx_buffer[RX_SIZE];
+static volatile uint8_t rx_head;
+static volatile uint8_t rx_tail;
+static volatile uint8_t tx_buffer[TX_SIZE];
+static volatile uint8_t tx_head;
+static volatile uint8_t tx_tail;
+
+// Events waiting to be sent (the oldest is the one in flight), and those
+// received waiting to be played. The size must be a power of two.
+#define QUEUE_SIZE 4
+#define QUEUE_MASK (QUEUE_SIZE - 1)
+
+typedef struct {
+	LinkEvent event;
+	uint8_t ends_turn;
+} Outgoing;
+
+static Outgoing send_queue[QUEUE_SIZE];
+static uint8_t send_head;
+static uint8_t send_tail;
+static uint8_t send_sequence;	// sequence number of the oldest
+static uint8_t sent;			// whether the oldest has been sent yet
+static uint32_t first_sent;		// when it was first sent
+static uint32_t last_sent;		// and when it was last sent
+static uint16_t resend_ms;		// how long to wait before sending it again
+
+static InputEvent receive_queue[QUEUE_SIZE];
+static uint8_t receive_head;
+static uint8_t receive_tail;
+static uint8_t last_received;	// sequence number of the last event played
+static uint8_t have_received;
+
+// The frame being received
+static uint8_t frame[FRAME_SIZE];
+static uint8_t frame_length;
+static uint8_t frame_escaped;
+static uint8_t frame_bad;
+
+static uint8_t player;
+static LinkStats stats;
+
+void link_set_player(uint8_t new_player) {
+	UCSR1B = 0;
+	player = new_player;
+	rx_head = rx_tail = 0;
+	tx_head = tx_tail = 0;
+	send_head = send_tail = 0;
+	receive_head = receive_tail = 0;
+	if (!player) {
+		return;
+	}
+	sent = 0;
+	have_received = 0;
+	frame_length = 0;
+	frame_escaped = 0;
+	frame_bad = 0;
+	stats = (LinkStats){0};
+	// Start from the time, so a unit that turns the link off and on again
+	// is unlikely to reuse the sequence number the other unit last saw
+	send_sequence = get_current_time();
+	UBRR1 = LINK_UBRR;
+	UCSR1A = (1 << U2X1);
+	UCSR1C = (1 << UCSZ11) | (1 << UCSZ10);
+	UCSR1B = (1 << RXEN1) | (1 << TXEN1) | (1 << RXCIE1);
+}
+
+uint8_t link_player(void) {
+	return player;
+}
+
+uint8_t link_playing(void) {
+	return player && get_cur_player() != player - 1;
+}
+
+uint8_t link_ready(void) {
+	return ((send_head + 1) & QUEUE_MASK) != send_tail;
+}
+
+uint8_t link_send_event(uint8_t type, uint8_t source, int8_t arg1,
+		int8_t arg2, uint8_t ends_turn) {
+	if (!link_ready()) {
+		return 0;
+	}
+	Outgoing* outgoing = &send_queue[send_head];
+	outgoing->event.type = type;
+	outgoing->event.source = source;
+	outgoing->event.arg1 = arg1;
+	outgoing->event.arg2 = arg2;
+	outgoing->ends_turn = ends_turn;
+	send_head = (send_head + 1) & QUEUE_MASK;
+	return 1;
+}
+
+static uint8_t tx_space(void) {
+	return (tx_tail - tx_head - 1) & TX_MASK;
+}
+
+static void encode_byte(uint8_t* data, uint8_t* length, uint8_t byte) {
+	if (byte == SLIP_END) {
+		data[(*length)++] = SLIP_ESC;
+		byte = SLIP_ESC_END;
+	} else if (byte == SLIP_ESC) {
+		data[(*length)++] = SLIP_ESC;
+		byte = SLIP_ESC_ESC;
+	} else if (byte == SLIP_XON) {
+		data[(*length)++] = SLIP_ESC;
+		byte = SLIP_ESC_XON;
+	} else if (byte == SLIP_XOFF) {
+		data[(*length)++] = SLIP_ESC;
+		byte = SLIP_ESC_XOFF;
+	}
+	data[(*length)++] = byte;
+}
+
+// Queue a frame for USART1 - all of it, or none of it if there isn't room.
+// Returns 1 if it was queued.
+static uint8_t send_frame(uint8_t kind, uint8_t sequence,
+		const LinkEvent* event) {
+	uint8_t raw[FRAME_SIZE];
+	uint8_t raw_length = 0;
+	raw[raw_length++] = kind;
+	raw[raw_length++] = sequence;
+	if (event) {
+		raw[raw_length++] = event->type;
+		raw[raw_length++] = event->source;
+		raw[raw_length++] = event->arg1;
+		raw[raw_length++] = event->arg2;
+	}
+	uint16_t crc = 0xFFFF;
+	for (uint8_t i = 0; i < raw_length; i++) {
+		crc = _crc_xmodem_update(crc, raw[i]);
+	}
+	raw[raw_length++] = crc & 0xFF;
+	raw[raw_length++] = crc >> 8;
+
+	uint8_t data[ENCODED_SIZE];
+	uint8_t length = 0;
+	data[length++] = SLIP_END;
+	for (uint8_t i = 0; i < raw_length; i++) {
+		encode_byte(data, &length, raw[i]);
+	}
+	data[length++] = SLIP_END;
+	if (tx_space() < length) {
+		return 0;
+	}
+	uint8_t head = tx_head;
+	for (uint8_t i = 0; i < length; i++) {
+		tx_buffer[head] = data[i];
+		head = (head + 1) & TX_MASK;
+	}
+	tx_head = head;
+	UCSR1B |= (1 << UDRIE1);
+	return 1;
+}
+
+static void count_bad_frame(void) {
+	if (stats.bad_frames < UINT8_MAX) {
+		stats.bad_frames++;
+	}
+}
+
+// Add a received byte to the frame. Returns the length of the frame when
+// the byte ends one with nothing wrong with its SLIP encoding, otherwise 0.
+static uint8_t receive_byte(uint8_t c) {
+	if (c == SLIP_END) {
+		uint8_t length = frame_length;
+		if (frame_bad) {
+			count_bad_frame();
+			length = 0;
+		}
+		frame_length = 0;
+		frame_escaped = 0;
+		frame_bad = 0;
+		return length;
+	}
+	if (c == SLIP_XON || c == SLIP_XOFF) {
+		return 0;
+	}
+	if (frame_escaped) {
+		frame_escaped = 0;
+		if (c == SLIP_ESC_END) {
+			c = SLIP_END;
+		} else if (c == SLIP_ESC_ESC) {
+			c = SLIP_ESC;
+		} else if (c == SLIP_ESC_XON) {
+			c = SLIP_XON;
+		} else if (c == SLIP_ESC_XOFF) {
+			c = SLIP_XOFF;
+		} else {
+			frame_bad = 1;
+		}
+	} else if (c == SLIP_ESC) {
+		frame_escaped = 1;
+		return 0;
+	}
+	if (frame_length == FRAME_SIZE) {
+		frame_bad = 1;
+	} else {
+		frame[frame_length++] = c;
+	}
+	return 0;
+}
+
+// An event from the other unit. It's acknowledged once it's been queued
+// to play (or if it has been already), and otherwise left for the other
+// unit to send again.
+static void receive_event(uint8_t sequence, uint32_t now) {
+	if (have_received && sequence == last_received) {
+		send_frame(LINK_ACK, sequence, NULL);
+		return;
+	}
+	uint8_t next = (receive_head + 1) & QUEUE_MASK;
+	if (next == receive_tail) {
+		return;
+	}
+	InputEvent* event = &receive_queue[receive_head];
+	event->type = frame[2];
+	event->source = frame[3];
+	event->arg1 = frame[4];
+	event->arg2 = frame[5];
+	event->time = now;
+	receive_head = next;
+	last_received = sequence;
+	have_received = 1;
+	send_frame(LINK_ACK, sequence, NULL);
+}
+
+// The acknowledgement of the event in flight. Returns 1 if that event
+// ended a turn, and so its round trip has been measured.
+static uint8_t receive_ack(uint8_t sequence, uint32_t now) {
+	if (!sent || sequence != send_sequence) {
+		return 0;
+	}
+	uint8_t ends_turn = send_queue[send_tail].ends_turn;
+	send_tail = (send_tail + 1) & QUEUE_MASK;
+	send_sequence++;
+	sent = 0;
+	if (!ends_turn) {
+		return 0;
+	}
+	uint16_t rtt = now - first_sent;
+	stats.turns++;
+	stats.last_rtt = rtt;
+	if (rtt > stats.max_rtt) {
+		stats.max_rtt = rtt;
+	}
+	stats.total_rtt += rtt;
+	return 1;
+}
+
+// A frame of length bytes has been received. Returns 1 if it
+// acknowledged the end of a turn.
+static uint8_t handle_frame(uint8_t length, uint32_t now) {
+	if (length < 4) {
+		count_bad_frame();
+		return 0;
+	}
+	uint16_t crc = 0xFFFF;
+	for (uint8_t i = 0; i < length - 2; i++) {
+		crc = _crc_xmodem_update(crc, frame[i]);
+	}
+	if ((frame[length - 2] | (frame[length - 1] << 8)) != crc) {
+		count_bad_frame();
+		return 0;
+	}
+	if (frame[0] == LINK_EVENT && length == FRAME_SIZE) {
+		receive_event(frame[1], now);
+	} else if (frame[0] == LINK_ACK && length == 4) {
+		return receive_ack(frame[1], now);
+	} else {
+		count_bad_frame();
+	}
+	return 0;
+}
+
+uint8_t link_poll(void) {
+	if (!player) {
+		return 0;
+	}
+	uint32_t now = get_current_time();
+	uint8_t measured = 0;
+	uint8_t tail = rx_tail;
+	while (tail != rx_head) {
+		uint8_t c = rx_buffer[tail];
+		tail = (tail + 1) & RX_MASK;
+		uint8_t length = receive_byte(c);
+		if (length) {
+			measured |= handle_frame(length, now);
+		}
+	}
+	rx_tail = tail;
+
+	// Send the oldest event waiting if it hasn't been sent, or send it
+	// again if it hasn't been acknowledged in time
+	if (send_tail != send_head &&
+			(!sent || now - last_sent >= resend_ms) &&
+			send_frame(LINK_EVENT, send_sequence,
+					&send_queue[send_tail].event)) {
+		if (!sent) {
+			sent = 1;
+			first_sent = now;
+			resend_ms = LINK_RESEND_MS;
+		} else {
+			if (resend_ms < LINK_RESEND_MAX_MS) {
+				resend_ms *= 2;
+			}
+			if (stats.resent < UINT8_MAX) {
+				stats.resent++;
+			}
+		}
+		last_sent = now;
+	}
+	return measured;
+}
+
+uint8_t link_get_event(InputEvent* event) {
+	if (receive_tail == receive_head) {
+		return 0;
+	}
+	*event = receive_queue[receive_tail];
+	receive_tail = (receive_tail + 1) & QUEUE_MASK;
+	return 1;
+}
+
+void link_get_stats(LinkStats* link_stats) {
+	*link_stats = stats;
+}
+
+ISR(USART1_RX_vect) {
+	// A byte with a framing error is kept - the frame's CRC will fail
+	uint8_t c = UDR1;
+	uint8_t head = rx_head;
+	uint8_t next = (head + 1) & RX_MASK;
+	if (next != rx_tail) {
+		rx_buffer[head] = c;
+		rx_head = next;
+	}
+}
+
+ISR(USART1_UDRE_vect) {
+	uint8_t tail = tx_tail;
+	if (tail != tx_head) {
+		UDR1 = tx_buffer[tail];
+		tx_tail = (tail + 1) & TX_MASK;
+	} else {
+		UCSR1B &= ~(1 << UDRIE1);
+	}
+}
@@ -0,0 +1,119 @@
+/*
+ * link.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * Two units playing one game over a serial link on USART1 (RXD1 on D2,
+ * TXD1 on D3, crossed over between the units, with a common ground). Each
+ * unit plays one of the players and takes input for that player only.
+ * The moves made on a unit are sent to the other one as the input events
+ * that made them, and the other unit plays them through its own copy of
+ * the game. The rules in game.c and rules.c are deterministic once the
+ * dice values are known, so a roll is sent as the dice it stopped on and
+ * both units stay in step without ever sending the board.
+ *
+ * A move is shown straight away on the unit that made it. Its event is
+ * then sent, and sent again until the other unit acknowledges it - first
+ * after LINK_RESEND_MS, then waiting twice as long each time up to
+ * LINK_RESEND_MAX_MS, so a unit busy showing a long move isn't flooded
+ * with copies. Events are sent one at a time, in order, and a repeat
+ * of the last event received (its acknowledgement was lost) is
+ * acknowledged again but not played twice. The time from sending the
+ * event that ends a turn to its acknowledgement is the turn's round trip.
+ *
+ * Frame format (before SLIP encoding, exactly as for telemetry.h):
+ *   kind (1 byte), sequence number (1 byte), payload, CRC-16 (2 bytes)
+ * LINK_EVENT carries an input event (LinkEvent) and LINK_ACK has no
+ * payload - its sequence number is that of the event it acknowledges.
+ * Each side numbers its events from any starting point, adding one for
+ * each new event.
+ *
+ * The dice LED on D2 can't be used while the link is on.
+ *
+ * The constants and payload structure are shared with the host stand-in
+ * for the other unit (host/link) so this header must only depend on
+ * stdint.h and input.h.
+ */
+
+
+#ifndef LINK_H_
+#define LINK_H_
+
+#include <stdint.h>
+#include "input.h"
+
+#define LINK_BAUD 38400
+
+// Frame kinds
+#define LINK_EVENT	0x01
+#define LINK_ACK	0x02
+
+// How long to wait for an acknowledgement before sending an event again
+// the first time, and at most (ms)
+#define LINK_RESEND_MS 50
+#define LINK_RESEND_MAX_MS 800
+
+// Payload of LINK_EVENT (4 bytes, in this order). The fields match
+// InputEvent in input.h. The events sent are INPUT_MOVE, INPUT_STEP and
+// INPUT_ROLL for moves - a roll is sent once as it starts (arg1 = 0) and
+// once as it stops, with arg1 the first die and arg2 the second (0 with
+// one die) - and INPUT_START to start a game, with arg1 the board (1 to
+// NUM_BOARDS) and arg2 the rule set (1 to NUM_RULE_SETS).
+typedef struct {
+	uint8_t type;
+	uint8_t source;
+	int8_t arg1;
+	int8_t arg2;
+} LinkEvent;
+
+typedef struct {
+	uint16_t turns;		// turns whose round trip has been measured
+	uint16_t last_rtt;	// round trip for the last turn (ms)
+	uint16_t max_rtt;
+	uint32_t total_rtt;
+	uint8_t resent;		// events sent again (stops at 255)
+	uint8_t bad_frames;	// frames received with a bad CRC (stops at 255)
+} LinkStats;
+
+/* Play as player (1 or 2) on this unit with the other player on the other
+ * unit, or turn the link off with 0. Turning it on starts USART1 and
+ * clears anything waiting to be sent or played.
+ */
+void link_set_player(uint8_t player);
+
+/* The player this unit plays, or 0 if the link is off.
+ */
+uint8_t link_player(void);
+
+/* Returns non-zero if the link is on and it's the other unit's player's
+ * turn.
+ */
+uint8_t link_playing(void);
+
+/* Returns non-zero if there's room to queue another event to send (always
+ * when the link is off).
+ */
+uint8_t link_ready(void);
+
+/* Queue an event to send to the other unit. ends_turn is non-zero if it
+ * ended this unit's player's turn, so its round trip is measured. Returns
+ * 1 if it was queued, 0 if there was no room.
+ */
+uint8_t link_send_event(uint8_t type, uint8_t source, int8_t arg1,
+		int8_t arg2, uint8_t ends_turn);
+
+/* Handle what the other unit has sent and send anything due. Call this
+ * every pass of the game loop. Returns 1 if a turn's round trip has been
+ * measured since the last call.
+ */
+uint8_t link_poll(void);
+
+/* Remove the oldest event received from the other unit and copy it into
+ * event. Returns 1 if there was one, 0 if not (always when the link is
+ * off).
+ */
+uint8_t link_get_event(InputEvent* event);
+
+void link_get_stats(LinkStats* stats);
+
+#endif /* LINK_H_ */
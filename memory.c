@@ -0,0 +1,62 @@
+/*
+ * memory.c
+ *
+ * Author: Adnaan Buksh
+ */
+
+#include "memory.h"
+#include <avr/io.h>
+
+// Value the unused RAM is painted with
+#define STACK_PAINT 0xC5
+
+// Set by the linker. _end is the end of the static variables (and the
+// start of the heap, if there was one).
+extern uint8_t __data_start;
+extern uint8_t __data_end;
+extern uint8_t __bss_start;
+extern uint8_t __bss_end;
+extern uint8_t _end;
+
+// Paint from _end to RAMEND. This runs from .init1, before the stack
+// pointer and the zero register have been set up, so it can't be ordinary
+// C - it mustn't touch the stack or rely on r1 being 0.
+void paint_stack(void) __attribute__((naked, used, section(".init1")));
+
+void paint_stack(void) {
+	__asm volatile (
+		"	ldi r30, lo8(_end)\n"
+		"	ldi r31, hi8(_end)\n"
+		"	ldi r24, %[paint]\n"
+		"	ldi r25, hi8(%[top] + 1)\n"
+		"1:	st Z+, r24\n"
+		"	cpi r30, lo8(%[top] + 1)\n"
+		"	cpc r31, r25\n"
+		"	brlo 1b\n"
+		:
+		: [paint] "M" (STACK_PAINT), [top] "i" (RAMEND)
+	);
+}
+
+// Lowest address the stack has reached
+static uint8_t* stack_low_water(void) {
+	uint8_t* p = &_end;
+	while (p <= (uint8_t*)RAMEND && *p == STACK_PAINT) {
+		p++;
+	}
+	return p;
+}
+
+uint16_t memory_stack_peak(void) {
+	return (uint8_t*)RAMEND + 1 - stack_low_water();
+}
+
+void memory_get_stats(MemoryStats* stats) {
+	uint8_t* low_water = stack_low_water();
+	stats->ram_size = RAMEND + 1 - RAMSTART;
+	stats->data_size = &__data_end - &__data_start;
+	stats->bss_size = &__bss_end - &__bss_start;
+	stats->stack_used = RAMEND - SP;
+	stats->stack_peak = (uint8_t*)RAMEND + 1 - low_water;
+	stats->headroom = low_water - &_end;
+}
@@ -0,0 +1,42 @@
+/*
+ * memory.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * SRAM usage. Before main() runs, everything between the end of the
+ * static variables and the top of RAM is painted with a known value. The
+ * stack grows down into that space, so the deepest it has ever been can
+ * be found later by looking for the first byte that has been overwritten.
+ * This relies on there being no heap (nothing uses malloc()).
+ *
+ * host/Makefile's memreport target lists the static variables of each
+ * module.
+ */
+
+
+#ifndef MEMORY_H_
+#define MEMORY_H_
+
+#include <stdint.h>
+
+typedef struct {
+	uint16_t ram_size;		// bytes of SRAM
+	uint16_t data_size;		// initialised static variables (.data)
+	uint16_t bss_size;		// zeroed static variables (.bss)
+	uint16_t stack_used;	// bytes on the stack now
+	uint16_t stack_peak;	// most bytes there have ever been on the stack
+	uint16_t headroom;		// bytes the stack has never reached
+} MemoryStats;
+
+/* Get the current figures. This looks through the unused stack space so
+ * takes a while (about 10 cycles a byte).
+ */
+void memory_get_stats(MemoryStats* stats);
+
+/* Return the most bytes there have ever been on the stack (the high water
+ * mark). Interrupt handlers are included. A byte that happens to be left
+ * holding the paint value can make this a few bytes short.
+ */
+uint16_t memory_stack_peak(void);
+
+#endif /* MEMORY_H_ */
@@ -0,0 +1,233 @@
+/*
+ * pcm.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * Timer 2 runs in fast PWM mode with no prescaler. Its overflow interrupt
+ * counts down PCM_DIVIDER periods and then mixes the next sample from
+ * each voice into OCR2B (which the timer only picks up at the start of
+ * the next period, so it never glitches). When no voice is playing the
+ * interrupt is turned off and the output is left at the mid point.
+ *
+ * The cost of each sample is measured with TCNT2 itself - it counts CPU
+ * cycles from zero at the overflow, so its value at the end of the
+ * handler is the time taken including the interrupt latency.
+ */
+
+#include "pcm.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+#define PCM_SILENCE 128
+
+typedef struct {
+	const uint8_t* data;	// next byte of sample data
+	uint16_t remaining;		// samples left to play (0 = not playing)
+	uint8_t format;
+	uint8_t high_nibble;	// ADPCM - next sample is in the high nibble
+	int16_t predictor;		// ADPCM decoder state
+	uint8_t index;
+} Voice;
+
+static volatile Voice voices[PCM_VOICES];
+static volatile uint8_t divider;
+
+static volatile uint8_t max_cycles;
+static volatile uint16_t total_cycles;
+static volatile uint8_t timed_samples;
+static volatile uint8_t average_cycles;
+static volatile uint16_t over_budget;
+static volatile uint16_t late;
+
+static const int8_t adpcm_index_table[8] PROGMEM = {
+	-1, -1, -1, -1, 2, 4, 6, 8
+};
+
+static const uint16_t adpcm_step_table[89] PROGMEM = {
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37,
+	41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173,
+	190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+	724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+	2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484,
+	7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818,
+	18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+void init_pcm(void) {
+	for (uint8_t i = 0; i < PCM_VOICES; i++) {
+		voices[i].remaining = 0;
+	}
+	divider = PCM_DIVIDER;
+	pcm_clear_stats();
+	
+	// Fast PWM (mode 3), clear OC2B on compare match, no prescaling
+	OCR2B = PCM_SILENCE;
+	TCCR2A = (1 << COM2B1) | (1 << WGM21) | (1 << WGM20);
+	TCCR2B = (1 << CS20);
+	DDRD |= (1 << DDRD6);
+}
+
+void pcm_play(uint8_t voice, const PcmSample* sample) {
+	volatile Voice* v = &voices[voice];
+	uint8_t interruptsOn = bit_is_set(SREG, SREG_I);
+	cli();
+	v->data = pgm_read_ptr(&sample->data);
+	v->remaining = pgm_read_word(&sample->length);
+	v->format = pgm_read_byte(&sample->format);
+	v->high_nibble = 0;
+	v->predictor = 0;
+	v->index = 0;
+	TIMSK2 |= (1 << TOIE2);
+	if (interruptsOn) {
+		sei();
+	}
+}
+
+void pcm_stop(uint8_t voice) {
+	uint8_t interruptsOn = bit_is_set(SREG, SREG_I);
+	cli();
+	voices[voice].remaining = 0;
+	if (interruptsOn) {
+		sei();
+	}
+}
+
+void pcm_stop_all(void) {
+	for (uint8_t i = 0; i < PCM_VOICES; i++) {
+		pcm_stop(i);
+	}
+}
+
+uint8_t pcm_playing(uint8_t voice) {
+	uint8_t interruptsOn = bit_is_set(SREG, SREG_I);
+	cli();
+	uint8_t playing = voices[voice].remaining != 0;
+	if (interruptsOn) {
+		sei();
+	}
+	return playing;
+}
+
+void pcm_get_stats(PcmStats* result) {
+	uint8_t interruptsOn = bit_is_set(SREG, SREG_I);
+	cli();
+	result->max_cycles = max_cycles;
+	result->average_cycles = average_cycles;
+	result->over_budget = over_budget;
+	result->late = late;
+	if (interruptsOn) {
+		sei();
+	}
+}
+
+void pcm_clear_stats(void) {
+	uint8_t interruptsOn = bit_is_set(SREG, SREG_I);
+	cli();
+	max_cycles = 0;
+	total_cycles = 0;
+	timed_samples = 0;
+	average_cycles = 0;
+	over_budget = 0;
+	late = 0;
+	if (interruptsOn) {
+		sei();
+	}
+}
+
+// Decode the next ADPCM sample of a voice and return its top 8 bits
+static int8_t next_adpcm(volatile Voice* v) {
+	uint8_t code = pgm_read_byte(v->data);
+	if (v->high_nibble) {
+		code >>= 4;
+		v->data++;
+	}
+	v->high_nibble ^= 1;
+	
+	uint16_t step = pgm_read_word(&adpcm_step_table[v->index]);
+	uint16_t difference = step >> 3;
+	if (code & 4) {
+		difference += step;
+	}
+	if (code & 2) {
+		difference += step >> 1;
+	}
+	if (code & 1) {
+		difference += step >> 2;
+	}
+	int32_t predictor = v->predictor;
+	if (code & 8) {
+		predictor -= difference;
+		if (predictor < INT16_MIN) {
+			predictor = INT16_MIN;
+		}
+	} else {
+		predictor += difference;
+		if (predictor > INT16_MAX) {
+			predictor = INT16_MAX;
+		}
+	}
+	v->predictor = predictor;
+	
+	int8_t index = v->index + (int8_t)pgm_read_byte(&adpcm_index_table[code & 7]);
+	if (index < 0) {
+		index = 0;
+	} else if (index > 88) {
+		index = 88;
+	}
+	v->index = index;
+	return v->predictor >> 8;
+}
+
+ISR(TIMER2_OVF_vect) {
+	if (--divider) {
+		return;
+	}
+	divider = PCM_DIVIDER;
+	
+	int16_t mix = 0;
+	uint8_t playing = 0;
+	for (uint8_t i = 0; i < PCM_VOICES; i++) {
+		volatile Voice* v = &voices[i];
+		if (v->remaining == 0) {
+			continue;
+		}
+		if (v->format == PCM_FORMAT_ADPCM) {
+			mix += next_adpcm(v);
+		} else {
+			mix += (int8_t)pgm_read_byte(v->data);
+			v->data++;
+		}
+		v->remaining--;
+		playing = 1;
+	}
+	if (mix > 127) {
+		mix = 127;
+	} else if (mix < -128) {
+		mix = -128;
+	}
+	OCR2B = mix + PCM_SILENCE;
+	if (!playing) {
+		TIMSK2 &= ~(1 << TOIE2);
+	}
+	
+	// If the timer has overflowed again we took more than a whole period
+	// and the count has wrapped around
+	uint8_t cycles = TCNT2;
+	if (TIFR2 & (1 << TOV2)) {
+		late++;
+		cycles = 255;
+	}
+	if (cycles > max_cycles) {
+		max_cycles = cycles;
+	}
+	if (cycles > PCM_CYCLE_BUDGET) {
+		over_budget++;
+	}
+	total_cycles += cycles;
+	if (++timed_samples == 0) {
+		// Average over the last 256 samples
+		average_cycles = total_cycles >> 8;
+		total_cycles = 0;
+	}
+}
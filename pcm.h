@@ -0,0 +1,76 @@
+/*
+ * pcm.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * Sampled sound effects on timer 2. The samples are stored in program
+ * memory as signed 8 bit PCM or 4 bit IMA ADPCM and are played through
+ * OC2B (pin D6) as 8 bit PWM - connect a speaker through a capacitor and
+ * low pass filter. Two voices are mixed so a short click can play over a
+ * longer effect. Samples are made from WAV files with host/pcm/pcm_encode.
+ */
+
+
+#ifndef PCM_H_
+#define PCM_H_
+
+#include <stdint.h>
+
+// The PWM runs at 8MHz / 256 = 31250Hz and a new sample is output every
+// PCM_DIVIDER PWM periods
+#define PCM_DIVIDER 4
+#define PCM_SAMPLE_RATE (8000000UL / 256 / PCM_DIVIDER)
+
+#define PCM_VOICES 2
+
+// Most CPU cycles the sample interrupt may take, measured from the timer
+// overflow to the end of the handler. With the interrupts in between that
+// don't output a sample this keeps playback under about a quarter of the
+// CPU.
+#define PCM_CYCLE_BUDGET 200
+
+// Sample formats
+#define PCM_FORMAT_PCM8		0	// signed 8 bit
+#define PCM_FORMAT_ADPCM	1	// IMA ADPCM, 4 bits per sample, low nibble first
+
+// A sample. These (and the data) are kept in program memory.
+typedef struct {
+	const uint8_t* data;
+	uint16_t length;	// number of samples
+	uint8_t format;
+} PcmSample;
+
+// Timing of the sample interrupt in CPU cycles
+typedef struct {
+	uint8_t max_cycles;
+	uint8_t average_cycles;
+	uint16_t over_budget;	// samples that took more than PCM_CYCLE_BUDGET
+	uint16_t late;			// samples that took a whole PWM period or more
+} PcmStats;
+
+/* Set up timer 2 and the output pin. Nothing plays until pcm_play() is
+ * called.
+ */
+void init_pcm(void);
+
+/* Start playing a sample (in program memory) on a voice, replacing
+ * whatever that voice was playing.
+ */
+void pcm_play(uint8_t voice, const PcmSample* sample);
+
+/* Stop a voice, or all of them.
+ */
+void pcm_stop(uint8_t voice);
+void pcm_stop_all(void);
+
+/* Returns non-zero while the voice is playing.
+ */
+uint8_t pcm_playing(uint8_t voice);
+
+/* Get or reset the interrupt timing.
+ */
+void pcm_get_stats(PcmStats* result);
+void pcm_clear_stats(void);
+
+
+#endif /* PCM_H_ */
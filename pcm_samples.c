@@ -0,0 +1,169 @@
+/*
+ * pcm_samples.c
+ *
+ * Generated by host/pcm/pcm_encode - do not edit.
+ */
+
+#include "pcm_samples.h"
+#include <avr/pgmspace.h>
+
+// click: 234 samples from pcm/samples/click.wav
+static const uint8_t click_data[] PROGMEM = {
+	0xf0, 0xf4, 0xe9, 0xd0, 0xcc, 0xc5, 0xdf, 0xdf, 0x01, 0x0d, 0x0e, 0x07,
+	0xdd, 0xf1, 0xf3, 0xfd, 0xea, 0xd4, 0xf2, 0xf8, 0xf1, 0x0f, 0x01, 0x15,
+	0x07, 0xfb, 0x03, 0xf2, 0xfd, 0x0d, 0x07, 0x0a, 0x0b, 0x15, 0x00, 0x06,
+	0x1b, 0x01, 0xf5, 0xee, 0xe0, 0xed, 0xf0, 0xf3, 0xfd, 0x11, 0x04, 0xff,
+	0x0e, 0xf5, 0xf2, 0xfa, 0xef, 0xf7, 0x0a, 0x07, 0xfe, 0x0a, 0x10, 0x02,
+	0xfd, 0xef, 0xee, 0xed, 0xea, 0xef, 0xfd, 0xf8, 0xf7, 0xf7, 0x07, 0xfe,
+	0xf5, 0xfb, 0xf6, 0x00, 0xfc, 0xf9, 0x07, 0x02, 0xfa, 0x00, 0x00, 0x02,
+	0x0a, 0x0a, 0x01, 0xfd, 0xf5, 0xf9, 0x03, 0x07, 0x08, 0xfe, 0xf9, 0x00,
+	0x04, 0x04, 0x00, 0x05, 0x03, 0x01, 0x02, 0x02, 0x04, 0xff, 0xfb, 0x02,
+	0x02, 0x03, 0x00, 0xfc, 0x01, 0x03, 0x04, 0xff, 0xfd, 0xfd, 0xfc, 0xff,
+	0xff, 0x01, 0x02, 0x01, 0xfe, 0xfb, 0xfd, 0x00, 0xff, 0x00, 0xff, 0xfe,
+	0x00, 0x00, 0x02, 0x01, 0x00, 0x00, 0x01, 0x02, 0x01, 0x02, 0x00, 0xfe,
+	0xfd, 0xfe, 0x01, 0x00, 0xff, 0x01, 0x01, 0x00, 0x01, 0xff, 0xff, 0xff,
+	0xfe, 0xfe, 0xff, 0xfe, 0x00, 0x00, 0xfe, 0xff, 0xfe, 0x01, 0xff, 0x00,
+	0xff, 0xff, 0xff, 0x00, 0xff, 0xff, 0x00, 0x00, 0xff, 0xff, 0xfe, 0xfe,
+	0xfe, 0xff, 0xff, 0xfe, 0xfe, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0xff, 0xff, 0xff, 0x00,
+	0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+	0xff, 0xff, 0x00, 0x00, 0xff, 0x00,
+};
+const PcmSample pcm_click PROGMEM = {click_data, 234, PCM_FORMAT_PCM8};
+
+// slide: 3124 samples from pcm/samples/slide.wav
+static const uint8_t slide_data[] PROGMEM = {
+	0x77, 0x77, 0xff, 0xff, 0x72, 0x07, 0xda, 0x8a, 0x32, 0x14, 0xc8, 0x9c,
+	0x20, 0x24, 0x90, 0xcc, 0x19, 0x43, 0x82, 0xcb, 0x8b, 0x42, 0x14, 0xc8,
+	0xab, 0x38, 0x25, 0x91, 0xbc, 0x0a, 0x44, 0x02, 0xda, 0x9a, 0x31, 0x24,
+	0xa8, 0xad, 0x29, 0x34, 0x81, 0xcc, 0x0a, 0x42, 0x13, 0xca, 0xbb, 0x40,
+	0x34, 0xa0, 0xcc, 0x09, 0x53, 0x82, 0xc9, 0x9b, 0x41, 0x23, 0xb0, 0xbd,
+	0x29, 0x34, 0x83, 0xcc, 0x8b, 0x42, 0x23, 0xb8, 0xae, 0x29, 0x34, 0x92,
+	0xdb, 0x8b, 0x42, 0x14, 0xb8, 0xac, 0x29, 0x44, 0x81, 0xcb, 0x9a, 0x42,
+	0x33, 0xc8, 0xac, 0x19, 0x34, 0x83, 0xea, 0x9a, 0x30, 0x25, 0xa0, 0xdb,
+	0x09, 0x42, 0x03, 0xb9, 0xad, 0x28, 0x34, 0x82, 0xeb, 0x9a, 0x31, 0x25,
+	0x98, 0xbc, 0x09, 0x52, 0x13, 0xb9, 0xad, 0x19, 0x34, 0x03, 0xda, 0xab,
+	0x38, 0x35, 0x92, 0xdb, 0x9b, 0x31, 0x26, 0x90, 0xcb, 0x8a, 0x41, 0x24,
+	0xa0, 0xbc, 0x8a, 0x52, 0x23, 0xa0, 0xbd, 0x8a, 0x52, 0x23, 0xb0, 0xcc,
+	0x0a, 0x42, 0x23, 0xa0, 0xbd, 0x8b, 0x52, 0x33, 0x90, 0xbd, 0x9b, 0x51,
+	0x33, 0x92, 0xcc, 0xab, 0x21, 0x26, 0x82, 0xca, 0xab, 0x18, 0x35, 0x13,
+	0xc9, 0xbc, 0x09, 0x52, 0x23, 0xa0, 0xcc, 0x9a, 0x31, 0x35, 0x81, 0xda,
+	0xab, 0x18, 0x44, 0x13, 0xb8, 0xbd, 0x8a, 0x51, 0x33, 0x81, 0xeb, 0xaa,
+	0x18, 0x53, 0x13, 0xa8, 0xbd, 0x9a, 0x41, 0x43, 0x02, 0xca, 0xac, 0x09,
+	0x42, 0x24, 0x80, 0xdb, 0xab, 0x10, 0x44, 0x22, 0xa8, 0xcc, 0x9a, 0x30,
+	0x34, 0x13, 0xc9, 0xbc, 0x8b, 0x41, 0x44, 0x01, 0xb9, 0xad, 0x0a, 0x41,
+	0x43, 0x01, 0xca, 0xcb, 0x09, 0x41, 0x24, 0x01, 0xca, 0xac, 0x09, 0x41,
+	0x24, 0x01, 0xca, 0xac, 0x89, 0x42, 0x43, 0x01, 0xca, 0xcb, 0x89, 0x32,
+	0x35, 0x01, 0xc9, 0xac, 0x9a, 0x32, 0x35, 0x03, 0xb9, 0xbe, 0x9a, 0x21,
+	0x45, 0x02, 0xa8, 0xdb, 0xaa, 0x20, 0x44, 0x22, 0xa0, 0xbc, 0xac, 0x18,
+	0x53, 0x33, 0x80, 0xcc, 0xbb, 0x19, 0x52, 0x24, 0x82, 0xca, 0xcb, 0x0a,
+	0x31, 0x35, 0x12, 0xb9, 0xcd, 0x9a, 0x30, 0x34, 0x14, 0x98, 0xcc, 0xaa,
+	0x18, 0x53, 0x33, 0x80, 0xbc, 0xad, 0x09, 0x42, 0x24, 0x01, 0xc9, 0xac,
+	0x8a, 0x31, 0x44, 0x12, 0xb8, 0xcc, 0x9b, 0x20, 0x44, 0x13, 0xa1, 0xeb,
+	0xab, 0x08, 0x53, 0x33, 0x81, 0xda, 0xac, 0x0a, 0x31, 0x35, 0x12, 0xb9,
+	0xcd, 0x9a, 0x20, 0x44, 0x12, 0x90, 0xbc, 0xac, 0x18, 0x52, 0x33, 0x81,
+	0xcb, 0xad, 0x0a, 0x41, 0x43, 0x02, 0xb9, 0xcc, 0x9a, 0x20, 0x44, 0x13,
+	0x90, 0xcc, 0xab, 0x19, 0x53, 0x33, 0x82, 0xda, 0xbc, 0x99, 0x32, 0x35,
+	0x13, 0xb8, 0xcd, 0x9b, 0x28, 0x63, 0x22, 0x91, 0xda, 0xbb, 0x09, 0x42,
+	0x34, 0x12, 0xc9, 0xbc, 0x9b, 0x20, 0x45, 0x22, 0x90, 0xcb, 0xbc, 0x09,
+	0x42, 0x34, 0x12, 0xc9, 0xbc, 0x9b, 0x20, 0x54, 0x13, 0x91, 0xcb, 0xbc,
+	0x89, 0x42, 0x34, 0x12, 0xb8, 0xbd, 0xac, 0x18, 0x53, 0x33, 0x01, 0xca,
+	0xad, 0x9a, 0x20, 0x44, 0x23, 0x90, 0xcb, 0xad, 0x89, 0x31, 0x44, 0x22,
+	0xa8, 0xdb, 0xac, 0x88, 0x42, 0x43, 0x02, 0xa8, 0xbc, 0xac, 0x09, 0x43,
+	0x34, 0x03, 0xb8, 0xcd, 0xaa, 0x09, 0x43, 0x34, 0x12, 0xb8, 0xdc, 0xab,
+	0x08, 0x42, 0x34, 0x22, 0xa8, 0xbd, 0xbc, 0x09, 0x41, 0x53, 0x22, 0x90,
+	0xcb, 0xbc, 0x9a, 0x21, 0x35, 0x24, 0x01, 0xca, 0xdb, 0x9a, 0x08, 0x43,
+	0x24, 0x13, 0xa8, 0xcc, 0xcb, 0x89, 0x21, 0x44, 0x32, 0x81, 0xc9, 0xbc,
+	0xbb, 0x08, 0x53, 0x34, 0x23, 0x90, 0xcc, 0xcb, 0xaa, 0x10, 0x34, 0x25,
+	0x12, 0xa0, 0xeb, 0xab, 0x9a, 0x10, 0x44, 0x24, 0x12, 0xa8, 0xeb, 0xba,
+	0x9a, 0x20, 0x44, 0x33, 0x13, 0xb0, 0xdc, 0xcb, 0x9a, 0x10, 0x53, 0x33,
+	0x23, 0x90, 0xeb, 0xbc, 0xaa, 0x08, 0x52, 0x43, 0x23, 0x81, 0xc9, 0xcc,
+	0xba, 0x89, 0x31, 0x44, 0x24, 0x02, 0xa0, 0xbc, 0xad, 0x9b, 0x18, 0x43,
+	0x44, 0x22, 0x00, 0xba, 0xbd, 0xac, 0x8a, 0x30, 0x44, 0x43, 0x12, 0x90,
+	0xcb, 0xcc, 0xaa, 0x88, 0x31, 0x35, 0x24, 0x12, 0xa8, 0xcc, 0xcb, 0x9a,
+	0x19, 0x42, 0x53, 0x23, 0x02, 0xb9, 0xcc, 0xac, 0x9b, 0x18, 0x52, 0x43,
+	0x33, 0x01, 0xb9, 0xcd, 0xbb, 0x9b, 0x18, 0x63, 0x43, 0x23, 0x82, 0xb9,
+	0xcd, 0xbb, 0xaa, 0x18, 0x44, 0x34, 0x33, 0x01, 0xb9, 0xbe, 0xbc, 0xaa,
+	0x18, 0x53, 0x34, 0x33, 0x01, 0xb8, 0xbe, 0xbc, 0xaa, 0x08, 0x43, 0x35,
+	0x33, 0x02, 0xa8, 0xcd, 0xac, 0x9b, 0x09, 0x42, 0x34, 0x24, 0x12, 0xa8,
+	0xdb, 0xbc, 0xab, 0x09, 0x32, 0x36, 0x34, 0x12, 0x98, 0xdb, 0xbc, 0xab,
+	0x0a, 0x31, 0x45, 0x43, 0x12, 0x80, 0xcb, 0xbc, 0xac, 0x89, 0x20, 0x63,
+	0x33, 0x23, 0x91, 0xca, 0xbd, 0xac, 0x9a, 0x20, 0x53, 0x53, 0x22, 0x00,
+	0xa9, 0xbd, 0xac, 0x9b, 0x18, 0x43, 0x44, 0x23, 0x02, 0xa9, 0xcc, 0xbc,
+	0xaa, 0x88, 0x42, 0x44, 0x23, 0x12, 0xa0, 0xdb, 0xbc, 0xbb, 0x0a, 0x31,
+	0x45, 0x34, 0x12, 0x91, 0xca, 0xbc, 0xbc, 0x8a, 0x28, 0x34, 0x35, 0x33,
+	0x01, 0xb9, 0xbe, 0xbc, 0xaa, 0x19, 0x42, 0x44, 0x33, 0x12, 0xa0, 0xeb,
+	0xcb, 0xab, 0x8a, 0x21, 0x54, 0x33, 0x33, 0x81, 0xca, 0xcc, 0xac, 0x9a,
+	0x19, 0x32, 0x36, 0x33, 0x13, 0x98, 0xeb, 0xbc, 0xbb, 0x99, 0x20, 0x44,
+	0x44, 0x22, 0x01, 0xa8, 0xbc, 0xbd, 0xab, 0x89, 0x31, 0x35, 0x35, 0x22,
+	0x01, 0xb9, 0xcd, 0xbb, 0xbb, 0x09, 0x41, 0x44, 0x24, 0x23, 0x81, 0xb9,
+	0xbd, 0xbd, 0xaa, 0x09, 0x21, 0x35, 0x25, 0x23, 0x01, 0xa9, 0xcc, 0xbc,
+	0xab, 0x8a, 0x20, 0x44, 0x44, 0x22, 0x12, 0x98, 0xcb, 0xcc, 0xab, 0x9b,
+	0x08, 0x42, 0x35, 0x43, 0x13, 0x01, 0xb9, 0xdc, 0xbb, 0xac, 0x8a, 0x10,
+	0x53, 0x53, 0x23, 0x22, 0x80, 0xc9, 0xbc, 0xad, 0xab, 0x8a, 0x20, 0x63,
+	0x43, 0x23, 0x23, 0x80, 0xba, 0xbe, 0xcc, 0xaa, 0x99, 0x10, 0x42, 0x44,
+	0x33, 0x22, 0x02, 0xb9, 0xdc, 0xcb, 0xbb, 0x9b, 0x09, 0x41, 0x44, 0x43,
+	0x33, 0x12, 0x80, 0xca, 0xcc, 0xac, 0xbb, 0x8a, 0x08, 0x43, 0x44, 0x24,
+	0x23, 0x12, 0x88, 0xcb, 0xcc, 0xac, 0xab, 0x9a, 0x10, 0x42, 0x44, 0x43,
+	0x32, 0x11, 0x80, 0xca, 0xbc, 0xbd, 0xab, 0x9b, 0x08, 0x41, 0x44, 0x43,
+	0x33, 0x23, 0x00, 0xb9, 0xcd, 0xdb, 0xab, 0xab, 0x99, 0x11, 0x44, 0x53,
+	0x33, 0x24, 0x11, 0x90, 0xba, 0xcd, 0xcb, 0xbb, 0x9a, 0x89, 0x22, 0x45,
+	0x43, 0x24, 0x22, 0x02, 0x98, 0xcb, 0xcc, 0xcb, 0xab, 0x9a, 0x09, 0x32,
+	0x45, 0x43, 0x33, 0x33, 0x02, 0xa8, 0xcc, 0xcc, 0xcb, 0xba, 0x9a, 0x08,
+	0x31, 0x35, 0x35, 0x24, 0x23, 0x01, 0x90, 0xdb, 0xdb, 0xcb, 0xba, 0x9a,
+	0x09, 0x21, 0x35, 0x35, 0x43, 0x32, 0x11, 0x90, 0xca, 0xcc, 0xac, 0xbb,
+	0xab, 0x89, 0x21, 0x44, 0x44, 0x33, 0x24, 0x12, 0x80, 0xba, 0xdc, 0xcb,
+	0xbb, 0xab, 0x8a, 0x10, 0x53, 0x35, 0x53, 0x32, 0x12, 0x81, 0xa8, 0xcc,
+	0xbc, 0xbc, 0xab, 0x9a, 0x08, 0x42, 0x44, 0x34, 0x33, 0x33, 0x11, 0xa8,
+	0xcc, 0xcc, 0xcb, 0xab, 0xaa, 0x09, 0x21, 0x35, 0x35, 0x34, 0x32, 0x21,
+	0x90, 0xca, 0xcc, 0xcb, 0xcb, 0x9a, 0x8a, 0x10, 0x43, 0x44, 0x33, 0x34,
+	0x12, 0x01, 0xa9, 0xcc, 0xcc, 0xca, 0xaa, 0x99, 0x08, 0x31, 0x44, 0x34,
+	0x43, 0x22, 0x02, 0x90, 0xca, 0xcc, 0xcb, 0xbb, 0xab, 0x99, 0x11, 0x44,
+	0x44, 0x33, 0x24, 0x22, 0x00, 0xa9, 0xeb, 0xcb, 0xac, 0xab, 0xaa, 0x08,
+	0x21, 0x45, 0x43, 0x43, 0x32, 0x21, 0x80, 0xba, 0xcd, 0xcb, 0xcb, 0xaa,
+	0x9a, 0x18, 0x31, 0x45, 0x43, 0x43, 0x22, 0x02, 0x80, 0xba, 0xdc, 0xcb,
+	0xcb, 0xaa, 0x99, 0x08, 0x22, 0x45, 0x43, 0x33, 0x33, 0x22, 0x80, 0xc9,
+	0xcc, 0xbc, 0xbc, 0xbb, 0xaa, 0x88, 0x31, 0x54, 0x34, 0x53, 0x22, 0x13,
+	0x01, 0x98, 0xdb, 0xdb, 0xcb, 0xab, 0xab, 0x9a, 0x18, 0x42, 0x44, 0x34,
+	0x43, 0x23, 0x22, 0x81, 0xa8, 0xcc, 0xcc, 0xbb, 0xac, 0xab, 0x9a, 0x00,
+	0x32, 0x36, 0x44, 0x33, 0x43, 0x12, 0x11, 0x98, 0xcb, 0xcc, 0xbc, 0xbb,
+	0xac, 0x9a, 0x89, 0x11, 0x34, 0x45, 0x33, 0x34, 0x23, 0x13, 0x01, 0xa9,
+	0xdc, 0xcb, 0xbc, 0xcb, 0xba, 0x9a, 0x89, 0x11, 0x34, 0x45, 0x43, 0x33,
+	0x33, 0x23, 0x01, 0x98, 0xeb, 0xdb, 0xcb, 0xcb, 0xba, 0xab, 0x99, 0x08,
+	0x32, 0x45, 0x34, 0x34, 0x43, 0x32, 0x12, 0x01, 0x99, 0xdb, 0xbc, 0xbd,
+	0xcb, 0xba, 0xab, 0x9a, 0x08, 0x31, 0x54, 0x34, 0x34, 0x24, 0x33, 0x23,
+	0x11, 0x90, 0xba, 0xbe, 0xbd, 0xbc, 0xac, 0xbb, 0xaa, 0x99, 0x00, 0x33,
+	0x36, 0x35, 0x34, 0x43, 0x32, 0x22, 0x11, 0x90, 0xba, 0xbe, 0xcc, 0xcb,
+	0xbb, 0xbb, 0xbb, 0x9a, 0x08, 0x42, 0x44, 0x44, 0x33, 0x34, 0x24, 0x22,
+	0x12, 0x00, 0xa9, 0xdb, 0xcc, 0xcb, 0xbb, 0xbc, 0xba, 0xaa, 0x89, 0x10,
+	0x43, 0x35, 0x35, 0x34, 0x43, 0x32, 0x32, 0x11, 0x80, 0xb9, 0xcd, 0xdb,
+	0xcb, 0xbb, 0xcb, 0xba, 0x9a, 0x89, 0x20, 0x52, 0x53, 0x34, 0x43, 0x43,
+	0x32, 0x22, 0x12, 0x90, 0xa9, 0xdc, 0xcb, 0xbc, 0xac, 0xcb, 0xaa, 0x9a,
+	0x89, 0x10, 0x32, 0x45, 0x34, 0x34, 0x43, 0x23, 0x23, 0x22, 0x00, 0xb9,
+	0xcc, 0xcc, 0xcb, 0xac, 0xbb, 0xac, 0x9a, 0x99, 0x18, 0x31, 0x44, 0x44,
+	0x43, 0x33, 0x43, 0x32, 0x12, 0x01, 0x98, 0xdb, 0xdb, 0xdb, 0xbb, 0xcb,
+	0xbb, 0xba, 0x9a, 0x08, 0x30, 0x54, 0x53, 0x43, 0x33, 0x34, 0x33, 0x22,
+	0x12, 0x88, 0xca, 0xcc, 0xdb, 0xcb, 0xcb, 0xba, 0xba, 0xaa, 0x98, 0x20,
+	0x42, 0x35, 0x35, 0x53, 0x32, 0x33, 0x33, 0x12, 0x01, 0xa9, 0xcc, 0xcc,
+	0xbc, 0xdb, 0xba, 0xab, 0xab, 0x9a, 0x08, 0x21, 0x35, 0x45, 0x43, 0x33,
+	0x34, 0x33, 0x22, 0x12, 0x80, 0xba, 0xbe, 0xcc, 0xbc, 0xcb, 0xbb, 0xbb,
+	0xaa, 0x9a, 0x00, 0x42, 0x44, 0x34, 0x35, 0x33, 0x34, 0x33, 0x22, 0x02,
+	0x80, 0xca, 0xcc, 0xdb, 0xcb, 0xbb, 0xbc, 0xab, 0xab, 0x8a, 0x19, 0x31,
+	0x45, 0x34, 0x44, 0x33, 0x43, 0x33, 0x32, 0x21, 0x00, 0xa9, 0xcc, 0xcc,
+	0xcb, 0xbc, 0xbb, 0xcb, 0xba, 0x9a, 0x99, 0x10, 0x42, 0x44, 0x34, 0x34,
+	0x34, 0x33, 0x43, 0x22, 0x11, 0x81, 0xa9, 0xdb, 0xbc, 0xbd, 0xbc, 0xcb,
+	0xbb, 0xab, 0xab, 0x9a, 0x08, 0x32, 0x45, 0x34, 0x35, 0x43, 0x43, 0x32,
+	0x23, 0x23, 0x11, 0x80, 0xaa, 0xbd, 0xcd, 0xcb, 0xcb, 0xbb, 0xcb, 0xba,
+	0xaa, 0x9a, 0x88, 0x21, 0x53, 0x44, 0x43, 0x34, 0x43, 0x33, 0x33, 0x33,
+	0x23, 0x11, 0x90, 0xcb, 0xcc, 0xcc, 0xcb, 0xac, 0xac, 0xab, 0xbb, 0xba,
+	0x9a, 0x89, 0x10, 0x43, 0x44, 0x34, 0x35, 0x43, 0x33, 0x24, 0x33, 0x32,
+	0x12, 0x02, 0x98, 0xca, 0xcc, 0xdb, 0xcb, 0xcb, 0xbb, 0xbc, 0xba, 0xbb,
+	0xaa, 0x9a, 0x08, 0x31, 0x44, 0x44, 0x34, 0x34, 0x53, 0x32, 0x33, 0x33,
+	0x33, 0x13, 0x02, 0x90, 0xbb, 0xce, 0xdb, 0xcb, 0xcb, 0xbb, 0xbc, 0xbb,
+	0xbb, 0xab, 0xab, 0x89, 0x10, 0x42, 0x44, 0x44, 0x43, 0x43, 0x33, 0x43,
+	0x33, 0x33, 0x33, 0x22, 0x02, 0x88, 0xca, 0xbc, 0xcd, 0xbb, 0xbd, 0xbb,
+	0xbc, 0xbb, 0xac, 0xaa, 0xa9, 0x88, 0x18, 0x22, 0x44, 0x43, 0x34, 0x33,
+	0x43, 0x22,
+};
+const PcmSample pcm_slide PROGMEM = {slide_data, 3124, PCM_FORMAT_ADPCM};
@@ -0,0 +1,21 @@
+/*
+ * pcm_samples.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * The sampled sound effects in pcm_samples.c. That file is generated from
+ * the WAV files in host/pcm/samples by running "make -C host samples".
+ */
+
+
+#ifndef PCM_SAMPLES_H_
+#define PCM_SAMPLES_H_
+
+#include <avr/pgmspace.h>
+#include "pcm.h"
+
+extern const PcmSample pcm_click PROGMEM;	// step click (8 bit)
+extern const PcmSample pcm_slide PROGMEM;	// falling sweep (ADPCM)
+
+
+#endif /* PCM_SAMPLES_H_ */
@@ -1,677 +1,959 @@
-/*
- * project.c
- *
- * Main file
- *
- * Authors: Peter Sutton, Luke Kamols, Jarrod Bennett
- * Modified by <Adnaan Buksh>
- */ 
-
-
-#include <stdio.h>
-#include <stdint.h>
-#include <avr/io.h>
-#include <avr/interrupt.h>
-#include <avr/pgmspace.h>
-
-#define F_CPU 8000000UL
-#include <util/delay.h>
-
-#include "project.h"
-#include "game.h"
-#include "display.h"
-#include "ledmatrix.h"
-#include "buttons.h"
-#include "serialio.h"
-#include "terminalio.h"
-#include "timer0.h"
-
-// Function prototypes - these are defined below (after main()) in the order
-// given here
-void initialise_hardware(void);
-void start_screen(void);
-void new_game(void);
-void play_game(void);
-void handle_game_over(void);
-
-volatile uint8_t seven_seg_cc = 0;
-int rolling;
-int board_type;
-int count;
-int start;
-int turn;
-int turn2;
-int multi;
-int p1;
-int p1_limit;
-int p2_limit;
-int limit;
-int time_limit;
-int p1_limit_sec;
-int p2_limit_sec;
-int p1_minus;
-int p2_minus;
-int pause;
-int sound_on_off;
-
-
-uint16_t value;
-uint8_t x_or_y = 0;
-int x;
-int y;
-
-
-uint8_t turn_data[10] = {63,6,91,79,102,109,125,7,127,111};
-uint8_t seven_seg_data[6] = {6,91,79,102,109,125};
-uint32_t last_flash_time, current_time, current_time2, last_dice_time, last_switch,switch_player, pause_offset;
-uint8_t btn; // The button pushed
-
-void play_sound(){
-	if (sound_on_off == 0){
-		OCR1A = (20*(1000000UL / 8000)-1);
-		_delay_ms(1000);
-		OCR1A = (40*(1000000UL / 9000)-1);
-		_delay_ms(100);
-		OCR1A = (90*(1000000UL / 10000)-1);
-		_delay_ms(100);
-	OCR1A =0;}
-}
-
-/////////////////////////////// main //////////////////////////////////
-int main(void) {
-	
-	OCR1B = 0xFF;
-	TCCR1A = (1 << WGM10) | (1 << WGM11) | (1 << CS10) | (1 << COM1A1)| (1 << COM1B1);
-	TCCR1B = (1 << WGM12) | (1 << WGM13) | (1 << CS11) ;
-	OCR1A = 0;
-	
-	sei();
-	ADMUX = (1<<REFS0);
-	ADCSRA = (1<<ADEN)|(1<<ADPS2)|(1<<ADPS1);
-	
-	// Setup hardware and call backs. This will turn on 
-	// interrupts.
-	initialise_hardware();
-	
-	// Show the splash screen message. Returns when display
-	// is complete.
-	start_screen();
-	// Loop forever and continuously play the game.
-	while(1) {
-		new_game();
-		play_game();
-		handle_game_over();
-	}
-}
-
-void initialise_hardware(void) {
-	ledmatrix_setup();
-	init_button_interrupts();
-	// Setup serial port for 19200 baud communication with no echo
-	// of incoming characters
-	init_serial_stdio(19200,0);
-	
-	init_timer0();
-	
-	// Turn on global interrupts
-	sei();
-}
-
-
-void start_screen(void) {
-	// Clear terminal screen and output a message
-	sound_on_off =0;
-	sound_on();
-	clear_terminal();
-	move_terminal_cursor(10,10);
-	printf_P(PSTR("Snakes and Ladders"));
-	move_terminal_cursor(10,12);
-	printf_P(PSTR("CSSE2010/7201 A2 by Adnaan Buksh - 47435568"));
-	move_terminal_cursor(10,14);
-	printf_P(PSTR("Board Chosen: One"));
-	move_terminal_cursor(10,16);
-	printf_P(PSTR("One Player"));
-	move_terminal_cursor(10,8);
-	printf_P(PSTR("Sound ON "));
-
-	// Output the static start screen and wait for a push button 
-	// to be pushed or a serial input of 's'
-	start_display();
-	
-	// Wait until a button is pressed, or 's' is pressed on the terminal
-	while(1) {	
-		// First check for if a 's' is pressed
-		// There are two steps to this
-		// 1) collect any serial input (if available)
-		// 2) check if the input is equal to the character 's'
-		char serial_input = -1;
-		if (serial_input_available()) {
-			serial_input = fgetc(stdin);
-		}
-		// If the serial input is 's', then exit the start screen
-		if (serial_input == '2'){
-			multi = 1;
-			activate_multiplayer();
-			move_terminal_cursor(10,16);
-			printf_P(PSTR("Two Player"));
-			move_terminal_cursor(10,18);
-			printf_P(PSTR("Easy: No time limit          "));
-		}
-		if (serial_input == '1'){
-			multi =0;
-			deactivate_multiplayer();
-			move_terminal_cursor(10,16);
-			printf_P(PSTR("One Player"));
-			move_terminal_cursor(10,18);
-			printf_P(PSTR("                             "));
-		}
-		if (serial_input == 's' || serial_input == 'S') {
-			break;
-		}
-		if ((serial_input == 'e' || serial_input == 'E') && multi == 1) {
-			move_terminal_cursor(10,18);
-			printf_P(PSTR("Easy: No time limit          "));
-			limit = 0;
-		}
-		if ((serial_input == 'm' || serial_input == 'M') && multi == 1) {
-			move_terminal_cursor(10,18);
-			printf_P(PSTR("Medium: 90 seconds time limit"));
-			time_limit = 90;
-			p1_limit_sec =10;
-			p2_limit_sec =10;
-			limit = 1;
-		}
-		if ((serial_input == 'h' || serial_input == 'H') && multi == 1) {
-			move_terminal_cursor(10,18);
-			printf_P(PSTR("Hard: 45 seconds time limit  "));
-			time_limit = 45;
-			p1_limit_sec =10;
-			p2_limit_sec =10;
-			limit = 1;
-		}
-		if (serial_input == 'b' || serial_input == 'B') {
-			board_type = 1^board_type;
-			move_terminal_cursor(10,14);
-			if (board_type==0){printf_P(PSTR("Board Chosen: One"));}
-			if (board_type==1){printf_P(PSTR("Board Chosen: Two"));}
-			choose_board(board_type);
-		}
-		if (serial_input == 'q' || serial_input == 'Q') {
-			sound_on_off = 1 ^ sound_on_off;
-			if (sound_on_off == 1){
-				move_terminal_cursor(10,8);
-				printf_P(PSTR("Sound OFF"));
-				sound_off();}
-			if (sound_on_off == 0){
-				move_terminal_cursor(10,8);
-				printf_P(PSTR("Sound ON "));
-				sound_on();}
-			
-		}
-		
-		// Next check for any button presses
-		int8_t btn = button_pushed();
-		if (btn != NO_BUTTON_PUSHED) {
-			break;
-		}
-		
-	}
-	
-}
-
-void new_game(void) {
-	// Clear the serial terminal
-	clear_terminal();
-	
-	// Initialise the game and display
-	initialise_game();
-	DDRC =0xFF;
-	DDRD |= (1<<DDRD2);
-	PORTC = 63;
-	turn2 = 0;
-	turn = 0;
-	start = 0;
-	rolling =0;
-	p1 =0;
-	sound_on_off=0;
-	pause_offset =0;
-	x=500;
-	y=500;
-	value=500;
-	
-	// Clear a button push or serial input if any are waiting
-	// (The cast to void means the return value is ignored.)
-	(void)button_pushed();
-	clear_serial_input_buffer();
-}
-
-void switch_ssd(void){
-	if (seven_seg_cc == 0 && start == 0){
-		PORTC = 63;
-		_delay_ms(5);
-		seven_seg_cc = 1 ^ seven_seg_cc;
-	}
-	else if (seven_seg_cc == 0 ){
-		PORTC = seven_seg_data[count];
-		PORTC |= (seven_seg_cc<<PINC7);
-		_delay_ms(5);
-		seven_seg_cc = 1 ^ seven_seg_cc;
-	}
-	else if (seven_seg_cc == 1 && p1 == 0){
-		PORTC = turn_data[turn];
-		PORTC |= (seven_seg_cc<<PINC7);
-		_delay_ms(5);
-	seven_seg_cc = 1 ^ seven_seg_cc;}
-
-	
-	else if (seven_seg_cc == 1 && p1 == 1){
-		PORTC = turn_data[turn2];
-		PORTC |= (seven_seg_cc<<PINC7);
-		_delay_ms(5);
-	seven_seg_cc = 1 ^ seven_seg_cc;}
-}
-
-void delay_move(){
-	int c = get_current_time();
-	int d =get_current_time();
-	while (c <= d+150)
-	{c = get_current_time();
-		switch_ssd();
-	}
-}
-
-void play_game(void) {
-	last_dice_time = get_current_time();
-	last_flash_time = get_current_time();
-	last_switch = get_current_time();
-	p1_limit = time_limit;
-	p2_limit = time_limit;
-	// We play the game until it's over
-	while(!is_game_over()) {
-		
-		if(x_or_y == 0) {
-			ADMUX &= ~1;
-			} else {
-			ADMUX |= 1;
-		}
-
-		ADCSRA |= (1<<ADSC);
-		
-		while(ADCSRA & (1<<ADSC)) {
-			;
-		}
-		value = ADC;
-		if(x_or_y == 0) {
-			//printf("X: %4d ", value);
-			x = value;
-			} 
-		if(x_or_y == 1) {
-			y = value;
-			//printf("Y: %4d\n", value);
-		}
-		
-		x_or_y ^= 1;
-
-		if (x >= 900 && y > 420 && y < 600 ){
-			x=500;
-			y=500;
-			change_joystick();
-			move_player(0,1);
-			delay_move();
-			change_joystick();	
-		}
-		if (x <= 100 && y > 420 && y < 600 ){
-			x=500;
-			y=500;
-			change_joystick();
-			move_player(0,-1);
-			delay_move();
-			change_joystick();
-		}
-		if (y >= 900 && x > 420 && x < 600 ){
-			x=500;
-			y=500;
-			change_joystick();
-			move_player(-1,0);
-			delay_move();
-			change_joystick();
-		}
-		if (y <= 100 && x > 420 && x < 600 ){
-			x=500;
-			y=500;
-			change_joystick();
-			move_player(1,0);
-			delay_move();
-			change_joystick();
-		}
-			
-		if (x > 832 &&  y < 190 ){
-			x=500;
-			y=500;
-			change_joystick();
-			move_player(1,1);
-			delay_move();
-			change_joystick();
-		}
-		if (x > 832 && y > 820){
-			x=500;
-			y=500;
-			change_joystick();
-			move_player(-1,1);
-			delay_move();
-			change_joystick();
-		}
-		if (x < 190 && y < 190 ){
-			x=500;
-			y=500;
-			change_joystick();
-			move_player(1,-1);
-			delay_move();
-			change_joystick();
-		}
-		if (x < 190 && y > 820 ){
-			x=500;
-			y=500;
-			change_joystick();
-			move_player(-1,-1);
-			delay_move();
-			change_joystick();
-		}		
-		
-		DDRD |= (1<<DDRD4);		
-		// We need to check if any button has been pushed, this will be
-		// NO_BUTTON_PUSHED if no button has been pushed
-		btn = button_pushed();
-		
-		if (btn == BUTTON0_PUSHED) {
-			// If button 0 is pushed, move the player 1 space forward
-			// YOU WILL NEED TO IMPLEMENT THIS FUNCTION
-			move_player_n(1);
-			last_flash_time = get_current_time();
-			if(multi == 1){
-				if (p1 == 0){
-					turn += 1;
-					_delay_ms(100);
-					p1 = p1^1;
-				}
-				else{turn2 += 1;
-					_delay_ms(100);
-				p1 = p1^1;}
-			}
-			else{turn += 1;}
-		}
-		// ADDED CODE >
-		else if (btn == BUTTON1_PUSHED) {
-			// If button 0 is pushed, move the player 1 space forward
-			// YOU WILL NEED TO IMPLEMENT THIS FUNCTION
-			move_player_n(2);
-			last_flash_time = get_current_time();
-			if(multi == 1){
-				if (p1 == 0){
-					turn += 1;
-					_delay_ms(100);
-					p1 = p1^1;
-				}
-				else{turn2 += 1;
-					_delay_ms(100);
-				p1 = p1^1;}
-			}
-			else{turn += 1;}
-		}
-	
-		char serial_input = -1;
-		if (serial_input_available()) {
-			serial_input = fgetc(stdin);
-		}
-		
-		if (serial_input == 'q' || serial_input == 'Q') {
-			sound_on_off = 1 ^ sound_on_off;
-			if (sound_on_off == 1){
-				move_terminal_cursor(10,8);
-				printf_P(PSTR("Sound OFF"));
-				sound_off();}
-			if (sound_on_off == 0){
-				sound_on();
-				move_terminal_cursor(10,8);
-				printf_P(PSTR("Sound ON "));
-			}
-		}
-		
-		if (serial_input == 'p' || serial_input == 'P' || btn == BUTTON3_PUSHED) {
-			pause_offset = get_current_time();
-			while(pause != 1){	
-				char serial_input = -1;
-				if (serial_input_available()) {
-					serial_input = fgetc(stdin);
-				}
-				
-				if (serial_input == 'p' || serial_input == 'P') {
-					pause_offset =  get_current_time() - pause_offset;
-					pause = 1;
-				}
-				
-				if (btn == button_pushed()){btn = NO_BUTTON_PUSHED;}
-				
-				if (seven_seg_cc == 0 && start == 0){
-					PORTC = 63;
-					_delay_ms(5);
-					seven_seg_cc = 1 ^ seven_seg_cc;
-				}
-				else if (seven_seg_cc == 0 ){
-					PORTC = seven_seg_data[count];
-					PORTC |= (seven_seg_cc<<PINC7);
-					_delay_ms(5);
-					seven_seg_cc = 1 ^ seven_seg_cc;
-				}
-				else if (seven_seg_cc == 1 && p1 == 0){
-					PORTC = turn_data[turn];
-					PORTC |= (seven_seg_cc<<PINC7);
-					_delay_ms(5);
-				seven_seg_cc = 1 ^ seven_seg_cc;}
-
-				
-				else if (seven_seg_cc == 1 && p1 == 1){
-					PORTC = turn_data[turn2];
-					PORTC |= (seven_seg_cc<<PINC7);
-					_delay_ms(5);
-				seven_seg_cc = 1 ^ seven_seg_cc;}
-			}
-			pause=0;
-		}
-		
-		
-		if ((serial_input == 'e' || serial_input == 'E') && multi == 1) {
-			move_terminal_cursor(10,17);
-			printf_P(PSTR("                             "));
-			move_terminal_cursor(10,18);
-			printf_P(PSTR("Easy: No time limit          "));
-			limit = 0;
-		}
-		if ((serial_input == 'm' || serial_input == 'M') && multi == 1) {
-			move_terminal_cursor(10,18);
-			printf_P(PSTR("Medium: 90 seconds time limit"));
-			time_limit = 90;
-			p1_limit = time_limit;
-			p2_limit =time_limit;
-			p1_limit_sec =10;
-			p2_limit_sec =10;
-			p1_minus =0;
-			p2_minus =0;
-			limit = 1;
-			
-		}
-		if ((serial_input == 'h' || serial_input == 'H') && multi == 1) {
-			move_terminal_cursor(10,18);
-			printf_P(PSTR("Hard: 45 seconds time limit  "));
-			time_limit = 45;
-			p1_limit = time_limit;
-			p2_limit =time_limit;
-			p1_limit_sec =10;
-			p2_limit_sec =10;
-			p1_minus =0;
-			p2_minus =0;
-			limit = 1;
-			
-		}
-		if (serial_input == 'w' || serial_input == 'W') {
-			move_player(0,1);
-			last_flash_time = get_current_time();
-		}
-		if (serial_input == 'a' || serial_input == 'A') {
-			move_player(-1,0);
-			last_flash_time = get_current_time();
-		}
-		if (serial_input == 's' || serial_input == 'S') {
-			move_player(0,-1);
-			last_flash_time = get_current_time();
-		}
-		if (serial_input == 'd' || serial_input == 'D') {
-			move_player(1,0);
-			last_flash_time = get_current_time();
-		}
-		if (serial_input == 'r' || serial_input == 'R'|| (btn == BUTTON2_PUSHED)) {
-			start = 1;
-			if (rolling == 0){
-				PIND |= (1<<PIND2);
-				move_terminal_cursor(10,5);
-				printf_P(PSTR("Dice status: Rolling    "));
-				move_terminal_cursor(10,6);
-				printf_P(PSTR("Last Roll: %d"),count+1 );
-				rolling = 1;				
-			}
-			else if (rolling == 1){
-				if(multi == 1){
-					if (p1 == 0){
-						turn += 1;
-						_delay_ms(100);
-						p1 = p1^1;
-					}
-					else{turn2 += 1;
-						_delay_ms(100);
-						p1 = p1^1;}
-				}
-				else{turn += 1;}
-				
-				PIND |= (1<<PIND2);
-	
-				move_terminal_cursor(10,5);
-				printf_P(PSTR("Dice status: Not rolling"));
-				move_terminal_cursor(10,6);
-				printf_P(PSTR("Last Roll: %d"),count+1 );
-				
-				move_player_n(count +1);
-				rolling = 0;	
-			}
-
-		}
-		// MY CODE ABOVE
-		
-		current_time = get_current_time();
-		current_time2 = get_current_time();
-		switch_player = get_current_time();
-		if (p1_limit >= 10 && get_cur_player() == 0 && limit == 1 && switch_player >= last_switch + 500){
-			p1_limit = p1_limit - p1_minus;
-			move_terminal_cursor(10,17);
-			printf_P(PSTR("Player 1: %d Seconds left"),p1_limit);
-			last_switch = switch_player;
-			p1_minus = 1^p1_minus;
-		}
-		if (p2_limit >= 10 && get_cur_player() == 1 && limit == 1 && switch_player >= last_switch + 500){
-			p2_limit = p2_limit - p2_minus;
-			move_terminal_cursor(10,17);
-			printf_P(PSTR("Player 2: %d Seconds left"),p2_limit);
-			last_switch = switch_player;
-			p2_minus = 1^p2_minus;
-		}
-		if (p1_limit < 10 && get_cur_player() == 0 && limit == 1 && switch_player >= last_switch + 100){
-			p1_limit_sec = p1_limit_sec - 0.10;
-			move_terminal_cursor(10,17);
-			printf_P(PSTR("Player 1: %d.%d Seconds left"),p1_limit,p1_limit_sec);
-			last_switch = switch_player;
-			if (p1_limit_sec == 0 && p1_limit != 0)
-			{p1_limit_sec =10;
-				p1_limit -= 1;
-			}
-		}
-		if (p2_limit < 10 && get_cur_player() == 1 && limit == 1 && switch_player >= last_switch + 100){
-			p2_limit_sec = p2_limit_sec - 0.10;
-			move_terminal_cursor(10,17);
-			printf_P(PSTR("Player 2: %d.%d Seconds left"),p2_limit,p2_limit_sec);
-			last_switch = switch_player;
-			if (p2_limit_sec == 0 && p2_limit != 0)
-			{p2_limit_sec =10;
-			p2_limit -= 1;
-			}
-		}
-		if (((p1_limit <= 0 && p1_limit_sec == 0)||(p2_limit <= 0 && p2_limit_sec==0)) && limit == 1 && multi == 1){
-			handle_game_over();	
-		}
-		
-		if (current_time >= last_flash_time + pause_offset + 500) {
-			// 500ms (0.5 second) has passed since the last time we
-			// flashed the cursor, so flash the cursor
-			flash_player_cursor();
-			// Update the most recent time the cursor was flashed
-			last_flash_time = current_time;
-			
-			if (pause_offset != 0 ){
-				pause_offset =0;
-			}
-		}
-		if (current_time2 >= last_dice_time + 62 && rolling == 1){
-			count += 1;
-			if (count == 6){
-				count = 0;
-			}
-			last_dice_time = current_time2;
-		}
-		
-	if (turn == 10){
-		turn =0;
-	}
-	if (turn2 == 10){
-		turn2 =0;
-	}
-	switch_ssd();
-}
-}
- 
- 
-void handle_game_over() {
-	move_terminal_cursor(10,17);
-	if (get_winner() == 1){
-		printf_P(PSTR("GAME OVER: Player 1 Wins (Orange)"));
-	}
-	else if (get_winner() == 2){
-		printf_P(PSTR("GAME OVER: Player 2 Wins (Yellow)"));}
-
-		
-	move_terminal_cursor(10,18);
-	printf_P(PSTR("Press a button to start again"));
-	
-	PORTC =0x00;
-			
-	while(button_pushed() == NO_BUTTON_PUSHED ) {
-		show_winner();
-		char serial_input = -1;
-		if (serial_input_available()) {
-			serial_input = fgetc(stdin);
-		}
-		if (serial_input == 'q' || serial_input == 'Q') {
-			sound_on_off = 1 ^ sound_on_off;
-			if (sound_on_off == 1){
-			sound_off();}
-			if (sound_on_off == 0){
-				sound_on();
-			}
-		}
-		if (serial_input == 's' || serial_input == 'S'){
-			deactivate_multiplayer();
-			main();
-		}
-		
-	}
-	deactivate_multiplayer();
-	main();
-	
-}
+/*
+ * project.c
+ *
+ * Main file
+ *
+ * Authors: Peter Sutton, Luke Kamols, Jarrod Bennett
+ * Modified by <Adnaan Buksh>
+ */ 
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <stddef.h>
+
+#define F_CPU 8000000UL
+#include <util/delay.h>
+
+#include "project.h"
+#include "game.h"
+#include "display.h"
+#include "ledmatrix.h"
+#include "buttons.h"
+#include "serialio.h"
+#include "terminalio.h"
+#include "timer0.h"
+#include "joystick.h"
+#include "input.h"
+#include "screen.h"
+#include "telemetry.h"
+#include "command.h"
+#include "fmt.h"
+#include "sound.h"
+#include "pcm.h"
+#include "ai.h"
+#include "rules.h"
+#include "link.h"
+
+// Function prototypes - these are defined below (after main()) in the order
+// given here
+void initialise_hardware(void);
+void splash_enter(uint8_t from);
+void splash_run(void);
+void setup_enter(uint8_t from);
+void setup_run(void);
+void new_game(void);
+void playing_enter(uint8_t from);
+void playing_run(void);
+void paused_enter(uint8_t from);
+void paused_run(void);
+void paused_exit(uint8_t to);
+void game_over_enter(uint8_t from);
+void game_over_run(void);
+void game_over_exit(uint8_t to);
+uint8_t get_event(InputEvent* event, uint8_t* from_link);
+void handle_common_event(InputEvent* event);
+void toggle_sound(void);
+void set_players(int8_t players);
+void set_difficulty(int8_t difficulty);
+void set_time_limit(int8_t seconds);
+void set_link(int8_t player);
+void choose_board_type(int8_t board);
+void choose_rules(uint8_t rule_set);
+void count_turn(void);
+void show_last_roll(void);
+void show_time_left(uint8_t player, int seconds, int tenths);
+void roll_dice(void);
+void roll_dice_value(int8_t value, int8_t extra);
+void send_move(InputEvent* event);
+void show_link_rtt(void);
+void reply_state(void);
+void send_telemetry(void);
+
+volatile uint8_t seven_seg_cc = 0;
+int rolling;
+int board_type;
+int count;
+// The dice after the first, for house rules with more than one
+uint8_t extra_dice[RULES_MAX_DICE - 1];
+// The second die for the next roll, when it has been rolled already (on
+// the other unit of a linked game). 0 to roll it here.
+int8_t given_die;
+int start;
+int turn;
+int turn2;
+int multi;
+int p1;
+int p1_limit;
+int p2_limit;
+int limit;
+int time_limit;
+int p1_limit_sec;
+int p2_limit_sec;
+int p1_minus;
+int p2_minus;
+int sound_on_off;
+
+
+
+uint8_t turn_data[10] = {63,6,91,79,102,109,125,7,127,111};
+uint8_t seven_seg_data[6] = {6,91,79,102,109,125};
+uint32_t last_flash_time, current_time, current_time2, last_dice_time, last_switch,switch_player, pause_offset;
+uint32_t input_latency; // ms from the last input event to the display update
+
+// How often telemetry snapshots and counters are sent (ms)
+#define SNAPSHOT_PERIOD 200
+#define COUNTERS_PERIOD 1000
+// How often the changes to the LED matrix are sent, and every pixel (ms)
+#define MATRIX_PERIOD 40
+#define KEYFRAME_PERIOD 2000
+uint32_t last_snapshot_time, last_counters_time, last_matrix_time, last_keyframe_time;
+uint16_t loops;
+uint8_t game_winner; // 0 while a game is being played
+
+// What each state does. run is called over and over while the game is in
+// the state. enter and exit are called once when the game moves into or
+// out of the state, and are given the state it is coming from or going
+// to. enter and exit may be NULL.
+typedef struct {
+	void (*enter)(uint8_t from);
+	void (*run)(void);
+	void (*exit)(uint8_t to);
+} State;
+
+// In the order of the STATE_ numbers in project.h
+static const State states[] PROGMEM = {
+	{splash_enter, splash_run, NULL},
+	{setup_enter, setup_run, NULL},
+	{playing_enter, playing_run, NULL},
+	{paused_enter, paused_run, paused_exit},
+	{game_over_enter, game_over_run, game_over_exit}
+};
+
+static uint8_t state;
+static uint8_t next_state;
+
+/////////////////////////////// main //////////////////////////////////
+int main(void) {
+	
+	// Setup hardware and call backs. This will turn on 
+	// interrupts.
+	initialise_hardware();
+	
+	// Show the splash screen, then play games one after another for ever
+	run_game(STATE_SPLASH);
+	return 0;
+}
+
+void initialise_hardware(void) {
+	ledmatrix_setup();
+	init_button_interrupts();
+	// Setup serial port for 19200 baud communication with no echo
+	// of incoming characters
+	init_serial_stdio(19200,0);
+	
+	init_timer0();
+	
+	// Buzzer on timer 1 and sampled sound on timer 2
+	init_sound();
+	init_pcm();
+	
+	// Start sampling the joystick in the background
+	init_joystick();
+	
+	// Turn on global interrupts
+	sei();
+}
+
+
+void run_game(uint8_t first_state) {
+	State current;
+	state = first_state;
+	next_state = first_state;
+	memcpy_P(&current, &states[state], sizeof(current));
+	if (current.enter) {
+		current.enter(STATE_NONE);
+	}
+#ifdef BENCH_MAIN_LOOPS
+	// The benchmark build (host/bench) times a fixed number of passes
+	uint16_t bench_loops = 0;
+#endif
+	while(1) {
+#ifdef BENCH_MAIN_LOOPS
+		if (bench_loops++ == BENCH_MAIN_LOOPS) {
+			return;
+		}
+#endif
+		current.run();
+		if (next_state != state) {
+			if (current.exit) {
+				current.exit(next_state);
+			}
+			uint8_t from = state;
+			state = next_state;
+			memcpy_P(&current, &states[state], sizeof(current));
+			if (current.enter) {
+				current.enter(from);
+			}
+		}
+	}
+}
+
+void set_state(uint8_t new_state) {
+	next_state = new_state;
+}
+
+uint8_t get_state(void) {
+	return state;
+}
+
+// Show the start screen with the default settings
+void splash_enter(uint8_t from) {
+	// Clear terminal screen and output a message
+	sound_on_off =0;
+	sound_on();
+	screen_clear();
+	screen_set_field_P(SCREEN_FIELD_TITLE, PSTR("Snakes and Ladders"));
+	screen_set_field_P(SCREEN_FIELD_CREDIT, PSTR("CSSE2010/7201 A2 by Adnaan Buksh - 47435568"));
+	screen_set_field_P(SCREEN_FIELD_BOARD, PSTR("Board Chosen: One"));
+	choose_rules(rules_selected());
+	screen_set_field_P(SCREEN_FIELD_PLAYERS, PSTR("One Player"));
+	if (link_player()) {
+		// Still linked from the last game
+		set_link(link_player());
+	}
+	screen_set_field_P(SCREEN_FIELD_SOUND, PSTR("Sound ON"));
+	command_report_baud();
+
+	// Output the static start screen and wait for a push button 
+	// to be pushed or a serial input of 's'
+	start_display();
+	input_set_context(INPUT_CONTEXT_MENU);
+}
+
+// Choose the players, board and difficulty until a button is pressed, or
+// 's' is pressed on the terminal
+void splash_run(void) {
+	input_poll();
+	link_poll();
+	InputEvent event;
+	uint8_t from_link;
+	while (next_state == state && get_event(&event, &from_link)) {
+		// The other unit only ever starts the game from here
+		if (from_link && event.type != INPUT_START) {
+			continue;
+		}
+		switch (event.type) {
+			case INPUT_START:
+				if (from_link) {
+					// With the board and rules chosen on the other unit. A
+					// unit running another build could choose ones this
+					// one doesn't have, so the start is ignored then.
+					if (event.arg1 < 1 || event.arg1 > NUM_BOARDS ||
+							event.arg2 < 1 || event.arg2 > NUM_RULE_SETS) {
+						break;
+					}
+					choose_board_type(event.arg1 - 1);
+					choose_rules(event.arg2 - 1);
+				} else if (link_player() && !link_send_event(INPUT_START,
+						event.source, board_type + 1, rules_selected() + 1,
+						0)) {
+					break;
+				}
+				set_state(STATE_SETUP);
+				break;
+			case INPUT_PLAYERS:
+				link_set_player(0);
+				set_players(event.arg1);
+				break;
+			case INPUT_LINK:
+				set_link(event.arg1);
+				break;
+			case INPUT_DIFFICULTY:
+				if (multi == 1 && !link_player()) {
+					set_difficulty(event.arg1);
+				}
+				break;
+			case INPUT_BOARD:
+				// arg1 picks a board (from 1), otherwise the next board
+				if (event.arg1) {
+					choose_board_type(event.arg1 - 1);
+				} else {
+					choose_board_type((board_type + 1) % NUM_BOARDS);
+				}
+				break;
+			case INPUT_RULES:
+				// arg1 picks a rule set, otherwise go on to the next one
+				if (event.arg1) {
+					choose_rules(event.arg1 - 1);
+				} else {
+					choose_rules((rules_selected() + 1) % NUM_RULE_SETS);
+				}
+				break;
+			case INPUT_TIME_LIMIT:
+				if (!link_player()) {
+					set_time_limit(event.arg1);
+				}
+				break;
+			default:
+				handle_common_event(&event);
+				break;
+		}
+	}
+	// Send any changes to the status text
+	screen_flush();
+}
+
+void setup_enter(uint8_t from) {
+	new_game();
+}
+
+// The new game has been set up, so start playing it
+void setup_run(void) {
+	set_state(STATE_PLAYING);
+}
+
+void new_game(void) {
+	// Clear the serial terminal
+	screen_clear();
+	
+	// Initialise the game and display
+	initialise_game();
+	DDRC =0xFF;
+	DDRD |= (1<<DDRD2);
+	PORTC = 63;
+	turn2 = 0;
+	turn = 0;
+	start = 0;
+	rolling =0;
+	p1 =0;
+	sound_on_off=0;
+	pause_offset =0;
+	game_winner = 0;
+	joystick_calibrate();
+	sound_play(SOUND_EFFECT_START);
+	
+	// Clear any button events or serial input that are waiting
+	input_clear();
+}
+
+void switch_ssd(void){
+	if (seven_seg_cc == 0 && start == 0){
+		PORTC = 63;
+		_delay_ms(5);
+		seven_seg_cc = 1 ^ seven_seg_cc;
+	}
+	else if (seven_seg_cc == 0 ){
+		PORTC = seven_seg_data[count];
+		PORTC |= (seven_seg_cc<<PINC7);
+		_delay_ms(5);
+		seven_seg_cc = 1 ^ seven_seg_cc;
+	}
+	else if (seven_seg_cc == 1 && p1 == 0){
+		PORTC = turn_data[turn];
+		PORTC |= (seven_seg_cc<<PINC7);
+		_delay_ms(5);
+	seven_seg_cc = 1 ^ seven_seg_cc;}
+
+	
+	else if (seven_seg_cc == 1 && p1 == 1){
+		PORTC = turn_data[turn2];
+		PORTC |= (seven_seg_cc<<PINC7);
+		_delay_ms(5);
+	seven_seg_cc = 1 ^ seven_seg_cc;}
+}
+
+// Start the clocks for a new game. Coming back from a pause carries on
+// where it left off.
+void playing_enter(uint8_t from) {
+	input_set_context(INPUT_CONTEXT_GAME);
+	if (from == STATE_PAUSED) {
+		return;
+	}
+	last_dice_time = get_current_time();
+	last_flash_time = get_current_time();
+	last_switch = get_current_time();
+	p1_limit = time_limit;
+	p2_limit = time_limit;
+}
+
+// One pass of the game
+void playing_run(void) {
+	DDRD |= (1<<DDRD4);
+	
+	// Handle everything that has happened since the last pass - the
+	// buttons, serial terminal and joystick all arrive as events
+	input_poll();
+	if (link_poll()) {
+		show_link_rtt();
+	}
+	InputEvent event;
+	uint8_t from_link;
+	while (next_state == state && get_event(&event, &from_link)) {
+		uint8_t move = event.type == INPUT_MOVE || event.type == INPUT_STEP ||
+				event.type == INPUT_ROLL;
+		// Only moves come from the other unit
+		if (from_link && !move) {
+			continue;
+		}
+		// On the computer's turn only its own moves count, and in a linked
+		// game only the moves from the unit whose player's turn it is
+		if (move && (ai_playing() ? event.source != INPUT_SOURCE_CPU :
+				from_link != link_playing())) {
+			continue;
+		}
+		// The other unit is too far behind to take another move, so drop
+		// it rather than let the two get out of step
+		if (move && !from_link && !link_ready()) {
+			continue;
+		}
+		switch (event.type) {
+			case INPUT_MOVE:
+				if (event.source == INPUT_SOURCE_JOYSTICK) {
+					change_joystick();
+					move_player(event.arg1, event.arg2);
+					change_joystick();
+				} else {
+					move_player(event.arg1, event.arg2);
+					last_flash_time = get_current_time();
+				}
+				break;
+			case INPUT_STEP:
+				move_player_n(event.arg1);
+				last_flash_time = get_current_time();
+				count_turn();
+				break;
+			case INPUT_ROLL:
+				if (event.arg1) {
+					roll_dice_value(event.arg1, event.arg2);
+				} else {
+					roll_dice();
+				}
+				break;
+			case INPUT_PAUSE:
+				set_state(STATE_PAUSED);
+				break;
+			case INPUT_DIFFICULTY:
+				if (multi == 1 && !link_player()) {
+					set_difficulty(event.arg1);
+				}
+				break;
+			case INPUT_TIME_LIMIT:
+				if (!link_player()) {
+					set_time_limit(event.arg1);
+				}
+				break;
+			default:
+				handle_common_event(&event);
+				break;
+		}
+		// The display has been updated by now, so record how long it
+		// took from the input arriving
+		input_latency = get_current_time() - event.time;
+		if (move && !from_link && link_player()) {
+			send_move(&event);
+		}
+		if (has_winner()) {
+			set_state(STATE_GAME_OVER);
+		}
+	}
+	// Anything after a pause or the winning move is left for the next state
+	if (next_state != state) {
+		return;
+	}
+	// MY CODE ABOVE
+	
+	current_time = get_current_time();
+	current_time2 = get_current_time();
+	switch_player = get_current_time();
+	// The computer queues its moves for the next pass like any other input
+	ai_poll(current_time);
+	if (p1_limit >= 10 && get_cur_player() == 0 && limit == 1 && switch_player >= last_switch + 500){
+		p1_limit = p1_limit - p1_minus;
+		show_time_left(1, p1_limit, -1);
+		last_switch = switch_player;
+		p1_minus = 1^p1_minus;
+	}
+	if (p2_limit >= 10 && get_cur_player() == 1 && limit == 1 && switch_player >= last_switch + 500){
+		p2_limit = p2_limit - p2_minus;
+		show_time_left(2, p2_limit, -1);
+		last_switch = switch_player;
+		p2_minus = 1^p2_minus;
+	}
+	if (p1_limit < 10 && get_cur_player() == 0 && limit == 1 && switch_player >= last_switch + 100){
+		p1_limit_sec = p1_limit_sec - 0.10;
+		show_time_left(1, p1_limit, p1_limit_sec);
+		last_switch = switch_player;
+		if (p1_limit_sec == 0 && p1_limit != 0)
+		{p1_limit_sec =10;
+			p1_limit -= 1;
+		}
+	}
+	if (p2_limit < 10 && get_cur_player() == 1 && limit == 1 && switch_player >= last_switch + 100){
+		p2_limit_sec = p2_limit_sec - 0.10;
+		show_time_left(2, p2_limit, p2_limit_sec);
+		last_switch = switch_player;
+		if (p2_limit_sec == 0 && p2_limit != 0)
+		{p2_limit_sec =10;
+		p2_limit -= 1;
+		}
+	}
+	if (((p1_limit <= 0 && p1_limit_sec == 0)||(p2_limit <= 0 && p2_limit_sec==0)) && limit == 1 && multi == 1){
+		set_state(STATE_GAME_OVER);
+		return;
+	}
+	
+	if (current_time >= last_flash_time + pause_offset + 500) {
+		// 500ms (0.5 second) has passed since the last time we
+		// flashed the cursor, so flash the cursor
+		flash_player_cursor();
+		// Update the most recent time the cursor was flashed
+		last_flash_time = current_time;
+		
+		if (pause_offset != 0 ){
+			pause_offset =0;
+		}
+	}
+	if (current_time2 >= last_dice_time + 62 && rolling == 1){
+		count += 1;
+		if (count == 6){
+			count = 0;
+		}
+		last_dice_time = current_time2;
+	}
+	
+if (turn == 10){
+	turn =0;
+}
+if (turn2 == 10){
+	turn2 =0;
+}
+screen_flush();
+send_telemetry();
+switch_ssd();
+}
+
+void game_over_enter(uint8_t from) {
+	game_winner = get_winner();
+	if (get_winner() == 1){
+		screen_set_field_P(SCREEN_FIELD_STATUS, PSTR("GAME OVER: Player 1 Wins (Orange)"));
+	}
+	else if (get_winner() == 2){
+		screen_set_field_P(SCREEN_FIELD_STATUS, PSTR("GAME OVER: Player 2 Wins (Yellow)"));}
+
+		
+	screen_set_field_P(SCREEN_FIELD_MODE, PSTR("Press a button to start again"));
+	
+	PORTC =0x00;
+			
+	input_set_context(INPUT_CONTEXT_MENU);
+}
+
+// Show the winner until a button is pressed
+void game_over_run(void) {
+	screen_flush();
+	send_telemetry();
+	show_winner();
+	input_poll();
+	link_poll();
+	InputEvent event;
+	while (next_state == state && input_get_event(&event)) {
+		if (event.type == INPUT_START) {
+			set_state(STATE_SPLASH);
+		}
+		handle_common_event(&event);
+	}
+}
+
+// Back to one player, and stop the winner's tune
+void game_over_exit(uint8_t to) {
+	deactivate_multiplayer();
+	ai_set_enabled(0);
+	sound_stop();
+}
+
+// Take the next event to handle - one from the other unit in a linked game
+// if there is one, otherwise this unit's own input. from_link is set to
+// say which.
+uint8_t get_event(InputEvent* event, uint8_t* from_link) {
+	*from_link = link_get_event(event);
+	return *from_link || input_get_event(event);
+}
+
+// Handle the events that mean the same thing whatever state the game is in.
+// Anything not handled here is ignored.
+void handle_common_event(InputEvent* event) {
+	switch (event->type) {
+		case INPUT_SOUND:
+			toggle_sound();
+			break;
+		case INPUT_TELEMETRY:
+			telemetry_set_enabled(!telemetry_enabled());
+			break;
+		case INPUT_QUERY:
+			reply_state();
+			break;
+	}
+}
+
+void toggle_sound(void) {
+	sound_on_off = 1 ^ sound_on_off;
+	if (sound_on_off == 1){
+		screen_set_field_P(SCREEN_FIELD_SOUND, PSTR("Sound OFF"));
+		sound_off();
+	} else {
+		screen_set_field_P(SCREEN_FIELD_SOUND, PSTR("Sound ON"));
+		sound_on();
+	}
+}
+
+void set_players(int8_t players) {
+	// Playing the computer is a two player game with the computer taking
+	// player 2's turns
+	ai_set_enabled(players == PLAYERS_CPU);
+	if (players == 2 || players == PLAYERS_CPU){
+		multi = 1;
+		activate_multiplayer();
+		if (players == PLAYERS_CPU) {
+			screen_set_field_P(SCREEN_FIELD_PLAYERS, PSTR("Player vs CPU"));
+		} else {
+			screen_set_field_P(SCREEN_FIELD_PLAYERS, PSTR("Two Player"));
+		}
+		screen_set_field_P(SCREEN_FIELD_MODE, PSTR("Easy: No time limit"));
+	} else {
+		multi = 0;
+		deactivate_multiplayer();
+		screen_set_field_P(SCREEN_FIELD_PLAYERS, PSTR("One Player"));
+		screen_clear_field(SCREEN_FIELD_MODE);
+	}
+}
+
+void set_difficulty(int8_t difficulty) {
+	if (difficulty == DIFFICULTY_EASY) {
+		screen_clear_field(SCREEN_FIELD_STATUS);
+		screen_set_field_P(SCREEN_FIELD_MODE, PSTR("Easy: No time limit"));
+		limit = 0;
+		return;
+	}
+	if (difficulty == DIFFICULTY_MEDIUM) {
+		screen_set_field_P(SCREEN_FIELD_MODE, PSTR("Medium: 90 seconds time limit"));
+		time_limit = 90;
+	} else {
+		screen_set_field_P(SCREEN_FIELD_MODE, PSTR("Hard: 45 seconds time limit"));
+		time_limit = 45;
+	}
+	p1_limit = time_limit;
+	p2_limit = time_limit;
+	p1_limit_sec = 10;
+	p2_limit_sec = 10;
+	p1_minus = 0;
+	p2_minus = 0;
+	limit = 1;
+}
+
+// Set a time limit other than the difficulty presets. 0 turns it off.
+void set_time_limit(int8_t seconds) {
+	if (seconds == 0) {
+		set_difficulty(DIFFICULTY_EASY);
+		return;
+	}
+	char text[SCREEN_MAX_WIDTH + 1];
+	char* p = fmt_str_P(text, PSTR("Custom: "));
+	p = fmt_int(p, seconds, 0);
+	fmt_str_P(p, PSTR(" seconds time limit"));
+	screen_set_field(SCREEN_FIELD_MODE, text);
+	time_limit = seconds;
+	p1_limit = time_limit;
+	p2_limit = time_limit;
+	p1_limit_sec = 10;
+	p2_limit_sec = 10;
+	p1_minus = 0;
+	p2_minus = 0;
+	limit = 1;
+}
+
+// Play a two player game with another unit over the link (link.h), as
+// player 1 or 2 on this unit. 0 goes back to one player on this unit.
+// Linked games have no time limit - each unit would time the other
+// player's turns by its own clock.
+void set_link(int8_t player) {
+	if (player != link_player()) {
+		link_set_player(player);
+	}
+	if (player == 0) {
+		set_players(1);
+		return;
+	}
+	set_players(2);
+	set_difficulty(DIFFICULTY_EASY);
+	char text[SCREEN_MAX_WIDTH + 1];
+	fmt_uint(fmt_str_P(text, PSTR("Link Player ")), player, 0);
+	screen_set_field(SCREEN_FIELD_PLAYERS, text);
+}
+
+void choose_board_type(int8_t board) {
+	board_type = board;
+	if (board_type==0){screen_set_field_P(SCREEN_FIELD_BOARD, PSTR("Board Chosen: One"));}
+	if (board_type==1){screen_set_field_P(SCREEN_FIELD_BOARD, PSTR("Board Chosen: Two"));}
+	if (board_type==2){screen_set_field_P(SCREEN_FIELD_BOARD, PSTR("Board Chosen: Three"));}
+	if (board_type==3){screen_set_field_P(SCREEN_FIELD_BOARD, PSTR("Board Chosen: Four"));}
+	choose_board(board_type);
+}
+
+void choose_rules(uint8_t rule_set) {
+	char text[SCREEN_MAX_WIDTH + 1];
+	rules_select(rule_set);
+	rules_get_name(fmt_str_P(text, PSTR("Rules: ")));
+	screen_set_field(SCREEN_FIELD_RULES, text);
+}
+
+// Count a turn for the player who just moved and hand over to the other
+// player in a two player game
+void count_turn(void) {
+	if(multi == 1){
+		if (p1 == 0){
+			turn += 1;
+		} else {
+			turn2 += 1;
+		}
+		_delay_ms(100);
+		p1 = p1^1;
+	}
+	else{turn += 1;}
+}
+
+// The last roll, and each die's part of it when there's more than one
+void show_last_roll(void) {
+	char text[SCREEN_MAX_WIDTH + 1];
+	char* p = fmt_str_P(text, PSTR("Last Roll: "));
+	uint8_t total = count + 1;
+	for (uint8_t i = 1; i < rules_num_dice(); i++) {
+		total += extra_dice[i - 1];
+	}
+	p = fmt_int(p, total, 0);
+	// (extra_dice is still 0 before the first roll)
+	if (rules_num_dice() > 1 && extra_dice[0]) {
+		p = fmt_str_P(p, PSTR(" ("));
+		p = fmt_int(p, count + 1, 0);
+		for (uint8_t i = 1; i < rules_num_dice(); i++) {
+			p = fmt_char(p, '+');
+			p = fmt_int(p, extra_dice[i - 1], 0);
+		}
+		fmt_char(p, ')');
+	}
+	screen_set_field(SCREEN_FIELD_LAST_ROLL, text);
+}
+
+// Show how long the current player has left. tenths is -1 while there are
+// 10 seconds or more to go.
+void show_time_left(uint8_t player, int seconds, int tenths) {
+	char text[SCREEN_MAX_WIDTH + 1];
+	char* p = fmt_str_P(text, PSTR("Player "));
+	p = fmt_uint(p, player, 0);
+	p = fmt_str_P(p, PSTR(": "));
+	p = fmt_int(p, seconds, 0);
+	if (tenths >= 0) {
+		p = fmt_char(p, '.');
+		p = fmt_int(p, tenths, 0);
+	}
+	fmt_str_P(p, PSTR(" Seconds left"));
+	screen_set_field(SCREEN_FIELD_STATUS, text);
+}
+
+// Start the dice rolling, or stop it and move by the number rolled
+void roll_dice(void) {
+	start = 1;
+	if (rolling == 0){
+		if (!link_player()) {
+			PIND |= (1<<PIND2);
+		}
+		screen_set_field_P(SCREEN_FIELD_DICE, PSTR("Dice status: Rolling"));
+		show_last_roll();
+		rolling = 1;
+	}
+	else {
+		// The first die is the one the player stopped, and any others are
+		// rolled now
+		uint8_t total = count + 1;
+		uint8_t sixes = count == 5;
+		for (uint8_t i = 1; i < rules_num_dice(); i++) {
+			extra_dice[i - 1] = given_die ? given_die :
+					rules_roll_die(get_current_time());
+			total += extra_dice[i - 1];
+			sixes += extra_dice[i - 1] == 6;
+		}
+		given_die = 0;
+		count_turn();
+		if (!link_player()) {
+			PIND |= (1<<PIND2);
+		}
+		screen_set_field_P(SCREEN_FIELD_DICE, PSTR("Dice status: Not rolling"));
+		show_last_roll();
+		if (move_player_roll(total, sixes) && multi == 1) {
+			// Another turn, so the turn counter goes back to this player
+			p1 = p1^1;
+		}
+		rolling = 0;
+	}
+}
+
+// Roll a given value (1 to 6) straight away, as if the dice had been
+// stopped on it. extra is the second die under house rules with two, or 0
+// to roll it as usual.
+void roll_dice_value(int8_t value, int8_t extra) {
+	if (rolling == 0) {
+		roll_dice();
+	}
+	count = value - 1;
+	given_die = extra;
+	roll_dice();
+}
+
+// Send a move made on this unit to the other unit of a linked game. A roll
+// is sent as the dice came out here, so the other unit doesn't roll its
+// own.
+void send_move(InputEvent* event) {
+	int8_t arg1 = event->arg1;
+	int8_t arg2 = event->arg2;
+	if (event->type == INPUT_ROLL) {
+		arg1 = 0;
+		arg2 = 0;
+		if (rolling == 0) {
+			arg1 = count + 1;
+			if (rules_num_dice() > 1) {
+				arg2 = extra_dice[0];
+			}
+		}
+	}
+	link_send_event(event->type, event->source, arg1, arg2,
+			link_playing() || has_winner());
+}
+
+// The round trip for the last turn sent to the other unit, and the average
+void show_link_rtt(void) {
+	LinkStats stats;
+	link_get_stats(&stats);
+	char text[SCREEN_MAX_WIDTH + 1];
+	char* p = fmt_str_P(text, PSTR("Link RTT: "));
+	p = fmt_uint(p, stats.last_rtt, 0);
+	p = fmt_str_P(p, PSTR(" ms, avg "));
+	p = fmt_uint(p, stats.total_rtt / stats.turns, 0);
+	fmt_str_P(p, PSTR(" ms"));
+	screen_set_field(SCREEN_FIELD_STATUS, text);
+}
+
+// Answer a STATE? remote command
+void reply_state(void) {
+	char text[TELEMETRY_MAX_PAYLOAD + 1];
+	int8_t p1_x, p1_y, p2_x, p2_y;
+	get_player_position(0, &p1_x, &p1_y);
+	get_player_position(1, &p2_x, &p2_y);
+	char* p = fmt_str_P(text, PSTR("OK cur="));
+	p = fmt_uint(p, get_cur_player() + 1, 0);
+	p = fmt_str_P(p, PSTR(" p1="));
+	p = fmt_int(p, p1_x, 0);
+	p = fmt_char(p, ',');
+	p = fmt_int(p, p1_y, 0);
+	p = fmt_str_P(p, PSTR(" p2="));
+	p = fmt_int(p, p2_x, 0);
+	p = fmt_char(p, ',');
+	p = fmt_int(p, p2_y, 0);
+	p = fmt_str_P(p, PSTR(" dice="));
+	p = fmt_int(p, count + 1, 0);
+	p = fmt_str_P(p, PSTR(" win="));
+	fmt_uint(p, game_winner, 0);
+	command_reply(text);
+}
+
+// The time spent paused is added to pause_offset so the cursor flashing
+// carries on where it left off
+void paused_enter(uint8_t from) {
+	pause_offset = get_current_time();
+}
+
+// Wait until the game is resumed, keeping the seven segment display going
+void paused_run(void) {
+	input_poll();
+	link_poll();
+	InputEvent event;
+	while (next_state == state && input_get_event(&event)) {
+		if (event.type == INPUT_PAUSE) {
+			set_state(STATE_PLAYING);
+		}
+		handle_common_event(&event);
+	}
+	if (next_state != state) {
+		return;
+	}
+	screen_flush();
+	send_telemetry();
+	switch_ssd();
+}
+
+void paused_exit(uint8_t to) {
+	pause_offset = get_current_time() - pause_offset;
+}
+
+// Send a snapshot of the game state, the performance counters and the
+// changes to the LED matrix if they're due. This is called every pass of the game loop.
+void send_telemetry(void) {
+	loops++;
+	if (!telemetry_enabled()) {
+		return;
+	}
+	uint32_t now = get_current_time();
+	if (now - last_snapshot_time >= SNAPSHOT_PERIOD) {
+		TelemetrySnapshot snapshot;
+		int8_t x, y;
+		snapshot.time = now;
+		snapshot.flags = 0;
+		if (multi == 1) {
+			snapshot.flags |= SNAPSHOT_MULTIPLAYER;
+		}
+		if (rolling == 1) {
+			snapshot.flags |= SNAPSHOT_ROLLING;
+		}
+		if (sound_on_off == 0) {
+			snapshot.flags |= SNAPSHOT_SOUND_ON;
+		}
+		if (limit == 1) {
+			snapshot.flags |= SNAPSHOT_TIME_LIMIT;
+		}
+		snapshot.current_player = get_cur_player();
+		get_player_position(0, &x, &y);
+		snapshot.p1_x = x;
+		snapshot.p1_y = y;
+		get_player_position(1, &x, &y);
+		snapshot.p2_x = x;
+		snapshot.p2_y = y;
+		snapshot.dice = count + 1;
+		snapshot.board = board_type;
+		snapshot.p1_turns = turn;
+		snapshot.p2_turns = turn2;
+		snapshot.p1_time_left = p1_limit;
+		snapshot.p2_time_left = p2_limit;
+		snapshot.winner = game_winner;
+		telemetry_send_snapshot(&snapshot);
+		last_snapshot_time = now;
+	}
+	if (now - last_counters_time >= COUNTERS_PERIOD) {
+		TelemetryCounters counters;
+		counters.input_latency = input_latency;
+		counters.loops = loops;
+		counters.period = now - last_counters_time;
+		telemetry_send_counters(&counters);
+		last_counters_time = now;
+		loops = 0;
+	}
+	if (now - last_keyframe_time >= KEYFRAME_PERIOD) {
+		ledmatrix_mark_all_changed();
+		last_keyframe_time = now;
+	}
+	if (now - last_matrix_time >= MATRIX_PERIOD) {
+		telemetry_send_matrix();
+		last_matrix_time = now;
+	}
+}
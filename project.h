@@ -1 +1,42 @@
-void switch_ssd();
\ No newline at end of file
+/*
+ * project.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * The game moves through these states, one at a time:
+ *
+ *   splash -> setup -> playing <-> paused
+ *      ^                  |
+ *      +-- game over <----+
+ *
+ * main() runs the current state over and over from a single loop.
+ * set_state() asks for a change, which happens at the end of the pass:
+ * the old state's exit hook runs and then the new state's enter hook.
+ * Nothing is ever nested, so the game can be played for as long as the
+ * power stays on.
+ */
+
+
+#ifndef PROJECT_H_
+#define PROJECT_H_
+
+#include <stdint.h>
+
+#define STATE_SPLASH		0	// start screen - choose the settings
+#define STATE_SETUP			1	// set up a new game
+#define STATE_PLAYING		2
+#define STATE_PAUSED		3
+#define STATE_GAME_OVER		4	// show the winner
+
+// Passed to the first state's enter hook
+#define STATE_NONE			0xFF
+
+void switch_ssd();
+
+// Run the game, starting in first_state. This only returns in the
+// benchmark build.
+void run_game(uint8_t first_state);
+void set_state(uint8_t new_state);
+uint8_t get_state(void);
+
+#endif /* PROJECT_H_ */
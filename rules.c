@@ -0,0 +1,99 @@
+/*
+ * rules.c
+ *
+ * Author: Adnaan Buksh
+ */
+
+#include <string.h>
+#include <avr/pgmspace.h>
+#include "rules.h"
+#include "game.h"
+
+typedef struct {
+	const char* name;	// in program memory
+	uint8_t dice;
+} RuleSet;
+
+// The planner for every rule set. options is always a constant, so each
+// copy of this (one per case in rules_plan_move()) keeps only the code for
+// the options its rule set uses.
+static inline __attribute__((always_inline)) void plan_move(uint16_t square,
+		uint8_t spaces, uint8_t sixes, RuleMove* move, uint8_t options) {
+	// Squares to the finish, the last square on the path
+	uint16_t left = get_board_squares() - 1 - square;
+	move->forward = spaces;
+	move->back = 0;
+	move->extra_turn = (options & RULE_EXTRA_TURN) && sixes;
+	if (spaces <= left) {
+		return;
+	}
+	if (options & RULE_EXACT_FINISH) {
+		move->forward = 0;
+	} else if (options & RULE_BOUNCE_BACK) {
+		move->forward = left;
+		move->back = spaces - left;
+	} else {
+		move->forward = left;
+	}
+}
+
+#define RULE_SET_NAME(id, name, options, dice) \
+	static const char name_##id[] PROGMEM = name;
+RULE_SETS(RULE_SET_NAME)
+
+#define RULE_SET_ENTRY(id, name, options, dice) {name_##id, dice},
+static const RuleSet rule_sets[NUM_RULE_SETS] PROGMEM = {
+	RULE_SETS(RULE_SET_ENTRY)
+};
+
+// The selected rule set, copied out of program memory
+static uint8_t selected_id;
+static RuleSet selected = {name_RULES_STANDARD, 1};
+
+static uint16_t die_state = 1;
+
+void rules_select(uint8_t rule_set) {
+	if (rule_set >= NUM_RULE_SETS) {
+		rule_set = RULES_STANDARD;
+	}
+	selected_id = rule_set;
+	memcpy_P(&selected, &rule_sets[rule_set], sizeof(RuleSet));
+}
+
+uint8_t rules_selected(void) {
+	return selected_id;
+}
+
+void rules_get_name(char* name) {
+	strcpy_P(name, selected.name);
+}
+
+uint8_t rules_num_dice(void) {
+	return selected.dice;
+}
+
+uint8_t rules_roll_die(uint32_t time) {
+	// xorshift, stirred with the time so the other dice depend on when the
+	// first one was stopped
+	uint16_t x = die_state ^ (uint16_t)time;
+	if (x == 0) {
+		x = 1;
+	}
+	x ^= x << 7;
+	x ^= x >> 9;
+	x ^= x << 8;
+	die_state = x;
+	return x % 6 + 1;
+}
+
+#define RULE_SET_CASE(id, name, options, dice) \
+	case id: \
+		plan_move(square, spaces, sixes, move, options); \
+		break;
+
+void rules_plan_move(uint16_t square, uint8_t spaces, uint8_t sixes,
+		RuleMove* move) {
+	switch (selected_id) {
+		RULE_SETS(RULE_SET_CASE)
+	}
+}
@@ -0,0 +1,90 @@
+/*
+ * rules.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * House rules, chosen on the start screen for each game. A rule set is a
+ * combination of these options:
+ *   exact finish   a move that would go past the finish isn't made
+ *   bounce back    a move that would go past the finish goes back from it
+ *                  by the squares left over
+ *   extra turn     a player who rolls a 6 goes again
+ *   dice           how many dice are rolled (added together)
+ * With neither exact finish nor bounce back, a move past the finish stops
+ * on it.
+ *
+ * The rule sets are listed in RULE_SETS. rules.c builds a separate move
+ * planner for each one with its options fixed at compile time, inlined
+ * into a switch on the rule set, so a rule set only has the code for the
+ * options it uses and the standard rules cost a switch over the clamp at
+ * the finish they had before there was a choice.
+ */
+
+
+#ifndef RULES_H_
+#define RULES_H_
+
+#include <stdint.h>
+
+// Rule options
+#define RULE_EXACT_FINISH	0x01
+#define RULE_BOUNCE_BACK	0x02
+#define RULE_EXTRA_TURN		0x04
+
+// Most dice any rule set rolls
+#define RULES_MAX_DICE		2
+
+// The rule sets: X(id, name, options, dice). The first is the default.
+#define RULE_SETS(X) \
+	X(RULES_STANDARD,	"Standard",			0,					1) \
+	X(RULES_EXACT,		"Exact finish",		RULE_EXACT_FINISH,	1) \
+	X(RULES_BOUNCE,		"Bounce back",		RULE_BOUNCE_BACK,	1) \
+	X(RULES_SIXES,		"Extra turn on 6",	RULE_EXTRA_TURN,	1) \
+	X(RULES_TWO_DICE,	"Two dice",			0,					2) \
+	X(RULES_PARTY,		"Party",	RULE_BOUNCE_BACK | RULE_EXTRA_TURN,	2)
+
+#define RULE_SET_ID(id, name, options, dice) id,
+enum {
+	RULE_SETS(RULE_SET_ID)
+	NUM_RULE_SETS
+};
+
+// Longest rule set name
+#define RULES_MAX_NAME 15
+
+typedef struct {
+	uint8_t forward;	// squares to move towards the finish
+	uint8_t back;		// then squares to move back towards the start
+	uint8_t extra_turn;	// 1 if the player goes again
+} RuleMove;
+
+/* Choose the rules for the next game. rule_set is one of the RULES_ ids
+ * above.
+ */
+void rules_select(uint8_t rule_set);
+uint8_t rules_selected(void);
+
+/* Copy the name of the selected rule set into name, which must have room
+ * for RULES_MAX_NAME + 1 characters.
+ */
+void rules_get_name(char* name);
+
+/* Number of dice to roll under the selected rules.
+ */
+uint8_t rules_num_dice(void);
+
+/* Roll a die (1 to 6) for the dice after the first. The first is the one
+ * shown rolling on the seven segment display and stopped by the player.
+ * time (get_current_time()) stirs the result.
+ */
+uint8_t rules_roll_die(uint32_t time);
+
+/* Work out a move under the selected rules, for a player on square (the
+ * position along the path, from 0 at the start) moving spaces squares.
+ * sixes is the number of dice that came up 6, or 0 for a move that
+ * wasn't rolled.
+ */
+void rules_plan_move(uint16_t square, uint8_t spaces, uint8_t sixes,
+		RuleMove* move);
+
+#endif /* RULES_H_ */
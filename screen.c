@@ -0,0 +1,180 @@
+/*
+ * screen.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * At 19200 baud each character takes about 0.5ms to send, so the status
+ * text is kept in a model here and only changed characters are sent.
+ * Each cell has a dirty bit which is set when the character in it
+ * changes, and cleared once it has been sent.
+ */
+
+#include "screen.h"
+#include <avr/pgmspace.h>
+#include "serialio.h"
+#include "terminalio.h"
+
+typedef struct {
+	uint8_t x;		// terminal column of the first character
+	uint8_t y;		// terminal row
+	uint8_t width;	// number of characters
+	uint8_t offset;	// index of the first character in cells[]
+} ScreenField;
+
+// Field widths are the longest text shown in each field
+static const ScreenField fields[SCREEN_NUM_FIELDS] = {
+	{10, 5, 24, 0},		// SCREEN_FIELD_DICE
+	{10, 6, 19, 24},	// SCREEN_FIELD_LAST_ROLL
+	{10, 8, 9, 43},		// SCREEN_FIELD_SOUND
+	{10, 10, 18, 52},	// SCREEN_FIELD_TITLE
+	{10, 12, 43, 70},	// SCREEN_FIELD_CREDIT
+	{10, 14, 19, 113},	// SCREEN_FIELD_BOARD
+	{10, 15, 22, 132},	// SCREEN_FIELD_RULES
+	{10, 16, 13, 154},	// SCREEN_FIELD_PLAYERS
+	{10, 17, 33, 167},	// SCREEN_FIELD_STATUS
+	{10, 18, 30, 200}	// SCREEN_FIELD_MODE
+};
+#define SCREEN_CELLS 230
+
+static char cells[SCREEN_CELLS];
+static uint8_t dirty[(SCREEN_CELLS + 7) / 8];
+static uint16_t dirty_fields;
+
+// Where the terminal cursor is. A row of 0 means we don't know.
+static uint8_t cursor_x;
+static uint8_t cursor_y;
+
+// Longest escape sequence used to move the cursor ("\x1b[yy;xxH") plus
+// the character to send
+#define SCREEN_MAX_SEND 9
+
+static void set_cell(uint8_t field, uint8_t index, char c) {
+	if (cells[index] != c) {
+		cells[index] = c;
+		dirty[index >> 3] |= (1 << (index & 7));
+		dirty_fields |= (1 << field);
+	}
+}
+
+void screen_clear(void) {
+	clear_terminal();
+	for (uint8_t i = 0; i < SCREEN_CELLS; i++) {
+		cells[i] = ' ';
+	}
+	for (uint8_t i = 0; i < sizeof(dirty); i++) {
+		dirty[i] = 0;
+	}
+	dirty_fields = 0;
+	screen_invalidate_cursor();
+}
+
+void screen_redraw(void) {
+	clear_terminal();
+	for (uint8_t field = 0; field < SCREEN_NUM_FIELDS; field++) {
+		const ScreenField* f = &fields[field];
+		for (uint8_t i = 0; i < f->width; i++) {
+			uint8_t index = f->offset + i;
+			if (cells[index] != ' ') {
+				dirty[index >> 3] |= (1 << (index & 7));
+				dirty_fields |= (1 << field);
+			}
+		}
+	}
+	screen_invalidate_cursor();
+}
+
+void screen_set_field(uint8_t field, const char* text) {
+	const ScreenField* f = &fields[field];
+	for (uint8_t i = 0; i < f->width; i++) {
+		char c = *text;
+		if (c) {
+			text++;
+		} else {
+			c = ' ';
+		}
+		set_cell(field, f->offset + i, c);
+	}
+}
+
+void screen_set_field_P(uint8_t field, const char* text) {
+	const ScreenField* f = &fields[field];
+	for (uint8_t i = 0; i < f->width; i++) {
+		char c = pgm_read_byte(text);
+		if (c) {
+			text++;
+		} else {
+			c = ' ';
+		}
+		set_cell(field, f->offset + i, c);
+	}
+}
+
+void screen_clear_field(uint8_t field) {
+	screen_set_field(field, "");
+}
+
+void screen_invalidate_cursor(void) {
+	cursor_y = 0;
+}
+
+static uint8_t number_length(uint8_t n) {
+	return n >= 100 ? 3 : (n >= 10 ? 2 : 1);
+}
+
+// Move the cursor to (x, y) using the fewest characters. On the same row
+// we can step right with an escape sequence or, for a short gap, just
+// send the characters already on the screen again.
+static void move_cursor(const ScreenField* f, uint8_t x, uint8_t y) {
+	if (cursor_y == y && cursor_x == x) {
+		return;
+	}
+	uint8_t absolute_cost = 4 + number_length(y) + number_length(x);
+	if (cursor_y == y && cursor_x < x) {
+		uint8_t gap = x - cursor_x;
+		uint8_t right_cost = (gap == 1) ? 3 : 3 + number_length(gap);
+		if (gap <= right_cost && gap < absolute_cost && cursor_x >= f->x) {
+			// The gap lies within this field, so resend it
+			serial_write(&cells[f->offset + cursor_x - f->x], gap);
+			cursor_x = x;
+			return;
+		}
+		if (right_cost < absolute_cost) {
+			move_terminal_cursor_right(gap);
+			cursor_x = x;
+			return;
+		}
+	}
+	move_terminal_cursor(x, y);
+	cursor_x = x;
+	cursor_y = y;
+}
+
+void screen_flush(void) {
+	// Hold the changes while text output is off (they're sent once it's
+	// back on)
+	if (!serial_text_output()) {
+		return;
+	}
+	for (uint8_t field = 0; dirty_fields && field < SCREEN_NUM_FIELDS; field++) {
+		if (!(dirty_fields & (1 << field))) {
+			continue;
+		}
+		const ScreenField* f = &fields[field];
+		for (uint8_t i = 0; i < f->width; i++) {
+			uint8_t index = f->offset + i;
+			uint8_t bit = 1 << (index & 7);
+			if (!(dirty[index >> 3] & bit)) {
+				continue;
+			}
+			if (serial_output_space() < SCREEN_MAX_SEND) {
+				// Out of buffer space - carry on next time
+				return;
+			}
+			move_cursor(f, f->x + i, f->y);
+			serial_write(&cells[index], 1);
+			cursor_x++;
+			dirty[index >> 3] &= ~bit;
+		}
+		dirty_fields &= ~(1 << field);
+	}
+}
@@ -0,0 +1,71 @@
+/*
+ * screen.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * A model of the status text shown on the serial terminal. The status
+ * lines are divided into named fields at fixed positions. Text is written
+ * into the model and screen_flush() sends only the characters that have
+ * changed since they were last sent, using the cheapest cursor movement
+ * to get to each one.
+ */
+
+
+#ifndef SCREEN_H_
+#define SCREEN_H_
+
+#include <stdint.h>
+
+// Status fields (in screen order)
+#define SCREEN_FIELD_DICE		0	// dice status (row 5)
+#define SCREEN_FIELD_LAST_ROLL	1	// last dice roll (row 6)
+#define SCREEN_FIELD_SOUND		2	// sound on/off (row 8)
+#define SCREEN_FIELD_TITLE		3	// game title (row 10)
+#define SCREEN_FIELD_CREDIT		4	// author (row 12)
+#define SCREEN_FIELD_BOARD		5	// board chosen (row 14)
+#define SCREEN_FIELD_RULES		6	// house rules (row 15)
+#define SCREEN_FIELD_PLAYERS	7	// number of players (row 16)
+#define SCREEN_FIELD_STATUS		8	// time left / game over (row 17)
+#define SCREEN_FIELD_MODE		9	// difficulty / restart prompt (row 18)
+#define SCREEN_NUM_FIELDS		10
+
+// Widest field - a buffer of SCREEN_MAX_WIDTH + 1 characters will hold
+// the text of any field
+#define SCREEN_MAX_WIDTH		43
+
+/* Clear the terminal and the model.
+ */
+void screen_clear(void);
+
+/* Set the text of a field. Text longer than the field is cut off and the
+ * rest of the field is filled with spaces. Nothing is sent until
+ * screen_flush() is called.
+ */
+void screen_set_field(uint8_t field, const char* text);
+
+/* As for screen_set_field() but for text stored in program memory.
+ */
+void screen_set_field_P(uint8_t field, const char* text);
+
+/* Blank a field.
+ */
+void screen_clear_field(uint8_t field);
+
+/* Send the changed parts of the model to the terminal. Only as much as
+ * fits in the serial output buffer is sent, so this never blocks. Anything
+ * left over is sent by the next call.
+ */
+void screen_flush(void);
+
+/* Clear the terminal and send the whole model again on the next flush
+ * (e.g. after the terminal has been used for something else).
+ */
+void screen_redraw(void);
+
+/* Forget where the terminal cursor is. This must be called after writing
+ * to the terminal other than through this module.
+ */
+void screen_invalidate_cursor(void);
+
+
+#endif /* SCREEN_H_ */
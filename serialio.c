@@ -1,303 +1,577 @@
-/*
- * FILE: serialio.c
- *
- * Written by Peter Sutton.
- * 
- * Module to allow standard input/output routines to be used via 
- * serial port 0. The init_serial_stdio() method must be called before
- * any standard IO methods (e.g. printf). We use interrupt-based output
- * and a circular buffer to store output messages. (This allows us 
- * to print many characters at once to the buffer and have them 
- * output by the UART as speed permits.) If the buffer fills up, the
- * put method will either
- * (1) if interrupts are enabled, block until there is room in it, or
- * (2) if interrupts are disabled, will discard the character.
- * Input is blocking - requesting input from stdin will block
- * until a character is available. If interrupts are disabled when 
- * input is sought, then this will block forever.
- * The function input_available() can be used to test whether there is
- * input available to read from stdin.
- *
- */
-
-#include "serialio.h"
-#include <stdio.h>
-#include <stdint.h>
-#include <avr/io.h>
-#include <avr/interrupt.h>
-
-/* System clock rate in Hz. (L at the end indicates this is a long constant) */
-#define SYSCLK 8000000L
-
-/* Global variables */
-/* Circular buffer to hold outgoing characters. The insert_pos variable
- * keeps track of the position (0 to OUTPUT_BUFFER_SIZE-1) that the next
- * outgoing character should be written to. bytes_in_buffer keeps
- * count of the number of characters currently stored in the buffer 
- * (ranging from 0 to OUTPUT_BUFFER_SIZE). This number of bytes immediately
- * prior to the current insert_pos are the bytes waiting to be output.
- * If the insert_pos reaches the end of the buffer it will wrap around
- * to the beginning (assuming those bytes have been output).
- * NOTE - OUTPUT_BUFFER_SIZE can not be larger than 255 without changing
- * the type of the variables below (currently defined as 8 bit unsigned ints).
- */
-#define OUTPUT_BUFFER_SIZE 255
-volatile char out_buffer[OUTPUT_BUFFER_SIZE];
-volatile uint8_t out_insert_pos;
-volatile uint8_t bytes_in_out_buffer;
-
-/* Circular buffer to hold incoming characters. Works on same principle
- * as output buffer
- */
-#define INPUT_BUFFER_SIZE 16
-volatile char input_buffer[INPUT_BUFFER_SIZE];
-volatile uint8_t input_insert_pos;
-volatile uint8_t bytes_in_input_buffer;
-volatile uint8_t input_overrun;
-
-/* Variable to keep track of whether incoming characters are to be echoed
- * back or not.
- */
-static int8_t do_echo;
-
-/* Function prototypes 
- */
-void init_serial_stdio(long baudrate, int8_t echo);
-static int uart_put_char(char, FILE*);
-static int uart_get_char(FILE*);
-
-/* Setup a stream that uses the uart get and put functions. We will
- * make standard input and output use this stream below.
- */
-static FILE myStream = FDEV_SETUP_STREAM(uart_put_char, uart_get_char,
-		_FDEV_SETUP_RW);
-
-void init_serial_stdio(long baudrate, int8_t echo) {
-	uint16_t ubrr;
-	/*
-	 * Initialise our buffers
-	*/
-	out_insert_pos = 0;
-	bytes_in_out_buffer = 0;
-	input_insert_pos = 0;
-	bytes_in_input_buffer = 0;
-	input_overrun = 0;
-	
-	/*
-	 * Record whether we're going to echo characters or not
-	*/
-	do_echo = echo;
-	
-	/* Configure the serial port baud rate */
-	/* (This differs from the datasheet formula so that we get 
-	 * rounding to the nearest integer while using integer division
-	 * (which truncates)).
-	*/
-	ubrr = ((SYSCLK / (8 * baudrate)) + 1)/2 - 1;
-	UBRR0 = ubrr;
-	
-	/*
-	 * Enable transmission and receiving via UART. We don't enable
-	 * the UDR empty interrupt here (we wait until we've got a
-	 * character to transmit).
-	 * NOTE: Interrupts must be enabled globally for this
-	 * library to work, but we do not do this here.
-	*/
-	UCSR0B = (1<<RXEN0)|(1<<TXEN0);
-	
-	/*
-	 * Enable receive complete interrupt 
-	*/
-	UCSR0B  |= (1 <<RXCIE0);
-
-	/* Set up our stream so the put and get functions below are used 
-	 * to write/read characters via the serial port when we use
-	 * stdio functions
-	*/
-	stdout = &myStream;
-	stdin = &myStream;
-}
-
-int8_t serial_input_available(void) {
-	return (bytes_in_input_buffer != 0);
-}
-
-void clear_serial_input_buffer(void) {
-	/* Just adjust our buffer data so it looks empty */
-	input_insert_pos = 0;
-	bytes_in_input_buffer = 0;
-}
-
-static int uart_put_char(char c, FILE* stream) {
-	uint8_t interrupts_enabled;
-	
-	/* Add the character to the buffer for transmission (if there 
-	 * is space to do so). If not we wait until the buffer has space.
-	 * If the character is \n, we output \r (carriage return)
-	 * also.
-	*/
-	if(c == '\n') {
-		uart_put_char('\r', stream);
-	}
-	
-	/* If the buffer is full and interrupts are disabled then we
-	 * abort - we don't output the character since the buffer will
-	 * never be emptied if interrupts are disabled. If the buffer is full
-	 * and interrupts are enabled then we loop until the buffer has 
-	 * enough space. The bytes_in_buffer variable will get modified by the
-	 * ISR which extracts bytes from the buffer.
-	*/
-	interrupts_enabled = bit_is_set(SREG, SREG_I);
-	while(bytes_in_out_buffer >= OUTPUT_BUFFER_SIZE) {
-		if(!interrupts_enabled) {
-			return 1;
-		}		
-		/* else do nothing */
-	}
-	
-	/* Add the character to the buffer for transmission if there
-	 * is space to do so. We advance the insert_pos to the next
-	 * character position. If this is beyond the end of the buffer
-	 * we wrap around back to the beginning of the buffer 
-	 * NOTE: we disable interrupts before modifying the buffer. This
-	 * prevents the ISR from modifying the buffer at the same time.
-	 * We reenable them if they were enabled when we entered the
-	 * function.
-	*/	
-	cli();
-	out_buffer[out_insert_pos++] = c;
-	bytes_in_out_buffer++;
-	if(out_insert_pos == OUTPUT_BUFFER_SIZE) {
-		/* Wrap around buffer pointer if necessary */
-		out_insert_pos = 0;
-	}
-	/* Reenable interrupts (UDR Empty interrupt may have been
-	 * disabled) - we ensure it is now enabled so that it will
-	 * fire and deal with the next character in the buffer. */
-	UCSR0B |= (1 << UDRIE0);
-	if(interrupts_enabled) {
-		sei();
-	}
-	return 0;
-}
-
-int uart_get_char(FILE* stream) {
-	/* Wait until we've received a character */
-	while(bytes_in_input_buffer == 0) {
-		/* do nothing */
-	}
-	
-	/*
-	 * Turn interrupts off and remove a character from the input
-	 * buffer. We reenable interrupts if they were on.
-	 * The pending character is the one which is byte_in_input_buffer
-	 * characters before the insert position (taking into account
-	 * that we may need to wrap around).
-	 */
-	uint8_t interrupts_enabled = bit_is_set(SREG, SREG_I);
-	cli();
-	char c;
-	if(input_insert_pos - bytes_in_input_buffer < 0) {
-		/* Need to wrap around */
-		c = input_buffer[input_insert_pos - bytes_in_input_buffer
-				+ INPUT_BUFFER_SIZE];
-	} else {
-		c = input_buffer[input_insert_pos - bytes_in_input_buffer];
-	}
-	
-	/* Decrement our count of bytes in the input buffer */
-	bytes_in_input_buffer--;
-	if(interrupts_enabled) {
-		sei();
-	}	
-	return c;
-}
-
-/*
- * Define the interrupt handler for UART Data Register Empty (i.e. 
- * another character can be taken from our buffer and written out)
- */
-ISR(USART0_UDRE_vect) 
-{
-	/* Check if we have data in our buffer */
-	if(bytes_in_out_buffer > 0) {
-		/* Yes we do - remove the pending byte and output it
-		 * via the UART. The pending byte (character) is the
-		 * one which is "bytes_in_buffer" characters before the 
-		 * insert_pos (taking into account that we may 
-		 * need to wrap around to the end of the buffer).
-		 */
-		char c;
-		if(out_insert_pos - bytes_in_out_buffer < 0) {
-			/* Need to wrap around */
-			c = out_buffer[out_insert_pos - bytes_in_out_buffer
-				+ OUTPUT_BUFFER_SIZE];
-		} else {
-			c = out_buffer[out_insert_pos - bytes_in_out_buffer];
-		}
-		/* Decrement our count of the number of bytes in the 
-		 * buffer 
-		 */
-		bytes_in_out_buffer--;
-		
-		/* Output the character via the UART */
-		UDR0 = c;
-	} else {
-		/* No data in the buffer. We disable the UART Data
-		 * Register Empty interrupt because otherwise it 
-		 * will trigger again immediately this ISR exits. 
-		 * The interrupt is reenabled when a character is
-		 * placed in the buffer.
-		 */
-		UCSR0B &= ~(1<<UDRIE0);
-	}
-}
-
-/*
- * Define the interrupt handler for UART Receive Complete (i.e. 
- * we can read a character. The character is read and placed in
- * the input buffer.
- */
-
-ISR(USART0_RX_vect) 
-{
-	/* Read the character - we ignore the possibility of overrun. */
-	char c;
-	c = UDR0;
-		
-	if(do_echo && bytes_in_out_buffer < OUTPUT_BUFFER_SIZE) {
-		/* If echoing is enabled and there is output buffer
-		 * space, echo the received character back to the UART.
-		 * (If there is no output buffer space, characters
-		 * will be lost.)
-		 */
-		uart_put_char(c, 0);
-	}
-	
-	/* 
-	 * Check if we have space in our buffer. If not, set the overrun
-	 * flag and throw away the character. (We never clear the 
-	 * overrun flag - it's up to the programmer to check/clear
-	 * this flag if desired.)
-	 */
-	if(bytes_in_input_buffer >= INPUT_BUFFER_SIZE) {
-		input_overrun = 1;
-	} else {
-		/* If the character is a carriage return, turn it into a
-		 * linefeed 
-		*/
-		if (c == '\r') {
-			c = '\n';
-		}
-		
-		/* 
-		 * There is room in the input buffer 
-		 */
-		input_buffer[input_insert_pos++] = c;
-		bytes_in_input_buffer++;
-		if(input_insert_pos == INPUT_BUFFER_SIZE) {
-			/* Wrap around buffer pointer if necessary */
-			input_insert_pos = 0;
-		}
-	}
-}
+/*
+ * FILE: serialio.c
+ *
+ * Written by Peter Sutton.
+ * 
+ * Module to allow standard input/output routines to be used via 
+ * serial port 0. The init_serial_stdio() method must be called before
+ * any standard IO methods (e.g. printf). We use interrupt-based output
+ * and a circular buffer to store output messages. (This allows us 
+ * to print many characters at once to the buffer and have them 
+ * output by the UART as speed permits.) If the buffer fills up, the
+ * put method will either
+ * (1) if interrupts are enabled, block until there is room in it, or
+ * (2) if interrupts are disabled, will discard the character.
+ * The buffers are lock-free single producer, single consumer rings so
+ * characters can be queued without turning interrupts off, and
+ * serial_write() can queue a whole string at once.
+ * Input is blocking - requesting input from stdin will block
+ * until a character is available. If interrupts are disabled when 
+ * input is sought, then this will block forever.
+ * The function input_available() can be used to test whether there is
+ * input available to read from stdin.
+ *
+ */
+
+#include "serialio.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+/* System clock rate in Hz. (L at the end indicates this is a long constant) */
+#define SYSCLK 8000000L
+
+/* Global variables */
+/* Circular buffer to hold outgoing characters. This is a single producer
+ * (uart_put_char() and serial_write(), called from the main program),
+ * single consumer (the UART data register empty interrupt handler) ring
+ * buffer. The producer only ever writes out_head and the consumer only
+ * ever writes out_tail, so neither side has to disable interrupts to
+ * update the buffer. The buffer is empty when the two are equal and full
+ * when advancing out_head would make it equal to out_tail (so one byte of
+ * the buffer is never used).
+ * NOTE - the buffer sizes must be powers of two (so positions can be
+ * wrapped with a mask) and can not be larger than 256 without changing
+ * the type of the position variables below (currently 8 bit unsigned
+ * ints, which are read and written atomically).
+ */
+#define OUTPUT_BUFFER_SIZE 256
+#define OUTPUT_BUFFER_MASK (OUTPUT_BUFFER_SIZE - 1)
+volatile char out_buffer[OUTPUT_BUFFER_SIZE];
+volatile uint8_t out_head;
+volatile uint8_t out_tail;
+
+/* Circular buffer to hold incoming characters. Works on same principle
+ * as output buffer, except that the receive complete interrupt handler
+ * is the producer and uart_get_char() is the consumer. The size is set
+ * by SERIAL_INPUT_BUFFER_SIZE (see serialio.h).
+ */
+#define INPUT_BUFFER_SIZE SERIAL_INPUT_BUFFER_SIZE
+#define INPUT_BUFFER_MASK (INPUT_BUFFER_SIZE - 1)
+#if (INPUT_BUFFER_SIZE & INPUT_BUFFER_MASK) || INPUT_BUFFER_SIZE > 256
+#error SERIAL_INPUT_BUFFER_SIZE must be a power of two no larger than 256
+#endif
+volatile char input_buffer[INPUT_BUFFER_SIZE];
+volatile uint8_t input_head;
+volatile uint8_t input_tail;
+
+/* Flow control. When the input buffer fills to XOFF_LEVEL we send XOFF
+ * to ask the other end to stop, and once it has been emptied to
+ * XON_LEVEL we send XON. The space left above XOFF_LEVEL has to hold
+ * whatever the other end sends before it reacts (USB serial adapters can
+ * send a few more characters).
+ * flow_control_char is the character waiting to be sent - it goes out
+ * ahead of anything in the output buffer.
+ */
+#define XOFF_LEVEL (INPUT_BUFFER_SIZE * 3 / 4)
+#define XON_LEVEL (INPUT_BUFFER_SIZE / 4)
+static uint8_t flow_control;
+static volatile uint8_t input_stopped;
+static volatile uint8_t flow_control_char;
+
+/* Error counts (see serialio.h) */
+static volatile SerialStats stats;
+
+/* Variable to keep track of whether incoming characters are to be echoed
+ * back or not.
+ */
+static int8_t do_echo;
+
+/* Whether text output (stdio, serial_write() and serial_write_P()) is
+ * sent or discarded. Raw output is always sent.
+ */
+static uint8_t text_output;
+
+/* The current baud rate, whether double speed (U2X) mode is used and the
+ * error in the actual rate (tenths of a percent).
+ */
+static long baud_rate;
+static uint8_t double_speed;
+static int16_t baud_error;
+
+/* Set when a character is written to the UART, cleared once we've waited
+ * for it to be sent.
+ */
+static volatile uint8_t transmitting;
+
+/* Write 1 to TXC0 to clear it. The error flags in UCSR0A must be written
+ * as zero so we can't just or the bit in.
+ */
+#define CLEAR_TXC0() (UCSR0A = (UCSR0A & (1<<U2X0)) | (1<<TXC0))
+
+/* Function prototypes 
+ */
+void init_serial_stdio(long baudrate, int8_t echo);
+static int uart_put_char(char, FILE*);
+static int uart_get_char(FILE*);
+
+/* Setup a stream that uses the uart get and put functions. We will
+ * make standard input and output use this stream below.
+ */
+static FILE myStream = FDEV_SETUP_STREAM(uart_put_char, uart_get_char,
+		_FDEV_SETUP_RW);
+
+/* Work out the UBRR value for the given baud rate with a divisor of 16
+ * (normal mode) or 8 (double speed mode). Returns the error in the actual
+ * rate in tenths of a percent, or INT16_MAX if the rate can't be made.
+ */
+static int16_t baud_setting(long baudrate, uint8_t divisor, uint16_t* ubrr) {
+	/* (This differs from the datasheet formula so that we get 
+	 * rounding to the nearest integer while using integer division
+	 * (which truncates)).
+	*/
+	if(baudrate <= 0 || baudrate > SERIAL_MAX_BAUD) {
+		return INT16_MAX;
+	}
+	long value = ((SYSCLK * 2 / (divisor * baudrate)) + 1)/2 - 1;
+	if(value < 0 || value > 4095) {
+		return INT16_MAX;
+	}
+	*ubrr = value;
+	long actual = SYSCLK / (divisor * (value + 1));
+	return (actual - baudrate) * 1000 / baudrate;
+}
+
+/* Choose between normal and double speed mode - whichever is closer to
+ * the rate asked for. Normal mode is used if they're the same since the
+ * receiver samples each bit more times.
+ */
+static int16_t choose_baud_setting(long baudrate, uint16_t* ubrr,
+		uint8_t* u2x) {
+	uint16_t normal_ubrr = 0, u2x_ubrr = 0;
+	int16_t normal_error = baud_setting(baudrate, 16, &normal_ubrr);
+	int16_t u2x_error = baud_setting(baudrate, 8, &u2x_ubrr);
+	if(abs(u2x_error) < abs(normal_error)) {
+		*ubrr = u2x_ubrr;
+		*u2x = 1;
+		return u2x_error;
+	}
+	*ubrr = normal_ubrr;
+	*u2x = 0;
+	return normal_error;
+}
+
+static void set_baud(long baudrate) {
+	uint16_t ubrr;
+	baud_error = choose_baud_setting(baudrate, &ubrr, &double_speed);
+	baud_rate = baudrate;
+	UBRR0 = ubrr;
+	UCSR0A = double_speed ? (1<<U2X0) : 0;
+}
+
+void init_serial_stdio(long baudrate, int8_t echo) {
+	/*
+	 * Initialise our buffers
+	*/
+	out_head = 0;
+	out_tail = 0;
+	input_head = 0;
+	input_tail = 0;
+	input_stopped = 0;
+	flow_control_char = 0;
+	flow_control = 1;
+	serial_clear_stats();
+	
+	/*
+	 * Record whether we're going to echo characters or not
+	*/
+	do_echo = echo;
+	text_output = 1;
+	
+	/* Configure the serial port baud rate. The error is kept so it
+	 * can be reported with serial_baud_error().
+	*/
+	transmitting = 0;
+	set_baud(baudrate);
+	
+	/*
+	 * Enable transmission and receiving via UART. We don't enable
+	 * the UDR empty interrupt here (we wait until we've got a
+	 * character to transmit).
+	 * NOTE: Interrupts must be enabled globally for this
+	 * library to work, but we do not do this here.
+	*/
+	UCSR0B = (1<<RXEN0)|(1<<TXEN0);
+	
+	/*
+	 * Enable receive complete interrupt 
+	*/
+	UCSR0B  |= (1 <<RXCIE0);
+
+	/* Set up our stream so the put and get functions below are used 
+	 * to write/read characters via the serial port when we use
+	 * stdio functions
+	*/
+	stdout = &myStream;
+	stdin = &myStream;
+}
+
+int8_t serial_input_available(void) {
+	return (input_head != input_tail);
+}
+
+/* Called by the consumer after removing characters. If we've stopped the
+ * other end and there's now enough room, let it carry on.
+ */
+static void check_resume_input(void) {
+	if(input_stopped &&
+			((input_head - input_tail) & INPUT_BUFFER_MASK) <= XON_LEVEL) {
+		input_stopped = 0;
+		flow_control_char = XON;
+		UCSR0B |= (1 << UDRIE0);
+	}
+}
+
+void clear_serial_input_buffer(void) {
+	/* Just adjust our buffer data so it looks empty. Only the consumer
+	 * side is changed so this is safe with interrupts on.
+	 */
+	input_tail = input_head;
+	check_resume_input();
+}
+
+void serial_set_flow_control(uint8_t enabled) {
+	flow_control = enabled;
+	if(!enabled && input_stopped) {
+		/* Don't leave the other end waiting */
+		input_stopped = 0;
+		flow_control_char = XON;
+		UCSR0B |= (1 << UDRIE0);
+	}
+}
+
+void serial_get_stats(SerialStats* result) {
+	/* The counts are updated by the receive interrupt so turn interrupts
+	 * off while they're copied
+	 */
+	uint8_t interruptsOn = bit_is_set(SREG, SREG_I);
+	cli();
+	result->overruns = stats.overruns;
+	result->framing_errors = stats.framing_errors;
+	result->dropped = stats.dropped;
+	result->xoffs_sent = stats.xoffs_sent;
+	result->max_used = stats.max_used;
+	if(interruptsOn) {
+		sei();
+	}
+	result->size = INPUT_BUFFER_SIZE;
+}
+
+void serial_clear_stats(void) {
+	uint8_t interruptsOn = bit_is_set(SREG, SREG_I);
+	cli();
+	stats.overruns = 0;
+	stats.framing_errors = 0;
+	stats.dropped = 0;
+	stats.xoffs_sent = 0;
+	stats.max_used = 0;
+	if(interruptsOn) {
+		sei();
+	}
+}
+
+static int uart_put_char(char c, FILE* stream) {
+	/* Add the character to the buffer for transmission (if there 
+	 * is space to do so). If not we wait until the buffer has space.
+	 * If the character is \n, we output \r (carriage return)
+	 * also.
+	*/
+	if(!text_output) {
+		return 0;
+	}
+	if(c == '\n') {
+		uart_put_char('\r', stream);
+	}
+	
+	/* If the buffer is full and interrupts are disabled then we
+	 * abort - we don't output the character since the buffer will
+	 * never be emptied if interrupts are disabled. If the buffer is full
+	 * and interrupts are enabled then we loop until the buffer has 
+	 * enough space. out_tail will get modified by the ISR which
+	 * extracts bytes from the buffer.
+	*/
+	uint8_t head = out_head;
+	uint8_t next = (head + 1) & OUTPUT_BUFFER_MASK;
+	while(next == out_tail) {
+		if(!bit_is_set(SREG, SREG_I)) {
+			return 1;
+		}		
+		/* else do nothing */
+	}
+	
+	/* Store the character and then publish it by advancing out_head.
+	 * The ISR never looks past out_head so it can't see a half written
+	 * entry. Finally make sure the UDR Empty interrupt is enabled so that
+	 * it will fire and deal with the character.
+	*/	
+	out_buffer[head] = c;
+	out_head = next;
+	UCSR0B |= (1 << UDRIE0);
+	return 0;
+}
+
+uint8_t serial_output_space(void) {
+	return (out_tail - out_head - 1) & OUTPUT_BUFFER_MASK;
+}
+
+void serial_write(const char* buffer, uint8_t length) {
+	if(!text_output) {
+		return;
+	}
+	while(length) {
+		/* Copy as much as fits into the buffer and then publish the
+		 * whole lot with a single update of out_head.
+		*/
+		uint8_t head = out_head;
+		uint8_t space = (out_tail - head - 1) & OUTPUT_BUFFER_MASK;
+		while(space && length) {
+			char c = *buffer;
+			if(c == '\n') {
+				/* Output \r\n - only if both fit */
+				if(space < 2) {
+					break;
+				}
+				out_buffer[head] = '\r';
+				head = (head + 1) & OUTPUT_BUFFER_MASK;
+				space--;
+			}
+			out_buffer[head] = c;
+			head = (head + 1) & OUTPUT_BUFFER_MASK;
+			space--;
+			buffer++;
+			length--;
+		}
+		out_head = head;
+		UCSR0B |= (1 << UDRIE0);
+		
+		/* If there's more to write then wait for space, unless
+		 * interrupts are off (the buffer will never empty) in which case
+		 * the rest is discarded.
+		*/
+		if(length && !bit_is_set(SREG, SREG_I)) {
+			return;
+		}
+	}
+}
+
+void serial_write_P(const char* string) {
+	/* Copy the string out of program memory in chunks */
+	char chunk[16];
+	uint8_t length;
+	do {
+		length = 0;
+		while(length < sizeof(chunk) &&
+				(chunk[length] = pgm_read_byte(string)) != 0) {
+			length++;
+			string++;
+		}
+		serial_write(chunk, length);
+	} while(length == sizeof(chunk));
+}
+
+uint8_t serial_write_raw(const uint8_t* buffer, uint8_t length) {
+	if(serial_output_space() < length) {
+		return 0;
+	}
+	uint8_t head = out_head;
+	for(uint8_t i = 0; i < length; i++) {
+		out_buffer[head] = buffer[i];
+		head = (head + 1) & OUTPUT_BUFFER_MASK;
+	}
+	out_head = head;
+	UCSR0B |= (1 << UDRIE0);
+	return 1;
+}
+
+int16_t serial_check_baud(long baudrate) {
+	uint16_t ubrr;
+	uint8_t u2x;
+	return choose_baud_setting(baudrate, &ubrr, &u2x);
+}
+
+int8_t serial_set_baud(long baudrate) {
+	if(abs(serial_check_baud(baudrate)) > SERIAL_MAX_BAUD_ERROR) {
+		return 0;
+	}
+	serial_wait_for_output();
+	set_baud(baudrate);
+	/* Anything received at the old rate is rubbish now */
+	clear_serial_input_buffer();
+	return 1;
+}
+
+long serial_baud_rate(void) {
+	return baud_rate;
+}
+
+int16_t serial_baud_error(void) {
+	return baud_error;
+}
+
+uint8_t serial_double_speed(void) {
+	return double_speed;
+}
+
+void serial_wait_for_output(void) {
+	/* Wait for the buffer to empty (if interrupts are on - otherwise
+	 * it never will) and then for the last character to leave the shift
+	 * register.
+	 */
+	while(out_head != out_tail) {
+		if(!bit_is_set(SREG, SREG_I)) {
+			return;
+		}
+	}
+	if(transmitting) {
+		while(!bit_is_set(UCSR0A, TXC0)) {
+			/* do nothing */
+		}
+		transmitting = 0;
+	}
+}
+
+void serial_set_text_output(uint8_t enabled) {
+	text_output = enabled;
+}
+
+uint8_t serial_text_output(void) {
+	return text_output;
+}
+
+int uart_get_char(FILE* stream) {
+	/* Wait until we've received a character */
+	while(input_head == input_tail) {
+		/* do nothing */
+	}
+	
+	/*
+	 * Remove a character from the input buffer. The RX ISR never writes
+	 * input_tail so there is no need to turn interrupts off.
+	 */
+	uint8_t tail = input_tail;
+	char c = input_buffer[tail];
+	input_tail = (tail + 1) & INPUT_BUFFER_MASK;
+	check_resume_input();
+	return c;
+}
+
+/*
+ * Define the interrupt handler for UART Data Register Empty (i.e. 
+ * another character can be taken from our buffer and written out)
+ */
+ISR(USART0_UDRE_vect) 
+{
+	/* Flow control characters jump the queue */
+	if(flow_control_char) {
+		CLEAR_TXC0();
+		UDR0 = flow_control_char;
+		transmitting = 1;
+		flow_control_char = 0;
+		return;
+	}
+	
+	/* Check if we have data in our buffer */
+	uint8_t tail = out_tail;
+	if(tail != out_head) {
+		/* Yes we do - output the oldest byte via the UART and
+		 * advance our position
+		 */
+		CLEAR_TXC0();
+		UDR0 = out_buffer[tail];
+		transmitting = 1;
+		out_tail = (tail + 1) & OUTPUT_BUFFER_MASK;
+	} else {
+		/* No data in the buffer. We disable the UART Data
+		 * Register Empty interrupt because otherwise it 
+		 * will trigger again immediately this ISR exits. 
+		 * The interrupt is reenabled when a character is
+		 * placed in the buffer.
+		 */
+		UCSR0B &= ~(1<<UDRIE0);
+	}
+}
+
+/*
+ * Define the interrupt handler for UART Receive Complete (i.e. 
+ * we can read a character. The character is read and placed in
+ * the input buffer.
+ */
+
+ISR(USART0_RX_vect) 
+{
+	/* Read the status before the character (reading UDR0 clears it).
+	 * An overrun means characters were lost before this one - this one
+	 * is fine. A character with a framing error is rubbish (usually the
+	 * wrong baud rate or a break) so is thrown away.
+	 */
+	uint8_t status = UCSR0A;
+	char c;
+	c = UDR0;
+	if(status & (1<<DOR0)) {
+		stats.overruns++;
+	}
+	if(status & (1<<FE0)) {
+		stats.framing_errors++;
+		return;
+	}
+		
+	if(do_echo && out_head == out_tail && bit_is_set(UCSR0A, UDRE0)) {
+		/* If echoing is enabled and the transmitter is idle, echo the
+		 * received character straight back to the UART. (We can't add
+		 * it to the output buffer since only the main program may do
+		 * that. Characters received while output is pending aren't
+		 * echoed.)
+		 */
+		CLEAR_TXC0();
+		UDR0 = c;
+		transmitting = 1;
+	}
+	
+	/* 
+	 * Check if we have space in our buffer. If not, count the character
+	 * as dropped and throw it away.
+	 */
+	uint8_t head = input_head;
+	uint8_t next = (head + 1) & INPUT_BUFFER_MASK;
+	uint8_t used = (next - input_tail) & INPUT_BUFFER_MASK;
+	if(next == input_tail) {
+		stats.dropped++;
+	} else {
+		/* If the character is a carriage return, turn it into a
+		 * linefeed 
+		*/
+		if (c == '\r') {
+			c = '\n';
+		}
+		
+		/* 
+		 * There is room in the input buffer 
+		 */
+		input_buffer[head] = c;
+		input_head = next;
+		if(used > stats.max_used) {
+			stats.max_used = used;
+		}
+		
+		/* Ask the other end to stop if we're getting full */
+		if(flow_control && !input_stopped && used >= XOFF_LEVEL) {
+			input_stopped = 1;
+			flow_control_char = XOFF;
+			stats.xoffs_sent++;
+			UCSR0B |= (1 << UDRIE0);
+		}
+	}
+}
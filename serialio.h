@@ -1,41 +1,147 @@
-/*
- * serialio.h
- *
- * Author: Peter Sutton
- * 
- * Module to allow standard input/output routines to be used via 
- * serial port 0. The init_serial_stdio() method must be called before
- * any standard IO methods (e.g. printf). We use interrupt-based serial
- * IO and a circular buffer to store output messages. (This allows us 
- * to print many characters at once to the buffer and have them 
- * output by the UART as speed permits.) Interrupts must be enabled 
- * globally for this module to work (after init_serial_stdio() is called).
- *
- */
-
-
-#ifndef SERIALIO_H_
-#define SERIALIO_H_
-
-#include <stdint.h>
-
-/* Initialise serial IO using the UART. baudrate specifies the desired
- * baud rate (e.g. 19200) and echo determines whether incoming characters
- * are echoed back to the UART output as they are received (zero means no
- * echo, non-zero means echo)
- */
-void init_serial_stdio(long baudrate, int8_t echo);
-
-/* Test if input is available from the serial port. Return 0 if not,
- * non-zero otherwise. If there is input available then it can be read
- * with a suitable standard IO library function, e.g. fgetc().
- */
-int8_t serial_input_available(void);
-
-/* Discard any input waiting to be read from the serial port. (Characters may
- * have been typed when we didn't want them - clear them.
- */
-void clear_serial_input_buffer(void);
-
-
+/*
+ * serialio.h
+ *
+ * Author: Peter Sutton
+ * 
+ * Module to allow standard input/output routines to be used via 
+ * serial port 0. The init_serial_stdio() method must be called before
+ * any standard IO methods (e.g. printf). We use interrupt-based serial
+ * IO and a circular buffer to store output messages. (This allows us 
+ * to print many characters at once to the buffer and have them 
+ * output by the UART as speed permits.) Interrupts must be enabled 
+ * globally for this module to work (after init_serial_stdio() is called).
+ *
+ */
+
+
+#ifndef SERIALIO_H_
+#define SERIALIO_H_
+
+#include <stdint.h>
+
+/* Size of the input buffer. This must be a power of two no larger than
+ * 256 and can be changed by defining it when compiling.
+ */
+#ifndef SERIAL_INPUT_BUFFER_SIZE
+#define SERIAL_INPUT_BUFFER_SIZE 128
+#endif
+
+/* XON/XOFF flow control characters */
+#define XON 0x11
+#define XOFF 0x13
+
+/* Counts of problems with received characters since
+ * init_serial_stdio() or serial_clear_stats().
+ */
+typedef struct {
+	uint16_t overruns;			// lost by the UART before we read them (DOR)
+	uint16_t framing_errors;	// received with a framing error (FE)
+	uint16_t dropped;			// thrown away because the buffer was full
+	uint16_t xoffs_sent;		// number of times XOFF was sent
+	uint16_t max_used;			// most characters in the buffer at once
+	uint16_t size;				// size of the buffer (up to 256)
+} SerialStats;
+
+/* Initialise serial IO using the UART. baudrate specifies the desired
+ * baud rate (e.g. 19200) and echo determines whether incoming characters
+ * are echoed back to the UART output as they are received (zero means no
+ * echo, non-zero means echo)
+ */
+void init_serial_stdio(long baudrate, int8_t echo);
+
+/* Largest baud rate error (tenths of a percent) that serial_set_baud()
+ * will accept. Both ends can be out by this much before characters are
+ * misread.
+ */
+#define SERIAL_MAX_BAUD_ERROR 20
+
+/* Fastest baud rate the UART can run at from the 8MHz clock (double speed
+ * mode with UBRR0 = 0). Faster rates are refused.
+ */
+#define SERIAL_MAX_BAUD 1000000L
+
+/* Return the error (in tenths of a percent) that the given baud rate
+ * would have. Double speed (U2X) mode is used where it is more accurate.
+ * The fastest rates that can be made exactly from the 8MHz clock are
+ * 250000, 500000 and 1000000. INT16_MAX is returned if the rate can't be
+ * made at all.
+ */
+int16_t serial_check_baud(long baudrate);
+
+/* Change the baud rate. Output already queued is sent at the old rate
+ * first, and any input waiting is discarded. Returns 1 if the rate was
+ * changed, 0 if its error is more than SERIAL_MAX_BAUD_ERROR.
+ */
+int8_t serial_set_baud(long baudrate);
+
+/* Return the current baud rate, its error (tenths of a percent) and
+ * whether double speed mode is being used.
+ */
+long serial_baud_rate(void);
+int16_t serial_baud_error(void);
+uint8_t serial_double_speed(void);
+
+/* Wait until all queued output has been transmitted. Returns straight
+ * away if interrupts are disabled.
+ */
+void serial_wait_for_output(void);
+
+/* Test if input is available from the serial port. Return 0 if not,
+ * non-zero otherwise. If there is input available then it can be read
+ * with a suitable standard IO library function, e.g. fgetc().
+ */
+int8_t serial_input_available(void);
+
+/* Discard any input waiting to be read from the serial port. (Characters may
+ * have been typed when we didn't want them - clear them.
+ */
+void clear_serial_input_buffer(void);
+
+/* Turn XON/XOFF flow control of the input on (non-zero, the default) or
+ * off. With it on XOFF is sent when the input buffer is three quarters
+ * full and XON when it is down to a quarter full. XON and XOFF are only
+ * sent, never acted on.
+ */
+void serial_set_flow_control(uint8_t enabled);
+
+/* Get or reset the error counts.
+ */
+void serial_get_stats(SerialStats* result);
+void serial_clear_stats(void);
+
+/* Queue length characters from buffer for output, bypassing stdio. This
+ * is much cheaper than printf for strings that need no formatting. \n is
+ * output as \r\n. Blocks for space like the stdio output does (or
+ * discards what doesn't fit if interrupts are disabled).
+ */
+void serial_write(const char* buffer, uint8_t length);
+
+/* Return the number of characters that can be queued for output without
+ * waiting.
+ */
+uint8_t serial_output_space(void);
+
+/* As for serial_write() but for a null terminated string stored in
+ * program memory (e.g. serial_write_P(PSTR("Hello"))).
+ */
+void serial_write_P(const char* string);
+
+/* Queue length bytes for output exactly as given (no \n translation). This
+ * never blocks - the bytes are only queued if they all fit. Returns 1 if
+ * they were queued, 0 if not. Raw output is sent even when text output is
+ * turned off.
+ */
+uint8_t serial_write_raw(const uint8_t* buffer, uint8_t length);
+
+/* Turn text output (stdio, serial_write() and serial_write_P()) on
+ * (non-zero) or off. While it is off text output is discarded. This is
+ * used to keep text out of a binary stream.
+ */
+void serial_set_text_output(uint8_t enabled);
+
+/* Returns non-zero if text output is on.
+ */
+uint8_t serial_text_output(void);
+
+
 #endif /* SERIALIO_H_ */
\ No newline at end of file
@@ -0,0 +1,146 @@
+/*
+ * sound.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * Timer 1 runs in fast PWM mode with OCR1A as TOP, counting at 1MHz, so a
+ * note's period in microseconds is OCR1A + 1. OC1B is set at the bottom
+ * and cleared when the count reaches OCR1B (0xFF), giving a short pulse
+ * each period. OCR1A = 0 is silent (the count never reaches OCR1B).
+ * OCR1A is double buffered by the timer in this mode so a new note starts
+ * cleanly at the end of a period.
+ */
+
+#include "sound.h"
+#include <stddef.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include "pcm.h"
+#include "pcm_samples.h"
+
+// A note - period in microseconds (0 for a rest) and duration in ms. A
+// duration of 0 ends the effect.
+typedef struct {
+	uint16_t period;
+	uint16_t duration;
+} Note;
+
+static const Note start_notes[] PROGMEM = {
+	{2500, 1000}, {4440, 100}, {9000, 100}, {0, 0}
+};
+static const Note step_notes[] PROGMEM = {
+	{40000, 70}, {0, 0}
+};
+static const Note snake_middle_notes[] PROGMEM = {
+	{2500, 50}, {9000, 120}, {0, 0}
+};
+static const Note snake_end_notes[] PROGMEM = {
+	{8880, 50}, {0, 0}
+};
+static const Note win_notes[] PROGMEM = {
+	{6000, 100}, {4000, 200}, {5000, 700}, {0, 0}
+};
+
+// Voices used for sampled effects - clicks go on their own voice so they
+// can play over longer effects
+#define VOICE_EFFECT 0
+#define VOICE_CLICK 1
+
+// An effect is a tune for the buzzer and optionally a sample for the
+// speaker
+typedef struct {
+	const Note* notes;
+	const PcmSample* sample;
+	uint8_t voice;
+} Effect;
+
+// Indexed by SOUND_EFFECT_
+static const Effect effects[] PROGMEM = {
+	{start_notes, NULL, 0},
+	{step_notes, &pcm_click, VOICE_CLICK},
+	{snake_middle_notes, &pcm_slide, VOICE_EFFECT},
+	{snake_end_notes, NULL, 0},
+	{win_notes, NULL, 0}
+};
+
+static uint8_t enabled;
+
+// The next note to play (NULL when nothing is playing) and how many ms
+// are left of the current note. Both are changed by the timer interrupt.
+static const Note* volatile next_note;
+static volatile uint16_t remaining;
+
+void init_sound(void) {
+	OCR1B = 0xFF;
+	TCCR1A = (1 << WGM10) | (1 << WGM11) | (1 << COM1A1)| (1 << COM1B1);
+	TCCR1B = (1 << WGM12) | (1 << WGM13) | (1 << CS11) ;
+	OCR1A = 0;
+	next_note = NULL;
+	enabled = 1;
+}
+
+// Start the next note, or go quiet at the end of the effect. Must be
+// called with interrupts off - OCR1A is 16 bits and shares the timer's
+// TEMP register with every other 16 bit access.
+static void start_next_note(void) {
+	uint16_t duration = pgm_read_word(&next_note->duration);
+	if (duration == 0) {
+		OCR1A = 0;
+		next_note = NULL;
+		return;
+	}
+	uint16_t period = pgm_read_word(&next_note->period);
+	OCR1A = period ? period - 1 : 0;
+	remaining = duration;
+	next_note++;
+}
+
+void sound_play(uint8_t effect) {
+	if (!enabled) {
+		return;
+	}
+	const Effect* e = &effects[effect];
+	uint8_t interruptsOn = bit_is_set(SREG, SREG_I);
+	cli();
+	next_note = pgm_read_ptr(&e->notes);
+	start_next_note();
+	if (interruptsOn) {
+		sei();
+	}
+	
+	const PcmSample* sample = pgm_read_ptr(&e->sample);
+	if (sample != NULL) {
+		pcm_play(pgm_read_byte(&e->voice), sample);
+	}
+}
+
+uint8_t sound_playing(void) {
+	return next_note != NULL;
+}
+
+void sound_stop(void) {
+	uint8_t interruptsOn = bit_is_set(SREG, SREG_I);
+	cli();
+	next_note = NULL;
+	OCR1A = 0;
+	if (interruptsOn) {
+		sei();
+	}
+}
+
+void sound_on(void) {
+	enabled = 1;
+}
+
+void sound_off(void) {
+	enabled = 0;
+	sound_stop();
+	pcm_stop_all();
+}
+
+void sound_tick(void) {
+	if (next_note != NULL && --remaining == 0) {
+		start_next_note();
+	}
+}
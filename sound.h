@@ -0,0 +1,53 @@
+/*
+ * sound.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * Sound effects on the piezo buzzer (OC1B, pin D4). An effect is a short
+ * tune stored in program memory which is played in the background by the
+ * 1ms timer tick, so the game carries on while it plays. Starting an
+ * effect stops whatever was playing before. Some effects also play a
+ * sample on the speaker (see pcm.h).
+ */
+
+
+#ifndef SOUND_H_
+#define SOUND_H_
+
+#include <stdint.h>
+
+// Sound effects
+#define SOUND_EFFECT_START			0	// new game
+#define SOUND_EFFECT_STEP			1	// player moves one square
+#define SOUND_EFFECT_SNAKE_MIDDLE	2	// sliding down a snake
+#define SOUND_EFFECT_SNAKE_END		3	// reached the bottom of a snake
+#define SOUND_EFFECT_WIN			4	// game over
+
+/* Set up timer 1 to drive the buzzer. Sound starts on and silent.
+ */
+void init_sound(void);
+
+/* Start playing an effect. Does nothing while sound is turned off.
+ */
+void sound_play(uint8_t effect);
+
+/* Returns non-zero while an effect is playing.
+ */
+uint8_t sound_playing(void);
+
+/* Stop the effect that is playing (if any).
+ */
+void sound_stop(void);
+
+/* Turn sound on or off. Turning it off stops the effect that is playing.
+ */
+void sound_on(void);
+void sound_off(void);
+
+/* Called every millisecond from the timer 0 interrupt to move on to the
+ * next note.
+ */
+void sound_tick(void);
+
+
+#endif /* SOUND_H_ */
@@ -0,0 +1,228 @@
+/*
+ * telemetry.c
+ *
+ * Author: Adnaan Buksh
+ *
+ * Each message is built and SLIP encoded into a buffer on the stack and
+ * then queued in one go with serial_write_raw(). A frame is either queued
+ * whole or dropped, so the game loop never waits for the serial port and
+ * the host never sees half a frame.
+ */
+
+#include "telemetry.h"
+#include <util/crc16.h>
+#include "serialio.h"
+#include "screen.h"
+#include "ledmatrix.h"
+
+// Frame header, payload and CRC, with every byte escaped, plus the two
+// SLIP_END delimiters
+#define FRAME_BUFFER_SIZE ((2 + TELEMETRY_MAX_PAYLOAD + 2) * 2 + 2)
+
+static uint8_t enabled;
+static uint8_t sequence;
+static uint16_t frames_sent;
+static uint16_t frames_dropped;
+
+typedef struct {
+	uint8_t data[FRAME_BUFFER_SIZE];
+	uint8_t length;
+	uint16_t crc;
+} Frame;
+
+void telemetry_set_enabled(uint8_t on) {
+	if (on && !enabled) {
+		frames_sent = 0;
+		frames_dropped = 0;
+		serial_set_text_output(0);
+		// The host needs the whole matrix to start from
+		ledmatrix_mark_all_changed();
+	} else if (!on && enabled) {
+		serial_set_text_output(1);
+		screen_redraw();
+	}
+	enabled = on;
+}
+
+uint8_t telemetry_enabled(void) {
+	return enabled;
+}
+
+static void frame_byte(Frame* frame, uint8_t byte) {
+	frame->crc = _crc_xmodem_update(frame->crc, byte);
+	if (byte == SLIP_END) {
+		frame->data[frame->length++] = SLIP_ESC;
+		byte = SLIP_ESC_END;
+	} else if (byte == SLIP_ESC) {
+		frame->data[frame->length++] = SLIP_ESC;
+		byte = SLIP_ESC_ESC;
+	} else if (byte == SLIP_XON) {
+		frame->data[frame->length++] = SLIP_ESC;
+		byte = SLIP_ESC_XON;
+	} else if (byte == SLIP_XOFF) {
+		frame->data[frame->length++] = SLIP_ESC;
+		byte = SLIP_ESC_XOFF;
+	}
+	frame->data[frame->length++] = byte;
+}
+
+static void frame_word(Frame* frame, uint16_t word) {
+	frame_byte(frame, word & 0xFF);
+	frame_byte(frame, word >> 8);
+}
+
+static void frame_long(Frame* frame, uint32_t value) {
+	frame_word(frame, value & 0xFFFF);
+	frame_word(frame, value >> 16);
+}
+
+static void frame_start(Frame* frame, uint8_t type) {
+	frame->length = 0;
+	frame->crc = 0xFFFF;
+	frame->data[frame->length++] = SLIP_END;
+	frame_byte(frame, type);
+	frame_byte(frame, sequence);
+}
+
+static uint8_t frame_send(Frame* frame) {
+	// The CRC goes through the same escaping as everything else
+	uint16_t crc = frame->crc;
+	frame_word(frame, crc);
+	frame->data[frame->length++] = SLIP_END;
+	
+	if (serial_write_raw(frame->data, frame->length)) {
+		sequence++;
+		frames_sent++;
+		return 1;
+	}
+	frames_dropped++;
+	return 0;
+}
+
+void telemetry_send_snapshot(const TelemetrySnapshot* snapshot) {
+	if (!enabled) {
+		return;
+	}
+	Frame frame;
+	frame_start(&frame, TELEMETRY_SNAPSHOT);
+	frame_long(&frame, snapshot->time);
+	frame_byte(&frame, snapshot->flags);
+	frame_byte(&frame, snapshot->current_player);
+	frame_byte(&frame, snapshot->p1_x);
+	frame_byte(&frame, snapshot->p1_y);
+	frame_byte(&frame, snapshot->p2_x);
+	frame_byte(&frame, snapshot->p2_y);
+	frame_byte(&frame, snapshot->dice);
+	frame_byte(&frame, snapshot->board);
+	frame_byte(&frame, snapshot->p1_turns);
+	frame_byte(&frame, snapshot->p2_turns);
+	frame_word(&frame, snapshot->p1_time_left);
+	frame_word(&frame, snapshot->p2_time_left);
+	frame_byte(&frame, snapshot->winner);
+	frame_send(&frame);
+}
+
+void telemetry_send_event(const TelemetryEvent* event) {
+	if (!enabled) {
+		return;
+	}
+	Frame frame;
+	frame_start(&frame, TELEMETRY_EVENT);
+	frame_long(&frame, event->time);
+	frame_byte(&frame, event->type);
+	frame_byte(&frame, event->source);
+	frame_byte(&frame, event->arg1);
+	frame_byte(&frame, event->arg2);
+	frame_send(&frame);
+}
+
+void telemetry_send_reply(const char* text) {
+	if (!enabled) {
+		return;
+	}
+	Frame frame;
+	frame_start(&frame, TELEMETRY_REPLY);
+	for (uint8_t i = 0; i < TELEMETRY_MAX_PAYLOAD && text[i]; i++) {
+		frame_byte(&frame, text[i]);
+	}
+	frame_send(&frame);
+}
+
+void telemetry_send_counters(TelemetryCounters* counters) {
+	if (!enabled) {
+		return;
+	}
+	counters->frames_sent = frames_sent;
+	counters->frames_dropped = frames_dropped;
+	counters->serial_space = serial_output_space();
+	Frame frame;
+	frame_start(&frame, TELEMETRY_COUNTERS);
+	frame_word(&frame, counters->frames_sent);
+	frame_word(&frame, counters->frames_dropped);
+	frame_word(&frame, counters->input_latency);
+	frame_word(&frame, counters->loops);
+	frame_word(&frame, counters->period);
+	frame_word(&frame, counters->serial_space);
+	frame_send(&frame);
+}
+
+// Number of pixels from index on that have changed (if changed is 1) or
+// haven't (if changed is 0), and are the same colour if colour is 1
+static uint8_t matrix_run(uint8_t index, uint8_t changed, uint8_t colour) {
+	PixelColour first = ledmatrix_get_pixel(index);
+	uint8_t run = 0;
+	while (index + run < MATRIX_NUM_PIXELS &&
+			ledmatrix_pixel_changed(index + run) == changed &&
+			(!colour || ledmatrix_get_pixel(index + run) == first)) {
+		run++;
+	}
+	return run;
+}
+
+uint8_t telemetry_send_matrix(void) {
+	if (!enabled) {
+		return 0;
+	}
+	int8_t dx, dy;
+	ledmatrix_get_shift(&dx, &dy);
+	uint8_t start = 0;
+	if (!ledmatrix_pixel_changed(0)) {
+		start = matrix_run(0, 0, 0);
+	}
+	if (start == MATRIX_NUM_PIXELS && !dx && !dy) {
+		return 0;
+	}
+	// Wait for room for the largest frame rather than build one to drop
+	if (serial_output_space() < FRAME_BUFFER_SIZE) {
+		return 0;
+	}
+	Frame frame;
+	frame_start(&frame, TELEMETRY_MATRIX);
+	frame_byte(&frame, (dx & 0x0F) | ((uint8_t)dy << 4));
+	frame_byte(&frame, start);
+	uint8_t length = 2;
+	uint8_t index = start;
+	while (index < MATRIX_NUM_PIXELS && length + 2 <= TELEMETRY_MAX_PAYLOAD) {
+		if (!ledmatrix_pixel_changed(index)) {
+			uint8_t run = matrix_run(index, 0, 0);
+			// Nothing after it to send, or no room to send it
+			if (index + run == MATRIX_NUM_PIXELS ||
+					length + 3 > TELEMETRY_MAX_PAYLOAD) {
+				break;
+			}
+			frame_byte(&frame, MATRIX_CODE_SKIP | (run - 1));
+			length++;
+			index += run;
+		}
+		uint8_t run = matrix_run(index, 1, 1);
+		frame_byte(&frame, run - 1);
+		frame_byte(&frame, ledmatrix_get_pixel(index));
+		length += 2;
+		index += run;
+	}
+	if (!frame_send(&frame)) {
+		return 0;
+	}
+	ledmatrix_changes_sent(start, index);
+	return 1;
+}
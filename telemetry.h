@@ -0,0 +1,142 @@
+/*
+ * telemetry.h
+ *
+ * Author: Adnaan Buksh
+ *
+ * Optional binary telemetry over the serial port. When telemetry is on,
+ * text output to the terminal is suppressed and the game instead sends
+ * SLIP framed messages that host tools can decode reliably.
+ *
+ * Frame format (before SLIP encoding):
+ *   type (1 byte), sequence number (1 byte), payload, CRC-16 (2 bytes)
+ * The CRC is CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF)
+ * over the type, sequence number and payload, sent low byte first. All
+ * multi-byte payload values are little endian. Each frame is preceded and
+ * followed by SLIP_END.
+ *
+ * The constants and payload structures are shared with the host decoder
+ * (host/telemetry) so this header must only depend on stdint.h.
+ */
+
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+
+// SLIP framing bytes
+#define SLIP_END		0xC0
+#define SLIP_ESC		0xDB
+#define SLIP_ESC_END	0xDC
+#define SLIP_ESC_ESC	0xDD
+// Not part of standard SLIP - XON and XOFF are escaped as well so that they
+// never appear in a frame. The serial port can send them at any time for
+// flow control, and decoders must ignore them.
+#define SLIP_ESC_XON	0xDE
+#define SLIP_ESC_XOFF	0xDF
+#define SLIP_XON		0x11
+#define SLIP_XOFF		0x13
+
+// Message types
+#define TELEMETRY_SNAPSHOT	0x01	// game state, see TelemetrySnapshot
+#define TELEMETRY_EVENT		0x02	// an input event, see TelemetryEvent
+#define TELEMETRY_COUNTERS	0x03	// performance counters, see TelemetryCounters
+#define TELEMETRY_REPLY		0x04	// reply to a remote command (text)
+#define TELEMETRY_MATRIX	0x05	// changes to the LED matrix, see below
+
+// Largest payload of any message
+#define TELEMETRY_MAX_PAYLOAD 40
+
+// Snapshot flags
+#define SNAPSHOT_MULTIPLAYER	0x01
+#define SNAPSHOT_ROLLING		0x02
+#define SNAPSHOT_SOUND_ON		0x04
+#define SNAPSHOT_TIME_LIMIT		0x08
+
+// Payload of TELEMETRY_SNAPSHOT (19 bytes, in this order)
+typedef struct {
+	uint32_t time;			// get_current_time()
+	uint8_t flags;			// SNAPSHOT_ flags above
+	uint8_t current_player;	// 0 or 1
+	uint8_t p1_x;
+	uint8_t p1_y;
+	uint8_t p2_x;
+	uint8_t p2_y;
+	uint8_t dice;			// value shown on the dice (1 to 6)
+	uint8_t board;			// board number
+	uint8_t p1_turns;
+	uint8_t p2_turns;
+	int16_t p1_time_left;	// seconds, when SNAPSHOT_TIME_LIMIT is set
+	int16_t p2_time_left;
+	uint8_t winner;			// 0 while playing, else 1 or 2
+} TelemetrySnapshot;
+
+// Payload of TELEMETRY_EVENT (8 bytes, in this order). The fields match
+// InputEvent in input.h.
+typedef struct {
+	uint32_t time;
+	uint8_t type;
+	uint8_t source;
+	int8_t arg1;
+	int8_t arg2;
+} TelemetryEvent;
+
+// Payload of TELEMETRY_COUNTERS (12 bytes, in this order)
+typedef struct {
+	uint16_t frames_sent;		// since telemetry was turned on
+	uint16_t frames_dropped;	// no room in the serial output buffer
+	uint16_t input_latency;		// ms from the last input to the display
+	uint16_t loops;				// main loop passes since the last counters
+	uint16_t period;			// ms since the last counters
+	uint16_t serial_space;		// free space in the serial output buffer
+} TelemetryCounters;
+
+// Payload of TELEMETRY_MATRIX (2 to TELEMETRY_MAX_PAYLOAD bytes). Each frame
+// brings a copy of the LED matrix up to date with the pixels that have
+// changed since the last one:
+//   shift (1 byte)  first move the whole matrix this many columns (towards
+//                   higher x, low nibble) and rows (towards higher y, high
+//                   nibble), both signed. Pixels moved in are black.
+//   start (1 byte)  the first pixel changed, numbered along the rows from
+//                   0 as x + 16y
+//   then codes, each carrying on from the pixel after the last:
+//     0nnnnnnn c    n + 1 pixels of colour c
+//     1nnnnnnn      n + 1 pixels that haven't changed
+// A frame doesn't always carry every change - the rest follow in the next
+// ones. Every pixel is sent again every few seconds (a keyframe) and when
+// telemetry is turned on, so a host that loses a frame only needs to wait
+// until each pixel has been sent since to have the whole matrix again.
+#define TELEMETRY_MATRIX_COLUMNS	16
+#define TELEMETRY_MATRIX_ROWS		8
+#define MATRIX_CODE_SKIP			0x80
+
+/* Turn telemetry on (non-zero) or off. Turning it on stops text output to
+ * the terminal. Turning it off clears the terminal and redraws the status
+ * text.
+ */
+void telemetry_set_enabled(uint8_t enabled);
+
+/* Returns non-zero if telemetry is on.
+ */
+uint8_t telemetry_enabled(void);
+
+/* Send a message. These never block - if there isn't room in the serial
+ * output buffer for the whole frame it is dropped (and counted). They do
+ * nothing if telemetry is off.
+ */
+void telemetry_send_snapshot(const TelemetrySnapshot* snapshot);
+void telemetry_send_event(const TelemetryEvent* event);
+void telemetry_send_counters(TelemetryCounters* counters);
+// The reply is cut off at TELEMETRY_MAX_PAYLOAD characters
+void telemetry_send_reply(const char* text);
+
+/* Send the changes to the LED matrix since they were last sent, as much as
+ * fits in one frame. Nothing is sent if nothing has changed, or if there
+ * isn't room for a full frame in the serial output buffer - the changes
+ * are kept until they can be sent, so none are lost and no frame is
+ * counted as dropped. The work is bounded: one pass over the 128 pixels
+ * and one frame. Returns 1 if a frame was sent.
+ */
+uint8_t telemetry_send_matrix(void);
+
+#endif /* TELEMETRY_H_ */